@@ -0,0 +1,62 @@
+/*
+ * libpoporon - bench.h
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef POPORON_BENCHMARK_BENCH_H
+#define POPORON_BENCHMARK_BENCH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/* monotonic wall clock in seconds */
+static inline double bench_now(void)
+{
+#if defined(_WIN32)
+    LARGE_INTEGER counter, frequency;
+
+    QueryPerformanceCounter(&counter);
+    QueryPerformanceFrequency(&frequency);
+
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+/* deterministic fill so that runs are comparable */
+static inline void bench_fill(uint8_t *out, size_t size, uint64_t *state)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 7;
+        *state ^= *state << 17;
+        out[i] = (uint8_t)*state;
+    }
+}
+
+static inline double bench_mbps(size_t bytes, double seconds)
+{
+    return seconds > 0.0 ? (double)bytes / seconds / 1e6 : 0.0;
+}
+
+#endif /* POPORON_BENCHMARK_BENCH_H */
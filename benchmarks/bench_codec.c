@@ -0,0 +1,338 @@
+/*
+ * libpoporon - bench_codec.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdbool.h>
+
+#include <poporon.h>
+
+#include "bench.h"
+
+#define RS_FRAMES    512
+#define RS_DATA      223
+#define RS_PARITY    32
+#define RS_ERRORS    16
+#define RS_FEW       2 /* errors per frame on a mostly clean channel */
+#define RS_ERASURES  32
+#define BCH_FRAMES   4096
+#define BCH_ERRORS   3
+#define REPEAT       16
+
+typedef struct {
+    uint8_t *data;
+    uint8_t *received;
+    uint8_t *parity;
+    size_t count;
+    size_t data_size;
+    size_t parity_size;
+} frames_t;
+
+static bool frames_alloc(frames_t *frames, size_t count, size_t data_size, size_t parity_size)
+{
+    frames->data = (uint8_t *)malloc(count * data_size);
+    frames->received = (uint8_t *)malloc(count * data_size);
+    frames->parity = (uint8_t *)calloc(count, parity_size);
+    frames->count = count;
+    frames->data_size = data_size;
+    frames->parity_size = parity_size;
+
+    return frames->data && frames->received && frames->parity;
+}
+
+static void frames_free(frames_t *frames)
+{
+    free(frames->data);
+    free(frames->received);
+    free(frames->parity);
+}
+
+/* encodes every frame, then keeps a copy of the data with errors applied by corrupt() */
+static bool frames_build(frames_t *frames, poporon_t *pprn, void (*corrupt)(uint8_t *data, size_t size, uint64_t *state))
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t i;
+
+    for (i = 0; i < frames->count; i++) {
+        bench_fill(&frames->data[i * frames->data_size], frames->data_size, &state);
+        if (!poporon_encode(pprn, &frames->data[i * frames->data_size], frames->data_size,
+                            &frames->parity[i * frames->parity_size])) {
+            return false;
+        }
+        corrupt(&frames->data[i * frames->data_size], frames->data_size, &state);
+    }
+
+    memcpy(frames->received, frames->data, frames->count * frames->data_size);
+
+    return true;
+}
+
+static void corrupt_none(uint8_t *data, size_t size, uint64_t *state)
+{
+    (void)data;
+    (void)size;
+    (void)state;
+}
+
+static void corrupt_rs_errors(uint8_t *data, size_t size, uint64_t *state)
+{
+    size_t i;
+
+    (void)state;
+
+    for (i = 0; i < RS_ERRORS; i++) {
+        data[(i * size) / RS_ERRORS] ^= 0x5A;
+    }
+}
+
+static void corrupt_rs_few_errors(uint8_t *data, size_t size, uint64_t *state)
+{
+    size_t i;
+
+    for (i = 0; i < RS_FEW; i++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 7;
+        *state ^= *state << 17;
+        data[(i * size + (size_t)(*state % size)) / RS_FEW] ^= (uint8_t)(1 + *state % 255);
+    }
+}
+
+static void corrupt_rs_erasures(uint8_t *data, size_t size, uint64_t *state)
+{
+    size_t i;
+
+    (void)size;
+    (void)state;
+
+    for (i = 0; i < RS_ERASURES; i++) {
+        data[i * 4] ^= 0xA5;
+    }
+}
+
+static void corrupt_bch_errors(uint8_t *data, size_t size, uint64_t *state)
+{
+    size_t i;
+
+    (void)size;
+    (void)state;
+
+    /* BCH(31,16) carries its 16 data bits in the first two bytes */
+    for (i = 0; i < BCH_ERRORS; i++) {
+        data[i & 1] ^= (uint8_t)(1 << (i * 3 % 8));
+    }
+}
+
+static double frames_encode(poporon_t *pprn, frames_t *frames)
+{
+    double start, elapsed = 0.0;
+    size_t r, i;
+
+    for (r = 0; r < REPEAT; r++) {
+        start = bench_now();
+        for (i = 0; i < frames->count; i++) {
+            poporon_encode(pprn, &frames->data[i * frames->data_size], frames->data_size,
+                           &frames->parity[i * frames->parity_size]);
+        }
+        elapsed += bench_now() - start;
+    }
+
+    return elapsed;
+}
+
+static double frames_decode(poporon_t *pprn, frames_t *frames, size_t *failures)
+{
+    double start, elapsed = 0.0;
+    size_t r, i;
+
+    *failures = 0;
+
+    for (r = 0; r < REPEAT; r++) {
+        memcpy(frames->data, frames->received, frames->count * frames->data_size);
+
+        start = bench_now();
+        for (i = 0; i < frames->count; i++) {
+            if (!poporon_decode(pprn, &frames->data[i * frames->data_size], frames->data_size,
+                                &frames->parity[i * frames->parity_size], NULL)) {
+                (*failures)++;
+            }
+        }
+        elapsed += bench_now() - start;
+    }
+
+    return elapsed;
+}
+
+/* verify only, the received copy is never written */
+static double frames_check(poporon_t *pprn, frames_t *frames, size_t *failures)
+{
+    double start, elapsed;
+    size_t r, i;
+
+    *failures = 0;
+
+    start = bench_now();
+    for (r = 0; r < REPEAT; r++) {
+        for (i = 0; i < frames->count; i++) {
+            if (!poporon_check(pprn, &frames->received[i * frames->data_size], frames->data_size,
+                               &frames->parity[i * frames->parity_size])) {
+                (*failures)++;
+            }
+        }
+    }
+    elapsed = bench_now() - start;
+
+    return elapsed;
+}
+
+static void report(const char *name, frames_t *frames, double seconds, size_t failures)
+{
+    size_t codewords = frames->count * REPEAT;
+
+    printf("  %-40s %10.2f Mcw/s %9.1f MB/s", name, seconds > 0.0 ? (double)codewords / seconds / 1e6 : 0.0,
+           bench_mbps(codewords * frames->data_size, seconds));
+    if (failures) {
+        printf("  (%zu failed)", failures);
+    }
+    printf("\n");
+}
+
+static bool bench_rs(poporon_simd_level_t level, const char *level_name)
+{
+    poporon_config_t *config, *ribm_config, *remainder_config, *erasure_config;
+    poporon_erasure_t *erasure;
+    poporon_t *pprn, *ribm_pprn, *remainder_pprn, *erasure_pprn;
+    frames_t clean, few, errors, erasures;
+    char name[64];
+    double seconds;
+    size_t failures, i;
+    bool ok;
+
+    if (!poporon_simd_set_level(level)) {
+        return true;
+    }
+
+    config = poporon_config_rs_default();
+    ribm_config = poporon_config_rs_default();
+    remainder_config = poporon_config_rs_default();
+    erasure = poporon_erasure_create(RS_PARITY, RS_ERASURES);
+    erasure_config = poporon_rs_config_create(8, 0x11D, 1, 1, RS_PARITY, erasure, NULL);
+    poporon_rs_config_set_decode_mode(ribm_config, PPRN_RS_DECODE_RIBM);
+    poporon_rs_config_set_syndrome_mode(remainder_config, PPRN_RS_SYNDROME_REMAINDER);
+    pprn = poporon_create(config);
+    ribm_pprn = poporon_create(ribm_config);
+    remainder_pprn = poporon_create(remainder_config);
+    erasure_pprn = poporon_create(erasure_config);
+    ok = pprn && ribm_pprn && remainder_pprn && erasure_pprn;
+
+    for (i = 0; ok && i < RS_ERASURES; i++) {
+        ok = poporon_erasure_add_position(erasure, (uint32_t)(i * 4));
+    }
+
+    ok = ok && frames_alloc(&clean, RS_FRAMES, RS_DATA, RS_PARITY) && frames_build(&clean, pprn, corrupt_none);
+    ok = ok && frames_alloc(&few, RS_FRAMES, RS_DATA, RS_PARITY) && frames_build(&few, pprn, corrupt_rs_few_errors);
+    ok = ok && frames_alloc(&errors, RS_FRAMES, RS_DATA, RS_PARITY) && frames_build(&errors, pprn, corrupt_rs_errors);
+    ok = ok && frames_alloc(&erasures, RS_FRAMES, RS_DATA, RS_PARITY) &&
+         frames_build(&erasures, erasure_pprn, corrupt_rs_erasures);
+
+    if (ok) {
+        printf("RS(255,223), %s kernels\n", level_name);
+        seconds = frames_encode(pprn, &clean);
+        report("encode", &clean, seconds, 0);
+        seconds = frames_decode(pprn, &clean, &failures);
+        report("decode, clean", &clean, seconds, failures);
+        seconds = frames_decode(remainder_pprn, &clean, &failures);
+        report("decode, clean, remainder", &clean, seconds, failures);
+        seconds = frames_check(pprn, &clean, &failures);
+        report("check, clean", &clean, seconds, failures);
+        seconds = frames_check(remainder_pprn, &clean, &failures);
+        report("check, clean, remainder", &clean, seconds, failures);
+        snprintf(name, sizeof(name), "decode, %d errors", RS_FEW);
+        seconds = frames_decode(pprn, &few, &failures);
+        report(name, &few, seconds, failures);
+        snprintf(name, sizeof(name), "decode, %d errors, remainder", RS_FEW);
+        seconds = frames_decode(remainder_pprn, &few, &failures);
+        report(name, &few, seconds, failures);
+        snprintf(name, sizeof(name), "decode, %d errors", RS_ERRORS);
+        seconds = frames_decode(pprn, &errors, &failures);
+        report(name, &errors, seconds, failures);
+        snprintf(name, sizeof(name), "decode, %d errors, riBM", RS_ERRORS);
+        seconds = frames_decode(ribm_pprn, &errors, &failures);
+        report(name, &errors, seconds, failures);
+        snprintf(name, sizeof(name), "decode, %d erasures", RS_ERASURES);
+        seconds = frames_decode(erasure_pprn, &erasures, &failures);
+        report(name, &erasures, seconds, failures);
+        printf("\n");
+
+        frames_free(&erasures);
+        frames_free(&errors);
+        frames_free(&few);
+        frames_free(&clean);
+    }
+
+    poporon_destroy(erasure_pprn);
+    poporon_destroy(remainder_pprn);
+    poporon_destroy(ribm_pprn);
+    poporon_destroy(pprn);
+    poporon_config_destroy(erasure_config);
+    poporon_config_destroy(remainder_config);
+    poporon_config_destroy(ribm_config);
+    poporon_config_destroy(config);
+    poporon_erasure_destroy(erasure);
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+
+    return ok;
+}
+
+static bool bench_bch(void)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+    frames_t clean, errors;
+    char name[64];
+    double seconds;
+    size_t failures;
+    bool ok;
+
+    config = poporon_bch_config_create(5, 0x25, BCH_ERRORS);
+    pprn = poporon_create(config);
+    ok = pprn != NULL;
+
+    ok = ok && frames_alloc(&clean, BCH_FRAMES, 2, 2) && frames_build(&clean, pprn, corrupt_none);
+    ok = ok && frames_alloc(&errors, BCH_FRAMES, 2, 2) && frames_build(&errors, pprn, corrupt_bch_errors);
+
+    if (ok) {
+        printf("BCH(31,16) t=%d\n", BCH_ERRORS);
+        seconds = frames_encode(pprn, &clean);
+        report("encode", &clean, seconds, 0);
+        seconds = frames_decode(pprn, &clean, &failures);
+        report("decode, clean", &clean, seconds, failures);
+        seconds = frames_check(pprn, &clean, &failures);
+        report("check, clean", &clean, seconds, failures);
+        snprintf(name, sizeof(name), "decode, %d bit errors", BCH_ERRORS);
+        seconds = frames_decode(pprn, &errors, &failures);
+        report(name, &errors, seconds, failures);
+
+        frames_free(&errors);
+        frames_free(&clean);
+    }
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+
+    return ok;
+}
+
+int main(void)
+{
+    /* the scalar kernels are where table lookups dominate, the vector tier shows what callers get by default */
+    if (!bench_rs(PPRN_SIMD_SCALAR, "scalar") || !bench_rs(PPRN_SIMD_AUTO, "default") || !bench_bch()) {
+        fprintf(stderr, "benchmark setup failed\n");
+        return 1;
+    }
+
+    return 0;
+}
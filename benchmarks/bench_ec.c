@@ -0,0 +1,199 @@
+/*
+ * libpoporon - bench_ec.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdbool.h>
+
+#include <poporon.h>
+
+#include "bench.h"
+
+#define SHARD_SIZE       (4 * 1024 * 1024)
+#define REPEAT           8
+#define SMALL_SHARD_SIZE (4 * 1024)
+#define SMALL_STRIPES    4096
+
+typedef struct {
+    uint16_t data_shards;
+    uint16_t parity_shards;
+} layout_t;
+
+static const layout_t layouts[] = {{10, 4}, {6, 3}};
+
+/* throughput counts the data bytes a stripe protects, the same for every operation of one layout */
+static void report(const char *name, const layout_t *layout, double seconds)
+{
+    printf("  %-40s %9.1f MB/s\n", name, bench_mbps((size_t)REPEAT * layout->data_shards * SHARD_SIZE, seconds));
+}
+
+static double run_reconstruct(poporon_ec_t *ec, uint8_t *const *shards, bool *present, uint16_t total, uint16_t lost)
+{
+    double start;
+    size_t r;
+    uint16_t i;
+
+    for (i = 0; i < total; i++) {
+        present[i] = i >= lost;
+    }
+
+    start = bench_now();
+    for (r = 0; r < REPEAT; r++) {
+        poporon_ec_reconstruct(ec, shards, present, SHARD_SIZE);
+    }
+
+    return bench_now() - start;
+}
+
+static bool bench_ec(const layout_t *layout, poporon_ec_matrix_t matrix, const char *matrix_name,
+                     const char *level_name)
+{
+    poporon_ec_t *ec;
+    uint8_t *shards[POPORON_EC_MAX_SHARDS];
+    bool present[POPORON_EC_MAX_SHARDS];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint16_t total, i;
+    double start;
+    char name[64];
+    size_t r;
+    bool ok;
+
+    total = (uint16_t)(layout->data_shards + layout->parity_shards);
+    ec = poporon_ec_create(layout->data_shards, layout->parity_shards, matrix);
+    ok = ec != NULL;
+
+    for (i = 0; i < total; i++) {
+        shards[i] = (uint8_t *)malloc(SHARD_SIZE);
+        ok = ok && shards[i];
+    }
+
+    if (ok) {
+        /* parity is written once up front so that page faults stay out of the timings */
+        for (i = 0; i < total; i++) {
+            bench_fill(shards[i], SHARD_SIZE, &state);
+        }
+
+        printf("%u+%u shards of %d MiB, %s, %s kernels\n", layout->data_shards, layout->parity_shards,
+               SHARD_SIZE / (1024 * 1024), matrix_name, level_name);
+
+        start = bench_now();
+        for (r = 0; r < REPEAT; r++) {
+            poporon_ec_encode(ec, (const uint8_t *const *)shards, &shards[layout->data_shards], SHARD_SIZE);
+        }
+        report("encode", layout, bench_now() - start);
+
+        report("reconstruct, 1 data shard lost", layout, run_reconstruct(ec, shards, present, total, 1));
+        snprintf(name, sizeof(name), "reconstruct, %u data shards lost", layout->parity_shards);
+        report(name, layout, run_reconstruct(ec, shards, present, total, layout->parity_shards));
+        printf("\n");
+    }
+
+    for (i = 0; i < total; i++) {
+        free(shards[i]);
+    }
+    poporon_ec_destroy(ec);
+
+    return ok;
+}
+
+/* many small stripes failing alike, where building the plan of a pattern would cost as much as applying it */
+static double run_small(poporon_ec_t *ec, uint8_t *const *shards, bool *present, uint16_t total, uint16_t lost)
+{
+    double start;
+    size_t r;
+    uint16_t i;
+
+    for (i = 0; i < total; i++) {
+        present[i] = i >= lost;
+    }
+
+    start = bench_now();
+    for (r = 0; r < SMALL_STRIPES; r++) {
+        poporon_ec_reconstruct(ec, shards, present, SMALL_SHARD_SIZE);
+    }
+
+    return bench_now() - start;
+}
+
+static bool bench_cache(const layout_t *layout, poporon_ec_matrix_t matrix, const char *matrix_name)
+{
+    poporon_ec_t *ec;
+    uint8_t *shards[POPORON_EC_MAX_SHARDS];
+    bool present[POPORON_EC_MAX_SHARDS];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint16_t total, i;
+    size_t bytes;
+    bool ok;
+
+    total = (uint16_t)(layout->data_shards + layout->parity_shards);
+    bytes = (size_t)SMALL_STRIPES * layout->data_shards * SMALL_SHARD_SIZE;
+    ec = poporon_ec_create(layout->data_shards, layout->parity_shards, matrix);
+    ok = ec != NULL;
+
+    for (i = 0; i < total; i++) {
+        shards[i] = (uint8_t *)malloc(SMALL_SHARD_SIZE);
+        ok = ok && shards[i];
+    }
+
+    if (ok) {
+        for (i = 0; i < total; i++) {
+            bench_fill(shards[i], SMALL_SHARD_SIZE, &state);
+        }
+
+        printf("%u+%u shards of %d KiB, %u data shards lost, %s\n", layout->data_shards, layout->parity_shards,
+               SMALL_SHARD_SIZE / 1024, layout->parity_shards, matrix_name);
+
+        poporon_ec_set_cache_capacity(ec, 0);
+        printf("  %-40s %9.1f MB/s\n", "reconstruct, uncached",
+               bench_mbps(bytes, run_small(ec, shards, present, total, layout->parity_shards)));
+        poporon_ec_set_cache_capacity(ec, POPORON_EC_CACHE_CAPACITY);
+        printf("  %-40s %9.1f MB/s\n", "reconstruct, cached",
+               bench_mbps(bytes, run_small(ec, shards, present, total, layout->parity_shards)));
+        printf("\n");
+    }
+
+    for (i = 0; i < total; i++) {
+        free(shards[i]);
+    }
+    poporon_ec_destroy(ec);
+
+    return ok;
+}
+
+/* the XOR code never touches the SIMD kernels, the scalar tier shows what it competes with on cores without PSHUFB */
+static bool bench_level(poporon_simd_level_t level, const char *level_name)
+{
+    size_t l;
+    bool ok;
+
+    if (!poporon_simd_set_level(level)) {
+        return true;
+    }
+
+    ok = true;
+    for (l = 0; ok && l < sizeof(layouts) / sizeof(layouts[0]); l++) {
+        ok = bench_ec(&layouts[l], PPRN_EC_VANDERMONDE, "Vandermonde", level_name) &&
+             bench_ec(&layouts[l], PPRN_EC_CAUCHY, "Cauchy", level_name) &&
+             bench_ec(&layouts[l], PPRN_EC_CAUCHY_XOR, "Cauchy bit matrix XOR", level_name);
+    }
+
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+
+    return ok;
+}
+
+int main(void)
+{
+    if (!bench_level(PPRN_SIMD_SCALAR, "scalar") || !bench_level(PPRN_SIMD_AUTO, "default") ||
+        !bench_cache(&layouts[0], PPRN_EC_CAUCHY, "Cauchy") ||
+        !bench_cache(&layouts[0], PPRN_EC_CAUCHY_XOR, "Cauchy bit matrix XOR")) {
+        fprintf(stderr, "benchmark setup failed\n");
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * libpoporon - bench_fft.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdbool.h>
+
+#include <poporon.h>
+
+#include "bench.h"
+
+#define TOTAL_BYTES (64 * 1024 * 1024) /* data bytes coded per measurement whatever the layout */
+
+typedef struct {
+    uint8_t symbol_size;
+    uint16_t data_shards;
+    uint16_t parity_shards;
+    size_t shard_size;
+} layout_t;
+
+/* the matrix code's range first, then packet sized shards spread wide */
+static const layout_t layouts[] = {
+    {8, 10, 4, 64 * 1024}, {8, 128, 64, 16 * 1024}, {16, 1000, 200, 1024}, {16, 4000, 1000, 1024},
+    {16, 32000, 8000, 1024},
+};
+
+typedef struct {
+    const layout_t *layout;
+    poporon_fft_t *fft;
+    poporon_ec_t *ec; /* the same layout on poporon_ec_t, when it fits */
+    uint8_t **shards;
+    bool *present;
+    uint32_t total;
+    size_t repeat;
+} stripe_t;
+
+static void report(const char *name, const stripe_t *stripe, double seconds)
+{
+    printf("  %-40s %9.1f MB/s\n", name,
+           bench_mbps(stripe->repeat * stripe->layout->data_shards * stripe->layout->shard_size, seconds));
+}
+
+static double run_encode(const stripe_t *stripe, bool matrix)
+{
+    const layout_t *layout;
+    double start;
+    size_t r;
+
+    layout = stripe->layout;
+    start = bench_now();
+    for (r = 0; r < stripe->repeat; r++) {
+        if (matrix) {
+            poporon_ec_encode(stripe->ec, (const uint8_t *const *)stripe->shards, &stripe->shards[layout->data_shards],
+                              layout->shard_size);
+        } else {
+            poporon_fft_encode(stripe->fft, (const uint8_t *const *)stripe->shards,
+                               &stripe->shards[layout->data_shards], layout->shard_size);
+        }
+    }
+
+    return bench_now() - start;
+}
+
+/* every parity shard's worth of data shards lost, spread over the stripe */
+static double run_reconstruct(const stripe_t *stripe, bool matrix)
+{
+    const layout_t *layout;
+    double start;
+    uint32_t i;
+    size_t r;
+
+    layout = stripe->layout;
+    for (i = 0; i < stripe->total; i++) {
+        stripe->present[i] = i >= layout->data_shards || i % (layout->data_shards / layout->parity_shards + 1) != 0;
+    }
+
+    start = bench_now();
+    for (r = 0; r < stripe->repeat; r++) {
+        if (matrix) {
+            poporon_ec_reconstruct(stripe->ec, stripe->shards, stripe->present, layout->shard_size);
+        } else {
+            poporon_fft_reconstruct(stripe->fft, stripe->shards, stripe->present, layout->shard_size);
+        }
+    }
+
+    return bench_now() - start;
+}
+
+static bool bench_layout(const layout_t *layout)
+{
+    stripe_t stripe;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint32_t i;
+    bool ok;
+
+    memset(&stripe, 0, sizeof(stripe));
+    stripe.layout = layout;
+    stripe.total = (uint32_t)layout->data_shards + layout->parity_shards;
+    stripe.repeat = TOTAL_BYTES / ((size_t)layout->data_shards * layout->shard_size);
+    stripe.repeat = stripe.repeat > 0 ? stripe.repeat : 1;
+    stripe.fft = poporon_fft_create(layout->symbol_size, layout->data_shards, layout->parity_shards);
+    if (layout->symbol_size == 8 && stripe.total <= POPORON_EC_MAX_SHARDS) {
+        stripe.ec = poporon_ec_create(layout->data_shards, layout->parity_shards, PPRN_EC_CAUCHY);
+    }
+    stripe.shards = (uint8_t **)calloc(stripe.total, sizeof(uint8_t *));
+    stripe.present = (bool *)calloc(stripe.total, sizeof(bool));
+    ok = stripe.fft && stripe.shards && stripe.present;
+
+    for (i = 0; ok && i < stripe.total; i++) {
+        stripe.shards[i] = (uint8_t *)malloc(layout->shard_size);
+        ok = stripe.shards[i] != NULL;
+        if (ok) {
+            bench_fill(stripe.shards[i], layout->shard_size, &state);
+        }
+    }
+
+    if (ok) {
+        printf("%u+%u shards of %zu KiB, GF(2^%u)\n", layout->data_shards, layout->parity_shards,
+               layout->shard_size / 1024, layout->symbol_size);
+
+        report("additive FFT encode", &stripe, run_encode(&stripe, false));
+        report("additive FFT reconstruct", &stripe, run_reconstruct(&stripe, false));
+        if (stripe.ec) {
+            report("Cauchy matrix encode", &stripe, run_encode(&stripe, true));
+            report("Cauchy matrix reconstruct", &stripe, run_reconstruct(&stripe, true));
+        }
+        printf("\n");
+    }
+
+    for (i = 0; stripe.shards && i < stripe.total; i++) {
+        free(stripe.shards[i]);
+    }
+    free(stripe.shards);
+    free(stripe.present);
+    poporon_ec_destroy(stripe.ec);
+    poporon_fft_destroy(stripe.fft);
+
+    return ok;
+}
+
+int main(void)
+{
+    size_t l;
+
+    for (l = 0; l < sizeof(layouts) / sizeof(layouts[0]); l++) {
+        if (!bench_layout(&layouts[l])) {
+            fprintf(stderr, "benchmark setup failed\n");
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,144 @@
+/*
+ * libpoporon - bench_gf.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdbool.h>
+
+#include <poporon.h>
+#include <poporon/gf.h>
+
+#include "bench.h"
+
+#define REGION_SIZE   (64 * 1024)
+#define REGION_PASSES 256
+#define DOT_SOURCES   10
+
+static void report(const char *name, size_t bytes, double seconds)
+{
+    printf("  %-40s %9.1f MB/s\n", name, bench_mbps(bytes, seconds));
+}
+
+/* the same regions read as uint16_t symbols of GF(2^16) */
+static bool bench_gf16(uint8_t *src, uint8_t *dst, const char *level_name)
+{
+    poporon_gf_t *gf;
+    double start;
+    size_t pass;
+
+    gf = poporon_gf_create(16, 0x100B);
+    if (!gf) {
+        return false;
+    }
+
+    printf("GF(2^16) regions of %d KiB, %s kernels\n", REGION_SIZE / 1024, level_name);
+
+    start = bench_now();
+    for (pass = 0; pass < REGION_PASSES; pass++) {
+        poporon_gf_mul_region_u16(gf, (uint16_t)(pass * 7919 + 3), (const uint16_t *)src, (uint16_t *)dst,
+                                  REGION_SIZE / sizeof(uint16_t));
+    }
+    report("mul", (size_t)REGION_PASSES * REGION_SIZE, bench_now() - start);
+
+    start = bench_now();
+    for (pass = 0; pass < REGION_PASSES; pass++) {
+        poporon_gf_muladd_region_u16(gf, (uint16_t)(pass * 7919 + 3), (const uint16_t *)src, (uint16_t *)dst,
+                                     REGION_SIZE / sizeof(uint16_t));
+    }
+    report("muladd", (size_t)REGION_PASSES * REGION_SIZE, bench_now() - start);
+    printf("\n");
+
+    poporon_gf_destroy(gf);
+
+    return true;
+}
+
+static bool bench_gf(poporon_simd_level_t level, const char *level_name)
+{
+    poporon_gf_t *gf;
+    uint8_t *sources[DOT_SOURCES], *dst, coefficients[DOT_SOURCES];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    double start;
+    size_t pass, k;
+    bool ok;
+
+    if (!poporon_simd_set_level(level)) {
+        return true;
+    }
+
+    gf = poporon_gf_create(8, 0x11D);
+    dst = (uint8_t *)malloc(REGION_SIZE);
+    ok = gf && dst;
+
+    for (k = 0; k < DOT_SOURCES; k++) {
+        sources[k] = (uint8_t *)malloc(REGION_SIZE);
+        ok = ok && sources[k];
+        coefficients[k] = (uint8_t)(k * 29 + 3);
+    }
+
+    if (ok) {
+        for (k = 0; k < DOT_SOURCES; k++) {
+            bench_fill(sources[k], REGION_SIZE, &state);
+        }
+
+        printf("GF(2^8) regions of %d KiB, %s kernels\n", REGION_SIZE / 1024, level_name);
+
+        start = bench_now();
+        for (pass = 0; pass < REGION_PASSES; pass++) {
+            poporon_gf_mul_region(gf, coefficients[pass % DOT_SOURCES], sources[0], dst, REGION_SIZE);
+        }
+        report("mul", (size_t)REGION_PASSES * REGION_SIZE, bench_now() - start);
+
+        start = bench_now();
+        for (pass = 0; pass < REGION_PASSES; pass++) {
+            poporon_gf_muladd_region(gf, coefficients[pass % DOT_SOURCES], sources[0], dst, REGION_SIZE);
+        }
+        report("muladd", (size_t)REGION_PASSES * REGION_SIZE, bench_now() - start);
+
+        /* input bytes consumed, so the two ways of forming the same combination compare directly */
+        start = bench_now();
+        for (pass = 0; pass < REGION_PASSES / DOT_SOURCES; pass++) {
+            poporon_gf_mul_region(gf, coefficients[0], sources[0], dst, REGION_SIZE);
+            for (k = 1; k < DOT_SOURCES; k++) {
+                poporon_gf_muladd_region(gf, coefficients[k], sources[k], dst, REGION_SIZE);
+            }
+        }
+        report("10 sources, mul + muladd chain", (size_t)(REGION_PASSES / DOT_SOURCES) * DOT_SOURCES * REGION_SIZE,
+               bench_now() - start);
+
+        start = bench_now();
+        for (pass = 0; pass < REGION_PASSES / DOT_SOURCES; pass++) {
+            poporon_gf_dot_region(gf, coefficients, (const uint8_t *const *)sources, DOT_SOURCES, dst, REGION_SIZE);
+        }
+        report("10 sources, dot", (size_t)(REGION_PASSES / DOT_SOURCES) * DOT_SOURCES * REGION_SIZE,
+               bench_now() - start);
+        printf("\n");
+    }
+
+    if (ok) {
+        ok = bench_gf16(sources[0], dst, level_name);
+    }
+
+    for (k = 0; k < DOT_SOURCES; k++) {
+        free(sources[k]);
+    }
+    free(dst);
+    poporon_gf_destroy(gf);
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+
+    return ok;
+}
+
+int main(void)
+{
+    if (!bench_gf(PPRN_SIMD_SCALAR, "scalar") || !bench_gf(PPRN_SIMD_AUTO, "default")) {
+        fprintf(stderr, "benchmark setup failed\n");
+        return 1;
+    }
+
+    return 0;
+}
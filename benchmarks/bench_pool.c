@@ -0,0 +1,209 @@
+/*
+ * libpoporon - bench_pool.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdbool.h>
+
+#include <poporon.h>
+
+#include "bench.h"
+
+#define RS_FRAMES     4096
+#define RS_DATA       223
+#define RS_PARITY     32
+#define RS_ERRORS     8
+#define LDPC_FRAMES   64
+#define LDPC_BLOCK    256
+#define LDPC_FLIP_PCT 8
+#define REPEAT        8
+
+typedef struct {
+    poporon_pool_job_t *jobs;
+    uint8_t *data;
+    uint8_t *received;
+    uint8_t *parity;
+    size_t count;
+    size_t stride;
+    size_t bytes;
+} workload_t;
+
+static bool workload_alloc(workload_t *workload, size_t count, size_t data_size, size_t parity_size)
+{
+    workload->jobs = (poporon_pool_job_t *)calloc(count, sizeof(poporon_pool_job_t));
+    workload->data = (uint8_t *)malloc(count * data_size);
+    workload->received = (uint8_t *)malloc(count * data_size);
+    workload->parity = (uint8_t *)malloc(count * parity_size);
+    workload->count = count;
+    workload->stride = data_size;
+    workload->bytes = 0;
+
+    return workload->jobs && workload->data && workload->received && workload->parity;
+}
+
+static void workload_free(workload_t *workload)
+{
+    free(workload->jobs);
+    free(workload->data);
+    free(workload->received);
+    free(workload->parity);
+}
+
+/* RS frames with RS_ERRORS corrupted bytes each, plus optionally LDPC frames up front that run to max iterations */
+static bool workload_build(workload_t *workload, poporon_t *rs, poporon_t *ldpc, size_t ldpc_frames)
+{
+    size_t ldpc_parity, data_size, parity_size, i, j;
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    uint8_t *data, *parity;
+
+    ldpc_parity = ldpc ? poporon_get_parity_size(ldpc) : 0;
+    data_size = LDPC_BLOCK > RS_DATA ? LDPC_BLOCK : RS_DATA;
+    parity_size = ldpc_parity > RS_PARITY ? ldpc_parity : RS_PARITY;
+
+    if (!workload_alloc(workload, RS_FRAMES + ldpc_frames, data_size, parity_size)) {
+        return false;
+    }
+
+    for (i = 0; i < workload->count; i++) {
+        data = &workload->data[i * data_size];
+        parity = &workload->parity[i * parity_size];
+
+        if (i < ldpc_frames) {
+            workload->jobs[i].pprn = ldpc;
+            workload->jobs[i].size = LDPC_BLOCK;
+        } else {
+            workload->jobs[i].pprn = rs;
+            workload->jobs[i].size = RS_DATA;
+        }
+        workload->jobs[i].data = data;
+        workload->jobs[i].parity = parity;
+        workload->bytes += workload->jobs[i].size;
+
+        bench_fill(data, workload->jobs[i].size, &state);
+        if (!poporon_encode((poporon_t *)workload->jobs[i].pprn, data, workload->jobs[i].size, parity)) {
+            return false;
+        }
+
+        if (i < ldpc_frames) {
+            for (j = 0; j < LDPC_BLOCK * 8 * LDPC_FLIP_PCT / 100; j++) {
+                data[(state >> 3) % LDPC_BLOCK] ^= (uint8_t)(1 << (state & 7));
+                state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            }
+        } else {
+            for (j = 0; j < RS_ERRORS; j++) {
+                data[(j * RS_DATA) / RS_ERRORS] ^= 0x5A;
+            }
+        }
+    }
+
+    memcpy(workload->received, workload->data, workload->count * data_size);
+
+    return true;
+}
+
+static double workload_run(poporon_pool_t *pool, workload_t *workload)
+{
+    double start, elapsed = 0.0;
+    size_t r;
+
+    for (r = 0; r < REPEAT; r++) {
+        memcpy(workload->data, workload->received, workload->count * workload->stride);
+
+        start = bench_now();
+        poporon_pool_decode(pool, workload->jobs, workload->count);
+        elapsed += bench_now() - start;
+    }
+
+    return bench_mbps(workload->bytes * REPEAT, elapsed);
+}
+
+static void run_scaling(const char *name, workload_t *workload, size_t max_threads)
+{
+    poporon_pool_t *pool;
+    double base = 0.0, mbps;
+    size_t threads;
+
+    printf("%s: %zu frames\n", name, workload->count);
+    printf("  threads      MB/s   speedup  efficiency\n");
+
+    /* powers of two, then max_threads itself */
+    for (threads = 1;; threads *= 2) {
+        if (threads > max_threads) {
+            threads = max_threads;
+        }
+
+        pool = poporon_pool_create(threads);
+        if (!pool) {
+            fprintf(stderr, "poporon_pool_create(%zu) failed\n", threads);
+            return;
+        }
+
+        workload_run(pool, workload);
+        mbps = workload_run(pool, workload);
+        if (threads == 1) {
+            base = mbps;
+        }
+
+        printf("  %7zu  %8.1f  %7.2fx  %9.1f%%\n", poporon_pool_get_num_threads(pool), mbps, mbps / base,
+               100.0 * mbps / (base * (double)poporon_pool_get_num_threads(pool)));
+
+        poporon_pool_destroy(pool);
+
+        if (threads == max_threads) {
+            break;
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    poporon_config_t *rs_config, *ldpc_config;
+    poporon_t *rs, *ldpc;
+    poporon_pool_t *probe;
+    workload_t clean, mixed;
+    size_t max_threads;
+
+    probe = poporon_pool_create(0);
+    max_threads = poporon_pool_get_num_threads(probe);
+    poporon_pool_destroy(probe);
+
+    if (argc > 1) {
+        max_threads = (size_t)strtoul(argv[1], NULL, 10);
+    }
+
+    if (max_threads == 0) {
+        max_threads = 1;
+    }
+
+    rs_config = poporon_config_rs_default();
+    ldpc_config = poporon_config_ldpc_default(LDPC_BLOCK, PPRN_LDPC_RATE_1_2);
+    rs = poporon_create(rs_config);
+    ldpc = poporon_create(ldpc_config);
+    if (!rs || !ldpc) {
+        fprintf(stderr, "codec creation failed\n");
+        return 1;
+    }
+
+    if (!workload_build(&clean, rs, NULL, 0) || !workload_build(&mixed, rs, ldpc, LDPC_FRAMES)) {
+        fprintf(stderr, "workload setup failed\n");
+        return 1;
+    }
+
+    run_scaling("RS(255,223) decode, 8 errors per frame", &clean, max_threads);
+    printf("\n");
+    /* every slow LDPC frame sits at the front, so without stealing the first worker would serialize them */
+    run_scaling("LDPC 256B rate 1/2 at max iterations ahead of RS frames", &mixed, max_threads);
+
+    workload_free(&clean);
+    workload_free(&mixed);
+    poporon_destroy(ldpc);
+    poporon_destroy(rs);
+    poporon_config_destroy(ldpc_config);
+    poporon_config_destroy(rs_config);
+
+    return 0;
+}
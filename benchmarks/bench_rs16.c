@@ -0,0 +1,169 @@
+/*
+ * libpoporon - bench_rs16.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdbool.h>
+
+#include <poporon.h>
+
+#include "bench.h"
+
+#define RS16_POLYNOMIAL 0x100B /* x^16 + x^12 + x^3 + x + 1 */
+#define RS16_PARITY     32
+#define RS16_ERRORS     16
+#define TOTAL_SYMBOLS   (1 << 21)
+
+static const size_t codeword_sizes[] = {1024, 8192, 65535 - RS16_PARITY};
+
+typedef struct {
+    uint16_t *data;
+    uint16_t *received;
+    uint16_t *parity;
+    size_t count;
+    size_t size;
+} frames16_t;
+
+static bool frames16_build(frames16_t *frames, poporon_t *pprn, size_t size, size_t errors)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t i, e;
+
+    frames->size = size;
+    frames->count = (TOTAL_SYMBOLS + size - 1) / size;
+    frames->data = (uint16_t *)malloc(frames->count * size * sizeof(uint16_t));
+    frames->received = (uint16_t *)malloc(frames->count * size * sizeof(uint16_t));
+    frames->parity = (uint16_t *)malloc(frames->count * RS16_PARITY * sizeof(uint16_t));
+    if (!frames->data || !frames->received || !frames->parity) {
+        return false;
+    }
+
+    bench_fill((uint8_t *)frames->data, frames->count * size * sizeof(uint16_t), &state);
+
+    for (i = 0; i < frames->count; i++) {
+        if (!poporon_encode_u16(pprn, &frames->data[i * size], size, &frames->parity[i * RS16_PARITY])) {
+            return false;
+        }
+
+        for (e = 0; e < errors; e++) {
+            frames->data[i * size + (e * size) / errors] ^= 0x5A5A;
+        }
+    }
+
+    memcpy(frames->received, frames->data, frames->count * size * sizeof(uint16_t));
+
+    return true;
+}
+
+static void frames16_free(frames16_t *frames)
+{
+    free(frames->data);
+    free(frames->received);
+    free(frames->parity);
+}
+
+static double frames16_encode(poporon_t *pprn, frames16_t *frames)
+{
+    double start;
+    size_t i;
+
+    start = bench_now();
+    for (i = 0; i < frames->count; i++) {
+        poporon_encode_u16(pprn, &frames->data[i * frames->size], frames->size, &frames->parity[i * RS16_PARITY]);
+    }
+
+    return bench_now() - start;
+}
+
+static double frames16_decode(poporon_t *pprn, frames16_t *frames, size_t *failures)
+{
+    double start;
+    size_t i;
+
+    *failures = 0;
+    memcpy(frames->data, frames->received, frames->count * frames->size * sizeof(uint16_t));
+
+    start = bench_now();
+    for (i = 0; i < frames->count; i++) {
+        if (!poporon_decode_u16(pprn, &frames->data[i * frames->size], frames->size,
+                                &frames->parity[i * RS16_PARITY], NULL)) {
+            (*failures)++;
+        }
+    }
+
+    return bench_now() - start;
+}
+
+static void report(const char *name, frames16_t *frames, double seconds, size_t failures)
+{
+    printf("  %-40s %9.1f MB/s", name, bench_mbps(frames->count * frames->size * sizeof(uint16_t), seconds));
+    if (failures) {
+        printf("  (%zu failed)", failures);
+    }
+    printf("\n");
+}
+
+static bool bench_rs16(poporon_simd_level_t level, const char *level_name)
+{
+    poporon_config_t *config, *remainder_config;
+    poporon_t *pprn, *remainder_pprn;
+    frames16_t clean, errors;
+    char name[64];
+    size_t s, failures;
+    bool ok;
+
+    if (!poporon_simd_set_level(level)) {
+        return true;
+    }
+
+    config = poporon_rs_config_create(16, RS16_POLYNOMIAL, 1, 1, RS16_PARITY, NULL, NULL);
+    remainder_config = poporon_rs_config_create(16, RS16_POLYNOMIAL, 1, 1, RS16_PARITY, NULL, NULL);
+    poporon_rs_config_set_syndrome_mode(remainder_config, PPRN_RS_SYNDROME_REMAINDER);
+    pprn = poporon_create(config);
+    remainder_pprn = poporon_create(remainder_config);
+    ok = pprn && remainder_pprn;
+
+    for (s = 0; ok && s < sizeof(codeword_sizes) / sizeof(codeword_sizes[0]); s++) {
+        memset(&clean, 0, sizeof(clean));
+        memset(&errors, 0, sizeof(errors));
+        ok = frames16_build(&clean, pprn, codeword_sizes[s], 0) &&
+             frames16_build(&errors, pprn, codeword_sizes[s], RS16_ERRORS);
+
+        if (ok) {
+            printf("RS(%zu,%zu) over GF(2^16), %s kernels\n", codeword_sizes[s] + RS16_PARITY, codeword_sizes[s],
+                   level_name);
+            report("encode", &clean, frames16_encode(pprn, &clean), 0);
+            report("decode, clean", &clean, frames16_decode(pprn, &clean, &failures), failures);
+            report("decode, clean, remainder", &clean, frames16_decode(remainder_pprn, &clean, &failures), failures);
+            snprintf(name, sizeof(name), "decode, %d errors", RS16_ERRORS);
+            report(name, &errors, frames16_decode(pprn, &errors, &failures), failures);
+            printf("\n");
+        }
+
+        frames16_free(&errors);
+        frames16_free(&clean);
+    }
+
+    poporon_destroy(remainder_pprn);
+    poporon_destroy(pprn);
+    poporon_config_destroy(remainder_config);
+    poporon_config_destroy(config);
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+
+    return ok;
+}
+
+int main(void)
+{
+    /* split tables keep the working set in L1, the scalar tier shows the table walk, the vector tier PSHUFB */
+    if (!bench_rs16(PPRN_SIMD_SCALAR, "scalar") || !bench_rs16(PPRN_SIMD_AUTO, "default")) {
+        fprintf(stderr, "benchmark setup failed\n");
+        return 1;
+    }
+
+    return 0;
+}
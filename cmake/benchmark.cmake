@@ -0,0 +1,18 @@
+# libpoporon benchmark
+
+file(MAKE_DIRECTORY ${CMAKE_BINARY_DIR}/benchmarks)
+
+file(GLOB BENCHMARK_SOURCES "benchmarks/bench_*.c")
+
+foreach(BENCHMARK_SOURCE ${BENCHMARK_SOURCES})
+  get_filename_component(BENCHMARK_NAME ${BENCHMARK_SOURCE} NAME_WE)
+  set(BENCHMARK_NAME "poporon_${BENCHMARK_NAME}")
+
+  add_executable(${BENCHMARK_NAME} ${BENCHMARK_SOURCE})
+  target_link_libraries(${BENCHMARK_NAME} PRIVATE poporon)
+  target_include_directories(${BENCHMARK_NAME} PRIVATE ${CMAKE_SOURCE_DIR}/include)
+
+  set_target_properties(${BENCHMARK_NAME} PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}/benchmarks
+  )
+endforeach()
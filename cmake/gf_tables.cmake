@@ -0,0 +1,131 @@
+# libpoporon static GF(2^8) tables
+#
+# Script mode generator, run at build time as
+#   cmake -DOUTPUT=<header> -DPOLYNOMIALS=<0x11D,0x187,...> -P gf_tables.cmake
+# and emits the same log2exp / exp2log / exp_table / nibble tables poporon_gf_create() would build at runtime.
+
+if(NOT OUTPUT OR NOT POLYNOMIALS)
+  message(FATAL_ERROR "gf_tables.cmake: OUTPUT and POLYNOMIALS are required")
+endif()
+
+string(REPLACE "," ";" POLYNOMIALS "${POLYNOMIALS}")
+
+# comma separated values, 16 per row
+function(gf_tables_format OUT_VAR VALUES)
+  set(TEXT "")
+  set(ROW "")
+  set(COLUMN 0)
+  foreach(VALUE ${VALUES})
+    string(APPEND ROW " ${VALUE},")
+    math(EXPR COLUMN "${COLUMN} + 1")
+    if(COLUMN EQUAL 16)
+      string(APPEND TEXT "   ${ROW}\n")
+      set(ROW "")
+      set(COLUMN 0)
+    endif()
+  endforeach()
+  if(NOT ROW STREQUAL "")
+    string(APPEND TEXT "   ${ROW}\n")
+  endif()
+  set(${OUT_VAR} "${TEXT}" PARENT_SCOPE)
+endfunction()
+
+set(HEADER "/*\n * libpoporon - gf_tables.h\n *\n * Generated by cmake/gf_tables.cmake, do not edit.\n */\n\n")
+string(APPEND HEADER "#ifndef POPORON_GENERATED_GF_TABLES_H\n#define POPORON_GENERATED_GF_TABLES_H\n\n")
+
+set(FIELDS "")
+set(FIELD_COUNT 0)
+
+foreach(POLYNOMIAL ${POLYNOMIALS})
+  math(EXPR POLYNOMIAL "${POLYNOMIAL}" OUTPUT_FORMAT HEXADECIMAL)
+  string(TOUPPER "${POLYNOMIAL}" NAME)
+  string(REGEX REPLACE "^0X" "" NAME "${NAME}")
+  string(TOLOWER "${NAME}" NAME)
+  string(TOUPPER "${NAME}" NAME_UPPER)
+
+  math(EXPR HIGH_BIT "${POLYNOMIAL} >> 8")
+  if(NOT HIGH_BIT EQUAL 1)
+    message(FATAL_ERROR "gf_tables.cmake: ${POLYNOMIAL} is not a degree 8 polynomial")
+  endif()
+
+  # same walk as poporon_gf_create(): EXP_<log> is the element, LOG_<element> its logarithm
+  set(LOG_0 255)
+  set(EXP_255 0)
+  set(ELEMENT 1)
+  foreach(I RANGE 0 254)
+    if(DEFINED LOG_${ELEMENT})
+      message(FATAL_ERROR "gf_tables.cmake: ${POLYNOMIAL} is not primitive")
+    endif()
+    set(EXP_${I} ${ELEMENT})
+    set(LOG_${ELEMENT} ${I})
+    math(EXPR ELEMENT "${ELEMENT} << 1")
+    if(ELEMENT GREATER 255)
+      math(EXPR ELEMENT "(${ELEMENT} ^ ${POLYNOMIAL}) & 255")
+    endif()
+  endforeach()
+
+  set(LOG2EXP "")
+  set(EXP2LOG "")
+  foreach(I RANGE 0 255)
+    list(APPEND LOG2EXP ${EXP_${I}})
+    list(APPEND EXP2LOG ${LOG_${I}})
+  endforeach()
+
+  # GF_EXP_PERIODS (3) repetitions of the cycle, indexed by unreduced log sums
+  set(EXP_TABLE "")
+  foreach(PERIOD RANGE 1 3)
+    foreach(I RANGE 0 254)
+      list(APPEND EXP_TABLE ${EXP_${I}})
+    endforeach()
+  endforeach()
+
+  # per multiplier: products with the 16 low nibbles, then with the 16 high nibbles
+  set(NIBBLE "")
+  foreach(MULTIPLIER RANGE 0 255)
+    foreach(SHIFT 0 4)
+      foreach(I RANGE 0 15)
+        math(EXPR VALUE "${I} << ${SHIFT}")
+        if(MULTIPLIER EQUAL 0 OR VALUE EQUAL 0)
+          list(APPEND NIBBLE 0)
+        else()
+          math(EXPR LOG "(${LOG_${MULTIPLIER}} + ${LOG_${VALUE}}) % 255")
+          list(APPEND NIBBLE ${EXP_${LOG}})
+        endif()
+      endforeach()
+    endforeach()
+  endforeach()
+
+  foreach(I RANGE 0 255)
+    unset(LOG_${I})
+    unset(EXP_${I})
+  endforeach()
+
+  gf_tables_format(LOG2EXP_TEXT "${LOG2EXP}")
+  gf_tables_format(EXP2LOG_TEXT "${EXP2LOG}")
+  gf_tables_format(EXP_TABLE_TEXT "${EXP_TABLE}")
+  gf_tables_format(NIBBLE_TEXT "${NIBBLE}")
+
+  string(APPEND HEADER "static const uint16_t gf_table_${NAME}_log2exp[256] = {\n${LOG2EXP_TEXT}};\n\n")
+  string(APPEND HEADER "static const uint16_t gf_table_${NAME}_exp2log[256] = {\n${EXP2LOG_TEXT}};\n\n")
+  string(APPEND HEADER "static const uint16_t gf_table_${NAME}_exp[GF_EXP_PERIODS * 255] = {\n${EXP_TABLE_TEXT}};\n\n")
+  string(APPEND HEADER "static const uint8_t gf_table_${NAME}_nibble[256 * GF_NIBBLE_TABLE_SIZE] = {\n${NIBBLE_TEXT}};\n\n")
+
+  string(APPEND FIELDS "    {\n")
+  string(APPEND FIELDS "        .symbol_size = 8,\n")
+  string(APPEND FIELDS "        .field_size = 255,\n")
+  string(APPEND FIELDS "        .log2exp = gf_table_${NAME}_log2exp,\n")
+  string(APPEND FIELDS "        .exp2log = gf_table_${NAME}_exp2log,\n")
+  string(APPEND FIELDS "        .exp_table = gf_table_${NAME}_exp,\n")
+  string(APPEND FIELDS "        .nibble_tables = gf_table_${NAME}_nibble,\n")
+  string(APPEND FIELDS "        .generator_polynomial = 0x${NAME_UPPER},\n")
+  string(APPEND FIELDS "        .is_static = true,\n")
+  string(APPEND FIELDS "    },\n")
+  math(EXPR FIELD_COUNT "${FIELD_COUNT} + 1")
+endforeach()
+
+string(APPEND HEADER "#define GF_STATIC_FIELDS ${FIELD_COUNT}\n\n")
+string(APPEND HEADER "static const poporon_gf_t gf_static_fields[GF_STATIC_FIELDS] = {\n${FIELDS}};\n\n")
+string(APPEND HEADER "#endif /* POPORON_GENERATED_GF_TABLES_H */\n")
+
+# only touch the header when the tables change, so that gf.c is not rebuilt needlessly
+file(CONFIGURE OUTPUT "${OUTPUT}" CONTENT "${HEADER}" @ONLY)
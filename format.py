@@ -16,7 +16,7 @@ LICENSE_HEADER = """\
 """
 
 
-DIRECTORIES = ["src", "tests", "include"]
+DIRECTORIES = ["src", "tests", "include", "benchmarks"]
 EXTENSIONS = [".c", ".h"]
 PYTHON_DIRECTORIES = ["."]
 PYTHON_EXTENSIONS = [".py"]
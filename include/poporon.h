@@ -15,7 +15,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include "poporon/ec.h"
 #include "poporon/erasure.h"
+#include "poporon/fft.h"
 #include "poporon/gf.h"
 #include "poporon/rng.h"
 
@@ -34,6 +36,25 @@
 #define POPORON_LDPC_MATRIX_RANDOM    1
 #define POPORON_LDPC_MATRIX_QC_RANDOM 2
 
+#define POPORON_RS_ENCODE_LFSR    0
+#define POPORON_RS_ENCODE_MATRIX  1
+#define POPORON_RS_ENCODE_SLICE_4 4
+#define POPORON_RS_ENCODE_SLICE_8 8
+
+#define POPORON_RS_DECODE_BM   0
+#define POPORON_RS_DECODE_RIBM 1
+
+#define POPORON_RS_SYNDROME_HORNER    0
+#define POPORON_RS_SYNDROME_REMAINDER 1
+
+#define POPORON_SIMD_LEVEL_AUTO     0
+#define POPORON_SIMD_LEVEL_SCALAR   1
+#define POPORON_SIMD_LEVEL_SSSE3    2
+#define POPORON_SIMD_LEVEL_AVX2     3
+#define POPORON_SIMD_LEVEL_AVX512BW 4
+#define POPORON_SIMD_LEVEL_NEON     5
+#define POPORON_SIMD_LEVEL_WASM     6
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -41,7 +62,9 @@ extern "C" {
 typedef uint32_t poporon_buildtime_t;
 
 typedef struct _poporon_t poporon_t;
+typedef struct _poporon_workspace_t poporon_workspace_t;
 typedef struct _poporon_config_t poporon_config_t;
+typedef struct _poporon_pool_t poporon_pool_t;
 
 typedef enum {
     PPLN_FEC_RS = POPORON_FEC_RS,
@@ -64,6 +87,33 @@ typedef enum {
     PPRN_LDPC_QC_RANDOM = POPORON_LDPC_MATRIX_QC_RANDOM,
 } poporon_ldpc_matrix_type_t;
 
+typedef enum {
+    PPRN_RS_ENCODE_LFSR = POPORON_RS_ENCODE_LFSR,       /* one byte per LFSR step on the SIMD kernels (default) */
+    PPRN_RS_ENCODE_MATRIX = POPORON_RS_ENCODE_MATRIX,   /* parity-generation matrix, region multiply-accumulate */
+    PPRN_RS_ENCODE_SLICE_4 = POPORON_RS_ENCODE_SLICE_4, /* 4 bytes per step, 4 * 256 * num_roots bytes of tables */
+    PPRN_RS_ENCODE_SLICE_8 = POPORON_RS_ENCODE_SLICE_8, /* 8 bytes per step, 8 * 256 * num_roots bytes of tables */
+} poporon_rs_encode_mode_t;
+
+typedef enum {
+    PPRN_RS_DECODE_BM = POPORON_RS_DECODE_BM,     /* Berlekamp-Massey, work follows the error count (default) */
+    PPRN_RS_DECODE_RIBM = POPORON_RS_DECODE_RIBM, /* inversionless reformulated BM, the same work for every codeword */
+} poporon_rs_decode_mode_t;
+
+typedef enum {
+    PPRN_RS_SYNDROME_HORNER = POPORON_RS_SYNDROME_HORNER,       /* Horner passes over the codeword (default) */
+    PPRN_RS_SYNDROME_REMAINDER = POPORON_RS_SYNDROME_REMAINDER, /* encoder remainder, evaluated only when non-zero */
+} poporon_rs_syndrome_mode_t;
+
+typedef enum {
+    PPRN_SIMD_AUTO = POPORON_SIMD_LEVEL_AUTO, /* best level supported by the running CPU */
+    PPRN_SIMD_SCALAR = POPORON_SIMD_LEVEL_SCALAR,
+    PPRN_SIMD_SSSE3 = POPORON_SIMD_LEVEL_SSSE3,
+    PPRN_SIMD_AVX2 = POPORON_SIMD_LEVEL_AVX2,
+    PPRN_SIMD_AVX512BW = POPORON_SIMD_LEVEL_AVX512BW,
+    PPRN_SIMD_NEON = POPORON_SIMD_LEVEL_NEON,
+    PPRN_SIMD_WASM = POPORON_SIMD_LEVEL_WASM,
+} poporon_simd_level_t;
+
 poporon_config_t *poporon_rs_config_create(uint8_t symbol_size, uint16_t generator_polynomial,
                                            uint16_t first_consecutive_root, uint16_t primitive_element,
                                            uint8_t num_roots, poporon_erasure_t *erasure, uint16_t *syndrome);
@@ -78,6 +128,10 @@ poporon_config_t *poporon_ldpc_config_create(size_t block_size, poporon_ldpc_rat
 poporon_config_t *poporon_bch_config_create(uint8_t symbol_size, uint16_t generator_polynomial,
                                             uint8_t correction_capability);
 
+bool poporon_rs_config_set_encode_mode(poporon_config_t *config, poporon_rs_encode_mode_t mode);
+bool poporon_rs_config_set_decode_mode(poporon_config_t *config, poporon_rs_decode_mode_t mode);
+bool poporon_rs_config_set_syndrome_mode(poporon_config_t *config, poporon_rs_syndrome_mode_t mode);
+
 poporon_config_t *poporon_config_rs_default(void);
 poporon_config_t *poporon_config_ldpc_default(size_t block_size, poporon_ldpc_rate_t rate);
 poporon_config_t *poporon_config_ldpc_burst_resistant(size_t block_size, poporon_ldpc_rate_t rate);
@@ -90,11 +144,72 @@ void poporon_destroy(poporon_t *pprn);
 bool poporon_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity);
 bool poporon_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t *corrected_num);
 
+poporon_workspace_t *poporon_workspace_create(const poporon_t *pprn);
+void poporon_workspace_destroy(poporon_workspace_t *workspace);
+bool poporon_encode_with_workspace(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                                   uint8_t *parity);
+bool poporon_decode_with_workspace(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                                   uint8_t *parity, size_t *corrected_num);
+
+/* codes with symbol_size > 8, one symbol per uint16_t: size counts data symbols and parity holds num_roots symbols */
+bool poporon_encode_u16(poporon_t *pprn, const uint16_t *data, size_t size, uint16_t *parity);
+bool poporon_decode_u16(poporon_t *pprn, uint16_t *data, size_t size, uint16_t *parity, size_t *corrected_num);
+bool poporon_decode_u16_with_workspace(const poporon_t *pprn, poporon_workspace_t *workspace, uint16_t *data,
+                                       size_t size, uint16_t *parity, size_t *corrected_num);
+
+/*
+ * Verify only: true when data || parity is an intact codeword, false when it is damaged or does not fit the codec.
+ * Nothing is written, allocated or kept in a workspace, so one instance may check from several threads at once. The
+ * batch form reports each codeword in results[] and returns true when all are intact.
+ */
+bool poporon_check(const poporon_t *pprn, const uint8_t *data, size_t size, const uint8_t *parity);
+bool poporon_check_u16(const poporon_t *pprn, const uint16_t *data, size_t size, const uint16_t *parity);
+bool poporon_check_batch(const poporon_t *pprn, const uint8_t *const *data, size_t size, const uint8_t *const *parity,
+                         size_t count, bool *results);
+
+bool poporon_encode_batch(poporon_t *pprn, uint8_t *const *data, size_t size, uint8_t *const *parity, size_t count,
+                          bool *results);
+bool poporon_decode_batch(poporon_t *pprn, uint8_t *const *data, size_t size, uint8_t *const *parity, size_t count,
+                          bool *results, size_t *corrected_num);
+bool poporon_encode_strided(poporon_t *pprn, uint8_t *data, size_t data_stride, size_t size, uint8_t *parity,
+                            size_t parity_stride, size_t count, bool *results);
+bool poporon_decode_strided(poporon_t *pprn, uint8_t *data, size_t data_stride, size_t size, uint8_t *parity,
+                            size_t parity_stride, size_t count, bool *results, size_t *corrected_num);
+
+bool poporon_interleave(const uint8_t *const *codewords, size_t size, size_t count, uint8_t *interleaved);
+bool poporon_deinterleave(const uint8_t *interleaved, size_t size, size_t count, uint8_t *const *codewords);
+bool poporon_encode_interleaved(poporon_t *pprn, const uint8_t *data, size_t size, size_t count, uint8_t *parity);
+bool poporon_decode_interleaved(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t count,
+                                bool *results, size_t *corrected_num);
+
+/* one frame of a poporon_pool_encode() / poporon_pool_decode() job list, frames may use different codecs */
+typedef struct {
+    const poporon_t *pprn;
+    uint8_t *data;
+    size_t size;
+    uint8_t *parity;
+    size_t corrected_num; /* out, decode only */
+    bool result;          /* out */
+} poporon_pool_job_t;
+
+poporon_pool_t *poporon_pool_create(size_t num_threads);
+void poporon_pool_destroy(poporon_pool_t *pool);
+size_t poporon_pool_get_num_threads(const poporon_pool_t *pool);
+bool poporon_pool_encode(poporon_pool_t *pool, poporon_pool_job_t *jobs, size_t count);
+bool poporon_pool_decode(poporon_pool_t *pool, poporon_pool_job_t *jobs, size_t count);
+bool poporon_pool_encode_batch(poporon_pool_t *pool, const poporon_t *pprn, uint8_t *const *data, size_t size,
+                               uint8_t *const *parity, size_t count, bool *results);
+bool poporon_pool_decode_batch(poporon_pool_t *pool, const poporon_t *pprn, uint8_t *const *data, size_t size,
+                               uint8_t *const *parity, size_t count, bool *results, size_t *corrected_num);
+
 poporon_fec_type_t poporon_get_fec_type(const poporon_t *pprn);
 uint32_t poporon_get_iterations_used(const poporon_t *pprn);
 size_t poporon_get_parity_size(const poporon_t *pprn);
 size_t poporon_get_info_size(const poporon_t *pprn);
 
+bool poporon_simd_set_level(poporon_simd_level_t level);
+poporon_simd_level_t poporon_simd_get_level(void);
+
 uint32_t poporon_version_id(void);
 poporon_buildtime_t poporon_buildtime(void);
 
@@ -0,0 +1,73 @@
+/*
+ * libpoporon - ec.h
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef POPORON_EC_H
+#define POPORON_EC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define POPORON_EC_MATRIX_VANDERMONDE 0
+#define POPORON_EC_MATRIX_CAUCHY      1
+#define POPORON_EC_MATRIX_CAUCHY_XOR  2
+
+#define POPORON_EC_MAX_SHARDS     256 /* data + parity, one distinct GF(2^8) element per shard */
+#define POPORON_EC_XOR_ALIGNMENT  64  /* PPRN_EC_CAUCHY_XOR shard sizes are a multiple of this */
+#define POPORON_EC_CACHE_CAPACITY 64  /* erasure patterns poporon_ec_reconstruct() remembers by default */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _poporon_ec_t poporon_ec_t;
+
+typedef enum {
+    PPRN_EC_VANDERMONDE = POPORON_EC_MATRIX_VANDERMONDE, /* Vandermonde matrix reduced to systematic form */
+    PPRN_EC_CAUCHY = POPORON_EC_MATRIX_CAUCHY,           /* identity over a Cauchy matrix */
+    PPRN_EC_CAUCHY_XOR = POPORON_EC_MATRIX_CAUCHY_XOR,   /* Cauchy as 8x8 bit matrices, encoded with XORs only */
+} poporon_ec_matrix_t;
+
+/*
+ * Systematic Reed-Solomon erasure code over GF(2^8): data_shards equally sized data shards are stored as they are and
+ * parity_shards parity shards are linear combinations of them, so that any data_shards of the data_shards +
+ * parity_shards shards restore all of them. A poporon_ec_t is immutable and may be shared between threads.
+ *
+ * PPRN_EC_CAUCHY_XOR is a different code with the same guarantee: every coefficient becomes an 8x8 matrix over GF(2)
+ * and shards are cut into 8 packets per block, one per bit, so that coding is whole-word XORs of packets following a
+ * schedule that reuses partial sums. It needs no multiply tables or byte shuffles.
+ */
+poporon_ec_t *poporon_ec_create(uint16_t data_shards, uint16_t parity_shards, poporon_ec_matrix_t matrix);
+void poporon_ec_destroy(poporon_ec_t *ec);
+
+uint16_t poporon_ec_get_data_shards(const poporon_ec_t *ec);
+uint16_t poporon_ec_get_parity_shards(const poporon_ec_t *ec);
+
+/* data[data_shards] and parity[parity_shards] point to shard_size bytes each */
+bool poporon_ec_encode(const poporon_ec_t *ec, const uint8_t *const *data, uint8_t *const *parity, size_t shard_size);
+
+/*
+ * shards[data_shards + parity_shards] lists the data shards then the parity shards, present[] flags the intact ones.
+ * Every missing shard is rebuilt in place, which needs at least data_shards of them present.
+ */
+bool poporon_ec_reconstruct(const poporon_ec_t *ec, uint8_t *const *shards, const bool *present, size_t shard_size);
+
+/*
+ * poporon_ec_reconstruct() keeps the inverted matrix (and the XOR schedules) of the last capacity erasure patterns it
+ * saw, least recently used out first, so elimination runs once per pattern rather than once per stripe. 0 disables the
+ * cache. Both calls are thread-safe, the cache lock is a real mutex even when POPORON_USE_THREADS is off.
+ */
+bool poporon_ec_set_cache_capacity(poporon_ec_t *ec, size_t capacity);
+bool poporon_ec_get_cache_stats(const poporon_ec_t *ec, uint64_t *hits, uint64_t *misses);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POPORON_EC_H */
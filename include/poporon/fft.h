@@ -0,0 +1,54 @@
+/*
+ * libpoporon - fft.h
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef POPORON_FFT_H
+#define POPORON_FFT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _poporon_fft_t poporon_fft_t;
+
+/*
+ * Systematic Reed-Solomon erasure code over GF(2^symbol_size), symbol_size 8 or 16, coded with additive FFTs in the
+ * Lin-Chung-Han polynomial basis instead of matrices: encoding costs O(data_shards log parity_shards) and
+ * reconstruction O(n log n) symbol operations per shard byte, so thousands of shards stay cheap. Any data_shards of the
+ * data_shards + parity_shards shards restore all of them.
+ *
+ * parity_shards rounded up to a power of two, plus data_shards rounded up to a multiple of that, must not exceed
+ * 2^symbol_size. With symbol_size 16 shards hold uint16_t symbols: shard sizes are even and shards 2-byte aligned.
+ * A poporon_fft_t is immutable and may be shared between threads.
+ */
+poporon_fft_t *poporon_fft_create(uint8_t symbol_size, uint16_t data_shards, uint16_t parity_shards);
+void poporon_fft_destroy(poporon_fft_t *fft);
+
+uint16_t poporon_fft_get_data_shards(const poporon_fft_t *fft);
+uint16_t poporon_fft_get_parity_shards(const poporon_fft_t *fft);
+
+/* data[data_shards] and parity[parity_shards] point to shard_size bytes each */
+bool poporon_fft_encode(const poporon_fft_t *fft, const uint8_t *const *data, uint8_t *const *parity,
+                        size_t shard_size);
+
+/*
+ * shards[data_shards + parity_shards] lists the data shards then the parity shards, present[] flags the intact ones.
+ * Every missing shard is rebuilt in place, which needs at least data_shards of them present.
+ */
+bool poporon_fft_reconstruct(const poporon_fft_t *fft, uint8_t *const *shards, const bool *present,
+                             size_t shard_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* POPORON_FFT_H */
@@ -10,6 +10,8 @@
 #ifndef POPORON_GF_H
 #define POPORON_GF_H
 
+#include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 
 #ifdef __cplusplus
@@ -21,7 +23,26 @@ typedef struct _poporon_gf_t poporon_gf_t;
 poporon_gf_t *poporon_gf_create(uint8_t symbol_size, uint16_t generator_polynomial);
 void poporon_gf_destroy(poporon_gf_t *gf);
 
-uint8_t poporon_gf_mod(poporon_gf_t *gf, uint16_t value);
+uint16_t poporon_gf_mod(poporon_gf_t *gf, uint32_t value);
+
+/*
+ * Region arithmetic over GF(2^m) with m <= 8, one symbol per byte, on the same SIMD kernels as the codecs. Bits above
+ * symbol_size are ignored. dst may be the same buffer as a source but must not partially overlap one.
+ */
+bool poporon_gf_mul_region(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                           size_t size); /* dst = multiplier * src */
+bool poporon_gf_muladd_region(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                              size_t size); /* dst ^= multiplier * src */
+bool poporon_gf_dot_region(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                           size_t count, uint8_t *dst, size_t size); /* dst = sum of coefficients[k] * sources[k] */
+
+/* the same over GF(2^m) with 8 < m <= 16, one symbol per uint16_t, size counts symbols */
+bool poporon_gf_mul_region_u16(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src, uint16_t *dst,
+                               size_t size);
+bool poporon_gf_muladd_region_u16(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src, uint16_t *dst,
+                                  size_t size);
+bool poporon_gf_dot_region_u16(const poporon_gf_t *gf, const uint16_t *coefficients, const uint16_t *const *sources,
+                               size_t count, uint16_t *dst, size_t size);
 
 #ifdef __cplusplus
 }
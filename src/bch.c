@@ -25,7 +25,7 @@ struct _poporon_bch_t {
 static inline int32_t bch_compute_syndromes(poporon_bch_t *bch, uint32_t codeword, uint16_t *syndromes)
 {
     poporon_gf_t *gf;
-    uint16_t exp_val;
+    uint16_t exp_val, step;
     int32_t i, j, has_nonzero, syndrome_count;
 
     gf = bch->gf;
@@ -35,9 +35,10 @@ static inline int32_t bch_compute_syndromes(poporon_bch_t *bch, uint32_t codewor
     for (i = 0; i < syndrome_count; i++) {
         syndromes[i] = 0;
 
-        for (j = 0; j < bch->codeword_length; j++) {
+        /* (i + 1) * j stepped along j, reduced once per syndrome instead of per bit */
+        step = (uint16_t)((i + 1) % gf->field_size);
+        for (j = 0, exp_val = 0; j < bch->codeword_length; j++, exp_val = gf_log_wrap(gf, exp_val + step)) {
             if (codeword & (1U << j)) {
-                exp_val = (uint16_t)(((i + 1) * j) % gf->field_size);
                 syndromes[i] ^= gf->log2exp[exp_val];
             }
         }
@@ -53,7 +54,7 @@ static inline int32_t bch_compute_syndromes(poporon_bch_t *bch, uint32_t codewor
 static inline uint16_t bch_poly_eval(poporon_bch_t *bch, const uint16_t *poly, int32_t degree, uint16_t x)
 {
     poporon_gf_t *gf;
-    uint16_t sum, log_x, exp_val;
+    uint16_t sum, log_x, power;
     int32_t i;
 
     gf = bch->gf;
@@ -65,21 +66,33 @@ static inline uint16_t bch_poly_eval(poporon_bch_t *bch, const uint16_t *poly, i
     sum = 0;
     log_x = gf->exp2log[x];
 
-    for (i = 0; i <= degree; i++) {
+    for (i = 0, power = 0; i <= degree; i++, power = gf_log_wrap(gf, power + log_x)) {
         if (poly[i] != 0) {
-            exp_val = (gf->exp2log[poly[i]] + (log_x * i) % gf->field_size) % gf->field_size;
-            sum ^= gf->log2exp[exp_val];
+            sum ^= gf_exp(gf, gf->exp2log[poly[i]] + power);
         }
     }
 
     return sum;
 }
 
+/* word mod g(x) over GF(2), bit i holding the coefficient of x^i */
+static inline uint32_t bch_remainder(const poporon_bch_t *bch, uint32_t word)
+{
+    int32_t i;
+
+    for (i = bch->codeword_length - 1; i >= bch->gen_poly_deg; i--) {
+        if (word & (1U << i)) {
+            word ^= bch->gen_poly << (i - bch->gen_poly_deg);
+        }
+    }
+
+    return word;
+}
+
 static inline int32_t bch_berlekamp_massey(poporon_bch_t *bch, const uint16_t *syndromes, uint16_t *error_locator)
 {
     poporon_gf_t *gf;
-    uint16_t current[BCH_MAX_POLY], prev[BCH_MAX_POLY], temp[BCH_MAX_POLY], prev_discrepancy, discrepancy, log_mult,
-        multiplier, log_sum, log_product;
+    uint16_t current[BCH_MAX_POLY], prev[BCH_MAX_POLY], temp[BCH_MAX_POLY], prev_discrepancy, discrepancy, log_mult;
     int32_t error_count, shift, syndrome_count, iteration, i;
 
     gf = bch->gf;
@@ -99,24 +112,21 @@ static inline int32_t bch_berlekamp_massey(poporon_bch_t *bch, const uint16_t *s
 
         for (i = 1; i <= error_count; i++) {
             if (current[i] != 0 && syndromes[iteration - i] != 0) {
-                log_sum = (gf->exp2log[current[i]] + gf->exp2log[syndromes[iteration - i]]) % gf->field_size;
-                discrepancy ^= gf->log2exp[log_sum];
+                discrepancy ^= gf_exp(gf, gf->exp2log[current[i]] + gf->exp2log[syndromes[iteration - i]]);
             }
         }
 
         if (discrepancy == 0) {
             shift++;
         } else {
-            log_mult = (gf->field_size - gf->exp2log[prev_discrepancy] + gf->exp2log[discrepancy]) % gf->field_size;
-            multiplier = gf->log2exp[log_mult];
+            log_mult = gf_log_wrap(gf, gf->field_size - gf->exp2log[prev_discrepancy] + gf->exp2log[discrepancy]);
 
             if (2 * error_count <= iteration) {
                 pmemcpy(temp, current, sizeof(temp));
 
                 for (i = 0; i < BCH_MAX_POLY - shift; i++) {
                     if (prev[i] != 0) {
-                        log_product = (gf->exp2log[prev[i]] + gf->exp2log[multiplier]) % gf->field_size;
-                        current[i + shift] ^= gf->log2exp[log_product];
+                        current[i + shift] ^= gf_exp(gf, gf->exp2log[prev[i]] + log_mult);
                     }
                 }
 
@@ -127,8 +137,7 @@ static inline int32_t bch_berlekamp_massey(poporon_bch_t *bch, const uint16_t *s
             } else {
                 for (i = 0; i < BCH_MAX_POLY - shift; i++) {
                     if (prev[i] != 0) {
-                        log_product = (gf->exp2log[prev[i]] + gf->exp2log[multiplier]) % gf->field_size;
-                        current[i + shift] ^= gf->log2exp[log_product];
+                        current[i + shift] ^= gf_exp(gf, gf->exp2log[prev[i]] + log_mult);
                     }
                 }
                 shift++;
@@ -151,7 +160,7 @@ static inline int32_t bch_chien_search(poporon_bch_t *bch, const uint16_t *error
     gf = bch->gf;
 
     for (i = 0; i < bch->codeword_length; i++) {
-        alpha_inv = gf->log2exp[(gf->field_size - i) % gf->field_size];
+        alpha_inv = gf_exp(gf, gf->field_size - i);
 
         if (bch_poly_eval(bch, error_locator, error_count, alpha_inv) == 0) {
             error_pos[found++] = (uint16_t)i;
@@ -168,7 +177,7 @@ static inline int32_t bch_chien_search(poporon_bch_t *bch, const uint16_t *error
 static inline uint32_t bch_get_minimal_polynomial(poporon_gf_t *gf, int32_t exp)
 {
     uint32_t binary_poly;
-    uint16_t poly[BCH_MAX_POLY], root, log_prod;
+    uint16_t poly[BCH_MAX_POLY], root;
     int32_t poly_deg, conjugate, i, j;
 
     pmemset(poly, 0, sizeof(poly));
@@ -185,8 +194,7 @@ static inline uint32_t bch_get_minimal_polynomial(poporon_gf_t *gf, int32_t exp)
                 poly[j + 1] ^= poly[j];
             }
             if (poly[j] != 0 && root != 0) {
-                log_prod = (gf->exp2log[poly[j]] + gf->exp2log[root]) % gf->field_size;
-                poly[j] = gf->log2exp[log_prod];
+                poly[j] = gf_exp(gf, gf->exp2log[poly[j]] + gf->exp2log[root]);
             } else {
                 poly[j] = 0;
             }
@@ -303,7 +311,7 @@ extern poporon_bch_t *poporon_bch_create(uint8_t symbol_size, uint16_t generator
         return NULL;
     }
 
-    bch->gf = poporon_gf_create(symbol_size, generator_polynomial);
+    bch->gf = poporon_gf_acquire(symbol_size, generator_polynomial);
     if (!bch->gf) {
         pfree(bch);
         return NULL;
@@ -313,7 +321,7 @@ extern poporon_bch_t *poporon_bch_create(uint8_t symbol_size, uint16_t generator
     bch->codeword_length = (uint16_t)((1 << symbol_size) - 1);
 
     if (!bch_build_generator(bch)) {
-        poporon_gf_destroy(bch->gf);
+        poporon_gf_release(bch->gf);
         pfree(bch);
         return NULL;
     }
@@ -328,7 +336,7 @@ extern void poporon_bch_destroy(poporon_bch_t *bch)
     }
 
     if (bch->gf) {
-        poporon_gf_destroy(bch->gf);
+        poporon_gf_release(bch->gf);
     }
 
     pfree(bch);
@@ -351,8 +359,7 @@ extern uint8_t poporon_bch_get_correction_capability(const poporon_bch_t *bch)
 
 extern bool poporon_bch_encode(poporon_bch_t *bch, uint32_t data, uint32_t *codeword)
 {
-    uint32_t shifted, remainder, gen;
-    int32_t gen_deg, i;
+    uint32_t shifted;
 
     if (!bch || !codeword) {
         return false;
@@ -364,17 +371,7 @@ extern bool poporon_bch_encode(poporon_bch_t *bch, uint32_t data, uint32_t *code
 
     shifted = data << bch->parity_bits;
 
-    remainder = shifted;
-    gen = bch->gen_poly;
-    gen_deg = bch->gen_poly_deg;
-
-    for (i = bch->codeword_length - 1; i >= gen_deg; i--) {
-        if (remainder & (1U << i)) {
-            remainder ^= (gen << (i - gen_deg));
-        }
-    }
-
-    *codeword = shifted ^ remainder;
+    *codeword = shifted ^ bch_remainder(bch, shifted);
 
     return true;
 }
@@ -434,6 +431,16 @@ extern bool poporon_bch_decode(poporon_bch_t *bch, uint32_t received, uint32_t *
     return true;
 }
 
+/* a cyclic code: the received word is a codeword exactly when the generator divides it, all syndromes zero */
+extern bool poporon_bch_check(const poporon_bch_t *bch, uint32_t received)
+{
+    if (!bch) {
+        return false;
+    }
+
+    return bch_remainder(bch, received & ((1U << bch->codeword_length) - 1)) == 0;
+}
+
 extern uint32_t poporon_bch_extract_data(const poporon_bch_t *bch, uint32_t codeword)
 {
     if (!bch) {
@@ -8,44 +8,136 @@
  */
 
 #include "internal/common.h"
+#include "internal/kernel.h"
 #include "internal/ldpc.h"
 
-#if POPORON_USE_SIMD
-#include "internal/simd.h"
-#endif
-
-static inline bool error_correction_u8(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity,
-                                       uint16_t *syndrome_ptr, uint32_t erasure_count, uint32_t *erasure_positions,
-                                       uint16_t *corrections, int16_t padding_length, size_t *errors_corrected)
+/*
+ * Forney for all roots at once, the loops interchanged so that every coefficient of omega(x) and of the odd part of
+ * lambda(x) is read once and applied to each root with a log step, powers[] holding root^i per root. Leaves the error
+ * values in buffer->coefficients, 0 where the numerator vanishes, and returns the number of nonzero ones. The roots
+ * are consumed; buffer->polynomial and buffer->register_coefficients are free after the Chien search and serve as
+ * scratch.
+ */
+static inline size_t forney_batch(const poporon_rs_t *rs, decoder_buffer_t *buffer, uint16_t error_count,
+                                  uint16_t evaluator_degree, uint16_t denominator_degree)
 {
-    poporon_rs_t *rs = pprn->ctx.rs.rs;
-    decoder_buffer_t *buffer = pprn->ctx.rs.buffer;
-    uint32_t iteration_count, polynomial_degree;
-    uint16_t error_locator_degree, error_evaluator_degree, polynomial_evaluation, temp_value, numerator_value,
-        second_numerator, denominator_value, discrepancy, error_count;
-    uint8_t poly_term;
-    int32_t location_with_padding;
-    int16_t i, j, k;
-    bool success = true;
+    uint16_t *steps, *powers, *numerators, log, r;
+    size_t corrected;
+    int32_t i;
+
+    steps = buffer->error_roots;
+    powers = buffer->register_coefficients;
+    numerators = buffer->polynomial;
+
+    for (r = 0; r < error_count; r++) {
+        steps[r] = gf_log_wrap(rs->gf, steps[r]);
+        powers[r] = 0;
+        numerators[r] = 0;
+    }
 
-    pmemset(&buffer->error_locator[1], 0, rs->num_roots * sizeof(buffer->error_locator[0]));
-    buffer->error_locator[0] = 1;
+    for (i = 0; i <= evaluator_degree; i++) {
+        log = buffer->error_evaluator[i];
+        if (log != rs->gf->field_size) {
+            for (r = 0; r < error_count; r++) {
+                numerators[r] ^= gf_exp(rs->gf, (uint32_t)log + powers[r]);
+            }
+        }
 
-    if (erasure_count > 0) {
-        buffer->error_locator[1] = rs->gf->log2exp[gf_mod(
-            rs->gf, rs->primitive_element * (rs->gf->field_size - 1 - (erasure_positions[0] + padding_length)))];
-        for (i = 1; i < erasure_count; i++) {
-            poly_term = gf_mod(rs->gf, rs->primitive_element *
-                                           (rs->gf->field_size - 1 - (erasure_positions[i] + padding_length)));
-            for (j = i + 1; j > 0; j--) {
-                temp_value = rs->gf->exp2log[buffer->error_locator[j - 1]];
-                if (temp_value != rs->gf->field_size) {
-                    buffer->error_locator[j] ^= rs->gf->log2exp[gf_mod(rs->gf, poly_term + temp_value)];
-                }
+        for (r = 0; r < error_count; r++) {
+            powers[r] = gf_log_wrap(rs->gf, (uint32_t)powers[r] + steps[r]);
+        }
+    }
+
+    /* numerators[] turn into logs of numerator * root^(first_consecutive_root - 1), field_size when zero */
+    log = gf_mod(rs->gf, (uint32_t)rs->first_consecutive_root + rs->gf->field_size - 1);
+    for (r = 0; r < error_count; r++) {
+        numerators[r] = (numerators[r] == 0) ? rs->gf->field_size
+                                             : gf_log_wrap(rs->gf, (uint32_t)rs->gf->exp2log[numerators[r]] +
+                                                                       gf_mod(rs->gf, (uint32_t)steps[r] * log));
+        steps[r] = gf_log_wrap(rs->gf, (uint32_t)steps[r] + steps[r]);
+        powers[r] = 0;
+        buffer->coefficients[r] = 0;
+    }
+
+    /* the denominator sums the odd coefficients of lambda(x) at root^2 */
+    for (i = 0; i <= denominator_degree; i += 2) {
+        log = buffer->error_locator[i + 1];
+        if (log != rs->gf->field_size) {
+            for (r = 0; r < error_count; r++) {
+                buffer->coefficients[r] ^= gf_exp(rs->gf, (uint32_t)log + powers[r]);
             }
         }
+
+        for (r = 0; r < error_count; r++) {
+            powers[r] = gf_log_wrap(rs->gf, (uint32_t)powers[r] + steps[r]);
+        }
+    }
+
+    corrected = 0;
+    for (r = 0; r < error_count; r++) {
+        if (numerators[r] == rs->gf->field_size) {
+            buffer->coefficients[r] = 0;
+            continue;
+        }
+
+        buffer->coefficients[r] = gf_exp(rs->gf, (uint32_t)numerators[r] + rs->gf->field_size -
+                                                     rs->gf->exp2log[buffer->coefficients[r]]);
+        corrected++;
     }
 
+    return corrected;
+}
+
+/*
+ * The error values must reproduce the syndrome, S_i being the sum of Y_j * X_j^((first_consecutive_root + i) *
+ * primitive_element) over the errors. Each error steps its own exponent, so no product is reduced per term.
+ */
+static inline bool syndrome_check(const poporon_rs_t *rs, decoder_buffer_t *buffer, uint16_t error_count,
+                                  const uint16_t *syndrome_ptr)
+{
+    uint16_t *steps, *terms, *values, count, value, r, i;
+
+    steps = buffer->error_roots;
+    terms = buffer->register_coefficients;
+    values = buffer->polynomial;
+
+    count = 0;
+    for (r = 0; r < error_count; r++) {
+        if (buffer->coefficients[r] == 0) {
+            continue;
+        }
+
+        steps[count] = gf_mod(rs->gf, (uint32_t)rs->primitive_element *
+                                          (rs->gf->field_size - buffer->error_locations[r] - 1));
+        terms[count] = gf_mod(rs->gf, (uint32_t)steps[count] * rs->first_consecutive_root);
+        values[count] = rs->gf->exp2log[buffer->coefficients[r]];
+        count++;
+    }
+
+    for (i = 0; i < rs->num_roots; i++) {
+        value = 0;
+
+        for (r = 0; r < count; r++) {
+            value ^= gf_exp(rs->gf, (uint32_t)values[r] + terms[r]);
+            terms[r] = gf_log_wrap(rs->gf, (uint32_t)terms[r] + steps[r]);
+        }
+
+        if (value != rs->gf->log2exp[syndrome_ptr[i]]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/* Berlekamp-Massey from the erasure locator in buffer->error_locator, lambda(x) is left there with lambda_0 = 1 */
+static inline void bm_solve(const poporon_rs_t *rs, decoder_buffer_t *buffer, const uint16_t *syndrome_ptr,
+                            uint32_t erasure_count)
+{
+    uint32_t iteration_count, polynomial_degree;
+    uint16_t discrepancy;
+    int16_t i;
+
     for (i = 0; i < rs->num_roots + 1; i++) {
         buffer->coefficients[i] = rs->gf->exp2log[buffer->error_locator[i]];
     }
@@ -56,8 +148,8 @@ static inline bool error_correction_u8(poporon_t *pprn, uint8_t *data, size_t si
         discrepancy = 0;
         for (i = 0; i < iteration_count; i++) {
             if ((buffer->error_locator[i] != 0) && (syndrome_ptr[iteration_count - i - 1] != rs->gf->field_size)) {
-                discrepancy ^= rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[buffer->error_locator[i]] +
-                                                                  syndrome_ptr[iteration_count - i - 1])];
+                discrepancy ^= gf_exp(rs->gf, rs->gf->exp2log[buffer->error_locator[i]] +
+                                                  syndrome_ptr[iteration_count - i - 1]);
             }
         }
         discrepancy = rs->gf->exp2log[discrepancy];
@@ -70,8 +162,8 @@ static inline bool error_correction_u8(poporon_t *pprn, uint8_t *data, size_t si
 
             for (i = 0; i < rs->num_roots; i++) {
                 if (buffer->coefficients[i] != rs->gf->field_size) {
-                    buffer->polynomial[i + 1] = buffer->error_locator[i + 1] ^
-                                                rs->gf->log2exp[gf_mod(rs->gf, discrepancy + buffer->coefficients[i])];
+                    buffer->polynomial[i + 1] =
+                        buffer->error_locator[i + 1] ^ gf_exp(rs->gf, discrepancy + buffer->coefficients[i]);
                 } else {
                     buffer->polynomial[i + 1] = buffer->error_locator[i + 1];
                 }
@@ -82,8 +174,8 @@ static inline bool error_correction_u8(poporon_t *pprn, uint8_t *data, size_t si
                 for (i = 0; i <= rs->num_roots; i++) {
                     buffer->coefficients[i] = (buffer->error_locator[i] == 0)
                                                   ? rs->gf->field_size
-                                                  : gf_mod(rs->gf, rs->gf->exp2log[buffer->error_locator[i]] -
-                                                                       discrepancy + rs->gf->field_size);
+                                                  : gf_log_wrap(rs->gf, rs->gf->exp2log[buffer->error_locator[i]] -
+                                                                            discrepancy + rs->gf->field_size);
                 }
             } else {
                 pmemmove(&buffer->coefficients[1], buffer->coefficients,
@@ -94,390 +186,555 @@ static inline bool error_correction_u8(poporon_t *pprn, uint8_t *data, size_t si
             pmemcpy(buffer->error_locator, buffer->polynomial, (rs->num_roots + 1) * sizeof(buffer->polynomial[0]));
         }
     }
+}
 
-    error_locator_degree = 0;
-
-    for (i = 0; i < rs->num_roots + 1; i++) {
-        buffer->error_locator[i] = rs->gf->exp2log[buffer->error_locator[i]];
-
-        if (buffer->error_locator[i] != rs->gf->field_size) {
-            error_locator_degree = i;
-        }
-    }
+static inline uint16_t ribm_get(const uint8_t *row, size_t i, bool wide)
+{
+    return wide ? ((const uint16_t *)row)[i] : row[i];
+}
 
-    if (error_locator_degree == 0) {
-        return false;
+static inline void ribm_set(uint8_t *row, size_t i, uint16_t value, bool wide)
+{
+    if (wide) {
+        ((uint16_t *)row)[i] = value;
+    } else {
+        row[i] = (uint8_t)value;
     }
+}
 
-    pmemcpy(&buffer->register_coefficients[1], &buffer->error_locator[1],
-            rs->num_roots * sizeof(buffer->register_coefficients[0]));
+/* next = gamma * delta[1 ..] + discrepancy * theta over length symbols, bytes or uint16_t */
+static inline void ribm_update(const poporon_rs_t *rs, const poporon_kernel_t *kernel, uint16_t gamma,
+                               uint16_t discrepancy, const uint8_t *delta, const uint8_t *theta, uint8_t *next,
+                               size_t length, bool wide)
+{
+    const uint8_t *sources[2];
+    uint8_t coefficients[2];
 
-    error_count = 0;
+    if (wide) {
+        kernel->gf_mul_region_u16(rs->gf, gamma, (const uint16_t *)delta + 1, (uint16_t *)next, length);
+        kernel->gf_muladd_region_u16(rs->gf, discrepancy, (const uint16_t *)theta, (uint16_t *)next, length);
+        return;
+    }
 
-    for (i = 1, k = buffer->primitive_inverse - 1; i <= rs->gf->field_size;
-         i++, k = gf_mod(rs->gf, k + buffer->primitive_inverse)) {
-        polynomial_evaluation = 1;
+    coefficients[0] = (uint8_t)gamma;
+    coefficients[1] = (uint8_t)discrepancy;
+    sources[0] = delta + 1;
+    sources[1] = theta;
+    kernel->gf_dot_region(rs->gf, coefficients, sources, 2, next, length);
+}
 
-        for (j = error_locator_degree; j > 0; j--) {
-            if (buffer->register_coefficients[j] != rs->gf->field_size) {
-                buffer->register_coefficients[j] = gf_mod(rs->gf, buffer->register_coefficients[j] + j);
-                polynomial_evaluation ^= rs->gf->log2exp[buffer->register_coefficients[j]];
+/*
+ * Inversionless reformulated Berlekamp-Massey (Sarwate and Shanbhag). At step r the row delta holds the coefficients
+ * r, r + 1, ... of lambda(x) * (S(x) + x^(2 * num_roots)), the second term carrying lambda(x) itself along, and theta
+ * the same for the correction polynomial. The discrepancy is delta[0] and every step is
+ * delta = gamma * (delta >> 1) + delta[0] * theta over the whole row: two region multiplies on the SIMD kernels for
+ * any error count, no division, and a choice among three rows where the classic loop copies. Starts at step
+ * erasure_count from the erasure locator in buffer->error_locator and leaves lambda(x) there, scaled to lambda_0 = 1.
+ */
+static inline void ribm_solve(const poporon_rs_t *rs, decoder_buffer_t *buffer, const uint16_t *syndrome_ptr,
+                              uint32_t erasure_count)
+{
+    const poporon_kernel_t *kernel;
+    uint8_t *delta, *theta_row, *next, *spare;
+    uint16_t gamma, discrepancy, value, scale;
+    size_t length, width, theta_offset, i, j, s;
+    int32_t k;
+    uint32_t r;
+    bool wide, update;
+
+    kernel = poporon_kernel();
+    wide = rs->gf->symbol_size > 8;
+    width = wide ? sizeof(uint16_t) : sizeof(uint8_t);
+    length = 2 * (size_t)rs->num_roots + 1;
+    delta = (uint8_t *)buffer->ribm;
+    theta_row = (uint8_t *)(buffer->ribm + RIBM_ROW_SIZE(rs->num_roots));
+    next = (uint8_t *)(buffer->ribm + 2 * RIBM_ROW_SIZE(rs->num_roots));
+    theta_offset = 0;
+
+    /* erasure locator times the syndrome from coefficient erasure_count on, the locator itself at 2 * num_roots */
+    for (i = 0; i < length; i++) {
+        value = 0;
+        for (j = 0; j <= erasure_count; j++) {
+            s = erasure_count + i - j;
+            if (s < rs->num_roots && buffer->error_locator[j] != 0 && syndrome_ptr[s] != rs->gf->field_size) {
+                value ^= gf_exp(rs->gf, (uint32_t)rs->gf->exp2log[buffer->error_locator[j]] + syndrome_ptr[s]);
             }
         }
 
-        if (polynomial_evaluation != 0) {
-            continue;
+        if (i + erasure_count >= 2 * (size_t)rs->num_roots) {
+            value ^= buffer->error_locator[i + erasure_count - 2 * (size_t)rs->num_roots];
         }
 
-        if (k < padding_length) {
-            return false;
-        }
+        ribm_set(delta, i, value, wide);
+        ribm_set(theta_row, i, value, wide);
+    }
 
-        buffer->error_roots[error_count] = i;
-        buffer->error_locations[error_count] = k;
-        if (++error_count == error_locator_degree) {
-            break;
-        }
+    /* the element past each row is read as delta[1 ..] and theta shifted by one, and stays zero */
+    ribm_set(delta, length, 0, wide);
+    ribm_set(theta_row, length, 0, wide);
+    ribm_set(next, length, 0, wide);
+
+    gamma = 1;
+    k = 0;
+
+    for (r = erasure_count; r < rs->num_roots; r++) {
+        discrepancy = ribm_get(delta, 0, wide);
+        ribm_update(rs, kernel, gamma, discrepancy, delta, theta_row + theta_offset * width, next, length, wide);
+
+        /* a nonzero discrepancy while 2 * L <= r + erasure_count makes the old lambda(x) the correction */
+        update = discrepancy != 0 && k >= 0;
+        gamma = update ? discrepancy : gamma;
+        k = update ? -k - 1 : k + 1;
+        spare = update ? theta_row : delta;
+        theta_row = update ? delta : theta_row;
+        theta_offset = update ? 1 : theta_offset;
+        delta = next;
+        next = spare;
     }
 
-    if (error_locator_degree != error_count) {
-        return false;
+    scale = rs->gf->field_size - rs->gf->exp2log[ribm_get(delta, rs->num_roots, wide)];
+    for (i = 0; i <= rs->num_roots; i++) {
+        value = ribm_get(delta, rs->num_roots + i, wide);
+        buffer->error_locator[i] = value ? gf_exp(rs->gf, (uint32_t)rs->gf->exp2log[value] + scale) : 0;
     }
+}
 
-    error_evaluator_degree = error_locator_degree - 1;
-    for (i = 0; i <= error_evaluator_degree; i++) {
-        temp_value = 0;
+/* codeword position of an error locator X = alpha^(primitive_element * (field_size - 1 - location)) given as a log */
+static inline int32_t locator_position(const poporon_t *pprn, uint16_t locator_log)
+{
+    const poporon_gf_t *gf = pprn->ctx.rs.rs->gf;
 
-        for (j = i; j >= 0; j--) {
-            if ((syndrome_ptr[i - j] != rs->gf->field_size) && (buffer->error_locator[j] != rs->gf->field_size)) {
-                temp_value ^= rs->gf->log2exp[gf_mod(rs->gf, syndrome_ptr[i - j] + buffer->error_locator[j])];
-            }
-        }
+    return (int32_t)gf->field_size - 1 - gf_mod(gf, (uint32_t)locator_log * pprn->ctx.rs.primitive_inverse);
+}
 
-        buffer->error_evaluator[i] = rs->gf->exp2log[temp_value];
+/*
+ * Closed forms for the common one and two error words, both verified against the whole syndrome so that anything
+ * else falls through to the general decoder. With S_i = sum of Y_j * X_j^(first_consecutive_root + i), one error
+ * gives X = S_1 / S_0. Two errors give sigma_1 = X_1 + X_2 and sigma_2 = X_1 * X_2 from S_0..S_3 by Cramer's rule,
+ * then X_1 = sigma_1 * y for a root y of y^2 + y = sigma_2 / sigma_1^2 read from rs->quadratic_roots, which only
+ * the fields with nibble tables carry.
+ */
+static inline bool few_errors_correction(const poporon_t *pprn, decoder_buffer_t *buffer, const uint16_t *syndrome_ptr,
+                                         int32_t padding_length, uint16_t *error_count_out, size_t *errors_corrected)
+{
+    const poporon_rs_t *rs = pprn->ctx.rs.rs;
+    const poporon_gf_t *gf = rs->gf;
+    uint16_t s[4], determinant, sigma1, sigma2, x[2], y[2], root, r;
+    uint32_t q;
+    int32_t location;
+
+    q = gf->field_size;
+
+    if (rs->num_roots < 2) {
+        return false;
     }
-    *errors_corrected = 0;
-    for (j = error_count - 1; j >= 0; j--) {
-        numerator_value = 0;
 
-        for (i = error_evaluator_degree; i >= 0; i--) {
-            if (buffer->error_evaluator[i] != rs->gf->field_size) {
-                numerator_value ^=
-                    rs->gf->log2exp[gf_mod(rs->gf, buffer->error_evaluator[i] + i * buffer->error_roots[j])];
+    if (syndrome_ptr[0] != q && syndrome_ptr[1] != q) {
+        x[0] = gf_log_wrap(gf, (uint32_t)syndrome_ptr[1] + q - syndrome_ptr[0]);
+        location = locator_position(pprn, x[0]);
+        if (location >= padding_length) {
+            buffer->error_locations[0] = (uint16_t)location;
+            buffer->coefficients[0] = gf_exp(
+                gf, (uint32_t)syndrome_ptr[0] + q - gf_mod(gf, (uint32_t)x[0] * rs->first_consecutive_root));
+            if (syndrome_check(rs, buffer, 1, syndrome_ptr)) {
+                *error_count_out = 1;
+                *errors_corrected = 1;
+
+                return true;
             }
         }
+    }
 
-        if (numerator_value == 0) {
-            buffer->coefficients[j] = 0;
-            continue;
-        }
+    if (rs->num_roots < 4 || !rs->quadratic_roots) {
+        return false;
+    }
 
-        second_numerator = rs->gf->log2exp[gf_mod(rs->gf, buffer->error_roots[j] * (rs->first_consecutive_root - 1) +
-                                                              rs->gf->field_size)];
-        denominator_value = 0;
+    for (r = 0; r < 4; r++) {
+        s[r] = gf->log2exp[syndrome_ptr[r]];
+    }
 
-        for (i = (error_locator_degree < (rs->num_roots - 1) ? error_locator_degree : (rs->num_roots - 1)) & ~1; i >= 0;
-             i -= 2) {
-            if (buffer->error_locator[i + 1] != rs->gf->field_size) {
-                denominator_value ^=
-                    rs->gf->log2exp[gf_mod(rs->gf, buffer->error_locator[i + 1] + i * buffer->error_roots[j])];
-            }
-        }
+    determinant = gf_mul(gf, s[0], s[2]) ^ gf_mul(gf, s[1], s[1]);
+    if (determinant == 0) {
+        return false;
+    }
 
-        buffer->coefficients[j] =
-            rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[numerator_value] + rs->gf->exp2log[second_numerator] +
-                                               rs->gf->field_size - rs->gf->exp2log[denominator_value])];
-        (*errors_corrected)++;
+    determinant = gf_inv(gf, determinant);
+    sigma1 = gf_mul(gf, gf_mul(gf, s[0], s[3]) ^ gf_mul(gf, s[1], s[2]), determinant);
+    sigma2 = gf_mul(gf, gf_mul(gf, s[1], s[3]) ^ gf_mul(gf, s[2], s[2]), determinant);
+    if (sigma1 == 0 || sigma2 == 0) {
+        return false;
     }
 
-    for (i = 0; i < rs->num_roots; i++) {
-        temp_value = 0;
+    root = rs->quadratic_roots[gf_mul(gf, sigma2, gf_inv(gf, gf_mul(gf, sigma1, sigma1)))];
+    if (root == 0) {
+        return false;
+    }
 
-        for (j = 0; j < error_count; j++) {
-            if (buffer->coefficients[j] == 0) {
-                continue;
-            }
+    x[0] = gf_mul(gf, sigma1, root);
+    x[1] = x[0] ^ sigma1;
 
-            k = (rs->first_consecutive_root + i) * rs->primitive_element *
-                (rs->gf->field_size - buffer->error_locations[j] - 1);
-            temp_value ^= rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[buffer->coefficients[j]] + k)];
+    /* Y_j * X_j^first_consecutive_root from S_0 and S_1, then scaled down */
+    y[0] = gf_mul(gf, s[1] ^ gf_mul(gf, s[0], x[1]), gf_inv(gf, sigma1));
+    y[1] = s[0] ^ y[0];
+
+    for (r = 0; r < 2; r++) {
+        if (y[r] == 0) {
+            return false;
         }
 
-        if (temp_value != rs->gf->log2exp[syndrome_ptr[i]]) {
+        location = locator_position(pprn, gf->exp2log[x[r]]);
+        if (location < padding_length) {
             return false;
         }
+
+        buffer->error_locations[r] = (uint16_t)location;
+        buffer->coefficients[r] = gf_exp(gf, (uint32_t)gf->exp2log[y[r]] + q -
+                                                 gf_mod(gf, (uint32_t)gf->exp2log[x[r]] * rs->first_consecutive_root));
     }
 
-    if (corrections && erasure_positions) {
-        for (i = 0; i < error_count; i++) {
-            data[erasure_positions[i]] ^= buffer->coefficients[i];
-        }
-    } else if (data && parity) {
-        for (i = 0; i < error_count; i++) {
-            location_with_padding = (int32_t)buffer->error_locations[i] - (int32_t)padding_length;
-            if (location_with_padding >= 0 && location_with_padding < (int32_t)size) {
-                data[location_with_padding] ^= buffer->coefficients[i];
-            } else if (location_with_padding >= (int32_t)size &&
-                       location_with_padding < (int32_t)(size + rs->num_roots)) {
-                parity[location_with_padding - size] ^= buffer->coefficients[i];
-            } else {
-                return false;
-            }
-        }
+    if (!syndrome_check(rs, buffer, 2, syndrome_ptr)) {
+        return false;
     }
 
+    *error_count_out = 2;
+    *errors_corrected = 2;
+
     return true;
 }
 
-static inline bool calculate_syndrome_u8(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity,
-                                         uint16_t *syndrome)
+/*
+ * Locates and evaluates the errors of one codeword from its log-domain syndrome, leaving the error values in
+ * buffer->coefficients and their positions in buffer->error_locations for apply_corrections_u8/u16().
+ */
+static inline bool error_correction(const poporon_t *pprn, decoder_buffer_t *buffer, const uint16_t *syndrome_ptr,
+                                    uint32_t erasure_count, const uint32_t *erasure_positions, int32_t padding_length,
+                                    uint16_t *error_count_out, size_t *errors_corrected)
 {
     poporon_rs_t *rs = pprn->ctx.rs.rs;
+    uint16_t error_locator_degree, error_evaluator_degree, denominator_degree, temp_value, error_count, poly_term;
+    int16_t i, j;
 
-#if POPORON_USE_SIMD && defined(POPORON_SIMD_AVX2)
-    __m256i syndrome_vec, result_vec;
-    uint16_t syndrome_error_flag, data_val, result[16], k;
-    int16_t i, j, num_roots_aligned;
-
-    syndrome_error_flag = 0;
-    num_roots_aligned = (rs->num_roots) & ~15;
-
-    for (i = 0; i < rs->num_roots; i++) {
-        syndrome[i] = data[0] & ((uint16_t)rs->gf->field_size);
+    if (erasure_count == 0 &&
+        few_errors_correction(pprn, buffer, syndrome_ptr, padding_length, error_count_out, errors_corrected)) {
+        return true;
     }
 
-    for (j = 1; j < size; j++) {
-        data_val = data[j] & ((uint16_t)rs->gf->field_size);
+    pmemset(&buffer->error_locator[1], 0, rs->num_roots * sizeof(buffer->error_locator[0]));
+    buffer->error_locator[0] = 1;
 
-        for (i = 0; i < num_roots_aligned; i += 16) {
-            for (k = 0; k < 16; k++) {
-                if (syndrome[i + k] == 0) {
-                    result[k] = data_val;
-                } else {
-                    result[k] =
-                        data_val ^
-                        rs->gf
-                            ->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i + k]] +
-                                                         (rs->first_consecutive_root + i + k) * rs->primitive_element)];
+    if (erasure_count > 0) {
+        buffer->error_locator[1] = rs->gf->log2exp[gf_mod(
+            rs->gf, rs->primitive_element * (rs->gf->field_size - 1 - (erasure_positions[0] + padding_length)))];
+        for (i = 1; i < erasure_count; i++) {
+            poly_term = gf_mod(rs->gf, rs->primitive_element *
+                                           (rs->gf->field_size - 1 - (erasure_positions[i] + padding_length)));
+            for (j = i + 1; j > 0; j--) {
+                temp_value = rs->gf->exp2log[buffer->error_locator[j - 1]];
+                if (temp_value != rs->gf->field_size) {
+                    buffer->error_locator[j] ^= gf_exp(rs->gf, poly_term + temp_value);
                 }
             }
-
-            syndrome_vec = _mm256_loadu_si256((__m256i *)&syndrome[i]);
-            result_vec = _mm256_loadu_si256((__m256i *)result);
-            _mm256_storeu_si256((__m256i *)&syndrome[i], result_vec);
         }
+    }
 
-        for (i = num_roots_aligned; i < rs->num_roots; i++) {
-            if (syndrome[i] == 0) {
-                syndrome[i] = data_val;
-            } else {
-                syndrome[i] =
-                    data_val ^
-                    rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i]] +
-                                                       (rs->first_consecutive_root + i) * rs->primitive_element)];
-            }
+    if (pprn->ctx.rs.decode_mode == PPRN_RS_DECODE_RIBM) {
+        ribm_solve(rs, buffer, syndrome_ptr, erasure_count);
+    } else {
+        bm_solve(rs, buffer, syndrome_ptr, erasure_count);
+    }
+
+    error_locator_degree = 0;
+
+    for (i = 0; i < rs->num_roots + 1; i++) {
+        buffer->error_locator[i] = rs->gf->exp2log[buffer->error_locator[i]];
+
+        if (buffer->error_locator[i] != rs->gf->field_size) {
+            error_locator_degree = i;
         }
     }
 
-    for (j = 0; j < rs->num_roots; j++) {
-        for (i = 0; i < rs->num_roots; i++) {
-            if (syndrome[i] == 0) {
-                syndrome[i] = parity[j] & ((uint16_t)rs->gf->field_size);
-            } else {
-                syndrome[i] =
-                    (parity[j] & ((uint16_t)rs->gf->field_size)) ^
-                    rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i]] +
-                                                       (rs->first_consecutive_root + i) * rs->primitive_element)];
-            }
+    if (error_locator_degree == 0) {
+        return false;
+    }
+
+    if (rs->gf->symbol_size > 8) {
+        error_count = poporon_kernel()->rs_chien_u16(rs, buffer->error_locator, error_locator_degree, padding_length,
+                                                     buffer->register_coefficients, buffer->error_roots,
+                                                     buffer->error_locations);
+    } else {
+        error_count = poporon_kernel()->rs_chien(rs, buffer->error_locator, error_locator_degree,
+                                                 pprn->ctx.rs.primitive_inverse, buffer->register_coefficients,
+                                                 buffer->error_roots, buffer->error_locations);
+    }
+
+    for (i = 0; i < error_count; i++) {
+        if ((int32_t)buffer->error_locations[i] < padding_length) {
+            return false;
         }
     }
 
-    for (i = 0; i < rs->num_roots; i++) {
-        syndrome_error_flag |= syndrome[i];
-        syndrome[i] = rs->gf->exp2log[syndrome[i]];
+    if (error_locator_degree != error_count) {
+        return false;
     }
 
-    return syndrome_error_flag != 0;
+    error_evaluator_degree = error_locator_degree - 1;
+    for (i = 0; i <= error_evaluator_degree; i++) {
+        temp_value = 0;
 
-#elif POPORON_USE_SIMD && (defined(POPORON_SIMD_NEON) || defined(POPORON_SIMD_WASM))
-    uint16_t syndrome_error_flag, data_val, result[8], k;
-    int16_t i, j, num_roots_aligned;
-#if defined(POPORON_SIMD_NEON)
-    uint16x8_t result_vec;
-#elif defined(POPORON_SIMD_WASM)
-    v128_t result_vec;
-#endif
+        for (j = i; j >= 0; j--) {
+            if ((syndrome_ptr[i - j] != rs->gf->field_size) && (buffer->error_locator[j] != rs->gf->field_size)) {
+                temp_value ^= gf_exp(rs->gf, syndrome_ptr[i - j] + buffer->error_locator[j]);
+            }
+        }
 
-    syndrome_error_flag = 0;
-    num_roots_aligned = (rs->num_roots) & ~7;
+        buffer->error_evaluator[i] = rs->gf->exp2log[temp_value];
+    }
 
-    for (i = 0; i < rs->num_roots; i++) {
-        syndrome[i] = data[0] & ((uint16_t)rs->gf->field_size);
+    denominator_degree =
+        (error_locator_degree < (rs->num_roots - 1) ? error_locator_degree : (rs->num_roots - 1)) & ~1;
+    *errors_corrected = forney_batch(rs, buffer, error_count, error_evaluator_degree, denominator_degree);
+
+    if (!syndrome_check(rs, buffer, error_count, syndrome_ptr)) {
+        return false;
     }
 
-    for (j = 1; j < size; j++) {
-        data_val = data[j] & ((uint16_t)rs->gf->field_size);
+    *error_count_out = error_count;
 
-        for (i = 0; i < num_roots_aligned; i += 8) {
-            for (k = 0; k < 8; k++) {
-                if (syndrome[i + k] == 0) {
-                    result[k] = data_val;
-                } else {
-                    result[k] =
-                        data_val ^
-                        rs->gf
-                            ->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i + k]] +
-                                                         (rs->first_consecutive_root + i + k) * rs->primitive_element)];
-                }
-            }
+    return true;
+}
+
+/* erasure decoding corrects the listed data positions, otherwise error locations cover data || parity */
+static inline bool apply_corrections_u8(const poporon_rs_t *rs, const decoder_buffer_t *buffer, uint16_t error_count,
+                                        uint8_t *data, size_t size, uint8_t *parity, const uint32_t *erasure_positions,
+                                        int32_t padding_length)
+{
+    int32_t location_with_padding;
+    uint16_t i;
 
-#if defined(POPORON_SIMD_NEON)
-            result_vec = vld1q_u16(result);
-            vst1q_u16(&syndrome[i], result_vec);
-#elif defined(POPORON_SIMD_WASM)
-            result_vec = wasm_v128_load(result);
-            wasm_v128_store(&syndrome[i], result_vec);
-#endif
+    for (i = 0; i < error_count; i++) {
+        if (erasure_positions) {
+            data[erasure_positions[i]] ^= (uint8_t)buffer->coefficients[i];
+            continue;
         }
 
-        for (i = num_roots_aligned; i < rs->num_roots; i++) {
-            if (syndrome[i] == 0) {
-                syndrome[i] = data_val;
-            } else {
-                syndrome[i] =
-                    data_val ^
-                    rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i]] +
-                                                       (rs->first_consecutive_root + i) * rs->primitive_element)];
-            }
+        location_with_padding = (int32_t)buffer->error_locations[i] - padding_length;
+        if (location_with_padding >= 0 && location_with_padding < (int32_t)size) {
+            data[location_with_padding] ^= (uint8_t)buffer->coefficients[i];
+        } else if (location_with_padding >= (int32_t)size && location_with_padding < (int32_t)(size + rs->num_roots)) {
+            parity[location_with_padding - size] ^= (uint8_t)buffer->coefficients[i];
+        } else {
+            return false;
         }
     }
 
-    for (j = 0; j < rs->num_roots; j++) {
-        for (i = 0; i < rs->num_roots; i++) {
-            if (syndrome[i] == 0) {
-                syndrome[i] = parity[j] & ((uint16_t)rs->gf->field_size);
-            } else {
-                syndrome[i] =
-                    (parity[j] & ((uint16_t)rs->gf->field_size)) ^
-                    rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i]] +
-                                                       (rs->first_consecutive_root + i) * rs->primitive_element)];
-            }
+    return true;
+}
+
+static inline bool apply_corrections_u16(const poporon_rs_t *rs, const decoder_buffer_t *buffer,
+                                         uint16_t error_count, uint16_t *data, size_t size, uint16_t *parity,
+                                         const uint32_t *erasure_positions, int32_t padding_length)
+{
+    int32_t location_with_padding;
+    uint16_t i;
+
+    for (i = 0; i < error_count; i++) {
+        if (erasure_positions) {
+            data[erasure_positions[i]] ^= buffer->coefficients[i];
+            continue;
         }
-    }
 
-    for (i = 0; i < rs->num_roots; i++) {
-        syndrome_error_flag |= syndrome[i];
-        syndrome[i] = rs->gf->exp2log[syndrome[i]];
+        location_with_padding = (int32_t)buffer->error_locations[i] - padding_length;
+        if (location_with_padding >= 0 && location_with_padding < (int32_t)size) {
+            data[location_with_padding] ^= buffer->coefficients[i];
+        } else if (location_with_padding >= (int32_t)size && location_with_padding < (int32_t)(size + rs->num_roots)) {
+            parity[location_with_padding - size] ^= buffer->coefficients[i];
+        } else {
+            return false;
+        }
     }
 
-    return syndrome_error_flag != 0;
+    return true;
+}
 
-#else
-    int16_t i, j;
-    uint16_t syndrome_error_flag = 0;
+/*
+ * The received word modulo g(x) takes the value of the word itself at every root of g(x). Re-encoding the received
+ * data and adding the received parity yields that remainder in remainder[1..num_roots], zero for a codeword; the
+ * syndrome kernels then evaluate it alone, remainder[0] = 0 standing in for the data. Returns true when non-zero.
+ */
+static inline bool remainder_u8(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                                uint8_t *remainder)
+{
+    uint8_t error_flag = 0;
+    uint16_t i;
 
-    for (i = 0; i < rs->num_roots; i++) {
-        syndrome[i] = data[0] & ((uint16_t)rs->gf->field_size);
+    poporon_rs_encode_parity(rs, data, size, &remainder[1]);
+    remainder[0] = 0;
+
+    for (i = 1; i <= rs->num_roots; i++) {
+        remainder[i] ^= parity[i - 1];
+        error_flag |= remainder[i];
     }
 
-    for (j = 1; j < size; j++) {
-        for (i = 0; i < rs->num_roots; i++) {
-            if (syndrome[i] == 0) {
-                syndrome[i] = data[j] & ((uint16_t)rs->gf->field_size);
-            } else {
-                syndrome[i] =
-                    (data[j] & ((uint16_t)rs->gf->field_size)) ^
-                    rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i]] +
-                                                       (rs->first_consecutive_root + i) * rs->primitive_element)];
-            }
-        }
+    return (error_flag & rs->gf->field_size) != 0;
+}
+
+static inline bool remainder_u16(const poporon_rs_t *rs, const uint16_t *data, size_t size, const uint16_t *parity,
+                                 uint16_t *remainder)
+{
+    uint16_t error_flag = 0, i;
+
+    poporon_kernel()->rs_encode_u16(rs, data, size, &remainder[1]);
+    remainder[0] = 0;
+
+    for (i = 1; i <= rs->num_roots; i++) {
+        remainder[i] ^= parity[i - 1];
+        error_flag |= remainder[i];
     }
 
-    for (j = 0; j < rs->num_roots; j++) {
-        for (i = 0; i < rs->num_roots; i++) {
-            if (syndrome[i] == 0) {
-                syndrome[i] = parity[j] & ((uint16_t)rs->gf->field_size);
-            } else {
-                syndrome[i] =
-                    (parity[j] & ((uint16_t)rs->gf->field_size)) ^
-                    rs->gf->log2exp[gf_mod(rs->gf, rs->gf->exp2log[syndrome[i]] +
-                                                       (rs->first_consecutive_root + i) * rs->primitive_element)];
-            }
+    return (error_flag & rs->gf->field_size) != 0;
+}
+
+static inline bool calculate_syndrome_u8(const poporon_t *pprn, const uint8_t *data, size_t size,
+                                         const uint8_t *parity, uint16_t *syndrome)
+{
+    poporon_rs_t *rs = pprn->ctx.rs.rs;
+    uint8_t remainder[UINT8_MAX + 1];
+
+    if (pprn->ctx.rs.syndrome_mode == PPRN_RS_SYNDROME_REMAINDER) {
+        if (!remainder_u8(rs, data, size, parity, remainder)) {
+            return false;
         }
+
+        data = remainder;
+        size = 1;
+        parity = &remainder[1];
     }
 
-    for (i = 0; i < rs->num_roots; i++) {
-        syndrome_error_flag |= syndrome[i];
-        syndrome[i] = rs->gf->exp2log[syndrome[i]];
+    if (rs->root_powers) {
+        return poporon_kernel()->rs_syndrome(rs, data, size, parity, syndrome);
     }
 
-    return syndrome_error_flag != 0;
-#endif
+    return poporon_rs_syndrome_scalar(rs, data, size, parity, syndrome);
 }
 
-static inline int16_t calculate_padding_length(poporon_rs_t *rs, size_t size)
+static inline bool calculate_syndrome_u16(const poporon_t *pprn, const uint16_t *data, size_t size,
+                                          const uint16_t *parity, uint16_t *syndrome)
 {
-    int16_t padding_length;
+    poporon_rs_t *rs = pprn->ctx.rs.rs;
+    uint16_t remainder[UINT8_MAX + 1];
+
+    if (pprn->ctx.rs.syndrome_mode == PPRN_RS_SYNDROME_REMAINDER && rs->feedback_split) {
+        if (!remainder_u16(rs, data, size, parity, remainder)) {
+            return false;
+        }
+
+        data = remainder;
+        size = 1;
+        parity = &remainder[1];
+    }
 
-    padding_length = rs->gf->field_size - rs->num_roots - size;
+    return poporon_kernel()->rs_syndrome_u16(rs, data, size, parity, syndrome);
+}
 
-    if (padding_length < 0 || padding_length >= rs->gf->field_size - rs->num_roots) {
+static inline int32_t calculate_padding_length(const poporon_rs_t *rs, size_t size)
+{
+    if (size == 0 || rs->num_roots >= rs->gf->field_size ||
+        size > (size_t)(rs->gf->field_size - rs->num_roots)) {
         return -1;
     }
 
-    return padding_length;
+    return (int32_t)(rs->gf->field_size - rs->num_roots - size);
 }
 
-static bool rs_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t *corrected_num)
+/*
+ * Error values of one codeword once its syndrome is known (has_errors), shared by the byte and 16-bit decoders. An
+ * external syndrome takes the place of the computed one and ignores erasures. *error_count stays 0 when there is
+ * nothing to correct.
+ */
+static inline bool rs_find_errors(const poporon_t *pprn, decoder_buffer_t *buffer, bool has_errors,
+                                  int32_t padding_length, const uint32_t **erasure_positions, uint16_t *error_count,
+                                  size_t *errors_corrected)
 {
     poporon_rs_t *rs = pprn->ctx.rs.rs;
-    poporon_erasure_t *eras;
-    decoder_buffer_t *buffer = pprn->ctx.rs.buffer;
-    uint16_t i, *syndrome;
-    int16_t padding_length;
-    size_t errors_corrected = 0;
-    bool success = false;
+    const uint16_t *syndrome = buffer->syndrome;
+    uint32_t erasure_count = 0;
+    uint16_t i;
 
-    padding_length = calculate_padding_length(rs, size);
-    if (padding_length < 0) {
-        goto finish;
-    }
+    *erasure_positions = NULL;
+    *error_count = 0;
 
     if (pprn->ctx.rs.ext_syndrome) {
         syndrome = pprn->ctx.rs.ext_syndrome;
-        bool has_errors = false;
         for (i = 0; i < rs->num_roots; i++) {
             if (syndrome[i] != rs->gf->field_size) {
                 has_errors = true;
                 break;
             }
         }
+    } else if (pprn->ctx.rs.erasure) {
+        erasure_count = pprn->ctx.rs.erasure->erasure_count;
+        *erasure_positions = pprn->ctx.rs.erasure->erasure_positions;
+    }
 
-        if (has_errors && !error_correction_u8(pprn, data, size, parity, syndrome, 0, NULL, NULL, padding_length,
-                                               &errors_corrected)) {
-            goto finish;
-        }
+    return !has_errors || error_correction(pprn, buffer, syndrome, erasure_count, *erasure_positions, padding_length,
+                                           error_count, errors_corrected);
+}
 
-        success = true;
+static bool rs_decode(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                      uint8_t *parity, size_t *corrected_num)
+{
+    poporon_rs_t *rs = pprn->ctx.rs.rs;
+    decoder_buffer_t *buffer = workspace->ctx.rs.buffer;
+    const uint32_t *erasure_positions;
+    uint16_t error_count;
+    int32_t padding_length;
+    size_t errors_corrected = 0;
+    bool has_errors, success = false;
 
+    /* wider symbols go through poporon_decode_u16() */
+    padding_length = calculate_padding_length(rs, size);
+    if (padding_length < 0 || rs->gf->symbol_size > 8) {
         goto finish;
     }
 
-    if (pprn->ctx.rs.erasure) {
-        eras = pprn->ctx.rs.erasure;
-        success = !calculate_syndrome_u8(pprn, data, size, parity, buffer->syndrome) ||
-                  error_correction_u8(pprn, data, size, parity, buffer->syndrome, eras->erasure_count,
-                                      eras->erasure_positions, eras->corrections, padding_length, &errors_corrected);
+    has_errors = !pprn->ctx.rs.ext_syndrome && calculate_syndrome_u8(pprn, data, size, parity, buffer->syndrome);
+    success = rs_find_errors(pprn, buffer, has_errors, padding_length, &erasure_positions, &error_count,
+                             &errors_corrected) &&
+              apply_corrections_u8(rs, buffer, error_count, data, size, parity, erasure_positions, padding_length);
 
+finish:
+    workspace->ctx.rs.last_corrected = errors_corrected;
+
+    if (corrected_num) {
+        *corrected_num = errors_corrected;
+    }
+
+    return success;
+}
+
+static bool rs_decode_u16(const poporon_t *pprn, poporon_workspace_t *workspace, uint16_t *data, size_t size,
+                          uint16_t *parity, size_t *corrected_num)
+{
+    poporon_rs_t *rs = pprn->ctx.rs.rs;
+    decoder_buffer_t *buffer = workspace->ctx.rs.buffer;
+    const uint32_t *erasure_positions;
+    uint16_t error_count;
+    int32_t padding_length;
+    size_t errors_corrected = 0;
+    bool has_errors, success = false;
+
+    padding_length = calculate_padding_length(rs, size);
+    if (padding_length < 0 || !rs->root_splits) {
         goto finish;
     }
 
-    success = !calculate_syndrome_u8(pprn, data, size, parity, buffer->syndrome) ||
-              error_correction_u8(pprn, data, size, parity, buffer->syndrome, 0, NULL, NULL, padding_length,
-                                  &errors_corrected);
+    has_errors = !pprn->ctx.rs.ext_syndrome && calculate_syndrome_u16(pprn, data, size, parity, buffer->syndrome);
+    success = rs_find_errors(pprn, buffer, has_errors, padding_length, &erasure_positions, &error_count,
+                             &errors_corrected) &&
+              apply_corrections_u16(rs, buffer, error_count, data, size, parity, erasure_positions, padding_length);
 
 finish:
-    pprn->ctx.rs.last_corrected = errors_corrected;
+    workspace->ctx.rs.last_corrected = errors_corrected;
 
     if (corrected_num) {
         *corrected_num = errors_corrected;
@@ -486,9 +743,11 @@ finish:
     return success;
 }
 
-static bool ldpc_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t *corrected_num)
+static bool ldpc_decode(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                        uint8_t *parity, size_t *corrected_num)
 {
     poporon_ldpc_t *ldpc = pprn->ctx.ldpc.ldpc;
+    poporon_ldpc_workspace_t *scratch = workspace->ctx.ldpc.ldpc;
     uint32_t iterations_used = 0;
     uint8_t *codeword, *temp;
     size_t i;
@@ -498,32 +757,29 @@ static bool ldpc_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *pa
         return false;
     }
 
-    if (ldpc->config.use_inner_interleave && ldpc->temp_interleaved) {
-        codeword = ldpc->temp_interleaved;
+    if (ldpc->config.use_inner_interleave) {
+        codeword = scratch->temp_interleaved;
     } else {
-        codeword = ldpc->temp_codeword;
+        codeword = scratch->temp_codeword;
     }
     pmemcpy(codeword, data, ldpc->info_bytes);
     pmemcpy(codeword + ldpc->info_bytes, parity, ldpc->parity_bytes);
 
     if (pprn->ctx.ldpc.use_soft_decode && pprn->ctx.ldpc.soft_llr) {
-        ok = poporon_ldpc_decode_soft(ldpc, pprn->ctx.ldpc.soft_llr, codeword, pprn->ctx.ldpc.max_iterations,
+        ok = poporon_ldpc_decode_soft(ldpc, scratch, pprn->ctx.ldpc.soft_llr, codeword, pprn->ctx.ldpc.max_iterations,
                                       &iterations_used);
     } else {
-        ok = poporon_ldpc_decode_hard(ldpc, codeword, pprn->ctx.ldpc.max_iterations, &iterations_used);
+        ok = poporon_ldpc_decode_hard(ldpc, scratch, codeword, pprn->ctx.ldpc.max_iterations, &iterations_used);
     }
 
-    pprn->ctx.ldpc.last_iterations = iterations_used;
+    workspace->ctx.ldpc.last_iterations = iterations_used;
 
     if (!ok) {
         return false;
     }
 
     if (ldpc->config.use_outer_interleave && ldpc->outer_interleaver.inverse) {
-        temp = ldpc->temp_outer;
-        if (!temp) {
-            return false;
-        }
+        temp = scratch->temp_outer;
         for (i = 0; i < ldpc->info_bytes; i++) {
             temp[ldpc->outer_interleaver.inverse[i]] = codeword[i];
         }
@@ -539,16 +795,15 @@ static bool ldpc_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *pa
     return true;
 }
 
-static bool bch_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t *corrected_num)
+/* data then parity bytes, each big-endian, packed into one received word with the parity bits lowest */
+static inline bool bch_received(const poporon_bch_t *bch, const uint8_t *data, size_t size, const uint8_t *parity,
+                                uint32_t *received)
 {
-    poporon_bch_t *bch = pprn->ctx.bch.bch;
-    uint32_t data_val = 0, parity_val = 0, received = 0, corrected = 0, corrected_data;
-    uint16_t i, data_len, codeword_len, parity_bits, data_bytes, parity_bytes_len;
-    int32_t num_errors = 0;
+    uint32_t data_val = 0, parity_val = 0;
+    uint16_t i, data_len, parity_bits, data_bytes, parity_bytes_len;
 
     data_len = poporon_bch_get_data_length(bch);
-    codeword_len = poporon_bch_get_codeword_length(bch);
-    parity_bits = codeword_len - data_len;
+    parity_bits = poporon_bch_get_codeword_length(bch) - data_len;
     data_bytes = (data_len + 7) / 8;
     parity_bytes_len = (parity_bits + 7) / 8;
 
@@ -572,15 +827,31 @@ static bool bch_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *par
         parity_val &= ((uint32_t)1 << parity_bits) - 1;
     }
 
-    received = (data_val << parity_bits) | parity_val;
+    *received = (data_val << parity_bits) | parity_val;
+
+    return true;
+}
+
+static bool bch_decode(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                       uint8_t *parity, size_t *corrected_num)
+{
+    poporon_bch_t *bch = pprn->ctx.bch.bch;
+    uint32_t received = 0, corrected = 0, corrected_data;
+    uint16_t i, data_bytes;
+    int32_t num_errors = 0;
+
+    if (!bch_received(bch, data, size, parity, &received)) {
+        return false;
+    }
 
     if (!poporon_bch_decode(bch, received, &corrected, &num_errors)) {
-        pprn->ctx.bch.last_num_errors = -1;
+        workspace->ctx.bch.last_num_errors = -1;
         return false;
     }
 
-    pprn->ctx.bch.last_num_errors = num_errors;
+    workspace->ctx.bch.last_num_errors = num_errors;
 
+    data_bytes = (poporon_bch_get_data_length(bch) + 7) / 8;
     corrected_data = poporon_bch_extract_data(bch, corrected);
     for (i = 0; i < data_bytes && i < 4; i++) {
         data[data_bytes - 1 - i] = (uint8_t)(corrected_data >> (8 * i));
@@ -593,20 +864,339 @@ static bool bch_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *par
     return true;
 }
 
-extern bool poporon_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t *corrected_num)
+/* the verify-only counterparts read data and parity and nothing else, their scratch lives on the stack */
+static bool rs_check(const poporon_t *pprn, const uint8_t *data, size_t size, const uint8_t *parity)
 {
-    if (!pprn || !data || !parity || !size) {
+    poporon_rs_t *rs = pprn->ctx.rs.rs;
+    uint16_t syndrome[UINT8_MAX + 1];
+    uint8_t remainder[UINT8_MAX + 1];
+
+    if (calculate_padding_length(rs, size) < 0 || rs->gf->symbol_size > 8) {
         return false;
     }
 
+    /* a zero remainder decides it without evaluating the syndrome */
+    if (pprn->ctx.rs.syndrome_mode == PPRN_RS_SYNDROME_REMAINDER) {
+        return !remainder_u8(rs, data, size, parity, remainder);
+    }
+
+    return !calculate_syndrome_u8(pprn, data, size, parity, syndrome);
+}
+
+static bool ldpc_check(const poporon_t *pprn, const uint8_t *data, size_t size, const uint8_t *parity)
+{
+    if (size != pprn->ctx.ldpc.ldpc->info_bytes) {
+        return false;
+    }
+
+    return poporon_ldpc_check_split(pprn->ctx.ldpc.ldpc, data, parity);
+}
+
+static bool bch_check(const poporon_t *pprn, const uint8_t *data, size_t size, const uint8_t *parity)
+{
+    uint32_t received;
+
+    return bch_received(pprn->ctx.bch.bch, data, size, parity, &received) &&
+           poporon_bch_check(pprn->ctx.bch.bch, received);
+}
+
+typedef bool (*check_func_t)(const poporon_t *pprn, const uint8_t *data, size_t size, const uint8_t *parity);
+
+static inline check_func_t select_checker(const poporon_t *pprn)
+{
     switch (pprn->fec_type) {
     case PPLN_FEC_RS:
-        return rs_decode(pprn, data, size, parity, corrected_num);
+        return rs_check;
     case PPLN_FEC_LDPC:
-        return ldpc_decode(pprn, data, size, parity, corrected_num);
+        return ldpc_check;
     case PPLN_FEC_BCH:
-        return bch_decode(pprn, data, size, parity, corrected_num);
+        return bch_check;
     default:
+        return NULL;
+    }
+}
+
+typedef bool (*decode_func_t)(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                              uint8_t *parity, size_t *corrected_num);
+
+static inline decode_func_t select_decoder(const poporon_t *pprn)
+{
+    switch (pprn->fec_type) {
+    case PPLN_FEC_RS:
+        return rs_decode;
+    case PPLN_FEC_LDPC:
+        return ldpc_decode;
+    case PPLN_FEC_BCH:
+        return bch_decode;
+    default:
+        return NULL;
+    }
+}
+
+static bool decode_batch(poporon_t *pprn, const batch_layout_t *layout, size_t size, size_t count, bool *results,
+                         size_t *corrected_num)
+{
+    decode_func_t decoder;
+    uint8_t *data, *parity;
+    size_t i, corrected;
+    bool ok, all_ok = true;
+
+    decoder = select_decoder(pprn);
+    if (!decoder || !size) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        data = batch_data(layout, i);
+        parity = batch_parity(layout, i);
+        corrected = 0;
+        ok = data && parity && decoder(pprn, pprn->workspace, data, size, parity, &corrected);
+        all_ok &= ok;
+
+        if (results) {
+            results[i] = ok;
+        }
+
+        if (corrected_num) {
+            corrected_num[i] = corrected;
+        }
+    }
+
+    return all_ok;
+}
+
+extern bool poporon_decode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t *corrected_num)
+{
+    if (!pprn) {
+        return false;
+    }
+
+    return poporon_decode_with_workspace(pprn, pprn->workspace, data, size, parity, corrected_num);
+}
+
+extern bool poporon_decode_with_workspace(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data,
+                                          size_t size, uint8_t *parity, size_t *corrected_num)
+{
+    decode_func_t decoder;
+
+    if (!pprn || !data || !parity || !size || !poporon_workspace_fits(pprn, workspace)) {
+        return false;
+    }
+
+    decoder = select_decoder(pprn);
+
+    return decoder && decoder(pprn, workspace, data, size, parity, corrected_num);
+}
+
+extern bool poporon_decode_u16(poporon_t *pprn, uint16_t *data, size_t size, uint16_t *parity, size_t *corrected_num)
+{
+    if (!pprn) {
+        return false;
+    }
+
+    return poporon_decode_u16_with_workspace(pprn, pprn->workspace, data, size, parity, corrected_num);
+}
+
+extern bool poporon_decode_u16_with_workspace(const poporon_t *pprn, poporon_workspace_t *workspace, uint16_t *data,
+                                              size_t size, uint16_t *parity, size_t *corrected_num)
+{
+    if (!pprn || !data || !parity || !size || pprn->fec_type != PPLN_FEC_RS ||
+        !poporon_workspace_fits(pprn, workspace)) {
+        return false;
+    }
+
+    return rs_decode_u16(pprn, workspace, data, size, parity, corrected_num);
+}
+
+extern bool poporon_check(const poporon_t *pprn, const uint8_t *data, size_t size, const uint8_t *parity)
+{
+    check_func_t checker;
+
+    if (!pprn || !data || !parity) {
+        return false;
+    }
+
+    checker = select_checker(pprn);
+
+    return checker && checker(pprn, data, size, parity);
+}
+
+extern bool poporon_check_u16(const poporon_t *pprn, const uint16_t *data, size_t size, const uint16_t *parity)
+{
+    poporon_rs_t *rs;
+    uint16_t syndrome[UINT8_MAX + 1], remainder[UINT8_MAX + 1];
+
+    if (!pprn || !data || !parity || pprn->fec_type != PPLN_FEC_RS) {
+        return false;
+    }
+
+    rs = pprn->ctx.rs.rs;
+    if (calculate_padding_length(rs, size) < 0 || !rs->root_splits) {
         return false;
     }
+
+    if (pprn->ctx.rs.syndrome_mode == PPRN_RS_SYNDROME_REMAINDER && rs->feedback_split) {
+        return !remainder_u16(rs, data, size, parity, remainder);
+    }
+
+    return !calculate_syndrome_u16(pprn, data, size, parity, syndrome);
+}
+
+extern bool poporon_check_batch(const poporon_t *pprn, const uint8_t *const *data, size_t size,
+                                const uint8_t *const *parity, size_t count, bool *results)
+{
+    check_func_t checker;
+    size_t i;
+    bool ok, all_ok = true;
+
+    if (!pprn || !data || !parity) {
+        return false;
+    }
+
+    checker = select_checker(pprn);
+    if (!checker) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        ok = data[i] && parity[i] && checker(pprn, data[i], size, parity[i]);
+        all_ok &= ok;
+
+        if (results) {
+            results[i] = ok;
+        }
+    }
+
+    return all_ok;
+}
+
+extern bool poporon_decode_batch(poporon_t *pprn, uint8_t *const *data, size_t size, uint8_t *const *parity,
+                                 size_t count, bool *results, size_t *corrected_num)
+{
+    batch_layout_t layout = {data, parity, NULL, NULL, 0, 0};
+
+    if (!pprn || !data || !parity) {
+        return false;
+    }
+
+    return decode_batch(pprn, &layout, size, count, results, corrected_num);
+}
+
+extern bool poporon_decode_strided(poporon_t *pprn, uint8_t *data, size_t data_stride, size_t size, uint8_t *parity,
+                                   size_t parity_stride, size_t count, bool *results, size_t *corrected_num)
+{
+    batch_layout_t layout = {NULL, NULL, data, parity, data_stride, parity_stride};
+
+    if (!pprn || !data || !parity || !batch_strides_valid(pprn, data_stride, size, parity_stride, count)) {
+        return false;
+    }
+
+    return decode_batch(pprn, &layout, size, count, results, corrected_num);
+}
+
+/*
+ * Syndromes of every codeword come from one interleaved kernel pass, only the codewords with a non-zero syndrome
+ * are gathered out of the batch for correction and written back.
+ */
+extern bool poporon_decode_interleaved(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity, size_t count,
+                                       bool *results, size_t *corrected_num)
+{
+    poporon_rs_t *rs;
+    poporon_workspace_t *workspace;
+    decoder_buffer_t *buffer;
+    uint8_t *syndromes, codeword[RS_STAGED_CODEWORD_SIZE], check[RS_STAGED_CODEWORD_SIZE], error_flag;
+    const uint32_t *erasure_positions;
+    size_t lane, i, corrected, total_corrected = 0;
+    uint16_t error_count;
+    int32_t padding_length;
+    bool ok, all_ok = true;
+
+    if (!pprn || !data || !parity || pprn->fec_type != PPLN_FEC_RS) {
+        return false;
+    }
+
+    /* erasures and external syndromes describe a single codeword */
+    if (pprn->ctx.rs.erasure || pprn->ctx.rs.ext_syndrome) {
+        return false;
+    }
+
+    rs = pprn->ctx.rs.rs;
+    workspace = pprn->workspace;
+    buffer = workspace->ctx.rs.buffer;
+    padding_length = calculate_padding_length(rs, size);
+    if (padding_length < 0 || rs->gf->symbol_size > 8) {
+        return false;
+    }
+
+    if (count == 0) {
+        return true;
+    }
+
+    if (workspace->ctx.rs.lane_syndromes_size < (size_t)rs->num_roots * count) {
+        syndromes = (uint8_t *)prealloc(workspace->ctx.rs.lane_syndromes, (size_t)rs->num_roots * count);
+        if (!syndromes) {
+            return false;
+        }
+
+        workspace->ctx.rs.lane_syndromes = syndromes;
+        workspace->ctx.rs.lane_syndromes_size = (size_t)rs->num_roots * count;
+    }
+
+    syndromes = workspace->ctx.rs.lane_syndromes;
+
+    if (rs->root_powers) {
+        poporon_kernel()->rs_syndrome_interleaved(rs, data, size, parity, count, count, syndromes);
+    } else {
+        poporon_rs_syndrome_interleaved_scalar(rs, data, size, parity, count, count, syndromes);
+    }
+
+    for (lane = 0; lane < count; lane++) {
+        error_flag = 0;
+        for (i = 0; i < rs->num_roots; i++) {
+            error_flag |= syndromes[i * count + lane];
+        }
+
+        ok = true;
+        corrected = 0;
+
+        if (error_flag) {
+            for (i = 0; i < rs->num_roots; i++) {
+                buffer->syndrome[i] = rs->gf->exp2log[syndromes[i * count + lane]];
+                check[i] = parity[i * count + lane];
+            }
+            for (i = 0; i < size; i++) {
+                codeword[i] = data[i * count + lane];
+            }
+
+            ok = rs_find_errors(pprn, buffer, true, padding_length, &erasure_positions, &error_count, &corrected) &&
+                 apply_corrections_u8(rs, buffer, error_count, codeword, size, check, NULL, padding_length);
+
+            if (ok) {
+                for (i = 0; i < rs->num_roots; i++) {
+                    parity[i * count + lane] = check[i];
+                }
+                for (i = 0; i < size; i++) {
+                    data[i * count + lane] = codeword[i];
+                }
+            } else {
+                corrected = 0;
+            }
+        }
+
+        all_ok &= ok;
+        total_corrected += corrected;
+
+        if (results) {
+            results[lane] = ok;
+        }
+
+        if (corrected_num) {
+            corrected_num[lane] = corrected;
+        }
+    }
+
+    /* summed over every lane, corrected_num[] has the per codeword counts */
+    workspace->ctx.rs.last_corrected = total_corrected;
+
+    return all_ok;
 }
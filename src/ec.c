@@ -0,0 +1,1087 @@
+/*
+ * libpoporon - ec.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/common.h"
+#include "internal/kernel.h"
+#include "internal/thread.h"
+
+#define EC_SYMBOL_SIZE   8
+#define EC_POLYNOMIAL    0x11D /* x^8 + x^4 + x^3 + x^2 + 1 */
+#define EC_XOR_FUSE      4     /* XOR sources folded into one pass over a packet */
+#define EC_PATTERN_WORDS (POPORON_EC_MAX_SHARDS / 64)
+
+/* which shards a reconstruction reads and rebuilds, from present[] */
+typedef struct {
+    uint64_t lost[EC_PATTERN_WORDS];      /* bitmap of the missing shards, the cache key */
+    uint16_t rows[POPORON_EC_MAX_SHARDS]; /* the first data_shards present shards */
+    uint16_t missing_data[POPORON_EC_MAX_SHARDS];
+    uint16_t missing_parity[POPORON_EC_MAX_SHARDS];
+    uint16_t num_rows;
+    uint16_t num_missing_data;
+    uint16_t num_missing_parity;
+} ec_pattern_t;
+
+typedef struct _ec_plan_t ec_plan_t;
+
+/* everything a reconstruction derives from its pattern alone */
+struct _ec_plan_t {
+    ec_plan_t *prev;
+    ec_plan_t *next;
+    size_t refcount; /* one while cached, one per reconstruction using it */
+    uint64_t lost[EC_PATTERN_WORDS];
+    uint8_t *inverse;              /* [data_shards][data_shards], NULL when no data shard is lost */
+    ec_schedule_t data_schedule;   /* PPRN_EC_CAUCHY_XOR, the inverse rows of the lost data shards */
+    ec_schedule_t parity_schedule; /* PPRN_EC_CAUCHY_XOR, the generator rows of the lost parity shards */
+};
+
+struct _ec_cache_t {
+    pmutex_t lock;   /* guards everything below and the plan refcounts */
+    ec_plan_t *head; /* most recently used first */
+    ec_plan_t *tail;
+    size_t size;
+    size_t capacity;
+    uint64_t hits;
+    uint64_t misses;
+};
+
+/* Gauss-Jordan elimination of the size x size matrix, destroyed on the way, into inverse */
+static inline bool ec_invert(const poporon_gf_t *gf, uint8_t *matrix, uint8_t *inverse, uint16_t size)
+{
+    uint8_t *row, *pivot_row, scale, factor, swap;
+    uint16_t column, pivot, r, j;
+
+    pmemset(inverse, 0, (size_t)size * size);
+    for (r = 0; r < size; r++) {
+        inverse[(size_t)r * size + r] = 1;
+    }
+
+    for (column = 0; column < size; column++) {
+        for (pivot = column; pivot < size && matrix[(size_t)pivot * size + column] == 0; pivot++) {
+        }
+
+        if (pivot == size) {
+            return false;
+        }
+
+        if (pivot != column) {
+            for (j = 0; j < size; j++) {
+                swap = matrix[(size_t)pivot * size + j];
+                matrix[(size_t)pivot * size + j] = matrix[(size_t)column * size + j];
+                matrix[(size_t)column * size + j] = swap;
+
+                swap = inverse[(size_t)pivot * size + j];
+                inverse[(size_t)pivot * size + j] = inverse[(size_t)column * size + j];
+                inverse[(size_t)column * size + j] = swap;
+            }
+        }
+
+        pivot_row = &matrix[(size_t)column * size];
+        scale = (uint8_t)gf_inv(gf, pivot_row[column]);
+        for (j = 0; j < size; j++) {
+            pivot_row[j] = (uint8_t)gf_mul(gf, pivot_row[j], scale);
+            inverse[(size_t)column * size + j] = (uint8_t)gf_mul(gf, inverse[(size_t)column * size + j], scale);
+        }
+
+        for (r = 0; r < size; r++) {
+            row = &matrix[(size_t)r * size];
+            factor = row[column];
+            if (r == column || factor == 0) {
+                continue;
+            }
+
+            for (j = 0; j < size; j++) {
+                row[j] ^= (uint8_t)gf_mul(gf, pivot_row[j], factor);
+                inverse[(size_t)r * size + j] ^= (uint8_t)gf_mul(gf, inverse[(size_t)column * size + j], factor);
+            }
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Rows x^0 .. x^(k-1) at the points 0 .. k+m-1 times the inverse of the top k rows. Any k rows of a Vandermonde matrix
+ * with distinct points are independent and the product keeps that, while the top turns into the identity.
+ */
+static inline bool ec_build_vandermonde(poporon_ec_t *ec)
+{
+    uint8_t *vandermonde, *top_inverse, *row, *parity_row;
+    uint16_t k, rows, i, j, l;
+    uint8_t value;
+    bool ok;
+
+    k = ec->data_shards;
+    rows = (uint16_t)(ec->data_shards + ec->parity_shards);
+
+    vandermonde = (uint8_t *)pmalloc((size_t)rows * k);
+    top_inverse = (uint8_t *)pmalloc((size_t)k * k);
+    ok = vandermonde && top_inverse;
+
+    if (ok) {
+        for (i = 0; i < rows; i++) {
+            row = &vandermonde[(size_t)i * k];
+            row[0] = 1;
+            for (j = 1; j < k; j++) {
+                row[j] = (uint8_t)gf_mul(ec->gf, row[j - 1], (uint8_t)i);
+            }
+        }
+
+        /* the parity rows stay intact, only the top square is eliminated */
+        ok = ec_invert(ec->gf, vandermonde, top_inverse, k);
+    }
+
+    for (i = 0; ok && i < ec->parity_shards; i++) {
+        row = &vandermonde[(size_t)(k + i) * k];
+        parity_row = &ec->parity_matrix[(size_t)i * k];
+
+        for (j = 0; j < k; j++) {
+            value = 0;
+            for (l = 0; l < k; l++) {
+                value ^= (uint8_t)gf_mul(ec->gf, row[l], top_inverse[(size_t)l * k + j]);
+            }
+            parity_row[j] = value;
+        }
+    }
+
+    if (vandermonde) {
+        pfree(vandermonde);
+    }
+
+    if (top_inverse) {
+        pfree(top_inverse);
+    }
+
+    return ok;
+}
+
+/* 1 / (x_i + y_j) with x_i = k + i and y_j = j, every square submatrix of a Cauchy matrix is invertible */
+static inline void ec_build_cauchy(poporon_ec_t *ec)
+{
+    uint16_t i, j;
+
+    for (i = 0; i < ec->parity_shards; i++) {
+        for (j = 0; j < ec->data_shards; j++) {
+            ec->parity_matrix[(size_t)i * ec->data_shards + j] =
+                (uint8_t)gf_inv(ec->gf, (uint16_t)((ec->data_shards + i) ^ j));
+        }
+    }
+}
+
+static inline uint32_t ec_popcount(uint64_t value)
+{
+    value = value - ((value >> 1) & 0x5555555555555555ULL);
+    value = (value & 0x3333333333333333ULL) + ((value >> 2) & 0x3333333333333333ULL);
+    value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+
+    return (uint32_t)((value * 0x0101010101010101ULL) >> 56);
+}
+
+/* ones in the 8x8 bit matrix of e, the XORs it costs */
+static inline uint32_t ec_bit_weight(const poporon_gf_t *gf, uint8_t e)
+{
+    uint32_t weight;
+    uint8_t c;
+
+    weight = 0;
+    for (c = 0; c < 8; c++) {
+        weight += ec_popcount(gf_mul(gf, e, (uint16_t)(1U << c)));
+    }
+
+    return weight;
+}
+
+/*
+ * Scaling a row or a column of a Cauchy matrix keeps every square submatrix invertible, so the bit matrices are made
+ * sparse: the columns are divided by the first row, which turns it into ones (identity blocks), then every other row
+ * is divided by whichever of its elements leaves the fewest ones.
+ */
+static inline void ec_thin_cauchy(poporon_ec_t *ec)
+{
+    uint32_t weights[UINT8_MAX + 1], weight, best_weight;
+    uint8_t *row, divisor, best_divisor;
+    uint16_t k, i, j, l;
+
+    k = ec->data_shards;
+
+    weights[0] = 0;
+    for (j = 1; j <= UINT8_MAX; j++) {
+        weights[j] = ec_bit_weight(ec->gf, (uint8_t)j);
+    }
+
+    for (j = 0; j < k; j++) {
+        divisor = (uint8_t)gf_inv(ec->gf, ec->parity_matrix[j]);
+        for (i = 0; i < ec->parity_shards; i++) {
+            ec->parity_matrix[(size_t)i * k + j] = (uint8_t)gf_mul(ec->gf, ec->parity_matrix[(size_t)i * k + j],
+                                                                   divisor);
+        }
+    }
+
+    for (i = 1; i < ec->parity_shards; i++) {
+        row = &ec->parity_matrix[(size_t)i * k];
+        best_divisor = 1;
+        best_weight = UINT32_MAX;
+
+        for (l = 0; l < k; l++) {
+            divisor = (uint8_t)gf_inv(ec->gf, row[l]);
+            weight = 0;
+            for (j = 0; j < k; j++) {
+                weight += weights[gf_mul(ec->gf, row[j], divisor)];
+            }
+
+            if (weight < best_weight) {
+                best_weight = weight;
+                best_divisor = divisor;
+            }
+        }
+
+        for (j = 0; j < k; j++) {
+            row[j] = (uint8_t)gf_mul(ec->gf, row[j], best_divisor);
+        }
+    }
+}
+
+/*
+ * XOR schedule computing the rows x 8 output packets of the GF rows x cols matrix from cols x 8 input packets. Bit
+ * (r, c) of an element e is bit r of e * x^c, the GF(2) matrix of multiplying by e. Every output starts either from
+ * its inputs or from a copy of an output already computed plus the bits where the two differ, whichever is cheaper,
+ * taking the cheapest remaining output first (the minimum spanning tree of the output rows).
+ */
+static inline bool ec_schedule_build(const poporon_gf_t *gf, const uint8_t *matrix, uint16_t rows, uint16_t cols,
+                                     ec_schedule_t *schedule)
+{
+    uint64_t *bits, *row, *base, difference;
+    uint32_t *cost, distance;
+    uint16_t *from, num_rows, num_cols, i, j, r, c;
+    size_t words, capacity, w;
+    ec_op_t *ops;
+    uint8_t product;
+    bool *done, first;
+
+    num_rows = (uint16_t)(rows * 8);
+    num_cols = (uint16_t)(cols * 8);
+    words = ((size_t)num_cols + 63) / 64;
+    capacity = (size_t)num_rows * (num_cols + 1);
+
+    schedule->ops = NULL;
+    schedule->count = 0;
+
+    bits = (uint64_t *)pcalloc((size_t)num_rows * words, sizeof(uint64_t));
+    cost = (uint32_t *)pmalloc(num_rows * sizeof(uint32_t));
+    from = (uint16_t *)pmalloc(num_rows * sizeof(uint16_t));
+    done = (bool *)pcalloc(num_rows, sizeof(bool));
+    ops = (ec_op_t *)pmalloc(capacity * sizeof(ec_op_t));
+
+    if (bits && cost && from && done && ops) {
+        for (i = 0; i < rows; i++) {
+            for (j = 0; j < cols; j++) {
+                for (c = 0; c < 8; c++) {
+                    product = (uint8_t)gf_mul(gf, matrix[(size_t)i * cols + j], (uint16_t)(1U << c));
+                    for (r = 0; r < 8; r++) {
+                        if (product & (1U << r)) {
+                            bits[(size_t)(i * 8 + r) * words + (j * 8 + c) / 64] |= 1ULL << ((j * 8 + c) % 64);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (i = 0; i < num_rows; i++) {
+            cost[i] = 0;
+            for (w = 0; w < words; w++) {
+                cost[i] += ec_popcount(bits[(size_t)i * words + w]);
+            }
+            from[i] = UINT16_MAX;
+        }
+
+        for (;;) {
+            i = UINT16_MAX;
+            for (j = 0; j < num_rows; j++) {
+                if (!done[j] && (i == UINT16_MAX || cost[j] < cost[i])) {
+                    i = j;
+                }
+            }
+
+            if (i == UINT16_MAX) {
+                break;
+            }
+
+            row = &bits[(size_t)i * words];
+            base = (from[i] == UINT16_MAX) ? NULL : &bits[(size_t)from[i] * words];
+            first = base == NULL;
+
+            if (base) {
+                ops[schedule->count].target = i;
+                ops[schedule->count].source = from[i];
+                ops[schedule->count].kind = EC_OP_COPY_TARGET;
+                schedule->count++;
+            }
+
+            for (w = 0; w < words; w++) {
+                difference = row[w] ^ (base ? base[w] : 0);
+                for (c = 0; difference; c++, difference >>= 1) {
+                    if (difference & 1) {
+                        ops[schedule->count].target = i;
+                        ops[schedule->count].source = (uint16_t)(w * 64 + c);
+                        ops[schedule->count].kind = first ? EC_OP_COPY : EC_OP_XOR;
+                        schedule->count++;
+                        first = false;
+                    }
+                }
+            }
+
+            if (first) {
+                ops[schedule->count].target = i;
+                ops[schedule->count].source = 0;
+                ops[schedule->count].kind = EC_OP_ZERO;
+                schedule->count++;
+            }
+
+            done[i] = true;
+
+            for (j = 0; j < num_rows; j++) {
+                if (done[j]) {
+                    continue;
+                }
+
+                distance = 1;
+                for (w = 0; w < words; w++) {
+                    distance += ec_popcount(row[w] ^ bits[(size_t)j * words + w]);
+                }
+
+                if (distance < cost[j]) {
+                    cost[j] = distance;
+                    from[j] = i;
+                }
+            }
+        }
+
+        /* ops reserved the worst case, keep only what was used */
+        schedule->ops = (ec_op_t *)pmalloc(schedule->count * sizeof(ec_op_t));
+        if (schedule->ops) {
+            pmemcpy(schedule->ops, ops, schedule->count * sizeof(ec_op_t));
+        }
+    }
+
+    if (bits) {
+        pfree(bits);
+    }
+
+    if (cost) {
+        pfree(cost);
+    }
+
+    if (from) {
+        pfree(from);
+    }
+
+    if (done) {
+        pfree(done);
+    }
+
+    if (ops) {
+        pfree(ops);
+    }
+
+    return schedule->ops != NULL;
+}
+
+static inline void ec_schedule_free(ec_schedule_t *schedule)
+{
+    if (schedule->ops) {
+        pfree(schedule->ops);
+    }
+
+    schedule->ops = NULL;
+    schedule->count = 0;
+}
+
+static inline uint64_t ec_load(const uint8_t *src)
+{
+    uint64_t value;
+
+    pmemcpy(&value, src, sizeof(uint64_t));
+
+    return value;
+}
+
+static inline void ec_store(uint8_t *dst, uint64_t value)
+{
+    pmemcpy(dst, &value, sizeof(uint64_t));
+}
+
+/* dst = base ^ sources[0] ^ ... for 1 to EC_XOR_FUSE sources, one pass over dst however many sources */
+static inline void ec_xor_packets(uint8_t *dst, const uint8_t *base, const uint8_t *const *sources, size_t count,
+                                  size_t size)
+{
+    const uint8_t *a, *b, *c, *d;
+    size_t i;
+
+    a = sources[0];
+    b = sources[count > 1 ? 1 : 0];
+    c = sources[count > 2 ? 2 : 0];
+    d = sources[count > 3 ? 3 : 0];
+
+    switch (count) {
+    case 1:
+        for (i = 0; i < size; i += sizeof(uint64_t)) {
+            ec_store(dst + i, ec_load(base + i) ^ ec_load(a + i));
+        }
+        break;
+    case 2:
+        for (i = 0; i < size; i += sizeof(uint64_t)) {
+            ec_store(dst + i, ec_load(base + i) ^ ec_load(a + i) ^ ec_load(b + i));
+        }
+        break;
+    case 3:
+        for (i = 0; i < size; i += sizeof(uint64_t)) {
+            ec_store(dst + i, ec_load(base + i) ^ ec_load(a + i) ^ ec_load(b + i) ^ ec_load(c + i));
+        }
+        break;
+    default:
+        for (i = 0; i < size; i += sizeof(uint64_t)) {
+            ec_store(dst + i, ec_load(base + i) ^ ec_load(a + i) ^ ec_load(b + i) ^ ec_load(c + i) ^ ec_load(d + i));
+        }
+        break;
+    }
+}
+
+static inline const uint8_t *ec_packet(const uint8_t *const *shards, uint16_t packet, size_t packet_size)
+{
+    return shards[packet >> 3] + (packet & 7) * packet_size;
+}
+
+/*
+ * One block of 8 packets per shard, inputs and outputs point to the block of each shard. A schedule lists the ops of
+ * one target back to back, so a run of XORs is applied EC_XOR_FUSE sources at a time.
+ */
+static inline void ec_schedule_run(const ec_schedule_t *schedule, const uint8_t *const *inputs,
+                                   uint8_t *const *outputs, size_t packet_size)
+{
+    const uint8_t *base, *sources[EC_XOR_FUSE];
+    const ec_op_t *op;
+    uint8_t *target;
+    size_t i, count;
+
+    for (i = 0; i < schedule->count;) {
+        op = &schedule->ops[i++];
+        target = (uint8_t *)ec_packet((const uint8_t *const *)outputs, op->target, packet_size);
+
+        switch (op->kind) {
+        case EC_OP_COPY:
+            base = ec_packet(inputs, op->source, packet_size);
+            break;
+        case EC_OP_COPY_TARGET:
+            base = ec_packet((const uint8_t *const *)outputs, op->source, packet_size);
+            break;
+        case EC_OP_XOR:
+            base = target;
+            i--;
+            break;
+        default:
+            pmemset(target, 0, packet_size);
+            continue;
+        }
+
+        do {
+            for (count = 0; count < EC_XOR_FUSE && i < schedule->count && schedule->ops[i].kind == EC_OP_XOR &&
+                            schedule->ops[i].target == op->target;
+                 count++, i++) {
+                sources[count] = ec_packet(inputs, schedule->ops[i].source, packet_size);
+            }
+
+            if (count > 0) {
+                ec_xor_packets(target, base, sources, count, packet_size);
+            } else if (base != target) {
+                pmemcpy(target, base, packet_size);
+            }
+
+            base = target;
+        } while (count == EC_XOR_FUSE);
+    }
+}
+
+/* packet bytes of the block at offset, EC_PACKET_SIZE but for a shorter last block */
+static inline size_t ec_packet_size(size_t shard_size, size_t offset)
+{
+    return ((shard_size - offset) / 8 < EC_PACKET_SIZE) ? (shard_size - offset) / 8 : EC_PACKET_SIZE;
+}
+
+static inline void ec_plan_destroy(ec_plan_t *plan)
+{
+    if (plan->inverse) {
+        pfree(plan->inverse);
+    }
+
+    ec_schedule_free(&plan->data_schedule);
+    ec_schedule_free(&plan->parity_schedule);
+    pfree(plan);
+}
+
+/*
+ * The first data_shards present shards select rows of the generator [I; parity_matrix], the inverse of that square
+ * maps them back to the data. The inverse also serves PPRN_EC_CAUCHY_XOR: expanding elements into bit matrices
+ * preserves sums and products, so its schedules are built from the inverse rows of the lost data shards.
+ */
+static inline ec_plan_t *ec_plan_create(const poporon_ec_t *ec, const ec_pattern_t *pattern)
+{
+    ec_plan_t *plan;
+    uint8_t *matrix;
+    uint16_t k, num_rows, i;
+    bool ok;
+
+    plan = (ec_plan_t *)pcalloc(1, sizeof(ec_plan_t));
+    if (!plan) {
+        return NULL;
+    }
+
+    k = ec->data_shards;
+    pmemcpy(plan->lost, pattern->lost, sizeof(plan->lost));
+    num_rows = (pattern->num_missing_data > pattern->num_missing_parity) ? pattern->num_missing_data
+                                                                           : pattern->num_missing_parity;
+
+    matrix = (uint8_t *)pcalloc((size_t)(k > num_rows ? k : num_rows) * k, 1);
+    ok = matrix != NULL;
+
+    if (ok && pattern->num_missing_data > 0) {
+        plan->inverse = (uint8_t *)pmalloc((size_t)k * k);
+        ok = plan->inverse != NULL;
+
+        for (i = 0; ok && i < k; i++) {
+            if (pattern->rows[i] < k) {
+                matrix[(size_t)i * k + pattern->rows[i]] = 1;
+            } else {
+                pmemcpy(&matrix[(size_t)i * k], &ec->parity_matrix[(size_t)(pattern->rows[i] - k) * k], k);
+            }
+        }
+
+        ok = ok && ec_invert(ec->gf, matrix, plan->inverse, k);
+    }
+
+    if (ok && ec->matrix == PPRN_EC_CAUCHY_XOR && pattern->num_missing_data > 0) {
+        for (i = 0; i < pattern->num_missing_data; i++) {
+            pmemcpy(&matrix[(size_t)i * k], &plan->inverse[(size_t)pattern->missing_data[i] * k], k);
+        }
+        ok = ec_schedule_build(ec->gf, matrix, pattern->num_missing_data, k, &plan->data_schedule);
+    }
+
+    if (ok && ec->matrix == PPRN_EC_CAUCHY_XOR && pattern->num_missing_parity > 0) {
+        for (i = 0; i < pattern->num_missing_parity; i++) {
+            pmemcpy(&matrix[(size_t)i * k], &ec->parity_matrix[(size_t)(pattern->missing_parity[i] - k) * k], k);
+        }
+        ok = ec_schedule_build(ec->gf, matrix, pattern->num_missing_parity, k, &plan->parity_schedule);
+    }
+
+    if (matrix) {
+        pfree(matrix);
+    }
+
+    if (!ok) {
+        ec_plan_destroy(plan);
+        return NULL;
+    }
+
+    return plan;
+}
+
+static inline void ec_cache_unlink(ec_cache_t *cache, ec_plan_t *plan)
+{
+    if (plan->prev) {
+        plan->prev->next = plan->next;
+    } else {
+        cache->head = plan->next;
+    }
+
+    if (plan->next) {
+        plan->next->prev = plan->prev;
+    } else {
+        cache->tail = plan->prev;
+    }
+
+    plan->prev = plan->next = NULL;
+    cache->size--;
+}
+
+static inline void ec_cache_push(ec_cache_t *cache, ec_plan_t *plan)
+{
+    plan->prev = NULL;
+    plan->next = cache->head;
+    if (cache->head) {
+        cache->head->prev = plan;
+    } else {
+        cache->tail = plan;
+    }
+
+    cache->head = plan;
+    cache->size++;
+}
+
+static inline ec_plan_t *ec_cache_find(ec_cache_t *cache, const uint64_t *lost)
+{
+    ec_plan_t *plan;
+
+    for (plan = cache->head; plan; plan = plan->next) {
+        if (pmemcmp(plan->lost, lost, sizeof(plan->lost)) == 0) {
+            return plan;
+        }
+    }
+
+    return NULL;
+}
+
+/* drops least recently used plans beyond the capacity, returns them chained through next for freeing unlocked */
+static inline ec_plan_t *ec_cache_trim(ec_cache_t *cache)
+{
+    ec_plan_t *plan, *freed;
+
+    freed = NULL;
+    while (cache->size > cache->capacity) {
+        plan = cache->tail;
+        ec_cache_unlink(cache, plan);
+        if (--plan->refcount == 0) {
+            plan->next = freed;
+            freed = plan;
+        }
+    }
+
+    return freed;
+}
+
+static inline void ec_plan_free_chain(ec_plan_t *plan)
+{
+    ec_plan_t *next;
+
+    for (; plan; plan = next) {
+        next = plan->next;
+        ec_plan_destroy(plan);
+    }
+}
+
+/*
+ * Like the registry, a miss builds the plan outside the lock and a thread that loses the race to insert the same
+ * pattern drops its copy. Plans stay alive while a reconstruction holds them even if evicted meanwhile.
+ */
+static inline ec_plan_t *ec_plan_acquire(const poporon_ec_t *ec, const ec_pattern_t *pattern)
+{
+    ec_cache_t *cache;
+    ec_plan_t *plan, *created, *freed;
+
+    cache = ec->cache;
+
+    pmutex_lock(&cache->lock);
+    plan = ec_cache_find(cache, pattern->lost);
+    if (plan) {
+        cache->hits++;
+        plan->refcount++;
+        ec_cache_unlink(cache, plan);
+        ec_cache_push(cache, plan);
+        pmutex_unlock(&cache->lock);
+
+        return plan;
+    }
+    cache->misses++;
+    pmutex_unlock(&cache->lock);
+
+    created = ec_plan_create(ec, pattern);
+    if (!created) {
+        return NULL;
+    }
+    created->refcount = 1;
+
+    freed = NULL;
+    pmutex_lock(&cache->lock);
+    plan = ec_cache_find(cache, pattern->lost);
+    if (plan) {
+        plan->refcount++;
+    } else if (cache->capacity > 0) {
+        created->refcount++;
+        ec_cache_push(cache, created);
+        freed = ec_cache_trim(cache);
+        plan = created;
+        created = NULL;
+    } else {
+        plan = created;
+        created = NULL;
+    }
+    pmutex_unlock(&cache->lock);
+
+    if (created) {
+        ec_plan_destroy(created);
+    }
+    ec_plan_free_chain(freed);
+
+    return plan;
+}
+
+static inline void ec_plan_release(const poporon_ec_t *ec, ec_plan_t *plan)
+{
+    bool unused;
+
+    pmutex_lock(&ec->cache->lock);
+    unused = --plan->refcount == 0;
+    pmutex_unlock(&ec->cache->lock);
+
+    if (unused) {
+        ec_plan_destroy(plan);
+    }
+}
+
+static inline void ec_cache_destroy(ec_cache_t *cache)
+{
+    ec_plan_t *plan, *next;
+
+    for (plan = cache->head; plan; plan = next) {
+        next = plan->next;
+        ec_plan_destroy(plan);
+    }
+
+    pmutex_destroy(&cache->lock);
+    pfree(cache);
+}
+
+extern void poporon_ec_destroy(poporon_ec_t *ec)
+{
+    if (!ec) {
+        return;
+    }
+
+    if (ec->parity_matrix) {
+        pfree(ec->parity_matrix);
+    }
+
+    ec_schedule_free(&ec->encode_schedule);
+
+    if (ec->cache) {
+        ec_cache_destroy(ec->cache);
+    }
+
+    if (ec->gf) {
+        poporon_gf_release(ec->gf);
+    }
+
+    pfree(ec);
+}
+
+extern poporon_ec_t *poporon_ec_create(uint16_t data_shards, uint16_t parity_shards, poporon_ec_matrix_t matrix)
+{
+    poporon_ec_t *ec;
+
+    if (data_shards < 1 || parity_shards < 1 || (uint32_t)data_shards + parity_shards > POPORON_EC_MAX_SHARDS) {
+        return NULL;
+    }
+
+    if (matrix != PPRN_EC_VANDERMONDE && matrix != PPRN_EC_CAUCHY && matrix != PPRN_EC_CAUCHY_XOR) {
+        return NULL;
+    }
+
+    ec = (poporon_ec_t *)pcalloc(1, sizeof(poporon_ec_t));
+    if (!ec) {
+        return NULL;
+    }
+
+    ec->data_shards = data_shards;
+    ec->parity_shards = parity_shards;
+    ec->matrix = matrix;
+
+    ec->gf = poporon_gf_acquire(EC_SYMBOL_SIZE, EC_POLYNOMIAL);
+    ec->parity_matrix = (uint8_t *)pmalloc((size_t)parity_shards * data_shards);
+    ec->cache = (ec_cache_t *)pcalloc(1, sizeof(ec_cache_t));
+    if (!ec->gf || !ec->parity_matrix || !ec->cache) {
+        poporon_ec_destroy(ec);
+        return NULL;
+    }
+
+    if (!pmutex_init(&ec->cache->lock)) {
+        pfree(ec->cache);
+        ec->cache = NULL;
+        poporon_ec_destroy(ec);
+        return NULL;
+    }
+    ec->cache->capacity = POPORON_EC_CACHE_CAPACITY;
+
+    if (matrix == PPRN_EC_VANDERMONDE) {
+        if (!ec_build_vandermonde(ec)) {
+            poporon_ec_destroy(ec);
+            return NULL;
+        }
+    } else {
+        ec_build_cauchy(ec);
+    }
+
+    if (matrix == PPRN_EC_CAUCHY_XOR) {
+        ec_thin_cauchy(ec);
+
+        if (!ec_schedule_build(ec->gf, ec->parity_matrix, parity_shards, data_shards, &ec->encode_schedule)) {
+            poporon_ec_destroy(ec);
+            return NULL;
+        }
+    }
+
+    return ec;
+}
+
+extern uint16_t poporon_ec_get_data_shards(const poporon_ec_t *ec)
+{
+    return ec ? ec->data_shards : 0;
+}
+
+extern uint16_t poporon_ec_get_parity_shards(const poporon_ec_t *ec)
+{
+    return ec ? ec->parity_shards : 0;
+}
+
+/*
+ * Shards are walked in EC_BLOCK_SIZE blocks and every output of a block is produced before moving on, so the sources
+ * are read from memory once however many outputs combine them.
+ */
+extern bool poporon_ec_encode(const poporon_ec_t *ec, const uint8_t *const *data, uint8_t *const *parity,
+                              size_t shard_size)
+{
+    const poporon_kernel_t *kernel;
+    const uint8_t *sources[POPORON_EC_MAX_SHARDS];
+    uint8_t *targets[POPORON_EC_MAX_SHARDS];
+    size_t offset, length;
+    uint16_t i;
+
+    if (!ec || !data || !parity) {
+        return false;
+    }
+
+    for (i = 0; i < ec->data_shards; i++) {
+        if (!data[i] && shard_size > 0) {
+            return false;
+        }
+    }
+
+    for (i = 0; i < ec->parity_shards; i++) {
+        if (!parity[i] && shard_size > 0) {
+            return false;
+        }
+    }
+
+    if (ec->matrix == PPRN_EC_CAUCHY_XOR) {
+        if (shard_size % POPORON_EC_XOR_ALIGNMENT != 0) {
+            return false;
+        }
+
+        for (offset = 0; offset < shard_size; offset += 8 * length) {
+            length = ec_packet_size(shard_size, offset);
+
+            for (i = 0; i < ec->data_shards; i++) {
+                sources[i] = data[i] + offset;
+            }
+
+            for (i = 0; i < ec->parity_shards; i++) {
+                targets[i] = parity[i] + offset;
+            }
+
+            ec_schedule_run(&ec->encode_schedule, sources, targets, length);
+        }
+
+        return true;
+    }
+
+    kernel = poporon_kernel();
+
+    for (offset = 0; offset < shard_size; offset += length) {
+        length = (shard_size - offset < EC_BLOCK_SIZE) ? shard_size - offset : EC_BLOCK_SIZE;
+
+        for (i = 0; i < ec->data_shards; i++) {
+            sources[i] = data[i] + offset;
+        }
+
+        for (i = 0; i < ec->parity_shards; i++) {
+            kernel->gf_dot_region(ec->gf, &ec->parity_matrix[(size_t)i * ec->data_shards], sources, ec->data_shards,
+                                  parity[i] + offset, length);
+        }
+    }
+
+    return true;
+}
+
+/* missing data from the survivors through the inverse, then missing parity from the completed data, block by block */
+static inline void ec_reconstruct_dot(const poporon_ec_t *ec, uint8_t *const *shards, const ec_pattern_t *pattern,
+                                      const ec_plan_t *plan, size_t shard_size)
+{
+    const poporon_kernel_t *kernel;
+    const uint8_t *survivors[POPORON_EC_MAX_SHARDS], *sources[POPORON_EC_MAX_SHARDS];
+    size_t offset, length;
+    uint16_t k, i, j;
+
+    k = ec->data_shards;
+    kernel = poporon_kernel();
+
+    for (offset = 0; offset < shard_size; offset += length) {
+        length = (shard_size - offset < EC_BLOCK_SIZE) ? shard_size - offset : EC_BLOCK_SIZE;
+
+        for (j = 0; j < k; j++) {
+            survivors[j] = shards[pattern->rows[j]] + offset;
+        }
+
+        for (i = 0; i < pattern->num_missing_data; i++) {
+            kernel->gf_dot_region(ec->gf, &plan->inverse[(size_t)pattern->missing_data[i] * k], survivors, k,
+                                  shards[pattern->missing_data[i]] + offset, length);
+        }
+
+        if (pattern->num_missing_parity > 0) {
+            for (j = 0; j < k; j++) {
+                sources[j] = shards[j] + offset;
+            }
+
+            for (i = 0; i < pattern->num_missing_parity; i++) {
+                kernel->gf_dot_region(ec->gf, &ec->parity_matrix[(size_t)(pattern->missing_parity[i] - k) * k],
+                                      sources, k, shards[pattern->missing_parity[i]] + offset, length);
+            }
+        }
+    }
+}
+
+/* the same with the plan's XOR schedules, 8 packets per shard and block */
+static inline void ec_reconstruct_xor(const poporon_ec_t *ec, uint8_t *const *shards, const ec_pattern_t *pattern,
+                                      const ec_plan_t *plan, size_t shard_size)
+{
+    const uint8_t *survivors[POPORON_EC_MAX_SHARDS], *sources[POPORON_EC_MAX_SHARDS];
+    uint8_t *data_targets[POPORON_EC_MAX_SHARDS], *parity_targets[POPORON_EC_MAX_SHARDS];
+    size_t offset, packet_size;
+    uint16_t k, i, j;
+
+    k = ec->data_shards;
+
+    for (offset = 0; offset < shard_size; offset += 8 * packet_size) {
+        packet_size = ec_packet_size(shard_size, offset);
+
+        if (pattern->num_missing_data > 0) {
+            for (j = 0; j < k; j++) {
+                survivors[j] = shards[pattern->rows[j]] + offset;
+            }
+
+            for (i = 0; i < pattern->num_missing_data; i++) {
+                data_targets[i] = shards[pattern->missing_data[i]] + offset;
+            }
+
+            ec_schedule_run(&plan->data_schedule, survivors, data_targets, packet_size);
+        }
+
+        if (pattern->num_missing_parity > 0) {
+            for (j = 0; j < k; j++) {
+                sources[j] = shards[j] + offset;
+            }
+
+            for (i = 0; i < pattern->num_missing_parity; i++) {
+                parity_targets[i] = shards[pattern->missing_parity[i]] + offset;
+            }
+
+            ec_schedule_run(&plan->parity_schedule, sources, parity_targets, packet_size);
+        }
+    }
+}
+
+/*
+ * Stripes usually fail the same way over and over, so the plan of a pattern (the inverse, and the XOR schedules of
+ * PPRN_EC_CAUCHY_XOR) is built once and cached, see poporon_ec_set_cache_capacity(). Missing data is rebuilt through
+ * the inverse, then missing parity is encoded again from the completed data, both in the same block pass.
+ */
+extern bool poporon_ec_reconstruct(const poporon_ec_t *ec, uint8_t *const *shards, const bool *present,
+                                   size_t shard_size)
+{
+    ec_pattern_t pattern;
+    ec_plan_t *plan;
+    uint16_t k, total, i;
+
+    if (!ec || !shards || !present) {
+        return false;
+    }
+
+    k = ec->data_shards;
+    total = (uint16_t)(ec->data_shards + ec->parity_shards);
+    pmemset(pattern.lost, 0, sizeof(pattern.lost));
+    pattern.num_rows = pattern.num_missing_data = pattern.num_missing_parity = 0;
+
+    for (i = 0; i < total; i++) {
+        if (!shards[i] && shard_size > 0) {
+            return false;
+        }
+
+        if (present[i]) {
+            if (pattern.num_rows < k) {
+                pattern.rows[pattern.num_rows++] = i;
+            }
+            continue;
+        }
+
+        pattern.lost[i / 64] |= 1ULL << (i % 64);
+        if (i < k) {
+            pattern.missing_data[pattern.num_missing_data++] = i;
+        } else {
+            pattern.missing_parity[pattern.num_missing_parity++] = i;
+        }
+    }
+
+    if (pattern.num_rows < k) {
+        return false;
+    }
+
+    if (ec->matrix == PPRN_EC_CAUCHY_XOR && shard_size % POPORON_EC_XOR_ALIGNMENT != 0) {
+        return false;
+    }
+
+    if (shard_size == 0 || (pattern.num_missing_data == 0 && pattern.num_missing_parity == 0)) {
+        return true;
+    }
+
+    plan = ec_plan_acquire(ec, &pattern);
+    if (!plan) {
+        return false;
+    }
+
+    if (ec->matrix == PPRN_EC_CAUCHY_XOR) {
+        ec_reconstruct_xor(ec, shards, &pattern, plan, shard_size);
+    } else {
+        ec_reconstruct_dot(ec, shards, &pattern, plan, shard_size);
+    }
+
+    ec_plan_release(ec, plan);
+
+    return true;
+}
+
+extern bool poporon_ec_set_cache_capacity(poporon_ec_t *ec, size_t capacity)
+{
+    ec_plan_t *freed;
+
+    if (!ec) {
+        return false;
+    }
+
+    pmutex_lock(&ec->cache->lock);
+    ec->cache->capacity = capacity;
+    freed = ec_cache_trim(ec->cache);
+    pmutex_unlock(&ec->cache->lock);
+
+    ec_plan_free_chain(freed);
+
+    return true;
+}
+
+extern bool poporon_ec_get_cache_stats(const poporon_ec_t *ec, uint64_t *hits, uint64_t *misses)
+{
+    if (!ec) {
+        return false;
+    }
+
+    pmutex_lock(&ec->cache->lock);
+    if (hits) {
+        *hits = ec->cache->hits;
+    }
+    if (misses) {
+        *misses = ec->cache->misses;
+    }
+    pmutex_unlock(&ec->cache->lock);
+
+    return true;
+}
@@ -8,143 +8,63 @@
  */
 
 #include "internal/common.h"
+#include "internal/kernel.h"
 #include "internal/ldpc.h"
 
-#if POPORON_USE_SIMD
-#include "internal/simd.h"
-#endif
-
-static bool rs_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity)
+/* independent multiply-accumulates of the precomputed parity rows, no dependency on the previous feedback symbol */
+static inline void rs_encode_matrix(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
 {
-    poporon_rs_t *rs = pprn->ctx.rs.rs;
-
-#if POPORON_USE_SIMD && defined(POPORON_SIMD_AVX2)
-    __m256i parity_vec, xor_vec;
-    uint16_t i, j, fb, num_roots_aligned, k;
-    uint8_t xor_values[32];
-
-    num_roots_aligned = (rs->num_roots - 1) & ~31;
-    pmemset(parity, 0, rs->num_roots * sizeof(uint8_t));
-
-    for (i = 0; i < size; i++) {
-        fb = rs->gf->exp2log[(((uint16_t)data[i]) & ((uint16_t)rs->gf->field_size)) ^ parity[0]];
-
-        if (fb != rs->gf->field_size) {
-            for (j = 1; j <= num_roots_aligned && j + 31 < rs->num_roots; j += 32) {
-                parity_vec = _mm256_loadu_si256((__m256i *)&parity[j]);
-
-                for (k = 0; k < 32; k++) {
-                    xor_values[k] =
-                        rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[rs->num_roots - (j + k)])];
-                }
-
-                xor_vec = _mm256_loadu_si256((__m256i *)xor_values);
-                parity_vec = _mm256_xor_si256(parity_vec, xor_vec);
-                _mm256_storeu_si256((__m256i *)&parity[j], parity_vec);
-            }
+    const poporon_kernel_t *kernel = poporon_kernel();
+    const uint8_t *row;
+    uint8_t accumulator[RS_STAGED_CODEWORD_SIZE], value;
+    size_t i;
 
-            for (; j < rs->num_roots; j++) {
-                parity[j] ^= rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[rs->num_roots - j])];
-            }
-        }
+    pmemset(accumulator, 0, rs->matrix_stride);
+    row = &rs->encode_matrix[(size_t)(rs->gf->field_size - rs->num_roots - size) * rs->matrix_stride];
 
-        pmemmove(&parity[0], &parity[1], sizeof(uint8_t) * (rs->num_roots - 1));
+    for (i = 0; i < size; i++, row += rs->matrix_stride) {
+        value = data[i] & rs->gf->field_size;
 
-        if (fb != rs->gf->field_size) {
-            parity[rs->num_roots - 1] = rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[0])];
-        } else {
-            parity[rs->num_roots - 1] = 0;
+        if (value) {
+            kernel->gf_muladd_region(rs->gf, value, row, accumulator, rs->matrix_stride);
         }
     }
 
-    return true;
-
-#elif POPORON_USE_SIMD && (defined(POPORON_SIMD_NEON) || defined(POPORON_SIMD_WASM))
-    uint16_t i, j, fb, num_roots_aligned, k;
-    uint8_t xor_values[16];
-#if defined(POPORON_SIMD_NEON)
-    uint8x16_t parity_vec, xor_vec;
-#elif defined(POPORON_SIMD_WASM)
-    v128_t parity_vec, xor_vec;
-#endif
-
-    num_roots_aligned = (rs->num_roots - 1) & ~15;
-    pmemset(parity, 0, rs->num_roots * sizeof(uint8_t));
-
-    for (i = 0; i < size; i++) {
-        fb = rs->gf->exp2log[(((uint16_t)data[i]) & ((uint16_t)rs->gf->field_size)) ^ parity[0]];
-
-        if (fb != rs->gf->field_size) {
-            for (j = 1; j <= num_roots_aligned && j + 15 < rs->num_roots; j += 16) {
-#if defined(POPORON_SIMD_NEON)
-                parity_vec = vld1q_u8(&parity[j]);
-
-                for (k = 0; k < 16; k++) {
-                    xor_values[k] =
-                        rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[rs->num_roots - (j + k)])];
-                }
-
-                xor_vec = vld1q_u8(xor_values);
-                parity_vec = veorq_u8(parity_vec, xor_vec);
-                vst1q_u8(&parity[j], parity_vec);
-#elif defined(POPORON_SIMD_WASM)
-                parity_vec = wasm_v128_load(&parity[j]);
-
-                for (k = 0; k < 16; k++) {
-                    xor_values[k] =
-                        rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[rs->num_roots - (j + k)])];
-                }
-
-                xor_vec = wasm_v128_load(xor_values);
-                parity_vec = wasm_v128_xor(parity_vec, xor_vec);
-                wasm_v128_store(&parity[j], parity_vec);
-#endif
-            }
-
-            for (; j < rs->num_roots; j++) {
-                parity[j] ^= rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[rs->num_roots - j])];
-            }
-        }
-
-        pmemmove(&parity[0], &parity[1], sizeof(uint8_t) * (rs->num_roots - 1));
+    pmemcpy(parity, accumulator, rs->num_roots);
+}
 
-        if (fb != rs->gf->field_size) {
-            parity[rs->num_roots - 1] = rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[0])];
-        } else {
-            parity[rs->num_roots - 1] = 0;
-        }
+extern void poporon_rs_encode_parity(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    if (rs->encode_matrix && size <= (size_t)(rs->gf->field_size - rs->num_roots)) {
+        rs_encode_matrix(rs, data, size, parity);
+    } else if (rs->slice_tables) {
+        poporon_rs_encode_slice(rs, data, size, parity);
+    } else if (rs->feedback_polynomial) {
+        poporon_kernel()->rs_encode(rs, data, size, parity);
+    } else {
+        poporon_rs_encode_scalar(rs, data, size, parity);
     }
+}
 
-    return true;
-
-#else
-    uint16_t i, j, fb;
-
-    pmemset(parity, 0, rs->num_roots * sizeof(uint8_t));
-
-    for (i = 0; i < size; i++) {
-        fb = rs->gf->exp2log[(((uint16_t)data[i]) & ((uint16_t)rs->gf->field_size)) ^ parity[0]];
-
-        if (fb != rs->gf->field_size) {
-            for (j = 1; j < rs->num_roots; j++) {
-                parity[j] ^= rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[rs->num_roots - j])];
-            }
-        }
+static bool rs_encode(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                      uint8_t *parity)
+{
+    poporon_rs_t *rs = pprn->ctx.rs.rs;
 
-        pmemmove(&parity[0], &parity[1], sizeof(uint8_t) * (rs->num_roots - 1));
+    (void)workspace;
 
-        if (fb != rs->gf->field_size) {
-            parity[rs->num_roots - 1] = rs->gf->log2exp[gf_mod(rs->gf, fb + rs->generator_polynomial[0])];
-        } else {
-            parity[rs->num_roots - 1] = 0;
-        }
+    /* wider symbols go through poporon_encode_u16() */
+    if (rs->gf->symbol_size > 8) {
+        return false;
     }
 
+    poporon_rs_encode_parity(rs, data, size, parity);
+
     return true;
-#endif
 }
 
-static bool ldpc_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity)
+static bool ldpc_encode(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                        uint8_t *parity)
 {
     uint8_t *encode_input;
     poporon_ldpc_t *ldpc = pprn->ctx.ldpc.ldpc;
@@ -156,11 +76,7 @@ static bool ldpc_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *pa
     }
 
     if (ldpc->config.use_outer_interleave && ldpc->outer_interleaver.forward) {
-        outer_buf = ldpc->temp_outer;
-        if (!outer_buf) {
-            return false;
-        }
-
+        outer_buf = workspace->ctx.ldpc.ldpc->temp_outer;
         pmemset(outer_buf, 0, ldpc->info_bytes);
 
         for (i = 0; i < ldpc->info_bytes; i++) {
@@ -178,15 +94,11 @@ static bool ldpc_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *pa
     }
 
     if (ldpc->config.use_inner_interleave && ldpc->interleaver.forward) {
-        codeword = ldpc->temp_codeword;
+        codeword = workspace->ctx.ldpc.ldpc->temp_codeword;
         pmemcpy(codeword, encode_input, ldpc->info_bytes);
         pmemcpy(codeword + ldpc->info_bytes, parity, ldpc->parity_bytes);
 
-        interleaved = ldpc->temp_interleaved;
-        if (!interleaved) {
-            return false;
-        }
-
+        interleaved = workspace->ctx.ldpc.ldpc->temp_interleaved;
         poporon_ldpc_interleave(ldpc, codeword, interleaved);
 
         pmemcpy(data, interleaved, ldpc->info_bytes);
@@ -196,12 +108,15 @@ static bool ldpc_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *pa
     return true;
 }
 
-static bool bch_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity)
+static bool bch_encode(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                       uint8_t *parity)
 {
     poporon_bch_t *bch = pprn->ctx.bch.bch;
     uint32_t data_val = 0, codeword = 0, parity_val;
     uint16_t i, data_len, codeword_len, parity_bits, data_bytes, parity_bytes;
 
+    (void)workspace;
+
     data_len = poporon_bch_get_data_length(bch);
     codeword_len = poporon_bch_get_codeword_length(bch);
     parity_bits = codeword_len - data_len;
@@ -233,20 +148,134 @@ static bool bch_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *par
     return true;
 }
 
-extern bool poporon_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity)
-{
-    if (!pprn || !data || !parity) {
-        return false;
-    }
+typedef bool (*encode_func_t)(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data, size_t size,
+                              uint8_t *parity);
 
+static inline encode_func_t select_encoder(const poporon_t *pprn)
+{
     switch (pprn->fec_type) {
     case PPLN_FEC_RS:
-        return rs_encode(pprn, data, size, parity);
+        return rs_encode;
     case PPLN_FEC_LDPC:
-        return ldpc_encode(pprn, data, size, parity);
+        return ldpc_encode;
     case PPLN_FEC_BCH:
-        return bch_encode(pprn, data, size, parity);
+        return bch_encode;
     default:
+        return NULL;
+    }
+}
+
+static bool encode_batch(poporon_t *pprn, const batch_layout_t *layout, size_t size, size_t count, bool *results)
+{
+    encode_func_t encoder;
+    uint8_t *data, *parity;
+    size_t i;
+    bool ok, all_ok = true;
+
+    /* an empty codeword is rejected as by decode_batch() */
+    encoder = select_encoder(pprn);
+    if (!encoder || !size) {
+        return false;
+    }
+
+    for (i = 0; i < count; i++) {
+        data = batch_data(layout, i);
+        parity = batch_parity(layout, i);
+        ok = data && parity && encoder(pprn, pprn->workspace, data, size, parity);
+        all_ok &= ok;
+
+        if (results) {
+            results[i] = ok;
+        }
+    }
+
+    return all_ok;
+}
+
+extern bool poporon_encode(poporon_t *pprn, uint8_t *data, size_t size, uint8_t *parity)
+{
+    if (!pprn) {
+        return false;
+    }
+
+    return poporon_encode_with_workspace(pprn, pprn->workspace, data, size, parity);
+}
+
+extern bool poporon_encode_with_workspace(const poporon_t *pprn, poporon_workspace_t *workspace, uint8_t *data,
+                                          size_t size, uint8_t *parity)
+{
+    encode_func_t encoder;
+
+    if (!pprn || !data || !parity || !poporon_workspace_fits(pprn, workspace)) {
+        return false;
+    }
+
+    encoder = select_encoder(pprn);
+
+    return encoder && encoder(pprn, workspace, data, size, parity);
+}
+
+extern bool poporon_encode_u16(poporon_t *pprn, const uint16_t *data, size_t size, uint16_t *parity)
+{
+    poporon_rs_t *rs;
+
+    if (!pprn || !data || !parity || pprn->fec_type != PPLN_FEC_RS) {
+        return false;
+    }
+
+    rs = pprn->ctx.rs.rs;
+    if (!rs->feedback_split || size == 0 || size > (size_t)(rs->gf->field_size - rs->num_roots)) {
+        return false;
+    }
+
+    poporon_kernel()->rs_encode_u16(rs, data, size, parity);
+
+    return true;
+}
+
+extern bool poporon_encode_batch(poporon_t *pprn, uint8_t *const *data, size_t size, uint8_t *const *parity,
+                                 size_t count, bool *results)
+{
+    batch_layout_t layout = {data, parity, NULL, NULL, 0, 0};
+
+    if (!pprn || !data || !parity) {
+        return false;
+    }
+
+    return encode_batch(pprn, &layout, size, count, results);
+}
+
+extern bool poporon_encode_strided(poporon_t *pprn, uint8_t *data, size_t data_stride, size_t size, uint8_t *parity,
+                                   size_t parity_stride, size_t count, bool *results)
+{
+    batch_layout_t layout = {NULL, NULL, data, parity, data_stride, parity_stride};
+
+    if (!pprn || !data || !parity || !batch_strides_valid(pprn, data_stride, size, parity_stride, count)) {
         return false;
     }
+
+    return encode_batch(pprn, &layout, size, count, results);
+}
+
+extern bool poporon_encode_interleaved(poporon_t *pprn, const uint8_t *data, size_t size, size_t count,
+                                       uint8_t *parity)
+{
+    poporon_rs_t *rs;
+
+    if (!pprn || !data || !parity || pprn->fec_type != PPLN_FEC_RS) {
+        return false;
+    }
+
+    rs = pprn->ctx.rs.rs;
+    if (size == 0 || size > (size_t)(rs->gf->field_size - rs->num_roots) || rs->gf->symbol_size > 8) {
+        return false;
+    }
+
+    if (rs->feedback_polynomial) {
+        poporon_kernel()->rs_encode_interleaved(rs, data, size, count, count, parity);
+    } else {
+        poporon_rs_encode_interleaved_scalar(rs, data, size, count, count, parity);
+    }
+
+    return true;
 }
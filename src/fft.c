@@ -0,0 +1,532 @@
+/*
+ * libpoporon - fft.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/common.h"
+#include "internal/kernel.h"
+
+#define FFT_POLYNOMIAL_8  0x11D  /* x^8 + x^4 + x^3 + x^2 + 1 */
+#define FFT_POLYNOMIAL_16 0x100B /* x^16 + x^12 + x^3 + x + 1 */
+
+/*
+ * Position i of a codeword is the field element omega(i) = sum of basis[b] over the bits b of i, with basis the Cantor
+ * basis: basis[0] = 1 and basis[b]^2 + basis[b] = basis[b - 1]. Its subspace polynomials are W_b(x) = f^b(x) with
+ * f(x) = x^2 + x, which gives the Lin-Chung-Han transforms their two shortcuts:
+ *
+ *   - W_b(basis[b]) = 1 and W_b(omega(x)) = omega(x >> b) for x a multiple of 2^(b + 1), so the skew of every
+ *     butterfly is an omega[] entry.
+ *   - W_b'(x) = 1, so the formal derivative in the polynomial basis is XORs of coefficients only.
+ *
+ * Parity takes positions [0, parity_span) and data [parity_span, parity_span + data_shards), unused positions up to
+ * span are zero. A codeword is the evaluation of a polynomial of degree below span - parity_span, which is what makes
+ * any data_shards positions enough.
+ */
+
+static inline uint32_t fft_span(uint32_t count)
+{
+    uint32_t span;
+
+    for (span = 1; span < count; span <<= 1) {
+        ;
+    }
+
+    return span;
+}
+
+static bool fft_build_basis(const poporon_gf_t *gf, uint16_t *basis)
+{
+    uint32_t x;
+    uint8_t b;
+
+    basis[0] = 1;
+    for (b = 1; b < gf->symbol_size; b++) {
+        for (x = 2; x <= gf->field_size; x++) {
+            if ((gf_mul(gf, (uint16_t)x, (uint16_t)x) ^ x) == basis[b - 1]) {
+                break;
+            }
+        }
+
+        if (x > gf->field_size) {
+            return false;
+        }
+        basis[b] = (uint16_t)x;
+    }
+
+    return true;
+}
+
+/* a + b mod field_size for a, b <= field_size, field_size itself standing for 0 as well */
+static inline uint32_t fft_add_mod(const poporon_gf_t *gf, uint32_t a, uint32_t b)
+{
+    uint32_t sum;
+
+    sum = a + b;
+
+    return (sum & gf->field_size) + (sum >> gf->symbol_size);
+}
+
+/* unnormalized Walsh-Hadamard transform mod field_size, count a power of two */
+static void fft_walsh(const poporon_gf_t *gf, uint32_t *values, uint32_t count)
+{
+    uint32_t half, block, j, a, b;
+
+    for (half = 1; half < count; half <<= 1) {
+        for (block = 0; block < count; block += 2 * half) {
+            for (j = block; j < block + half; j++) {
+                a = values[j];
+                b = values[j + half];
+                values[j] = fft_add_mod(gf, a, b);
+                values[j + half] = fft_add_mod(gf, a, gf->field_size - b);
+            }
+        }
+    }
+}
+
+/*
+ * log_walsh[] is the transform of log(omega[i]), log(0) taken as 0, divided by span: 2^symbol_size is 1 mod
+ * field_size, so dividing by span is multiplying by 2^symbol_size / span.
+ */
+static bool fft_build_tables(poporon_fft_t *fft)
+{
+    const poporon_gf_t *gf;
+    uint16_t basis[16];
+    uint32_t *values, scale, bit, i;
+
+    gf = fft->gf;
+    if (!fft_build_basis(gf, basis)) {
+        return false;
+    }
+
+    fft->omega = (uint16_t *)pmalloc(fft->span * sizeof(uint16_t));
+    fft->log_walsh = (uint16_t *)pmalloc(fft->span * sizeof(uint16_t));
+    values = (uint32_t *)pmalloc(fft->span * sizeof(uint32_t));
+    if (!fft->omega || !fft->log_walsh || !values) {
+        if (values) {
+            pfree(values);
+        }
+        return false;
+    }
+
+    fft->omega[0] = 0;
+    for (bit = 0; (1U << bit) < fft->span; bit++) {
+        for (i = 0; i < (1U << bit); i++) {
+            fft->omega[i + (1U << bit)] = fft->omega[i] ^ basis[bit];
+        }
+    }
+
+    values[0] = 0;
+    for (i = 1; i < fft->span; i++) {
+        values[i] = gf->exp2log[fft->omega[i]];
+    }
+
+    fft_walsh(gf, values, fft->span);
+
+    scale = ((uint32_t)1 << gf->symbol_size) / fft->span;
+    for (i = 0; i < fft->span; i++) {
+        fft->log_walsh[i] = (uint16_t)(values[i] * scale % gf->field_size);
+    }
+
+    pfree(values);
+
+    return true;
+}
+
+static inline void fft_xor(const uint8_t *src, uint8_t *dst, size_t size)
+{
+    uint64_t a, b;
+    size_t i;
+
+    for (i = 0; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        pmemcpy(&a, src + i, sizeof(uint64_t));
+        pmemcpy(&b, dst + i, sizeof(uint64_t));
+        b ^= a;
+        pmemcpy(dst + i, &b, sizeof(uint64_t));
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= src[i];
+    }
+}
+
+/* dst = multiplier * src over symbols of the field, bytes or uint16_t */
+static inline void fft_mul(const poporon_fft_t *fft, const poporon_kernel_t *kernel, uint16_t multiplier,
+                           const uint8_t *src, uint8_t *dst, size_t size)
+{
+    uint8_t multiplier8;
+
+    if (fft->gf->symbol_size > 8) {
+        kernel->gf_mul_region_u16(fft->gf, multiplier, (const uint16_t *)src, (uint16_t *)dst,
+                                  size / sizeof(uint16_t));
+    } else {
+        multiplier8 = (uint8_t)multiplier;
+        kernel->gf_dot_region(fft->gf, &multiplier8, &src, 1, dst, size);
+    }
+}
+
+/* dst ^= multiplier * src */
+static inline void fft_muladd(const poporon_fft_t *fft, const poporon_kernel_t *kernel, uint16_t multiplier,
+                              const uint8_t *src, uint8_t *dst, size_t size)
+{
+    if (fft->gf->symbol_size > 8) {
+        kernel->gf_muladd_region_u16(fft->gf, multiplier, (const uint16_t *)src, (uint16_t *)dst,
+                                     size / sizeof(uint16_t));
+    } else {
+        kernel->gf_muladd_region(fft->gf, (uint8_t)multiplier, src, dst, size);
+    }
+}
+
+/*
+ * Buffers work + i * size, i < count with count a power of two, hold polynomial basis coefficients and receive the
+ * values at omega(shift + i), shift a multiple of count, of which only those below limit are needed. Butterflies run
+ * from the widest down; the halves of a group share one skew and are contiguous, so each is a single kernel pass.
+ */
+static void fft_forward(const poporon_fft_t *fft, const poporon_kernel_t *kernel, uint8_t *work, size_t size,
+                        uint32_t count, uint32_t shift, uint32_t limit)
+{
+    uint32_t half, level, block;
+    uint16_t skew;
+    uint8_t *lo, *hi;
+
+    for (level = 0; (2U << level) < count; level++) {
+        ;
+    }
+
+    for (half = count >> 1; half > 0; half >>= 1, level--) {
+        for (block = 0; block < limit; block += 2 * half) {
+            skew = fft->omega[(shift + block) >> level];
+            lo = work + (size_t)block * size;
+            hi = lo + (size_t)half * size;
+
+            if (skew) {
+                fft_muladd(fft, kernel, skew, hi, lo, (size_t)half * size);
+            }
+            if (block + half < limit) {
+                fft_xor(lo, hi, (size_t)half * size);
+            }
+        }
+    }
+}
+
+/* the inverse, values at omega(shift + i) back to coefficients, values from limit on being zero */
+static void fft_inverse(const poporon_fft_t *fft, const poporon_kernel_t *kernel, uint8_t *work, size_t size,
+                        uint32_t count, uint32_t shift, uint32_t limit)
+{
+    uint32_t half, level, block;
+    uint16_t skew;
+    uint8_t *lo, *hi;
+
+    for (half = 1, level = 0; half < count; half <<= 1, level++) {
+        /* groups past limit are still all zero */
+        for (block = 0; block < limit; block += 2 * half) {
+            skew = fft->omega[(shift + block) >> level];
+            lo = work + (size_t)block * size;
+            hi = lo + (size_t)half * size;
+
+            fft_xor(lo, hi, (size_t)half * size);
+            if (skew) {
+                fft_muladd(fft, kernel, skew, hi, lo, (size_t)half * size);
+            }
+        }
+    }
+}
+
+/*
+ * Formal derivative in the polynomial basis: X_k' is the sum of X_(k - 2^b) over the bits b of k. Coefficient i moves
+ * to i - 2^b for every bit b, in an order that reads each coefficient before it is overwritten.
+ */
+static void fft_derivative(uint8_t *work, size_t size, uint32_t count)
+{
+    uint32_t i, width;
+
+    for (i = 1; i < count; i++) {
+        width = i & (~i + 1);
+        fft_xor(work + (size_t)i * size, work + (size_t)(i - width) * size, (size_t)width * size);
+    }
+}
+
+/* bytes per shard handled in one pass so that count buffers of it stay in cache, the whole shard when it fits */
+static inline size_t fft_block_size(uint32_t count, size_t shard_size)
+{
+    size_t block;
+
+    block = FFT_WORKING_SET / count;
+    block -= block % FFT_MIN_BLOCK_SIZE;
+    if (block < FFT_MIN_BLOCK_SIZE) {
+        block = FFT_MIN_BLOCK_SIZE;
+    }
+
+    return block < shard_size ? block : shard_size;
+}
+
+/* the shard at a codeword position, or data_shards + parity_shards for the positions that are always zero */
+static inline uint32_t fft_shard_at(const poporon_fft_t *fft, uint32_t position)
+{
+    if (position < fft->parity_shards) {
+        return fft->data_shards + position;
+    }
+
+    if (position >= fft->parity_span && position < fft->parity_span + fft->data_shards) {
+        return position - fft->parity_span;
+    }
+
+    return (uint32_t)fft->data_shards + fft->parity_shards;
+}
+
+static inline bool fft_shard_valid(const poporon_fft_t *fft, const uint8_t *shard)
+{
+    return shard && (fft->gf->symbol_size <= 8 || ((uintptr_t)shard & 1) == 0);
+}
+
+extern void poporon_fft_destroy(poporon_fft_t *fft)
+{
+    if (!fft) {
+        return;
+    }
+
+    if (fft->omega) {
+        pfree(fft->omega);
+    }
+
+    if (fft->log_walsh) {
+        pfree(fft->log_walsh);
+    }
+
+    if (fft->gf) {
+        poporon_gf_release(fft->gf);
+    }
+
+    pfree(fft);
+}
+
+extern poporon_fft_t *poporon_fft_create(uint8_t symbol_size, uint16_t data_shards, uint16_t parity_shards)
+{
+    poporon_fft_t *fft;
+    uint32_t parity_span, data_span;
+
+    if ((symbol_size != 8 && symbol_size != 16) || data_shards < 1 || parity_shards < 1) {
+        return NULL;
+    }
+
+    parity_span = fft_span(parity_shards);
+    data_span = (data_shards + parity_span - 1) / parity_span * parity_span;
+    if (parity_span + data_span > ((uint32_t)1 << symbol_size)) {
+        return NULL;
+    }
+
+    fft = (poporon_fft_t *)pcalloc(1, sizeof(poporon_fft_t));
+    if (!fft) {
+        return NULL;
+    }
+
+    fft->data_shards = data_shards;
+    fft->parity_shards = parity_shards;
+    fft->parity_span = parity_span;
+    fft->span = fft_span(parity_span + data_span);
+
+    fft->gf = poporon_gf_acquire(symbol_size, symbol_size == 8 ? FFT_POLYNOMIAL_8 : FFT_POLYNOMIAL_16);
+    if (!fft->gf || !fft_build_tables(fft)) {
+        poporon_fft_destroy(fft);
+        return NULL;
+    }
+
+    return fft;
+}
+
+extern uint16_t poporon_fft_get_data_shards(const poporon_fft_t *fft)
+{
+    return fft ? fft->data_shards : 0;
+}
+
+extern uint16_t poporon_fft_get_parity_shards(const poporon_fft_t *fft)
+{
+    return fft ? fft->parity_shards : 0;
+}
+
+/*
+ * Each parity_span run of data is interpolated on its own coset with an inverse transform, the coefficients of all
+ * runs summed, and the sum evaluated on the parity coset.
+ */
+extern bool poporon_fft_encode(const poporon_fft_t *fft, const uint8_t *const *data, uint8_t *const *parity,
+                               size_t shard_size)
+{
+    const poporon_kernel_t *kernel;
+    uint8_t *work, *sum, *run;
+    size_t block, offset, length;
+    uint32_t span, first, i;
+    uint16_t k;
+
+    if (!fft || !data || !parity) {
+        return false;
+    }
+
+    if (fft->gf->symbol_size > 8 && shard_size % sizeof(uint16_t) != 0) {
+        return false;
+    }
+
+    for (k = 0; k < fft->data_shards; k++) {
+        if (!fft_shard_valid(fft, data[k]) && shard_size > 0) {
+            return false;
+        }
+    }
+
+    for (k = 0; k < fft->parity_shards; k++) {
+        if (!fft_shard_valid(fft, parity[k]) && shard_size > 0) {
+            return false;
+        }
+    }
+
+    if (shard_size == 0) {
+        return true;
+    }
+
+    span = fft->parity_span;
+    block = fft_block_size(2 * span, shard_size);
+    work = (uint8_t *)pmalloc(2 * span * block);
+    if (!work) {
+        return false;
+    }
+
+    kernel = poporon_kernel();
+    sum = work;
+    run = work + span * block;
+
+    for (offset = 0; offset < shard_size; offset += length) {
+        length = (shard_size - offset < block) ? shard_size - offset : block;
+
+        for (first = 0; first < fft->data_shards; first += span) {
+            for (i = 0; i < span; i++) {
+                if (first + i < fft->data_shards) {
+                    pmemcpy(run + i * length, data[first + i] + offset, length);
+                } else {
+                    pmemset(run + i * length, 0, length);
+                }
+            }
+
+            fft_inverse(fft, kernel, run, length, span, span + first,
+                        fft->data_shards - first < span ? fft->data_shards - first : span);
+
+            if (first == 0) {
+                pmemcpy(sum, run, span * length);
+            } else {
+                fft_xor(run, sum, span * length);
+            }
+        }
+
+        fft_forward(fft, kernel, sum, length, span, 0, fft->parity_shards);
+
+        for (k = 0; k < fft->parity_shards; k++) {
+            pmemcpy(parity[k] + offset, sum + k * length, length);
+        }
+    }
+
+    pfree(work);
+
+    return true;
+}
+
+/*
+ * With E the lost positions and the parity positions past parity_shards, L(x) = product of (x - omega(e)) over E and
+ * P the codeword polynomial: the values of L * P are known everywhere, and at e in E (L * P)'(omega(e)) =
+ * L'(omega(e)) P(omega(e)). log L(omega(i)), or log L'(omega(i)) for i in E, is the sum of log(omega(i ^ e)) over E,
+ * a XOR convolution that two Walsh-Hadamard transforms compute for all i at once.
+ */
+extern bool poporon_fft_reconstruct(const poporon_fft_t *fft, uint8_t *const *shards, const bool *present,
+                                    size_t shard_size)
+{
+    const poporon_kernel_t *kernel;
+    uint32_t *locator, span, total, position, needed, lost, i;
+    uint8_t *work;
+    size_t block, offset, length;
+
+    if (!fft || !shards || !present) {
+        return false;
+    }
+
+    if (fft->gf->symbol_size > 8 && shard_size % sizeof(uint16_t) != 0) {
+        return false;
+    }
+
+    total = (uint32_t)fft->data_shards + fft->parity_shards;
+    lost = 0;
+    for (i = 0; i < total; i++) {
+        if (!fft_shard_valid(fft, shards[i]) && shard_size > 0) {
+            return false;
+        }
+        lost += !present[i];
+    }
+
+    if (lost > fft->parity_shards) {
+        return false;
+    }
+
+    if (shard_size == 0 || lost == 0) {
+        return true;
+    }
+
+    span = fft->span;
+    locator = (uint32_t *)pcalloc(span, sizeof(uint32_t));
+    if (!locator) {
+        return false;
+    }
+
+    /* parity positions past parity_shards count as lost, the zero positions past the data as present */
+    needed = 0;
+    for (position = 0; position < fft->parity_span + fft->data_shards; position++) {
+        i = fft_shard_at(fft, position);
+        locator[position] = i >= total || !present[i];
+        if (i < total && !present[i]) {
+            needed = position + 1;
+        }
+    }
+
+    fft_walsh(fft->gf, locator, span);
+    for (i = 0; i < span; i++) {
+        locator[i] = locator[i] * fft->log_walsh[i] % fft->gf->field_size;
+    }
+    fft_walsh(fft->gf, locator, span);
+
+    block = fft_block_size(span, shard_size);
+    work = (uint8_t *)pmalloc(span * block);
+    if (!work) {
+        pfree(locator);
+        return false;
+    }
+
+    kernel = poporon_kernel();
+
+    for (offset = 0; offset < shard_size; offset += length) {
+        length = (shard_size - offset < block) ? shard_size - offset : block;
+
+        for (position = 0; position < span; position++) {
+            i = fft_shard_at(fft, position);
+            if (i < total && present[i]) {
+                fft_mul(fft, kernel, gf_exp(fft->gf, locator[position]), shards[i] + offset, work + position * length,
+                        length);
+            } else {
+                pmemset(work + position * length, 0, length);
+            }
+        }
+
+        fft_inverse(fft, kernel, work, length, span, 0, fft->parity_span + fft->data_shards);
+        fft_derivative(work, length, span);
+        fft_forward(fft, kernel, work, length, span, 0, needed);
+
+        for (position = 0; position < needed; position++) {
+            i = fft_shard_at(fft, position);
+            if (i < total && !present[i]) {
+                fft_mul(fft, kernel, gf_exp(fft->gf, fft->gf->field_size - locator[position]),
+                        work + position * length, shards[i] + offset, length);
+            }
+        }
+    }
+
+    pfree(work);
+    pfree(locator);
+
+    return true;
+}
@@ -8,84 +8,405 @@
  */
 
 #include "internal/common.h"
+#include "internal/kernel.h"
+
+typedef struct {
+    uint8_t symbol_size;
+    uint16_t generator_polynomial;
+} gf_key_t;
+
+#if POPORON_USE_STATIC_GF
+/* generated at build time by cmake/gf_tables.cmake */
+#include "gf_tables.h"
+#endif
+
+static inline const poporon_gf_t *gf_static_lookup(uint8_t symbol_size, uint16_t generator_polynomial)
+{
+#if POPORON_USE_STATIC_GF
+    size_t i;
+
+    if (symbol_size != 8) {
+        return NULL;
+    }
+
+    for (i = 0; i < GF_STATIC_FIELDS; i++) {
+        if (gf_static_fields[i].generator_polynomial == generator_polynomial) {
+            return &gf_static_fields[i];
+        }
+    }
+#else
+    (void)symbol_size;
+    (void)generator_polynomial;
+#endif
+
+    return NULL;
+}
+
+static inline uint8_t *build_nibble_tables(poporon_gf_t *gf)
+{
+    uint8_t *nibble_tables, *table;
+    uint16_t multiplier, log_multiplier, i, nibble;
+
+    nibble_tables = (uint8_t *)pcalloc(gf->field_size + 1, GF_NIBBLE_TABLE_SIZE);
+    if (!nibble_tables) {
+        return NULL;
+    }
+
+    for (multiplier = 1; multiplier <= gf->field_size; multiplier++) {
+        table = nibble_tables + (size_t)multiplier * GF_NIBBLE_TABLE_SIZE;
+        log_multiplier = gf->exp2log[multiplier];
+
+        for (i = 1; i < 16; i++) {
+            nibble = i;
+            if (nibble <= gf->field_size) {
+                table[i] = (uint8_t)gf->log2exp[gf_mod(gf, log_multiplier + gf->exp2log[nibble])];
+            }
+
+            nibble = i << 4;
+            if (nibble <= gf->field_size) {
+                table[16 + i] = (uint8_t)gf->log2exp[gf_mod(gf, log_multiplier + gf->exp2log[nibble])];
+            }
+        }
+    }
+
+    return nibble_tables;
+}
 
 extern void poporon_gf_destroy(poporon_gf_t *gf)
 {
-    if (!gf) {
+    if (!gf || gf->is_static) {
         return;
     }
 
     if (gf->exp2log) {
-        pfree(gf->exp2log);
+        pfree((void *)gf->exp2log);
     }
 
     if (gf->log2exp) {
-        pfree(gf->log2exp);
+        pfree((void *)gf->log2exp);
+    }
+
+    if (gf->exp_table) {
+        pfree((void *)gf->exp_table);
+    }
+
+    if (gf->nibble_tables) {
+        pfree((void *)gf->nibble_tables);
     }
 
     pfree(gf);
 }
 
+/*
+ * Fields with build time generated tables (see POPORON_GF_STATIC_POLYNOMIALS) are returned as a shared view of
+ * read-only data without allocating, everything else is computed here.
+ */
 extern poporon_gf_t *poporon_gf_create(uint8_t symbol_size, uint16_t generator_polynomial)
 {
+    const poporon_gf_t *static_gf;
     poporon_gf_t *gf;
-    uint16_t field_element;
-    uint8_t i;
+    uint16_t *log2exp, *exp2log, *exp_table;
+    uint32_t field_element;
+    size_t i;
 
     if (symbol_size < 1 || symbol_size > 16) {
         return NULL;
     }
 
-    gf = (poporon_gf_t *)pmalloc(sizeof(poporon_gf_t));
+    static_gf = gf_static_lookup(symbol_size, generator_polynomial);
+    if (static_gf) {
+        /* handed out mutable for the API only, is_static keeps poporon_gf_destroy() from touching it */
+        return (poporon_gf_t *)static_gf;
+    }
+
+    gf = (poporon_gf_t *)pcalloc(1, sizeof(poporon_gf_t));
     if (!gf) {
         return NULL;
     }
 
     gf->symbol_size = symbol_size;
-    gf->field_size = (1 << symbol_size) - 1;
+    gf->field_size = (uint16_t)((1U << symbol_size) - 1);
     gf->generator_polynomial = generator_polynomial;
 
-    gf->log2exp = (uint16_t *)pmalloc((gf->field_size + 1) * sizeof(uint16_t));
-    if (!gf->log2exp) {
+    log2exp = (uint16_t *)pmalloc((gf->field_size + 1) * sizeof(uint16_t));
+    gf->log2exp = log2exp;
+    if (!log2exp) {
         poporon_gf_destroy(gf);
 
         return NULL;
     }
 
-    gf->exp2log = (uint16_t *)pmalloc((gf->field_size + 1) * sizeof(uint16_t));
-    if (!gf->exp2log) {
+    exp2log = (uint16_t *)pmalloc((gf->field_size + 1) * sizeof(uint16_t));
+    gf->exp2log = exp2log;
+    if (!exp2log) {
         poporon_gf_destroy(gf);
 
         return NULL;
     }
 
-    gf->exp2log[0] = gf->field_size;
-    gf->log2exp[gf->field_size] = 0;
+    exp2log[0] = gf->field_size;
+    log2exp[gf->field_size] = 0;
 
     field_element = 1;
     for (i = 0; i < gf->field_size; i++) {
-        gf->exp2log[field_element] = i;
-        gf->log2exp[i] = field_element;
+        exp2log[field_element] = (uint16_t)i;
+        log2exp[i] = (uint16_t)field_element;
 
         field_element <<= 1;
 
-        if (field_element & (1 << symbol_size)) {
+        /* x^symbol_size itself is masked off below, so GF(2^16) polynomials may leave it out (0x1100B as 0x100B) */
+        if (field_element & ((uint32_t)1 << symbol_size)) {
             field_element ^= generator_polynomial;
         }
 
         field_element &= gf->field_size;
     }
 
-    if (field_element != gf->log2exp[0]) {
+    if (field_element != log2exp[0]) {
+        poporon_gf_destroy(gf);
+
+        return NULL;
+    }
+
+    exp_table = (uint16_t *)pmalloc((size_t)GF_EXP_PERIODS * gf->field_size * sizeof(uint16_t));
+    gf->exp_table = exp_table;
+    if (!exp_table) {
         poporon_gf_destroy(gf);
 
         return NULL;
     }
 
+    for (i = 0; i < (size_t)GF_EXP_PERIODS * gf->field_size; i++) {
+        exp_table[i] = log2exp[i % gf->field_size];
+    }
+
+    if (symbol_size <= 8) {
+        gf->nibble_tables = build_nibble_tables(gf);
+        if (!gf->nibble_tables) {
+            poporon_gf_destroy(gf);
+
+            return NULL;
+        }
+    }
+
     return gf;
 }
 
-extern uint8_t poporon_gf_mod(poporon_gf_t *gf, uint16_t value)
+extern uint16_t poporon_gf_mod(poporon_gf_t *gf, uint32_t value)
 {
     return gf_mod(gf, value);
 }
+
+/* region arithmetic runs on the nibble tables, which only byte sized fields have */
+static inline bool gf_region_valid(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, const uint8_t *dst,
+                                   size_t size)
+{
+    return gf && gf->nibble_tables && multiplier <= gf->field_size && ((src && dst) || size == 0);
+}
+
+extern bool poporon_gf_mul_region(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                                  size_t size)
+{
+    if (!gf_region_valid(gf, multiplier, src, dst, size)) {
+        return false;
+    }
+
+    if (size == 0) {
+        return true;
+    }
+
+    if (multiplier == 0) {
+        pmemset(dst, 0, size);
+
+        return true;
+    }
+
+    poporon_kernel()->gf_dot_region(gf, &multiplier, &src, 1, dst, size);
+
+    return true;
+}
+
+extern bool poporon_gf_muladd_region(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                                     size_t size)
+{
+    if (!gf_region_valid(gf, multiplier, src, dst, size)) {
+        return false;
+    }
+
+    if (size == 0 || multiplier == 0) {
+        return true;
+    }
+
+    poporon_kernel()->gf_muladd_region(gf, multiplier, src, dst, size);
+
+    return true;
+}
+
+/*
+ * Every output vector is accumulated in registers over all sources and stored once, instead of count read-modify-
+ * write passes over dst as a chain of poporon_gf_muladd_region() calls would take.
+ */
+extern bool poporon_gf_dot_region(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                                  size_t count, uint8_t *dst, size_t size)
+{
+    size_t k;
+
+    if (!gf_region_valid(gf, 0, dst, dst, size) || (count > 0 && (!coefficients || !sources))) {
+        return false;
+    }
+
+    for (k = 0; k < count; k++) {
+        if (!gf_region_valid(gf, coefficients[k], sources[k], dst, size)) {
+            return false;
+        }
+    }
+
+    if (size == 0) {
+        return true;
+    }
+
+    if (count == 0) {
+        pmemset(dst, 0, size);
+
+        return true;
+    }
+
+    poporon_kernel()->gf_dot_region(gf, coefficients, sources, count, dst, size);
+
+    return true;
+}
+
+void poporon_gf_split_table(const poporon_gf_t *gf, uint16_t multiplier, uint8_t *table)
+{
+    uint16_t product, nibble;
+    uint8_t position, i;
+
+    pmemset(table, 0, GF_SPLIT_TABLE_SIZE);
+
+    for (position = 0; position < 4; position++) {
+        for (i = 1; i < 16; i++) {
+            /* bits above symbol_size are dropped, so that products ignore them rather than pick up garbage */
+            nibble = (uint16_t)((i << (4 * position)) & gf->field_size);
+            product = gf_mul(gf, multiplier, nibble);
+            table[position * 32 + i] = (uint8_t)product;
+            table[position * 32 + 16 + i] = (uint8_t)(product >> 8);
+        }
+    }
+}
+
+/* the uint16_t forms cover the fields beyond a byte, which have split tables rather than nibble tables */
+static inline bool gf_region_u16_valid(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                       const uint16_t *dst, size_t size)
+{
+    return gf && gf->symbol_size > 8 && multiplier <= gf->field_size && ((src && dst) || size == 0);
+}
+
+extern bool poporon_gf_mul_region_u16(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                      uint16_t *dst, size_t size)
+{
+    if (!gf_region_u16_valid(gf, multiplier, src, dst, size)) {
+        return false;
+    }
+
+    if (size > 0) {
+        poporon_kernel()->gf_mul_region_u16(gf, multiplier, src, dst, size);
+    }
+
+    return true;
+}
+
+extern bool poporon_gf_muladd_region_u16(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                         uint16_t *dst, size_t size)
+{
+    if (!gf_region_u16_valid(gf, multiplier, src, dst, size)) {
+        return false;
+    }
+
+    if (size > 0 && multiplier != 0) {
+        poporon_kernel()->gf_muladd_region_u16(gf, multiplier, src, dst, size);
+    }
+
+    return true;
+}
+
+/* one pass per source, a source that is dst itself is scaled in place before the others are added */
+extern bool poporon_gf_dot_region_u16(const poporon_gf_t *gf, const uint16_t *coefficients,
+                                      const uint16_t *const *sources, size_t count, uint16_t *dst, size_t size)
+{
+    const poporon_kernel_t *kernel;
+    size_t first, k;
+
+    if (!gf_region_u16_valid(gf, 0, dst, dst, size) || (count > 0 && (!coefficients || !sources))) {
+        return false;
+    }
+
+    first = 0;
+    for (k = 0; k < count; k++) {
+        if (!gf_region_u16_valid(gf, coefficients[k], sources[k], dst, size)) {
+            return false;
+        }
+
+        if (sources[k] == dst && sources[first] != dst) {
+            first = k;
+        }
+    }
+
+    if (size == 0) {
+        return true;
+    }
+
+    if (count == 0) {
+        pmemset(dst, 0, size * sizeof(uint16_t));
+
+        return true;
+    }
+
+    kernel = poporon_kernel();
+    kernel->gf_mul_region_u16(gf, coefficients[first], sources[first], dst, size);
+
+    for (k = 0; k < count; k++) {
+        if (k != first && coefficients[k] != 0) {
+            kernel->gf_muladd_region_u16(gf, coefficients[k], sources[k], dst, size);
+        }
+    }
+
+    return true;
+}
+
+static void *gf_registry_create(const void *key)
+{
+    const gf_key_t *gf_key = (const gf_key_t *)key;
+
+    return poporon_gf_create(gf_key->symbol_size, gf_key->generator_polynomial);
+}
+
+static void gf_registry_destroy(void *object)
+{
+    poporon_gf_destroy((poporon_gf_t *)object);
+}
+
+extern poporon_gf_t *poporon_gf_acquire(uint8_t symbol_size, uint16_t generator_polynomial)
+{
+    gf_key_t key;
+
+    /* static fields are already shared, there is nothing to count */
+    if (gf_static_lookup(symbol_size, generator_polynomial)) {
+        return poporon_gf_create(symbol_size, generator_polynomial);
+    }
+
+    pmemset(&key, 0, sizeof(key));
+    key.symbol_size = symbol_size;
+    key.generator_polynomial = generator_polynomial;
+
+    return (poporon_gf_t *)poporon_registry_acquire(REGISTRY_GF, &key, sizeof(key), gf_registry_create,
+                                                    gf_registry_destroy);
+}
+
+extern void poporon_gf_release(poporon_gf_t *gf)
+{
+    if (!gf || gf->is_static) {
+        return;
+    }
+
+    poporon_registry_release(gf);
+}
@@ -35,6 +35,7 @@
 typedef struct _poporon_rs_t poporon_rs_t;
 typedef struct _poporon_bch_t poporon_bch_t;
 typedef struct _poporon_ldpc_t poporon_ldpc_t;
+typedef struct _poporon_ldpc_workspace_t poporon_ldpc_workspace_t;
 
 struct _poporon_erasure_t {
     uint32_t capacity;
@@ -43,12 +44,29 @@ struct _poporon_erasure_t {
     uint16_t *corrections;
 };
 
+#define GF_NIBBLE_TABLE_SIZE 32
+#define GF_SPLIT_TABLE_SIZE  128 /* symbol_size > 8, per nibble position the low then the high product bytes */
+#define GF_EXP_PERIODS       3   /* exp_table covers sums of up to three logs */
+#define RS_ROOT_POWERS       8
+#define RS_ENCODE_MAX_SLICES 8
+#define RIBM_ROW_SIZE(roots) (2 * (size_t)(roots) + 2) /* riBM row: 2 * num_roots + 1 coefficients and a zero */
+#define INTERLEAVE_BLOCK     64 /* codewords transposed per pass by poporon_interleave() / poporon_deinterleave() */
+#define EC_BLOCK_SIZE        (8 * 1024) /* shard bytes per pass, a block of every source stays cached for all outputs */
+#define EC_PACKET_SIZE       2048 /* PPRN_EC_CAUCHY_XOR packet bytes, a block of a shard is 8 packets */
+#define FFT_WORKING_SET      (1024 * 1024) /* bytes of all transform buffers together in one pass */
+#define FFT_MIN_BLOCK_SIZE   256 /* shard bytes per pass however many transform buffers */
+
 struct _poporon_gf_t {
     uint8_t symbol_size;
-    uint8_t field_size;
-    uint16_t *log2exp;
-    uint16_t *exp2log;
+    uint16_t field_size;
+    const uint16_t *log2exp;
+    const uint16_t *exp2log;
+    /* GF_EXP_PERIODS * field_size entries, alpha^(i mod field_size), so log sums need no reduction */
+    const uint16_t *exp_table;
+    /* (field_size + 1) * GF_NIBBLE_TABLE_SIZE, low nibble products then high nibble products */
+    const uint8_t *nibble_tables;
     uint16_t generator_polynomial;
+    bool is_static; /* view of build time generated tables, never freed */
 };
 
 struct _poporon_rs_t {
@@ -57,6 +75,58 @@ struct _poporon_rs_t {
     uint16_t primitive_element;
     uint16_t num_roots;
     uint16_t *generator_polynomial;
+    uint8_t *feedback_polynomial; /* generator coefficients in polynomial form, register order */
+    uint8_t *root_powers;         /* RS_ROOT_POWERS per root, root^(2^k) in polynomial form */
+    uint8_t *quadratic_roots;     /* symbol_size <= 8: [kappa], a root of y^2 + y = kappa, 0 when there is none */
+    uint8_t encode_slices;        /* message bytes absorbed per slice encoder step, 0 when disabled */
+    uint16_t slice_stride;
+    uint8_t *slice_tables; /* [slice][byte][slice_stride], register contribution of byte entering at slice */
+    uint16_t matrix_stride;
+    uint8_t *encode_matrix; /* [field_size - num_roots][matrix_stride], parity contribution of a 1 per position */
+    uint16_t split_stride;
+    uint16_t *feedback_split; /* symbol_size > 8: [nibble position][nibble][split_stride], feedback times nibble */
+    uint8_t *root_splits;     /* symbol_size > 8: RS_ROOT_POWERS split tables per root, root^(2^k) */
+};
+
+typedef enum {
+    EC_OP_COPY = 0,    /* target = source */
+    EC_OP_XOR,         /* target ^= source */
+    EC_OP_COPY_TARGET, /* target = an earlier target, then XORs of the difference */
+    EC_OP_ZERO,
+} ec_op_kind_t;
+
+/* one packet operation of a PPRN_EC_CAUCHY_XOR schedule, packets are numbered shard * 8 + bit */
+typedef struct {
+    uint16_t target;
+    uint16_t source;
+    uint8_t kind;
+} ec_op_t;
+
+typedef struct {
+    ec_op_t *ops;
+    size_t count;
+} ec_schedule_t;
+
+typedef struct _ec_cache_t ec_cache_t;
+
+struct _poporon_ec_t {
+    poporon_gf_t *gf;
+    uint16_t data_shards;
+    uint16_t parity_shards;
+    poporon_ec_matrix_t matrix;
+    uint8_t *parity_matrix;        /* [parity_shards][data_shards], the generator rows below the identity */
+    ec_schedule_t encode_schedule; /* PPRN_EC_CAUCHY_XOR, parity packets from data packets */
+    ec_cache_t *cache;             /* reconstruction plans by erasure pattern, in ec.c */
+};
+
+struct _poporon_fft_t {
+    poporon_gf_t *gf;
+    uint16_t data_shards;
+    uint16_t parity_shards;
+    uint32_t parity_span; /* parity_shards rounded up to a power of two, the encoding transform size */
+    uint32_t span;        /* parity_span + data_shards rounded up to parity_span, then to a power of two */
+    uint16_t *omega;      /* [span], the point of position i: i read in the Cantor basis */
+    uint16_t *log_walsh;  /* [span], Walsh-Hadamard transform of log(omega[i]) over span, mod field_size */
 };
 
 typedef struct {
@@ -68,19 +138,45 @@ typedef struct {
     uint16_t *error_roots;
     uint16_t *register_coefficients;
     uint16_t *error_locations;
-    uint16_t primitive_inverse;
+    uint16_t *ribm; /* [3][RIBM_ROW_SIZE(num_roots)], the riBM discrepancy and correction rows */
 } decoder_buffer_t;
 
+/* everything a decode writes to, so that one poporon_t can serve several threads each holding a workspace */
+struct _poporon_workspace_t {
+    poporon_fec_type_t fec_type;
+
+    union {
+        struct {
+            decoder_buffer_t *buffer;
+            uint16_t num_roots;
+            size_t last_corrected;
+            uint8_t *lane_syndromes; /* [num_roots][lanes] for poporon_decode_interleaved(), grown on demand */
+            size_t lane_syndromes_size;
+        } rs;
+
+        struct {
+            poporon_ldpc_workspace_t *ldpc;
+            uint32_t last_iterations;
+        } ldpc;
+
+        struct {
+            int32_t last_num_errors;
+        } bch;
+    } ctx;
+};
+
 struct _poporon_t {
     poporon_fec_type_t fec_type;
+    poporon_workspace_t *workspace; /* used by the calls that do not take a workspace */
 
     union {
         struct {
             poporon_rs_t *rs;
-            decoder_buffer_t *buffer;
             poporon_erasure_t *erasure;
             uint16_t *ext_syndrome;
-            size_t last_corrected;
+            uint16_t primitive_inverse;
+            poporon_rs_decode_mode_t decode_mode;
+            poporon_rs_syndrome_mode_t syndrome_mode;
         } rs;
 
         struct {
@@ -88,30 +184,190 @@ struct _poporon_t {
             const int8_t *soft_llr;
             size_t soft_llr_size;
             uint32_t max_iterations;
-            uint32_t last_iterations;
             bool use_soft_decode;
         } ldpc;
 
         struct {
             poporon_bch_t *bch;
-            int32_t last_num_errors;
         } bch;
     } ctx;
 };
 
-static inline uint8_t gf_mod(poporon_gf_t *gf, uint16_t value)
+bool poporon_workspace_fits(const poporon_t *pprn, const poporon_workspace_t *workspace);
+
+/* codeword addressing for the batch APIs, either pointer lists or a fixed stride from a base */
+typedef struct {
+    uint8_t *const *data_list;
+    uint8_t *const *parity_list;
+    uint8_t *data;
+    uint8_t *parity;
+    size_t data_stride;
+    size_t parity_stride;
+} batch_layout_t;
+
+static inline uint8_t *batch_data(const batch_layout_t *layout, size_t index)
+{
+    return layout->data_list ? layout->data_list[index] : layout->data + index * layout->data_stride;
+}
+
+static inline uint8_t *batch_parity(const batch_layout_t *layout, size_t index)
+{
+    return layout->parity_list ? layout->parity_list[index] : layout->parity + index * layout->parity_stride;
+}
+
+/* strides that keep the codewords of a strided batch apart, so none overwrites the parity of another */
+static inline bool batch_strides_valid(const poporon_t *pprn, size_t data_stride, size_t size, size_t parity_stride,
+                                       size_t count)
+{
+    return data_stride >= size && (count <= 1 || parity_stride >= poporon_get_parity_size(pprn));
+}
+
+static inline uint16_t gf_mod(const poporon_gf_t *gf, uint32_t value)
 {
     while (value >= gf->field_size) {
         value -= gf->field_size;
         value = (value >> gf->symbol_size) + (value & gf->field_size);
     }
 
-    return value;
+    return (uint16_t)value;
+}
+
+/* alpha^log for any log below GF_EXP_PERIODS * field_size, e.g. a + b or a + b + field_size - c */
+static inline uint16_t gf_exp(const poporon_gf_t *gf, uint32_t log)
+{
+    return gf->exp_table[log];
+}
+
+/* a log below 2 * field_size back into [0, field_size), the common case of gf_mod() without the loop */
+static inline uint16_t gf_log_wrap(const poporon_gf_t *gf, uint32_t log)
+{
+    return (uint16_t)(log >= gf->field_size ? log - gf->field_size : log);
+}
+
+/* a * b in polynomial form through the log tables, for building tables rather than for inner loops */
+static inline uint16_t gf_mul(const poporon_gf_t *gf, uint16_t a, uint16_t b)
+{
+    if (a == 0 || b == 0) {
+        return 0;
+    }
+
+    return gf_exp(gf, (uint32_t)gf->exp2log[a] + gf->exp2log[b]);
+}
+
+/* 1 / a for a != 0 */
+static inline uint16_t gf_inv(const poporon_gf_t *gf, uint16_t a)
+{
+    return gf_exp(gf, (uint32_t)gf->field_size - gf->exp2log[a]);
 }
 
+static inline const uint8_t *gf_nibble_table(const poporon_gf_t *gf, uint8_t multiplier)
+{
+    return gf->nibble_tables + (size_t)multiplier * GF_NIBBLE_TABLE_SIZE;
+}
+
+static inline uint8_t gf_nibble_mul(const uint8_t *table, uint8_t value)
+{
+    return table[value & 0x0F] ^ table[16 + (value >> 4)];
+}
+
+/* fills a GF_SPLIT_TABLE_SIZE table for multiplier, the 16-bit counterpart of a nibble table */
+void poporon_gf_split_table(const poporon_gf_t *gf, uint16_t multiplier, uint8_t *table);
+
+/* multiplier * value with a split table: four nibble lookups for each product byte */
+static inline uint16_t gf_split_mul(const uint8_t *table, uint16_t value)
+{
+    uint8_t n0, n1, n2, n3;
+
+    n0 = value & 0x0F;
+    n1 = (value >> 4) & 0x0F;
+    n2 = (value >> 8) & 0x0F;
+    n3 = value >> 12;
+
+    return (uint16_t)((table[n0] ^ table[32 + n1] ^ table[64 + n2] ^ table[96 + n3]) |
+                      ((table[16 + n0] ^ table[48 + n1] ^ table[80 + n2] ^ table[112 + n3]) << 8));
+}
+
+/* a * b in polynomial form one bit at a time, needs no tables, the reference for the carry-less kernels */
+static inline uint16_t gf_mul_bitserial(const poporon_gf_t *gf, uint16_t a, uint16_t b)
+{
+    uint32_t product, polynomial;
+    int8_t i;
+
+    polynomial = ((uint32_t)1 << gf->symbol_size) | gf->generator_polynomial;
+    product = 0;
+
+    for (i = 0; i < gf->symbol_size; i++) {
+        if (b & (1U << i)) {
+            product ^= (uint32_t)a << i;
+        }
+    }
+
+    for (i = (int8_t)(2 * gf->symbol_size - 2); i >= gf->symbol_size; i--) {
+        if (product & ((uint32_t)1 << i)) {
+            product ^= polynomial << (i - gf->symbol_size);
+        }
+    }
+
+    return (uint16_t)product;
+}
+
+/*
+ * floor(c * x^symbol_size / p(x)) for a fixed multiplier c. With it a * c mod p(x) takes two carry-less multiplies:
+ * q = (a * quotient) >> symbol_size is exactly floor(a * c / p(x)), and a * c ^ q * p(x) is the remainder.
+ */
+static inline uint16_t gf_clmul_quotient(const poporon_gf_t *gf, uint16_t c)
+{
+    uint32_t dividend, polynomial;
+    uint16_t quotient;
+    int8_t i;
+
+    polynomial = ((uint32_t)1 << gf->symbol_size) | gf->generator_polynomial;
+    dividend = (uint32_t)c << gf->symbol_size;
+    quotient = 0;
+
+    for (i = (int8_t)(2 * gf->symbol_size - 1); i >= gf->symbol_size; i--) {
+        if (dividend & ((uint32_t)1 << i)) {
+            dividend ^= polynomial << (i - gf->symbol_size);
+            quotient |= (uint16_t)(1U << (i - gf->symbol_size));
+        }
+    }
+
+    return quotient;
+}
+
+typedef enum {
+    REGISTRY_GF = 1,
+    REGISTRY_RS,
+    REGISTRY_LDPC,
+} registry_kind_t;
+
+typedef void *(*registry_create_t)(const void *key);
+typedef void (*registry_destroy_t)(void *object);
+
+/*
+ * Process-wide refcounted cache of immutable objects, keyed by the bytes of their construction parameters (keys must
+ * be zero-filled before the fields are set so that padding compares equal). Thread-safe.
+ */
+void *poporon_registry_acquire(registry_kind_t kind, const void *key, size_t key_size, registry_create_t create,
+                               registry_destroy_t destroy);
+bool poporon_registry_release(void *object);
+size_t poporon_registry_size(void);
+
+/* shared read-only fields and RS codes, poporon_gf_create() / poporon_rs_create() return private ones instead */
+poporon_gf_t *poporon_gf_acquire(uint8_t symbol_size, uint16_t generator_polynomial);
+void poporon_gf_release(poporon_gf_t *gf);
+poporon_rs_t *poporon_rs_acquire(uint8_t symbol_size, uint16_t generator_polynomial, uint16_t first_consecutive_root,
+                                 uint16_t primitive_element, uint8_t num_roots, poporon_rs_encode_mode_t encode_mode);
+void poporon_rs_release(poporon_rs_t *rs);
+
 poporon_rs_t *poporon_rs_create(uint8_t symbol_size, uint16_t generator_polynomial, uint16_t first_consecutive_root,
                                 uint16_t primitive_element, uint8_t num_roots);
 void poporon_rs_destroy(poporon_rs_t *rs);
+bool poporon_rs_enable_encode_slices(poporon_rs_t *rs, uint8_t slices);
+bool poporon_rs_enable_encode_matrix(poporon_rs_t *rs);
+
+/* parity of data[size] with the fastest encoder the code carries, symbol_size <= 8 */
+void poporon_rs_encode_parity(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity);
 
 poporon_bch_t *poporon_bch_create(uint8_t symbol_size, uint16_t generator_polynomial, uint8_t t);
 void poporon_bch_destroy(poporon_bch_t *bch);
@@ -121,6 +377,7 @@ uint16_t poporon_bch_get_data_length(const poporon_bch_t *bch);
 uint8_t poporon_bch_get_correction_capability(const poporon_bch_t *bch);
 bool poporon_bch_encode(poporon_bch_t *bch, uint32_t data, uint32_t *codeword);
 bool poporon_bch_decode(poporon_bch_t *bch, uint32_t received, uint32_t *corrected, int32_t *num_errors);
+bool poporon_bch_check(const poporon_bch_t *bch, uint32_t received);
 uint32_t poporon_bch_extract_data(const poporon_bch_t *bch, uint32_t codeword);
 
 #endif /* POPORON_INTERNAL_COMMON_H */
@@ -23,6 +23,9 @@ struct _poporon_config_t {
             uint8_t num_roots;
             poporon_erasure_t *erasure;
             uint16_t *syndrome;
+            poporon_rs_encode_mode_t encode_mode;
+            poporon_rs_decode_mode_t decode_mode;
+            poporon_rs_syndrome_mode_t syndrome_mode;
         } rs;
         struct {
             size_t block_size;
@@ -0,0 +1,386 @@
+/*
+ * libpoporon - kernel.h
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef POPORON_INTERNAL_KERNEL_H
+#define POPORON_INTERNAL_KERNEL_H
+
+#include "common.h"
+
+typedef struct {
+    poporon_simd_level_t level;
+
+    /*
+     * parity = data * x^num_roots mod g(x), requires rs->feedback_polynomial for every level but scalar. Vector levels
+     * step the register a whole vector at a time, the zero padding of feedback_polynomial to a multiple of 64 and the
+     * window slack past num_roots keep the last partial vector harmless.
+     */
+    void (*rs_encode)(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity);
+
+    /* syndrome[] receives log-domain values, returns true when any syndrome is non-zero, requires rs->root_powers */
+    bool (*rs_syndrome)(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                        uint16_t *syndrome);
+
+    /* roots of the log-domain error locator, returns the number of roots found (at most degree) */
+    uint16_t (*rs_chien)(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                         uint16_t primitive_inverse, uint16_t *registers, uint16_t *error_roots,
+                         uint16_t *error_locations);
+
+    /*
+     * Interleaved batches: row r holds symbol r of every codeword, codeword c sits in column c of rows that are
+     * stride bytes apart. Each kernel handles lanes codewords, parity and syndrome (polynomial form) use the same
+     * layout with num_roots rows. Every level but scalar requires rs->feedback_polynomial and rs->root_powers.
+     *
+     * The lanes of a vector hold the same symbol position of different codewords, so every multiplier is a constant
+     * shared by the whole vector. The encoder keeps the register as a ring of vectors whose head is the element
+     * consumed by the next feedback, the syndrome walks the rows outer with one independent Horner chain per root.
+     */
+    void (*rs_encode_interleaved)(const poporon_rs_t *rs, const uint8_t *data, size_t size, size_t stride,
+                                  size_t lanes, uint8_t *parity);
+    void (*rs_syndrome_interleaved)(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                                    size_t stride, size_t lanes, uint8_t *syndrome);
+
+    /*
+     * symbol_size > 8 counterparts over uint16_t symbols, require rs->feedback_split and rs->root_splits. The
+     * split_stride padding and the window slack cover the last partial vector as for rs_encode.
+     */
+    void (*rs_encode_u16)(const poporon_rs_t *rs, const uint16_t *data, size_t size, uint16_t *parity);
+    bool (*rs_syndrome_u16)(const poporon_rs_t *rs, const uint16_t *data, size_t size, const uint16_t *parity,
+                            uint16_t *syndrome);
+
+    /* Chien search over the positions [padding_length, field_size) of a shortened symbol_size > 8 code */
+    uint16_t (*rs_chien_u16)(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                             int32_t padding_length, uint16_t *registers, uint16_t *error_roots,
+                             uint16_t *error_locations);
+
+    /* dst[i] ^= multiplier * src[i] over GF(2^m) with m <= 8, requires gf->nibble_tables */
+    void (*gf_muladd_region)(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                             size_t size);
+
+    /* dst[i] = sum of coefficients[k] * sources[k][i] over GF(2^m) with m <= 8, count >= 1, dst may be a source */
+    void (*gf_dot_region)(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                          size_t count, uint8_t *dst, size_t size);
+
+    /* dst[i] = / ^= multiplier * src[i] over GF(2^m) with m > 8, bits above m are ignored, dst may be src */
+    void (*gf_mul_region_u16)(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src, uint16_t *dst,
+                              size_t size);
+    void (*gf_muladd_region_u16)(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src, uint16_t *dst,
+                                 size_t size);
+
+    /*
+     * normalized min-sum check node update over a CSR parity check matrix. Every level matches the scalar kernel bit
+     * for bit: min1 belongs to the first edge of the row holding it, and the 15/16 scaling is x - (x + 15) / 16.
+     */
+    void (*ldpc_check_node)(const uint32_t *row_ptr, uint32_t num_checks, const int16_t *var_to_check,
+                            int16_t *check_to_var);
+} poporon_kernel_t;
+
+#define RS_STAGED_CODEWORD_SIZE 256
+#define RS_ENCODE_WINDOW_SIZE   1024
+#define RS_ENCODE_WINDOW_SLACK  64 /* vector kernels may touch up to one lane past the register */
+
+/*
+ * Parity register kept as a window sliding over a stack buffer: shifting the LFSR advances head instead of moving
+ * num_roots bytes, the register is copied back to the front only when it reaches the end of the buffer.
+ */
+typedef struct {
+    size_t head;
+    uint8_t bytes[RS_ENCODE_WINDOW_SIZE];
+} rs_encode_window_t;
+
+/* the same window over 16-bit symbols */
+typedef struct {
+    size_t head;
+    uint16_t words[RS_ENCODE_WINDOW_SIZE];
+} rs_encode_window_u16_t;
+
+const poporon_kernel_t *poporon_kernel(void);
+
+static inline uint8_t *rs_window_reset(rs_encode_window_t *window, uint16_t num_roots)
+{
+    window->head = 0;
+    pmemset(window->bytes, 0, num_roots + RS_ENCODE_WINDOW_SLACK);
+
+    return window->bytes;
+}
+
+/* drops the first count register bytes and appends count zero bytes, returns the new register start */
+static inline uint8_t *rs_window_shift(rs_encode_window_t *window, uint16_t num_roots, size_t count)
+{
+    window->head += count;
+
+    if (window->head + num_roots + RS_ENCODE_WINDOW_SLACK > RS_ENCODE_WINDOW_SIZE) {
+        pmemmove(window->bytes, &window->bytes[window->head], num_roots - count);
+        window->head = 0;
+    }
+
+    pmemset(&window->bytes[window->head + num_roots - count], 0, count);
+
+    return &window->bytes[window->head];
+}
+
+static inline uint16_t *rs_window_u16_reset(rs_encode_window_u16_t *window, uint16_t num_roots)
+{
+    window->head = 0;
+    pmemset(window->words, 0, (num_roots + RS_ENCODE_WINDOW_SLACK) * sizeof(uint16_t));
+
+    return window->words;
+}
+
+static inline uint16_t *rs_window_u16_shift(rs_encode_window_u16_t *window, uint16_t num_roots, size_t count)
+{
+    window->head += count;
+
+    if (window->head + num_roots + RS_ENCODE_WINDOW_SLACK > RS_ENCODE_WINDOW_SIZE) {
+        pmemmove(window->words, &window->words[window->head], (num_roots - count) * sizeof(uint16_t));
+        window->head = 0;
+    }
+
+    pmemset(&window->words[window->head + num_roots - count], 0, count * sizeof(uint16_t));
+
+    return &window->words[window->head];
+}
+
+/* the feedback_split row for the nibble of fb at position, xoring all four rows multiplies g(x) by fb */
+static inline const uint16_t *rs_split_row(const poporon_rs_t *rs, uint8_t position, uint16_t fb)
+{
+    return &rs->feedback_split[((size_t)position * 16 + ((fb >> (4 * position)) & 0x0F)) * rs->split_stride];
+}
+
+/*
+ * Dot product over bytes [begin, end), the scalar kernel and the tail of the vector ones. One source at a time, so
+ * that each pass walks with a single nibble table; a source that is dst itself is scaled in place first.
+ */
+static inline void gf_dot_bytes(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                                size_t count, uint8_t *dst, size_t begin, size_t end)
+{
+    const uint8_t *table;
+    size_t first, i, k;
+
+    first = 0;
+    for (k = 0; k < count; k++) {
+        if (sources[k] == dst) {
+            first = k;
+            break;
+        }
+    }
+
+    table = gf_nibble_table(gf, coefficients[first]);
+    for (i = begin; i < end; i++) {
+        dst[i] = gf_nibble_mul(table, sources[first][i]);
+    }
+
+    for (k = 0; k < count; k++) {
+        if (k == first) {
+            continue;
+        }
+
+        table = gf_nibble_table(gf, coefficients[k]);
+        for (i = begin; i < end; i++) {
+            dst[i] ^= gf_nibble_mul(table, sources[k][i]);
+        }
+    }
+}
+
+/* split table of root^(2^power) */
+static inline const uint8_t *rs_root_split(const poporon_rs_t *rs, uint16_t root, uint8_t power)
+{
+    return &rs->root_splits[((size_t)root * RS_ROOT_POWERS + power) * GF_SPLIT_TABLE_SIZE];
+}
+
+/*
+ * Copies data || parity into staged[] right-aligned to a multiple of lanes, so that the last symbol lands in the
+ * last lane of the last block. Leading zeros do not change a syndrome. Returns the number of blocks, or 0 when the
+ * codeword does not fit.
+ */
+static inline size_t rs_stage_codeword(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                       const uint8_t *parity, uint8_t *staged, size_t lanes)
+{
+    size_t length, num_blocks, offset, i;
+
+    length = size + rs->num_roots;
+    if (length > RS_STAGED_CODEWORD_SIZE) {
+        return 0;
+    }
+
+    num_blocks = (length + lanes - 1) / lanes;
+    offset = num_blocks * lanes - length;
+    pmemset(staged, 0, offset);
+    pmemcpy(&staged[offset], data, size);
+    pmemcpy(&staged[offset + size], parity, rs->num_roots);
+
+    if (rs->gf->field_size != 0xFF) {
+        for (i = offset; i < offset + length; i++) {
+            staged[i] &= rs->gf->field_size;
+        }
+    }
+
+    return num_blocks;
+}
+
+/*
+ * 16-bit codewords run up to 65535 symbols and are not staged as a whole. Returns the number of lanes wide blocks of
+ * data || parity once front-padded with *offset zeros, so that the last symbol lands in the last lane.
+ */
+static inline size_t rs_u16_blocks(const poporon_rs_t *rs, size_t size, size_t lanes, size_t *offset)
+{
+    size_t length, num_blocks;
+
+    length = size + rs->num_roots;
+    num_blocks = (length + lanes - 1) / lanes;
+    *offset = num_blocks * lanes - length;
+
+    return num_blocks;
+}
+
+/* block of the padded codeword, read in place when it needs neither padding nor masking, else assembled in staged[] */
+static inline const uint16_t *rs_u16_block(const poporon_rs_t *rs, const uint16_t *data, size_t size,
+                                           const uint16_t *parity, size_t offset, size_t block, size_t lanes,
+                                           uint16_t *staged)
+{
+    size_t start, position, i;
+
+    start = block * lanes;
+
+    if (rs->gf->field_size == 0xFFFF && start >= offset) {
+        position = start - offset;
+        if (position + lanes <= size) {
+            return &data[position];
+        }
+
+        if (position >= size) {
+            return &parity[position - size];
+        }
+    }
+
+    for (i = 0; i < lanes; i++) {
+        if (start + i < offset) {
+            staged[i] = 0;
+            continue;
+        }
+
+        position = start + i - offset;
+        staged[i] = (position < size ? data[position] : parity[position - size]) & rs->gf->field_size;
+    }
+
+    return staged;
+}
+
+/*
+ * Lane setup of the vector Chien searches over 8-bit symbols. For every nonzero coefficient j of the log-domain
+ * error_locator, lanes bytes of lambda_j * alpha^(j * (1 + t)) go to values + active * lanes, and tables[active] is the
+ * nibble table of alpha^(j * lanes) that steps them to the next lanes field points. Returns the active count.
+ */
+static inline uint16_t rs_chien_lanes(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                      size_t lanes, uint8_t *values, const uint8_t **tables)
+{
+    uint16_t active, log, j;
+    size_t t;
+
+    active = 0;
+    for (j = 1; j <= degree; j++) {
+        if (error_locator[j] == rs->gf->field_size) {
+            continue;
+        }
+
+        log = gf_mod(rs->gf, (uint32_t)error_locator[j] + j);
+        for (t = 0; t < lanes; t++) {
+            values[(size_t)active * lanes + t] = (uint8_t)rs->gf->log2exp[log];
+            log = gf_log_wrap(rs->gf, (uint32_t)log + j);
+        }
+
+        tables[active++] = gf_nibble_table(rs->gf, (uint8_t)rs->gf->log2exp[gf_mod(rs->gf, (uint32_t)j * lanes)]);
+    }
+
+    return active;
+}
+
+/*
+ * Records the roots flagged in found, bit t for the field point first + t, in the order and with the locations of
+ * poporon_rs_chien_scalar(). Returns true once degree roots are known.
+ */
+static inline bool rs_chien_record(const poporon_rs_t *rs, uint32_t found, uint16_t first, uint16_t degree,
+                                   uint16_t primitive_inverse, uint16_t *error_roots, uint16_t *error_locations,
+                                   uint16_t *error_count)
+{
+    uint16_t i;
+
+    for (i = first; found != 0 && i <= rs->gf->field_size; i++, found >>= 1) {
+        if ((found & 1) == 0) {
+            continue;
+        }
+
+        error_roots[*error_count] = i;
+        error_locations[*error_count] =
+            gf_mod(rs->gf, (uint32_t)i * primitive_inverse + rs->gf->field_size - 1);
+        if (++(*error_count) == degree) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void poporon_rs_encode_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity);
+void poporon_rs_encode_slice(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity);
+bool poporon_rs_syndrome_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                                uint16_t *syndrome);
+uint16_t poporon_rs_chien_scalar(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                 uint16_t primitive_inverse, uint16_t *registers, uint16_t *error_roots,
+                                 uint16_t *error_locations);
+void poporon_rs_encode_interleaved_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size, size_t stride,
+                                          size_t lanes, uint8_t *parity);
+void poporon_rs_syndrome_interleaved_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                            const uint8_t *parity, size_t stride, size_t lanes, uint8_t *syndrome);
+void poporon_rs_encode_u16_scalar(const poporon_rs_t *rs, const uint16_t *data, size_t size, uint16_t *parity);
+bool poporon_rs_syndrome_u16_scalar(const poporon_rs_t *rs, const uint16_t *data, size_t size, const uint16_t *parity,
+                                    uint16_t *syndrome);
+uint16_t poporon_rs_chien_u16_scalar(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                     int32_t padding_length, uint16_t *registers, uint16_t *error_roots,
+                                     uint16_t *error_locations);
+void poporon_gf_muladd_region_scalar(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                                     size_t size);
+void poporon_gf_dot_region_scalar(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                                  size_t count, uint8_t *dst, size_t size);
+void poporon_gf_mul_region_u16_scalar(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                      uint16_t *dst, size_t size);
+void poporon_gf_muladd_region_u16_scalar(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                         uint16_t *dst, size_t size);
+void poporon_ldpc_check_node_scalar(const uint32_t *row_ptr, uint32_t num_checks, const int16_t *var_to_check,
+                                    int16_t *check_to_var);
+
+extern const poporon_kernel_t poporon_kernel_scalar;
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+extern const poporon_kernel_t poporon_kernel_ssse3;
+extern const poporon_kernel_t poporon_kernel_avx2;
+/* kernels of the AVX2 tier shared with AVX-512BW */
+void poporon_rs_encode_u16_avx2(const poporon_rs_t *rs, const uint16_t *data, size_t size, uint16_t *parity);
+bool poporon_rs_syndrome_u16_avx2(const poporon_rs_t *rs, const uint16_t *data, size_t size, const uint16_t *parity,
+                                  uint16_t *syndrome);
+uint16_t poporon_rs_chien_avx2(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                uint16_t primitive_inverse, uint16_t *registers, uint16_t *error_roots,
+                                uint16_t *error_locations);
+uint16_t poporon_rs_chien_u16_clmul(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                    int32_t padding_length, uint16_t *registers, uint16_t *error_roots,
+                                    uint16_t *error_locations);
+void poporon_gf_mul_region_u16_avx2(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src, uint16_t *dst,
+                                    size_t size);
+void poporon_gf_muladd_region_u16_avx2(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                       uint16_t *dst, size_t size);
+#if defined(POPORON_SIMD_AVX512) && (defined(__x86_64__) || defined(_M_X64))
+#define POPORON_KERNEL_AVX512BW 1
+extern const poporon_kernel_t poporon_kernel_avx512bw;
+#endif
+#elif POPORON_USE_SIMD && defined(POPORON_SIMD_NEON)
+extern const poporon_kernel_t poporon_kernel_neon;
+#elif POPORON_USE_SIMD && defined(POPORON_SIMD_WASM)
+extern const poporon_kernel_t poporon_kernel_wasm;
+#endif
+
+#endif /* POPORON_INTERNAL_KERNEL_H */
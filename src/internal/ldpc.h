@@ -16,6 +16,9 @@
 #define LLR_MIN      ((int16_t)-32000)
 #define LLR_INFINITY ((int16_t)30000)
 
+#define MINSUM_ALPHA_NUMERATOR   15
+#define MINSUM_ALPHA_DENOMINATOR 16
+
 typedef struct {
     poporon_ldpc_matrix_type_t matrix_type;
     uint32_t column_weight;
@@ -29,6 +32,10 @@ typedef struct {
 poporon_ldpc_t *poporon_ldpc_create(size_t block_size, poporon_ldpc_rate_t rate, const poporon_ldpc_params_t *config);
 void poporon_ldpc_destroy(poporon_ldpc_t *ldpc);
 
+/* shared read-only code from the registry, keyed by every parameter that shapes the matrix and interleavers */
+poporon_ldpc_t *poporon_ldpc_acquire(size_t block_size, poporon_ldpc_rate_t rate, const poporon_ldpc_params_t *config);
+void poporon_ldpc_release(poporon_ldpc_t *ldpc);
+
 bool poporon_ldpc_params_default(poporon_ldpc_params_t *config);
 bool poporon_ldpc_params_burst_resistant(poporon_ldpc_params_t *config);
 
@@ -36,13 +43,19 @@ size_t poporon_ldpc_info_size(const poporon_ldpc_t *ldpc);
 size_t poporon_ldpc_codeword_size(const poporon_ldpc_t *ldpc);
 size_t poporon_ldpc_parity_size(const poporon_ldpc_t *ldpc);
 
-bool poporon_ldpc_encode(poporon_ldpc_t *ldpc, const uint8_t *info, uint8_t *parity);
-bool poporon_ldpc_decode_hard(poporon_ldpc_t *ldpc, uint8_t *codeword, uint32_t max_iterations,
-                              uint32_t *iterations_used);
-bool poporon_ldpc_decode_soft(poporon_ldpc_t *ldpc, const int8_t *llr, uint8_t *codeword, uint32_t max_iterations,
-                              uint32_t *iterations_used);
+poporon_ldpc_workspace_t *poporon_ldpc_workspace_create(const poporon_ldpc_t *ldpc);
+void poporon_ldpc_workspace_destroy(poporon_ldpc_workspace_t *workspace);
+bool poporon_ldpc_workspace_fits(const poporon_ldpc_t *ldpc, const poporon_ldpc_workspace_t *workspace);
+
+bool poporon_ldpc_encode(const poporon_ldpc_t *ldpc, const uint8_t *info, uint8_t *parity);
+bool poporon_ldpc_decode_hard(const poporon_ldpc_t *ldpc, poporon_ldpc_workspace_t *workspace, uint8_t *codeword,
+                              uint32_t max_iterations, uint32_t *iterations_used);
+bool poporon_ldpc_decode_soft(const poporon_ldpc_t *ldpc, poporon_ldpc_workspace_t *workspace, const int8_t *llr,
+                              uint8_t *codeword, uint32_t max_iterations, uint32_t *iterations_used);
 
 bool poporon_ldpc_check(const poporon_ldpc_t *ldpc, const uint8_t *codeword);
+/* the info and parity halves as poporon_encode() leaves them, inner interleaving included, without a copy */
+bool poporon_ldpc_check_split(const poporon_ldpc_t *ldpc, const uint8_t *info, const uint8_t *parity);
 bool poporon_ldpc_has_interleaver(const poporon_ldpc_t *ldpc);
 
 bool poporon_ldpc_interleave(const poporon_ldpc_t *ldpc, const uint8_t *input, uint8_t *output);
@@ -93,13 +106,22 @@ struct _poporon_ldpc_t {
 
     sparse_matrix_t parity_matrix;
     column_view_t parity_matrix_cols;
-    messages_t msg;
     interleaver_t interleaver;
     outer_interleaver_t outer_interleaver;
+};
 
+/* per-thread decoder state, every buffer is sized for the code it was created from */
+struct _poporon_ldpc_workspace_t {
+    size_t num_edges;
+    size_t codeword_bits;
+    size_t codeword_bytes;
+    size_t info_bytes;
+
+    messages_t msg;
     uint8_t *temp_codeword;
     uint8_t *temp_interleaved;
     uint8_t *temp_outer;
+    int8_t *temp_llr;
 };
 
 static inline int16_t ldpc_saturate(int32_t val)
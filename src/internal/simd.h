@@ -13,7 +13,7 @@
 #include <stddef.h>
 #include <stdint.h>
 
-#if defined(POPORON_SIMD_AVX2)
+#if defined(POPORON_SIMD_X86)
 #include <immintrin.h>
 #elif defined(POPORON_SIMD_NEON)
 #include <arm_neon.h>
@@ -0,0 +1,237 @@
+/*
+ * libpoporon - thread.h
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#ifndef POPORON_INTERNAL_THREAD_H
+#define POPORON_INTERNAL_THREAD_H
+
+#include "common.h"
+
+#ifndef POPORON_USE_THREADS
+#define POPORON_USE_THREADS 0
+#endif
+
+/*
+ * Minimal mutex / condition variable / thread wrappers over Win32 and pthreads. Mutexes are real in every build, the
+ * registry and the EC plan cache rely on them whatever POPORON_USE_THREADS says. Without thread support only the
+ * condition variable operations become no-ops and thread creation fails, so poporon_pool_t falls back to the calling
+ * thread. PMUTEX_INITIALIZER initializes mutexes with static storage duration.
+ */
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+typedef SRWLOCK pmutex_t;
+
+#define PMUTEX_INITIALIZER SRWLOCK_INIT
+
+static inline bool pmutex_init(pmutex_t *mutex)
+{
+    InitializeSRWLock(mutex);
+
+    return true;
+}
+
+static inline void pmutex_destroy(pmutex_t *mutex)
+{
+    (void)mutex;
+}
+
+static inline void pmutex_lock(pmutex_t *mutex)
+{
+    AcquireSRWLockExclusive(mutex);
+}
+
+static inline void pmutex_unlock(pmutex_t *mutex)
+{
+    ReleaseSRWLockExclusive(mutex);
+}
+#else
+#include <pthread.h>
+
+typedef pthread_mutex_t pmutex_t;
+
+#define PMUTEX_INITIALIZER PTHREAD_MUTEX_INITIALIZER
+
+static inline bool pmutex_init(pmutex_t *mutex)
+{
+    return pthread_mutex_init(mutex, NULL) == 0;
+}
+
+static inline void pmutex_destroy(pmutex_t *mutex)
+{
+    pthread_mutex_destroy(mutex);
+}
+
+static inline void pmutex_lock(pmutex_t *mutex)
+{
+    pthread_mutex_lock(mutex);
+}
+
+static inline void pmutex_unlock(pmutex_t *mutex)
+{
+    pthread_mutex_unlock(mutex);
+}
+#endif
+
+#if POPORON_USE_THREADS && defined(_WIN32)
+typedef CONDITION_VARIABLE pcond_t;
+typedef HANDLE pthrd_t;
+
+#define PTHRD_ROUTINE(name, arg) DWORD WINAPI name(LPVOID arg)
+#define PTHRD_RETURN             return 0
+
+typedef DWORD(WINAPI *pthrd_routine_t)(LPVOID);
+
+static inline bool pcond_init(pcond_t *cond)
+{
+    InitializeConditionVariable(cond);
+
+    return true;
+}
+
+static inline void pcond_destroy(pcond_t *cond)
+{
+    (void)cond;
+}
+
+static inline void pcond_wait(pcond_t *cond, pmutex_t *mutex)
+{
+    SleepConditionVariableSRW(cond, mutex, INFINITE, 0);
+}
+
+static inline void pcond_broadcast(pcond_t *cond)
+{
+    WakeAllConditionVariable(cond);
+}
+
+static inline bool pthrd_create(pthrd_t *thread, pthrd_routine_t routine, void *arg)
+{
+    *thread = CreateThread(NULL, 0, routine, arg, 0, NULL);
+
+    return *thread != NULL;
+}
+
+static inline void pthrd_join(pthrd_t thread)
+{
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+static inline size_t pcpu_count(void)
+{
+    SYSTEM_INFO info;
+
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors > 0 ? (size_t)info.dwNumberOfProcessors : 1;
+}
+#elif POPORON_USE_THREADS
+#include <unistd.h>
+
+typedef pthread_cond_t pcond_t;
+typedef pthread_t pthrd_t;
+
+#define PTHRD_ROUTINE(name, arg) void *name(void *arg)
+#define PTHRD_RETURN             return NULL
+
+typedef void *(*pthrd_routine_t)(void *);
+
+static inline bool pcond_init(pcond_t *cond)
+{
+    return pthread_cond_init(cond, NULL) == 0;
+}
+
+static inline void pcond_destroy(pcond_t *cond)
+{
+    pthread_cond_destroy(cond);
+}
+
+static inline void pcond_wait(pcond_t *cond, pmutex_t *mutex)
+{
+    pthread_cond_wait(cond, mutex);
+}
+
+static inline void pcond_broadcast(pcond_t *cond)
+{
+    pthread_cond_broadcast(cond);
+}
+
+static inline bool pthrd_create(pthrd_t *thread, pthrd_routine_t routine, void *arg)
+{
+    return pthread_create(thread, NULL, routine, arg) == 0;
+}
+
+static inline void pthrd_join(pthrd_t thread)
+{
+    pthread_join(thread, NULL);
+}
+
+static inline size_t pcpu_count(void)
+{
+#if defined(_SC_NPROCESSORS_ONLN)
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (size_t)count : 1;
+#else
+    return 1;
+#endif
+}
+#else
+typedef int pcond_t;
+typedef int pthrd_t;
+
+#define PTHRD_ROUTINE(name, arg) void *name(void *arg)
+#define PTHRD_RETURN             return NULL
+
+typedef void *(*pthrd_routine_t)(void *);
+
+static inline bool pcond_init(pcond_t *cond)
+{
+    *cond = 0;
+
+    return true;
+}
+
+static inline void pcond_destroy(pcond_t *cond)
+{
+    (void)cond;
+}
+
+static inline void pcond_wait(pcond_t *cond, pmutex_t *mutex)
+{
+    (void)cond;
+    (void)mutex;
+}
+
+static inline void pcond_broadcast(pcond_t *cond)
+{
+    (void)cond;
+}
+
+static inline bool pthrd_create(pthrd_t *thread, pthrd_routine_t routine, void *arg)
+{
+    (void)thread;
+    (void)routine;
+    (void)arg;
+
+    return false;
+}
+
+static inline void pthrd_join(pthrd_t thread)
+{
+    (void)thread;
+}
+
+static inline size_t pcpu_count(void)
+{
+    return 1;
+}
+#endif
+
+#endif /* POPORON_INTERNAL_THREAD_H */
@@ -0,0 +1,236 @@
+/*
+ * libpoporon - kernel.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/kernel.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+#define CPUID_1_ECX_PCLMULQDQ (1U << 1)
+#define CPUID_1_ECX_SSSE3     (1U << 9)
+#define CPUID_1_ECX_OSXSAVE   (1U << 27)
+#define CPUID_1_ECX_AVX       (1U << 28)
+#define CPUID_7_EBX_AVX2      (1U << 5)
+#define CPUID_7_EBX_AVX512F   (1U << 16)
+#define CPUID_7_EBX_AVX512BW  (1U << 30)
+#define XCR0_YMM_STATE        0x06
+#define XCR0_ZMM_STATE        0xE6
+#endif
+
+/*
+ * Only ever accessed through the helpers below: relaxed atomics are enough since every value is a constant static
+ * table. C99 has no <stdatomic.h>, so this goes through the compiler builtins.
+ */
+static const poporon_kernel_t *selected_kernel = NULL;
+
+static inline const poporon_kernel_t *selected_kernel_load(void)
+{
+#if defined(_MSC_VER)
+    return (const poporon_kernel_t *)_InterlockedCompareExchangePointer((void *volatile *)&selected_kernel, NULL, NULL);
+#else
+    return __atomic_load_n(&selected_kernel, __ATOMIC_RELAXED);
+#endif
+}
+
+static inline void selected_kernel_store(const poporon_kernel_t *kernel)
+{
+#if defined(_MSC_VER)
+    _InterlockedExchangePointer((void *volatile *)&selected_kernel, (void *)kernel);
+#else
+    __atomic_store_n(&selected_kernel, kernel, __ATOMIC_RELAXED);
+#endif
+}
+
+/* installs kernel unless another thread or poporon_simd_set_level() got there first, returns the table in place */
+static inline const poporon_kernel_t *selected_kernel_init(const poporon_kernel_t *kernel)
+{
+#if defined(_MSC_VER)
+    const poporon_kernel_t *current;
+
+    current = (const poporon_kernel_t *)_InterlockedCompareExchangePointer((void *volatile *)&selected_kernel,
+                                                                           (void *)kernel, NULL);
+
+    return current ? current : kernel;
+#else
+    const poporon_kernel_t *expected = NULL;
+
+    if (!__atomic_compare_exchange_n(&selected_kernel, &expected, kernel, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+        return expected;
+    }
+
+    return kernel;
+#endif
+}
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+static inline void cpuid(uint32_t leaf, uint32_t subleaf, uint32_t *regs)
+{
+#if defined(_MSC_VER)
+    int info[4];
+
+    __cpuidex(info, (int)leaf, (int)subleaf);
+    regs[0] = (uint32_t)info[0];
+    regs[1] = (uint32_t)info[1];
+    regs[2] = (uint32_t)info[2];
+    regs[3] = (uint32_t)info[3];
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+static inline uint64_t xgetbv(void)
+{
+#if defined(_MSC_VER)
+    return (uint64_t)_xgetbv(0);
+#else
+    uint32_t eax, edx;
+
+    __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+
+static inline poporon_simd_level_t detect_level_x86(void)
+{
+    uint64_t xcr0;
+    uint32_t regs[4], max_leaf, leaf1_ecx, leaf7_ebx;
+
+    cpuid(0, 0, regs);
+    max_leaf = regs[0];
+
+    cpuid(1, 0, regs);
+    leaf1_ecx = regs[2];
+
+    leaf7_ebx = 0;
+    if (max_leaf >= 7) {
+        cpuid(7, 0, regs);
+        leaf7_ebx = regs[1];
+    }
+
+    xcr0 = 0;
+    if (leaf1_ecx & CPUID_1_ECX_OSXSAVE) {
+        xcr0 = xgetbv();
+    }
+
+    /* PCLMULQDQ ships with every AVX2 part, the AVX2 tier and AVX-512BW, which reuses its GF(2^16) kernels, rely on it */
+#if defined(POPORON_KERNEL_AVX512BW)
+    if ((leaf7_ebx & CPUID_7_EBX_AVX512F) && (leaf7_ebx & CPUID_7_EBX_AVX512BW) && (leaf7_ebx & CPUID_7_EBX_AVX2) &&
+        (leaf1_ecx & CPUID_1_ECX_PCLMULQDQ) && (xcr0 & XCR0_ZMM_STATE) == XCR0_ZMM_STATE) {
+        return PPRN_SIMD_AVX512BW;
+    }
+#endif
+
+    if ((leaf1_ecx & CPUID_1_ECX_AVX) && (leaf1_ecx & CPUID_1_ECX_PCLMULQDQ) && (leaf7_ebx & CPUID_7_EBX_AVX2) &&
+        (xcr0 & XCR0_YMM_STATE) == XCR0_YMM_STATE) {
+        return PPRN_SIMD_AVX2;
+    }
+
+    if (leaf1_ecx & CPUID_1_ECX_SSSE3) {
+        return PPRN_SIMD_SSSE3;
+    }
+
+    return PPRN_SIMD_SCALAR;
+}
+#endif
+
+static inline poporon_simd_level_t detect_level(void)
+{
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+    return detect_level_x86();
+#elif POPORON_USE_SIMD && defined(POPORON_SIMD_NEON)
+    return PPRN_SIMD_NEON;
+#elif POPORON_USE_SIMD && defined(POPORON_SIMD_WASM)
+    return PPRN_SIMD_WASM;
+#else
+    return PPRN_SIMD_SCALAR;
+#endif
+}
+
+static inline const poporon_kernel_t *kernel_for_level(poporon_simd_level_t level)
+{
+    switch (level) {
+    case PPRN_SIMD_SCALAR:
+        return &poporon_kernel_scalar;
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+    case PPRN_SIMD_SSSE3:
+        return &poporon_kernel_ssse3;
+    case PPRN_SIMD_AVX2:
+        return &poporon_kernel_avx2;
+#if defined(POPORON_KERNEL_AVX512BW)
+    case PPRN_SIMD_AVX512BW:
+        return &poporon_kernel_avx512bw;
+#endif
+#elif POPORON_USE_SIMD && defined(POPORON_SIMD_NEON)
+    case PPRN_SIMD_NEON:
+        return &poporon_kernel_neon;
+#elif POPORON_USE_SIMD && defined(POPORON_SIMD_WASM)
+    case PPRN_SIMD_WASM:
+        return &poporon_kernel_wasm;
+#endif
+    default:
+        return NULL;
+    }
+}
+
+static inline bool level_supported(poporon_simd_level_t level, poporon_simd_level_t detected)
+{
+    if (!kernel_for_level(level)) {
+        return false;
+    }
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+    /* x86 tiers are strictly nested, anything up to the detected level runs */
+    return level <= detected;
+#else
+    return level == PPRN_SIMD_SCALAR || level == detected;
+#endif
+}
+
+extern const poporon_kernel_t *poporon_kernel(void)
+{
+    const poporon_kernel_t *kernel = selected_kernel_load();
+
+    if (!kernel) {
+        kernel = selected_kernel_init(kernel_for_level(detect_level()));
+    }
+
+    return kernel;
+}
+
+extern bool poporon_simd_set_level(poporon_simd_level_t level)
+{
+    poporon_simd_level_t detected = detect_level();
+
+    if (level == PPRN_SIMD_AUTO) {
+        level = detected;
+    }
+
+    if (!level_supported(level, detected)) {
+        return false;
+    }
+
+    selected_kernel_store(kernel_for_level(level));
+
+    return true;
+}
+
+extern poporon_simd_level_t poporon_simd_get_level(void)
+{
+    return poporon_kernel()->level;
+}
@@ -0,0 +1,666 @@
+/*
+ * libpoporon - kernel_avx2.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/kernel.h"
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+
+#include "internal/ldpc.h"
+#include "internal/simd.h"
+
+#define SYNDROME_LANES     32
+#define SYNDROME_U16_LANES 16
+#define INTERLEAVED_LANES  32
+#define CHIEN_LANES        32
+#define CHECK_NODE_LANES   16
+
+static inline __m256i gf_mul_avx2(const uint8_t *table, __m256i value, __m256i mask)
+{
+    __m256i table_lo, table_hi;
+
+    table_lo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)table));
+    table_hi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(table + 16)));
+
+    return _mm256_xor_si256(_mm256_shuffle_epi8(table_lo, _mm256_and_si256(value, mask)),
+                            _mm256_shuffle_epi8(table_hi, _mm256_and_si256(_mm256_srli_epi16(value, 4), mask)));
+}
+
+static inline __m128i gf_mul_128(const uint8_t *table, __m128i value, __m128i mask)
+{
+    __m128i table_lo, table_hi;
+
+    table_lo = _mm_loadu_si128((const __m128i *)table);
+    table_hi = _mm_loadu_si128((const __m128i *)(table + 16));
+
+    return _mm_xor_si128(_mm_shuffle_epi8(table_lo, _mm_and_si128(value, mask)),
+                         _mm_shuffle_epi8(table_hi, _mm_and_si128(_mm_srli_epi16(value, 4), mask)));
+}
+
+static inline __m256i split_table_avx2(const uint8_t *table, size_t offset)
+{
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)(table + offset)));
+}
+
+/* 16 products of 16-bit symbols, the index high bytes are 0 and so is entry 0 of every table */
+static inline __m256i gf_split_mul_avx2(const uint8_t *table, __m256i value, __m256i mask)
+{
+    __m256i n0, n1, n2, n3, lo, hi;
+
+    n0 = _mm256_and_si256(value, mask);
+    n1 = _mm256_and_si256(_mm256_srli_epi16(value, 4), mask);
+    n2 = _mm256_and_si256(_mm256_srli_epi16(value, 8), mask);
+    n3 = _mm256_srli_epi16(value, 12);
+
+    lo = _mm256_xor_si256(_mm256_xor_si256(_mm256_shuffle_epi8(split_table_avx2(table, 0), n0),
+                                           _mm256_shuffle_epi8(split_table_avx2(table, 32), n1)),
+                          _mm256_xor_si256(_mm256_shuffle_epi8(split_table_avx2(table, 64), n2),
+                                           _mm256_shuffle_epi8(split_table_avx2(table, 96), n3)));
+    hi = _mm256_xor_si256(_mm256_xor_si256(_mm256_shuffle_epi8(split_table_avx2(table, 16), n0),
+                                           _mm256_shuffle_epi8(split_table_avx2(table, 48), n1)),
+                          _mm256_xor_si256(_mm256_shuffle_epi8(split_table_avx2(table, 80), n2),
+                                           _mm256_shuffle_epi8(split_table_avx2(table, 112), n3)));
+
+    return _mm256_xor_si256(lo, _mm256_slli_epi16(hi, 8));
+}
+
+static inline __m128i gf_split_mul_128(const uint8_t *table, __m128i value, __m128i mask)
+{
+    __m128i n0, n1, n2, n3, lo, hi;
+
+    n0 = _mm_and_si128(value, mask);
+    n1 = _mm_and_si128(_mm_srli_epi16(value, 4), mask);
+    n2 = _mm_and_si128(_mm_srli_epi16(value, 8), mask);
+    n3 = _mm_srli_epi16(value, 12);
+
+    lo = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)table), n0),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 32)), n1)),
+                       _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 64)), n2),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 96)), n3)));
+    hi = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 16)), n0),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 48)), n1)),
+                       _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 80)), n2),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 112)), n3)));
+
+    return _mm_xor_si128(lo, _mm_slli_epi16(hi, 8));
+}
+
+static void rs_encode_avx2(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    rs_encode_window_t window;
+    __m256i mask, generator_vec, parity_vec;
+    const uint8_t *table;
+    uint8_t *registers;
+    size_t i;
+    uint16_t j;
+    uint8_t fb;
+
+    mask = _mm256_set1_epi8(0x0F);
+    registers = rs_window_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        table = gf_nibble_table(rs->gf, fb);
+
+        for (j = 0; j < rs->num_roots; j += 32) {
+            generator_vec = _mm256_loadu_si256((const __m256i *)&rs->feedback_polynomial[j]);
+            parity_vec = _mm256_loadu_si256((__m256i *)&registers[j]);
+            _mm256_storeu_si256((__m256i *)&registers[j],
+                                _mm256_xor_si256(parity_vec, gf_mul_avx2(table, generator_vec, mask)));
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots);
+}
+
+/* lanes hold codeword positions, Horner with root^32 per block then folded with root^16 ... root^1 */
+static bool rs_syndrome_avx2(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                             uint16_t *syndrome)
+{
+    uint8_t staged[RS_STAGED_CODEWORD_SIZE];
+    __m256i mask, blocks[RS_STAGED_CODEWORD_SIZE / SYNDROME_LANES], accumulator;
+    __m128i mask_128, folded;
+    const uint8_t *powers, *horner;
+    size_t num_blocks, b;
+    uint16_t i, error_flag;
+    uint8_t value;
+
+    num_blocks = rs_stage_codeword(rs, data, size, parity, staged, SYNDROME_LANES);
+    if (!num_blocks) {
+        return poporon_rs_syndrome_scalar(rs, data, size, parity, syndrome);
+    }
+
+    mask = _mm256_set1_epi8(0x0F);
+    mask_128 = _mm_set1_epi8(0x0F);
+    for (b = 0; b < num_blocks; b++) {
+        blocks[b] = _mm256_loadu_si256((const __m256i *)&staged[b * SYNDROME_LANES]);
+    }
+
+    error_flag = 0;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        powers = &rs->root_powers[i * RS_ROOT_POWERS];
+        horner = gf_nibble_table(rs->gf, powers[5]);
+
+        accumulator = blocks[0];
+        for (b = 1; b < num_blocks; b++) {
+            accumulator = _mm256_xor_si256(gf_mul_avx2(horner, accumulator, mask), blocks[b]);
+        }
+
+        folded = gf_mul_128(gf_nibble_table(rs->gf, powers[4]), _mm256_castsi256_si128(accumulator), mask_128);
+        folded = _mm_xor_si128(folded, _mm256_extracti128_si256(accumulator, 1));
+
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[3]), folded, mask_128),
+                               _mm_srli_si128(folded, 8));
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[2]), folded, mask_128),
+                               _mm_srli_si128(folded, 4));
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[1]), folded, mask_128),
+                               _mm_srli_si128(folded, 2));
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[0]), folded, mask_128),
+                               _mm_srli_si128(folded, 1));
+
+        value = (uint8_t)_mm_cvtsi128_si32(folded);
+        error_flag |= value;
+        syndrome[i] = rs->gf->exp2log[value];
+    }
+
+    return error_flag != 0;
+}
+
+/* the CHIEN_LANES wide counterpart of rs_chien_ssse3(), shared with AVX-512BW */
+extern uint16_t poporon_rs_chien_avx2(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                      uint16_t primitive_inverse, uint16_t *registers, uint16_t *error_roots,
+                                      uint16_t *error_locations)
+{
+    uint8_t values[(UINT8_MAX + 1) * CHIEN_LANES];
+    const uint8_t *tables[UINT8_MAX + 1];
+    __m256i mask, zero, evaluation, value;
+    uint16_t active, error_count, i, j;
+    uint32_t found;
+
+    (void)registers;
+
+    mask = _mm256_set1_epi8(0x0F);
+    zero = _mm256_setzero_si256();
+    active = rs_chien_lanes(rs, error_locator, degree, CHIEN_LANES, values, tables);
+    error_count = 0;
+
+    for (i = 1; i <= rs->gf->field_size; i += CHIEN_LANES) {
+        evaluation = _mm256_set1_epi8(1);
+
+        for (j = 0; j < active; j++) {
+            value = _mm256_loadu_si256((const __m256i *)&values[(size_t)j * CHIEN_LANES]);
+            evaluation = _mm256_xor_si256(evaluation, value);
+            _mm256_storeu_si256((__m256i *)&values[(size_t)j * CHIEN_LANES], gf_mul_avx2(tables[j], value, mask));
+        }
+
+        found = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(evaluation, zero));
+        if (found != 0 && rs_chien_record(rs, found, i, degree, primitive_inverse, error_roots, error_locations,
+                                          &error_count)) {
+            break;
+        }
+    }
+
+    return error_count;
+}
+
+extern void poporon_rs_encode_u16_avx2(const poporon_rs_t *rs, const uint16_t *data, size_t size, uint16_t *parity)
+{
+    rs_encode_window_u16_t window;
+    const uint16_t *row0, *row1, *row2, *row3;
+    __m256i rows;
+    uint16_t *registers, fb, j;
+    size_t i;
+
+    registers = rs_window_u16_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_u16_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        row0 = rs_split_row(rs, 0, fb);
+        row1 = rs_split_row(rs, 1, fb);
+        row2 = rs_split_row(rs, 2, fb);
+        row3 = rs_split_row(rs, 3, fb);
+
+        for (j = 0; j < rs->num_roots; j += SYNDROME_U16_LANES) {
+            rows = _mm256_xor_si256(_mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&row0[j]),
+                                                     _mm256_loadu_si256((const __m256i *)&row1[j])),
+                                    _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&row2[j]),
+                                                     _mm256_loadu_si256((const __m256i *)&row3[j])));
+            _mm256_storeu_si256((__m256i *)&registers[j],
+                                _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&registers[j]), rows));
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots * sizeof(uint16_t));
+}
+
+/* Horner with root^16 over 16 positions, the halves are folded with root^8 and then as in the SSSE3 kernel */
+extern bool poporon_rs_syndrome_u16_avx2(const poporon_rs_t *rs, const uint16_t *data, size_t size,
+                                         const uint16_t *parity, uint16_t *syndrome)
+{
+    __m256i accumulators[UINT8_MAX + 1], mask, block;
+    __m128i mask_128, accumulator;
+    uint16_t staged[SYNDROME_U16_LANES], i, value, error_flag;
+    size_t num_blocks, offset, b;
+
+    mask = _mm256_set1_epi16(0x0F);
+    mask_128 = _mm_set1_epi16(0x0F);
+    num_blocks = rs_u16_blocks(rs, size, SYNDROME_U16_LANES, &offset);
+
+    for (i = 0; i < rs->num_roots; i++) {
+        accumulators[i] = _mm256_setzero_si256();
+    }
+
+    for (b = 0; b < num_blocks; b++) {
+        block = _mm256_loadu_si256(
+            (const __m256i *)rs_u16_block(rs, data, size, parity, offset, b, SYNDROME_U16_LANES, staged));
+
+        for (i = 0; i < rs->num_roots; i++) {
+            accumulators[i] =
+                _mm256_xor_si256(gf_split_mul_avx2(rs_root_split(rs, i, 4), accumulators[i], mask), block);
+        }
+    }
+
+    error_flag = 0;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        accumulator = _mm_xor_si128(
+            gf_split_mul_128(rs_root_split(rs, i, 3), _mm256_castsi256_si128(accumulators[i]), mask_128),
+            _mm256_extracti128_si256(accumulators[i], 1));
+        accumulator = _mm_xor_si128(gf_split_mul_128(rs_root_split(rs, i, 2), accumulator, mask_128),
+                                    _mm_srli_si128(accumulator, 8));
+        accumulator = _mm_xor_si128(gf_split_mul_128(rs_root_split(rs, i, 1), accumulator, mask_128),
+                                    _mm_srli_si128(accumulator, 4));
+        accumulator = _mm_xor_si128(gf_split_mul_128(rs_root_split(rs, i, 0), accumulator, mask_128),
+                                    _mm_srli_si128(accumulator, 2));
+
+        value = (uint16_t)_mm_cvtsi128_si32(accumulator);
+        error_flag |= value;
+        syndrome[i] = rs->gf->exp2log[value];
+    }
+
+    return error_flag != 0;
+}
+
+/* 32 codewords per vector, a trailing partial group goes through the SSSE3 kernel */
+static void rs_encode_interleaved_avx2(const poporon_rs_t *rs, const uint8_t *data, size_t size, size_t stride,
+                                       size_t lanes, uint8_t *parity)
+{
+    __m256i registers[RS_STAGED_CODEWORD_SIZE], mask, field_mask, fb;
+    size_t lane, i;
+    uint16_t head, j, k;
+
+    mask = _mm256_set1_epi8(0x0F);
+    field_mask = _mm256_set1_epi8((char)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (j = 0; j < rs->num_roots; j++) {
+            registers[j] = _mm256_setzero_si256();
+        }
+        head = 0;
+
+        for (i = 0; i < size; i++) {
+            fb = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)&data[i * stride + lane]), field_mask);
+            fb = _mm256_xor_si256(fb, registers[head]);
+
+            k = 0;
+            for (j = head + 1; j < rs->num_roots; j++, k++) {
+                registers[j] = _mm256_xor_si256(
+                    registers[j], gf_mul_avx2(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            for (j = 0; j < head; j++, k++) {
+                registers[j] = _mm256_xor_si256(
+                    registers[j], gf_mul_avx2(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            registers[head] = gf_mul_avx2(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+
+        for (j = 0; j < rs->num_roots; j++) {
+            _mm256_storeu_si256((__m256i *)&parity[j * stride + lane], registers[head]);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_kernel_ssse3.rs_encode_interleaved(rs, &data[lane], size, stride, lanes - lane, &parity[lane]);
+    }
+}
+
+static void rs_syndrome_interleaved_avx2(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                         const uint8_t *parity, size_t stride, size_t lanes, uint8_t *syndrome)
+{
+    __m256i accumulators[RS_STAGED_CODEWORD_SIZE], mask, field_mask, symbols;
+    const uint8_t *row;
+    size_t lane, j;
+    uint16_t i;
+
+    mask = _mm256_set1_epi8(0x0F);
+    field_mask = _mm256_set1_epi8((char)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (i = 0; i < rs->num_roots; i++) {
+            accumulators[i] = _mm256_setzero_si256();
+        }
+
+        for (j = 0; j < size + rs->num_roots; j++) {
+            row = (j < size) ? &data[j * stride + lane] : &parity[(j - size) * stride + lane];
+            symbols = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)row), field_mask);
+
+            for (i = 0; i < rs->num_roots; i++) {
+                accumulators[i] = _mm256_xor_si256(
+                    gf_mul_avx2(gf_nibble_table(rs->gf, rs->root_powers[i * RS_ROOT_POWERS]), accumulators[i], mask),
+                    symbols);
+            }
+        }
+
+        for (i = 0; i < rs->num_roots; i++) {
+            _mm256_storeu_si256((__m256i *)&syndrome[i * stride + lane], accumulators[i]);
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_kernel_ssse3.rs_syndrome_interleaved(rs, &data[lane], size, &parity[lane], stride, lanes - lane,
+                                                     &syndrome[lane]);
+    }
+}
+
+static void gf_muladd_region_avx2(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                                  size_t size)
+{
+    __m256i mask, product;
+    const uint8_t *table;
+    size_t i;
+
+    mask = _mm256_set1_epi8(0x0F);
+    table = gf_nibble_table(gf, multiplier);
+
+    for (i = 0; i + 32 <= size; i += 32) {
+        product = gf_mul_avx2(table, _mm256_loadu_si256((const __m256i *)&src[i]), mask);
+        _mm256_storeu_si256((__m256i *)&dst[i],
+                            _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&dst[i]), product));
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= gf_nibble_mul(table, src[i]);
+    }
+}
+
+static void gf_dot_region_avx2(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                               size_t count, uint8_t *dst, size_t size)
+{
+    __m256i mask, accumulator;
+    size_t i, k;
+
+    mask = _mm256_set1_epi8(0x0F);
+
+    for (i = 0; i + 32 <= size; i += 32) {
+        accumulator = _mm256_setzero_si256();
+        for (k = 0; k < count; k++) {
+            accumulator = _mm256_xor_si256(accumulator, gf_mul_avx2(gf_nibble_table(gf, coefficients[k]),
+                                                                    _mm256_loadu_si256((const __m256i *)&sources[k][i]),
+                                                                    mask));
+        }
+
+        _mm256_storeu_si256((__m256i *)&dst[i], accumulator);
+    }
+
+    gf_dot_bytes(gf, coefficients, sources, count, dst, i, size);
+}
+
+/*
+ * Chien search with the registers in polynomial form, so that the sweep reads no tables: register j is multiplied by
+ * the fixed alpha^(step * j) at every position, a carry-less multiply against the multiplier and its quotient packed
+ * in one qword gives the product and floor(product / p(x)) (see gf_clmul_quotient()), a second one reduces. The tier
+ * is only selected when the CPU has PCLMULQDQ.
+ */
+extern uint16_t poporon_rs_chien_u16_clmul(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                           int32_t padding_length, uint16_t *registers, uint16_t *error_roots,
+                                           uint16_t *error_locations)
+{
+    __m128i values[UINT8_MAX + 1], multipliers[UINT8_MAX + 1], polynomial, field_mask, shift, evaluation, product;
+    uint16_t root, root_step, multiplier, error_count, j;
+    uint32_t k;
+
+    (void)registers;
+
+    root_step = gf_mod(rs->gf, rs->primitive_element);
+    root = gf_mod(rs->gf, (uint32_t)(padding_length + 1) * root_step);
+    polynomial = _mm_cvtsi32_si128((int)(((uint32_t)1 << rs->gf->symbol_size) | rs->gf->generator_polynomial));
+    field_mask = _mm_cvtsi32_si128(rs->gf->field_size);
+    shift = _mm_cvtsi32_si128(32 + rs->gf->symbol_size);
+
+    for (j = 1; j <= degree; j++) {
+        multiplier = rs->gf->log2exp[gf_mod(rs->gf, (uint32_t)root_step * j)];
+        multipliers[j] = _mm_set_epi32(0, 0, gf_clmul_quotient(rs->gf, multiplier), multiplier);
+        values[j] = _mm_cvtsi32_si128((error_locator[j] == rs->gf->field_size)
+                                          ? 0
+                                          : rs->gf->log2exp[gf_mod(rs->gf, error_locator[j] + (uint32_t)root * j)]);
+    }
+
+    error_count = 0;
+
+    for (k = (uint32_t)padding_length; k < rs->gf->field_size; k++, root = gf_log_wrap(rs->gf, root + root_step)) {
+        evaluation = _mm_cvtsi32_si128(1);
+
+        for (j = 1; j <= degree; j++) {
+            evaluation = _mm_xor_si128(evaluation, values[j]);
+            product = _mm_clmulepi64_si128(values[j], multipliers[j], 0x00);
+            values[j] = _mm_and_si128(
+                _mm_xor_si128(product, _mm_clmulepi64_si128(_mm_srl_epi64(product, shift), polynomial, 0x00)),
+                field_mask);
+        }
+
+        if (_mm_cvtsi128_si32(evaluation) != 0) {
+            continue;
+        }
+
+        error_roots[error_count] = root;
+        error_locations[error_count] = (uint16_t)k;
+        if (++error_count == degree) {
+            break;
+        }
+    }
+
+    return error_count;
+}
+
+static inline void gf_region_u16_avx2(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src, uint16_t *dst,
+                                      size_t size, bool accumulate)
+{
+    uint8_t table[GF_SPLIT_TABLE_SIZE];
+    __m256i mask, product;
+    __m128i product_128;
+    size_t i;
+
+    mask = _mm256_set1_epi16(0x0F);
+    poporon_gf_split_table(gf, multiplier, table);
+
+    for (i = 0; i + SYNDROME_U16_LANES <= size; i += SYNDROME_U16_LANES) {
+        product = gf_split_mul_avx2(table, _mm256_loadu_si256((const __m256i *)&src[i]), mask);
+        if (accumulate) {
+            product = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&dst[i]), product);
+        }
+        _mm256_storeu_si256((__m256i *)&dst[i], product);
+    }
+
+    if (i + SYNDROME_U16_LANES / 2 <= size) {
+        product_128 = gf_split_mul_128(table, _mm_loadu_si128((const __m128i *)&src[i]), _mm256_castsi256_si128(mask));
+        if (accumulate) {
+            product_128 = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&dst[i]), product_128);
+        }
+        _mm_storeu_si128((__m128i *)&dst[i], product_128);
+        i += SYNDROME_U16_LANES / 2;
+    }
+
+    for (; i < size; i++) {
+        dst[i] = (uint16_t)((accumulate ? dst[i] : 0) ^ gf_split_mul(table, src[i]));
+    }
+}
+
+extern void poporon_gf_mul_region_u16_avx2(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                           uint16_t *dst, size_t size)
+{
+    gf_region_u16_avx2(gf, multiplier, src, dst, size, false);
+}
+
+extern void poporon_gf_muladd_region_u16_avx2(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                              uint16_t *dst, size_t size)
+{
+    gf_region_u16_avx2(gf, multiplier, src, dst, size, true);
+}
+
+static inline int16_t reduce_min_epi16(__m256i value)
+{
+    __m128i value_128;
+
+    value_128 = _mm_min_epi16(_mm256_castsi256_si128(value), _mm256_extracti128_si256(value, 1));
+    value_128 = _mm_min_epi16(value_128, _mm_shuffle_epi32(value_128, _MM_SHUFFLE(1, 0, 3, 2)));
+    value_128 = _mm_min_epi16(value_128, _mm_shuffle_epi32(value_128, _MM_SHUFFLE(2, 3, 0, 1)));
+    value_128 = _mm_min_epi16(value_128, _mm_srli_epi32(value_128, 16));
+
+    return (int16_t)_mm_cvtsi128_si32(value_128);
+}
+
+/* lane index of the lowest set lane in a movemask of 16-bit lanes, bits must be non-zero */
+static inline uint32_t lowest_lane(uint32_t bits)
+{
+    uint32_t index = 0;
+
+    while (!(bits & 1)) {
+        bits >>= 2;
+        index++;
+    }
+
+    return index;
+}
+
+static inline uint32_t parity32(uint32_t bits)
+{
+    bits ^= bits >> 16;
+    bits ^= bits >> 8;
+    bits ^= bits >> 4;
+    bits ^= bits >> 2;
+
+    return (bits ^ (bits >> 1)) & 1;
+}
+
+/* 16 edges per vector, the edges of a row past its last full vector take the scalar steps */
+static void ldpc_check_node_avx2(const uint32_t *row_ptr, uint32_t num_checks, const int16_t *var_to_check,
+                                 int16_t *check_to_var)
+{
+    __m256i fill, index, zero, msg, abs_msg, signs, min_vec, min1_vec, min2_vec, parity_vec, select, flip, out;
+    uint32_t i, j, start, end, full, min1_idx, negative_parity, bits;
+    int16_t min1, min2, value;
+
+    fill = _mm256_set1_epi16(LLR_MAX);
+    index = _mm256_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    zero = _mm256_setzero_si256();
+
+    for (i = 0; i < num_checks; i++) {
+        start = row_ptr[i];
+        end = row_ptr[i + 1];
+        full = start + (end - start) / CHECK_NODE_LANES * CHECK_NODE_LANES;
+
+        /* the sign bit of the xor of every message is the parity of the negative ones in that lane */
+        min_vec = fill;
+        signs = zero;
+        for (j = start; j < full; j += CHECK_NODE_LANES) {
+            msg = _mm256_loadu_si256((const __m256i *)&var_to_check[j]);
+            signs = _mm256_xor_si256(signs, msg);
+            min_vec = _mm256_min_epi16(min_vec, _mm256_abs_epi16(msg));
+        }
+        min1 = reduce_min_epi16(min_vec);
+        negative_parity = parity32((uint32_t)_mm256_movemask_epi8(signs) & 0xAAAAAAAAU);
+        for (; j < end; j++) {
+            value = var_to_check[j];
+            negative_parity ^= (uint32_t)(value < 0);
+            value = (int16_t)((value < 0) ? -value : value);
+            min1 = (value < min1) ? value : min1;
+        }
+
+        min1_vec = _mm256_set1_epi16(min1);
+        min1_idx = end;
+        min_vec = fill;
+        for (j = start; j < full; j += CHECK_NODE_LANES) {
+            abs_msg = _mm256_abs_epi16(_mm256_loadu_si256((const __m256i *)&var_to_check[j]));
+            if (min1_idx == end) {
+                bits = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi16(abs_msg, min1_vec));
+                if (bits) {
+                    min1_idx = j + lowest_lane(bits);
+                    select = _mm256_cmpeq_epi16(index, _mm256_set1_epi16((int16_t)(min1_idx - j)));
+                    abs_msg = _mm256_blendv_epi8(abs_msg, fill, select);
+                }
+            }
+            min_vec = _mm256_min_epi16(min_vec, abs_msg);
+        }
+        min2 = reduce_min_epi16(min_vec);
+        for (; j < end; j++) {
+            value = var_to_check[j];
+            value = (int16_t)((value < 0) ? -value : value);
+            if (min1_idx == end && value == min1) {
+                min1_idx = j;
+            } else if (value < min2) {
+                min2 = value;
+            }
+        }
+
+        min1 -= (int16_t)((min1 + 15) >> 4);
+        min2 -= (int16_t)((min2 + 15) >> 4);
+        min1_vec = _mm256_set1_epi16(min1);
+        min2_vec = _mm256_set1_epi16(min2);
+        parity_vec = negative_parity ? _mm256_set1_epi16(-1) : zero;
+
+        /* (x ^ flip) - flip negates the lanes whose flip is all ones */
+        for (j = start; j < full; j += CHECK_NODE_LANES) {
+            msg = _mm256_loadu_si256((const __m256i *)&var_to_check[j]);
+            flip = _mm256_xor_si256(_mm256_srai_epi16(msg, 15), parity_vec);
+            out = min1_vec;
+            if (min1_idx >= j && min1_idx < j + CHECK_NODE_LANES) {
+                select = _mm256_cmpeq_epi16(index, _mm256_set1_epi16((int16_t)(min1_idx - j)));
+                out = _mm256_blendv_epi8(out, min2_vec, select);
+            }
+            _mm256_storeu_si256((__m256i *)&check_to_var[j], _mm256_sub_epi16(_mm256_xor_si256(out, flip), flip));
+        }
+        for (; j < end; j++) {
+            value = (j == min1_idx) ? min2 : min1;
+            check_to_var[j] = ((uint32_t)(var_to_check[j] < 0) ^ negative_parity) ? (int16_t)-value : value;
+        }
+    }
+}
+
+const poporon_kernel_t poporon_kernel_avx2 = {
+    PPRN_SIMD_AVX2,
+    rs_encode_avx2,
+    rs_syndrome_avx2,
+    poporon_rs_chien_avx2,
+    rs_encode_interleaved_avx2,
+    rs_syndrome_interleaved_avx2,
+    poporon_rs_encode_u16_avx2,
+    poporon_rs_syndrome_u16_avx2,
+    poporon_rs_chien_u16_clmul,
+    gf_muladd_region_avx2,
+    gf_dot_region_avx2,
+    poporon_gf_mul_region_u16_avx2,
+    poporon_gf_muladd_region_u16_avx2,
+    ldpc_check_node_avx2,
+};
+
+#endif
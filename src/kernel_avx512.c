@@ -0,0 +1,398 @@
+/*
+ * libpoporon - kernel_avx512.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/kernel.h"
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86) && defined(POPORON_KERNEL_AVX512BW)
+
+#include "internal/ldpc.h"
+#include "internal/simd.h"
+
+#define SYNDROME_LANES    64
+#define INTERLEAVED_LANES 64
+#define CHECK_NODE_LANES  32
+
+static inline __m512i gf_mul_avx512(const uint8_t *table, __m512i value, __m512i mask)
+{
+    __m512i table_lo, table_hi;
+
+    table_lo = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)table));
+    table_hi = _mm512_broadcast_i32x4(_mm_loadu_si128((const __m128i *)(table + 16)));
+
+    return _mm512_xor_si512(_mm512_shuffle_epi8(table_lo, _mm512_and_si512(value, mask)),
+                            _mm512_shuffle_epi8(table_hi, _mm512_and_si512(_mm512_srli_epi16(value, 4), mask)));
+}
+
+static inline __m128i gf_mul_128(const uint8_t *table, __m128i value, __m128i mask)
+{
+    __m128i table_lo, table_hi;
+
+    table_lo = _mm_loadu_si128((const __m128i *)table);
+    table_hi = _mm_loadu_si128((const __m128i *)(table + 16));
+
+    return _mm_xor_si128(_mm_shuffle_epi8(table_lo, _mm_and_si128(value, mask)),
+                         _mm_shuffle_epi8(table_hi, _mm_and_si128(_mm_srli_epi16(value, 4), mask)));
+}
+
+static inline __mmask32 tail_mask32(size_t count)
+{
+    return count >= 32 ? ~(__mmask32)0 : (((__mmask32)1 << count) - 1);
+}
+
+static inline __mmask64 tail_mask64(size_t count)
+{
+    return count >= 64 ? ~(__mmask64)0 : (((__mmask64)1 << count) - 1);
+}
+
+static void rs_encode_avx512bw(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    rs_encode_window_t window;
+    __m512i mask, generator_vec, parity_vec;
+    const uint8_t *table;
+    uint8_t *registers;
+    size_t i;
+    uint16_t j;
+    uint8_t fb;
+
+    mask = _mm512_set1_epi8(0x0F);
+    registers = rs_window_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        table = gf_nibble_table(rs->gf, fb);
+
+        for (j = 0; j < rs->num_roots; j += 64) {
+            generator_vec = _mm512_loadu_si512((const void *)&rs->feedback_polynomial[j]);
+            parity_vec = _mm512_loadu_si512((const void *)&registers[j]);
+            _mm512_storeu_si512((void *)&registers[j],
+                                _mm512_xor_si512(parity_vec, gf_mul_avx512(table, generator_vec, mask)));
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots);
+}
+
+/*
+ * Lanes hold codeword positions: each root runs Horner over 64-byte blocks with the constant root^64, then the
+ * block is folded in halves (root^32 ... root^1) down to a single byte.
+ */
+static bool rs_syndrome_avx512bw(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                                 uint16_t *syndrome)
+{
+    uint8_t staged[RS_STAGED_CODEWORD_SIZE];
+    __m512i mask, blocks[RS_STAGED_CODEWORD_SIZE / SYNDROME_LANES], accumulator;
+    __m256i folded_256;
+    __m128i mask_128, folded;
+    const uint8_t *powers;
+    size_t num_blocks, b;
+    uint16_t i, error_flag;
+    uint8_t value;
+
+    num_blocks = rs_stage_codeword(rs, data, size, parity, staged, SYNDROME_LANES);
+    if (!num_blocks) {
+        return poporon_rs_syndrome_scalar(rs, data, size, parity, syndrome);
+    }
+
+    mask = _mm512_set1_epi8(0x0F);
+    mask_128 = _mm_set1_epi8(0x0F);
+    for (b = 0; b < num_blocks; b++) {
+        blocks[b] = _mm512_loadu_si512((const void *)&staged[b * SYNDROME_LANES]);
+    }
+
+    error_flag = 0;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        powers = &rs->root_powers[i * RS_ROOT_POWERS];
+
+        accumulator = blocks[0];
+        for (b = 1; b < num_blocks; b++) {
+            accumulator = _mm512_xor_si512(gf_mul_avx512(gf_nibble_table(rs->gf, powers[6]), accumulator, mask),
+                                           blocks[b]);
+        }
+
+        folded_256 = _mm512_castsi512_si256(gf_mul_avx512(gf_nibble_table(rs->gf, powers[5]), accumulator, mask));
+        folded_256 = _mm256_xor_si256(folded_256, _mm512_extracti64x4_epi64(accumulator, 1));
+
+        folded = gf_mul_128(gf_nibble_table(rs->gf, powers[4]), _mm256_castsi256_si128(folded_256), mask_128);
+        folded = _mm_xor_si128(folded, _mm256_extracti128_si256(folded_256, 1));
+
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[3]), folded, mask_128),
+                               _mm_srli_si128(folded, 8));
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[2]), folded, mask_128),
+                               _mm_srli_si128(folded, 4));
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[1]), folded, mask_128),
+                               _mm_srli_si128(folded, 2));
+        folded = _mm_xor_si128(gf_mul_128(gf_nibble_table(rs->gf, powers[0]), folded, mask_128),
+                               _mm_srli_si128(folded, 1));
+
+        value = (uint8_t)_mm_cvtsi128_si32(folded);
+        error_flag |= value;
+        syndrome[i] = rs->gf->exp2log[value];
+    }
+
+    return error_flag != 0;
+}
+
+static inline int16_t reduce_min_epi16(__m512i value)
+{
+    __m256i value_256;
+    __m128i value_128;
+
+    value_256 = _mm256_min_epi16(_mm512_castsi512_si256(value), _mm512_extracti64x4_epi64(value, 1));
+    value_128 = _mm_min_epi16(_mm256_castsi256_si128(value_256), _mm256_extracti128_si256(value_256, 1));
+    value_128 = _mm_min_epi16(value_128, _mm_shuffle_epi32(value_128, _MM_SHUFFLE(1, 0, 3, 2)));
+    value_128 = _mm_min_epi16(value_128, _mm_shuffle_epi32(value_128, _MM_SHUFFLE(2, 3, 0, 1)));
+    value_128 = _mm_min_epi16(value_128, _mm_srli_epi32(value_128, 16));
+
+    return (int16_t)_mm_cvtsi128_si32(value_128);
+}
+
+static inline uint32_t lowest_lane(uint32_t lanes)
+{
+    uint32_t index = 0;
+
+    while (!(lanes & 1)) {
+        lanes >>= 1;
+        index++;
+    }
+
+    return index;
+}
+
+static void ldpc_check_node_avx512bw(const uint32_t *row_ptr, uint32_t num_checks, const int16_t *var_to_check,
+                                     int16_t *check_to_var)
+{
+    __m512i fill, msg, abs_msg, min_vec, min1_vec, min2_vec, scaled_vec, out;
+    __mmask32 lanes, negative, flip;
+    uint32_t i, j, start, end, min1_idx, negative_parity;
+    int16_t min1, min2;
+
+    fill = _mm512_set1_epi16(LLR_MAX);
+
+    for (i = 0; i < num_checks; i++) {
+        start = row_ptr[i];
+        end = row_ptr[i + 1];
+
+        min_vec = fill;
+        negative_parity = 0;
+        for (j = start; j < end; j += CHECK_NODE_LANES) {
+            lanes = tail_mask32(end - j);
+            msg = _mm512_mask_loadu_epi16(fill, lanes, &var_to_check[j]);
+            negative_parity ^= (uint32_t)_mm512_cmplt_epi16_mask(msg, _mm512_setzero_si512());
+            min_vec = _mm512_min_epi16(min_vec, _mm512_abs_epi16(msg));
+        }
+        min1 = reduce_min_epi16(min_vec);
+        min1_vec = _mm512_set1_epi16(min1);
+
+        /* the scalar kernel keeps the first edge holding min1, min2 is the minimum over every other edge */
+        min1_idx = end;
+        min_vec = fill;
+        for (j = start; j < end; j += CHECK_NODE_LANES) {
+            lanes = tail_mask32(end - j);
+            abs_msg = _mm512_abs_epi16(_mm512_mask_loadu_epi16(fill, lanes, &var_to_check[j]));
+            if (min1_idx == end) {
+                flip = _mm512_mask_cmpeq_epi16_mask(lanes, abs_msg, min1_vec);
+                if (flip) {
+                    min1_idx = j + lowest_lane((uint32_t)flip);
+                    abs_msg = _mm512_mask_mov_epi16(abs_msg, (__mmask32)1 << (min1_idx - j), fill);
+                }
+            }
+            min_vec = _mm512_min_epi16(min_vec, abs_msg);
+        }
+        min2 = reduce_min_epi16(min_vec);
+
+        /* x * 15 / 16 without leaving 16-bit lanes */
+        min1 -= (int16_t)((min1 + 15) >> 4);
+        min2 -= (int16_t)((min2 + 15) >> 4);
+        min1_vec = _mm512_set1_epi16(min1);
+        min2_vec = _mm512_set1_epi16(min2);
+
+        negative_parity = (negative_parity ^ (negative_parity >> 16));
+        negative_parity = (negative_parity ^ (negative_parity >> 8));
+        negative_parity = (negative_parity ^ (negative_parity >> 4));
+        negative_parity = (negative_parity ^ (negative_parity >> 2));
+        negative_parity = (negative_parity ^ (negative_parity >> 1)) & 1;
+
+        for (j = start; j < end; j += CHECK_NODE_LANES) {
+            lanes = tail_mask32(end - j);
+            msg = _mm512_maskz_loadu_epi16(lanes, &var_to_check[j]);
+            negative = _mm512_cmplt_epi16_mask(msg, _mm512_setzero_si512());
+            flip = negative_parity ? (__mmask32)~negative : negative;
+
+            scaled_vec = min1_vec;
+            if (min1_idx >= j && min1_idx < j + CHECK_NODE_LANES) {
+                scaled_vec = _mm512_mask_mov_epi16(scaled_vec, (__mmask32)1 << (min1_idx - j), min2_vec);
+            }
+
+            out = _mm512_mask_sub_epi16(scaled_vec, flip, _mm512_setzero_si512(), scaled_vec);
+            _mm512_mask_storeu_epi16(&check_to_var[j], lanes, out);
+        }
+    }
+}
+
+/* 64 codewords per vector, the last partial group runs under a lane mask instead of a fallback */
+static void rs_encode_interleaved_avx512bw(const poporon_rs_t *rs, const uint8_t *data, size_t size, size_t stride,
+                                           size_t lanes, uint8_t *parity)
+{
+    __m512i registers[RS_STAGED_CODEWORD_SIZE], mask, field_mask, fb;
+    __mmask64 active;
+    size_t lane, i;
+    uint16_t head, j, k;
+
+    mask = _mm512_set1_epi8(0x0F);
+    field_mask = _mm512_set1_epi8((char)rs->gf->field_size);
+
+    for (lane = 0; lane < lanes; lane += INTERLEAVED_LANES) {
+        active = tail_mask64(lanes - lane);
+
+        for (j = 0; j < rs->num_roots; j++) {
+            registers[j] = _mm512_setzero_si512();
+        }
+        head = 0;
+
+        for (i = 0; i < size; i++) {
+            fb = _mm512_and_si512(_mm512_maskz_loadu_epi8(active, &data[i * stride + lane]), field_mask);
+            fb = _mm512_xor_si512(fb, registers[head]);
+
+            k = 0;
+            for (j = head + 1; j < rs->num_roots; j++, k++) {
+                registers[j] = _mm512_xor_si512(
+                    registers[j], gf_mul_avx512(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            for (j = 0; j < head; j++, k++) {
+                registers[j] = _mm512_xor_si512(
+                    registers[j], gf_mul_avx512(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            registers[head] = gf_mul_avx512(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+
+        for (j = 0; j < rs->num_roots; j++) {
+            _mm512_mask_storeu_epi8(&parity[j * stride + lane], active, registers[head]);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+    }
+}
+
+static void rs_syndrome_interleaved_avx512bw(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                             const uint8_t *parity, size_t stride, size_t lanes, uint8_t *syndrome)
+{
+    __m512i accumulators[RS_STAGED_CODEWORD_SIZE], mask, field_mask, symbols;
+    __mmask64 active;
+    const uint8_t *row;
+    size_t lane, j;
+    uint16_t i;
+
+    mask = _mm512_set1_epi8(0x0F);
+    field_mask = _mm512_set1_epi8((char)rs->gf->field_size);
+
+    for (lane = 0; lane < lanes; lane += INTERLEAVED_LANES) {
+        active = tail_mask64(lanes - lane);
+
+        for (i = 0; i < rs->num_roots; i++) {
+            accumulators[i] = _mm512_setzero_si512();
+        }
+
+        for (j = 0; j < size + rs->num_roots; j++) {
+            row = (j < size) ? &data[j * stride + lane] : &parity[(j - size) * stride + lane];
+            symbols = _mm512_and_si512(_mm512_maskz_loadu_epi8(active, row), field_mask);
+
+            for (i = 0; i < rs->num_roots; i++) {
+                accumulators[i] = _mm512_xor_si512(
+                    gf_mul_avx512(gf_nibble_table(rs->gf, rs->root_powers[i * RS_ROOT_POWERS]), accumulators[i], mask),
+                    symbols);
+            }
+        }
+
+        for (i = 0; i < rs->num_roots; i++) {
+            _mm512_mask_storeu_epi8(&syndrome[i * stride + lane], active, accumulators[i]);
+        }
+    }
+}
+
+static void gf_muladd_region_avx512bw(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src,
+                                      uint8_t *dst, size_t size)
+{
+    __m512i mask, product;
+    __mmask64 lanes;
+    const uint8_t *table;
+    size_t i;
+
+    mask = _mm512_set1_epi8(0x0F);
+    table = gf_nibble_table(gf, multiplier);
+
+    for (i = 0; i + 64 <= size; i += 64) {
+        product = gf_mul_avx512(table, _mm512_loadu_si512((const void *)&src[i]), mask);
+        _mm512_storeu_si512((void *)&dst[i], _mm512_xor_si512(_mm512_loadu_si512((const void *)&dst[i]), product));
+    }
+
+    if (i < size) {
+        lanes = tail_mask64(size - i);
+        product = gf_mul_avx512(table, _mm512_maskz_loadu_epi8(lanes, &src[i]), mask);
+        _mm512_mask_storeu_epi8(&dst[i], lanes, _mm512_xor_si512(_mm512_maskz_loadu_epi8(lanes, &dst[i]), product));
+    }
+}
+
+static void gf_dot_region_avx512bw(const poporon_gf_t *gf, const uint8_t *coefficients,
+                                   const uint8_t *const *sources, size_t count, uint8_t *dst, size_t size)
+{
+    __m512i mask, accumulator;
+    __mmask64 lanes;
+    size_t i, k;
+
+    mask = _mm512_set1_epi8(0x0F);
+
+    for (i = 0; i + 64 <= size; i += 64) {
+        accumulator = _mm512_setzero_si512();
+        for (k = 0; k < count; k++) {
+            accumulator = _mm512_xor_si512(accumulator, gf_mul_avx512(gf_nibble_table(gf, coefficients[k]),
+                                                                      _mm512_loadu_si512((const void *)&sources[k][i]),
+                                                                      mask));
+        }
+
+        _mm512_storeu_si512((void *)&dst[i], accumulator);
+    }
+
+    if (i < size) {
+        lanes = tail_mask64(size - i);
+        accumulator = _mm512_setzero_si512();
+        for (k = 0; k < count; k++) {
+            accumulator = _mm512_xor_si512(accumulator, gf_mul_avx512(gf_nibble_table(gf, coefficients[k]),
+                                                                      _mm512_maskz_loadu_epi8(lanes, &sources[k][i]),
+                                                                      mask));
+        }
+
+        _mm512_mask_storeu_epi8(&dst[i], lanes, accumulator);
+    }
+}
+
+const poporon_kernel_t poporon_kernel_avx512bw = {
+    PPRN_SIMD_AVX512BW,
+    rs_encode_avx512bw,
+    rs_syndrome_avx512bw,
+    poporon_rs_chien_avx2,
+    rs_encode_interleaved_avx512bw,
+    rs_syndrome_interleaved_avx512bw,
+    poporon_rs_encode_u16_avx2,
+    poporon_rs_syndrome_u16_avx2,
+    poporon_rs_chien_u16_clmul,
+    gf_muladd_region_avx512bw,
+    gf_dot_region_avx512bw,
+    poporon_gf_mul_region_u16_avx2,
+    poporon_gf_muladd_region_u16_avx2,
+    ldpc_check_node_avx512bw,
+};
+
+#endif
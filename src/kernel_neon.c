@@ -0,0 +1,244 @@
+/*
+ * libpoporon - kernel_neon.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/kernel.h"
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_NEON)
+
+#include "internal/simd.h"
+
+#define SYNDROME_LANES    16
+#define INTERLEAVED_LANES 16
+
+static inline uint8x16_t gf_mul_neon(const uint8_t *table, uint8x16_t value, uint8x16_t mask)
+{
+    return veorq_u8(vqtbl1q_u8(vld1q_u8(table), vandq_u8(value, mask)),
+                    vqtbl1q_u8(vld1q_u8(table + 16), vshrq_n_u8(value, 4)));
+}
+
+static void rs_encode_neon(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    rs_encode_window_t window;
+    uint8x16_t mask, generator_vec, parity_vec;
+    const uint8_t *table;
+    uint8_t *registers;
+    size_t i;
+    uint16_t j;
+    uint8_t fb;
+
+    mask = vdupq_n_u8(0x0F);
+    registers = rs_window_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        table = gf_nibble_table(rs->gf, fb);
+
+        for (j = 0; j < rs->num_roots; j += 16) {
+            generator_vec = vld1q_u8(&rs->feedback_polynomial[j]);
+            parity_vec = vld1q_u8(&registers[j]);
+            vst1q_u8(&registers[j], veorq_u8(parity_vec, gf_mul_neon(table, generator_vec, mask)));
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots);
+}
+
+/* lanes hold codeword positions, Horner with root^16 per block then folded with root^8 ... root^1 */
+static bool rs_syndrome_neon(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                             uint16_t *syndrome)
+{
+    uint8_t staged[RS_STAGED_CODEWORD_SIZE];
+    uint8x16_t mask, zero, accumulator;
+    const uint8_t *powers, *horner;
+    size_t num_blocks, b;
+    uint16_t i, error_flag;
+    uint8_t value;
+
+    num_blocks = rs_stage_codeword(rs, data, size, parity, staged, SYNDROME_LANES);
+    if (!num_blocks) {
+        return poporon_rs_syndrome_scalar(rs, data, size, parity, syndrome);
+    }
+
+    mask = vdupq_n_u8(0x0F);
+    zero = vdupq_n_u8(0);
+    error_flag = 0;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        powers = &rs->root_powers[i * RS_ROOT_POWERS];
+        horner = gf_nibble_table(rs->gf, powers[4]);
+
+        accumulator = vld1q_u8(staged);
+        for (b = 1; b < num_blocks; b++) {
+            accumulator = veorq_u8(gf_mul_neon(horner, accumulator, mask), vld1q_u8(&staged[b * SYNDROME_LANES]));
+        }
+
+        accumulator = veorq_u8(gf_mul_neon(gf_nibble_table(rs->gf, powers[3]), accumulator, mask),
+                               vextq_u8(accumulator, zero, 8));
+        accumulator = veorq_u8(gf_mul_neon(gf_nibble_table(rs->gf, powers[2]), accumulator, mask),
+                               vextq_u8(accumulator, zero, 4));
+        accumulator = veorq_u8(gf_mul_neon(gf_nibble_table(rs->gf, powers[1]), accumulator, mask),
+                               vextq_u8(accumulator, zero, 2));
+        accumulator = veorq_u8(gf_mul_neon(gf_nibble_table(rs->gf, powers[0]), accumulator, mask),
+                               vextq_u8(accumulator, zero, 1));
+
+        value = vgetq_lane_u8(accumulator, 0);
+        error_flag |= value;
+        syndrome[i] = rs->gf->exp2log[value];
+    }
+
+    return error_flag != 0;
+}
+
+/* 16 codewords per vector, a trailing partial group goes through the scalar kernel */
+static void rs_encode_interleaved_neon(const poporon_rs_t *rs, const uint8_t *data, size_t size, size_t stride,
+                                       size_t lanes, uint8_t *parity)
+{
+    uint8x16_t registers[RS_STAGED_CODEWORD_SIZE], mask, field_mask, fb;
+    size_t lane, i;
+    uint16_t head, j, k;
+
+    mask = vdupq_n_u8(0x0F);
+    field_mask = vdupq_n_u8((uint8_t)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (j = 0; j < rs->num_roots; j++) {
+            registers[j] = vdupq_n_u8(0);
+        }
+        head = 0;
+
+        for (i = 0; i < size; i++) {
+            fb = vandq_u8(vld1q_u8(&data[i * stride + lane]), field_mask);
+            fb = veorq_u8(fb, registers[head]);
+
+            k = 0;
+            for (j = head + 1; j < rs->num_roots; j++, k++) {
+                registers[j] = veorq_u8(
+                    registers[j], gf_mul_neon(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            for (j = 0; j < head; j++, k++) {
+                registers[j] = veorq_u8(
+                    registers[j], gf_mul_neon(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            registers[head] = gf_mul_neon(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+
+        for (j = 0; j < rs->num_roots; j++) {
+            vst1q_u8(&parity[j * stride + lane], registers[head]);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_rs_encode_interleaved_scalar(rs, &data[lane], size, stride, lanes - lane, &parity[lane]);
+    }
+}
+
+static void rs_syndrome_interleaved_neon(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                         const uint8_t *parity, size_t stride, size_t lanes, uint8_t *syndrome)
+{
+    uint8x16_t accumulators[RS_STAGED_CODEWORD_SIZE], mask, field_mask, symbols;
+    const uint8_t *row;
+    size_t lane, j;
+    uint16_t i;
+
+    mask = vdupq_n_u8(0x0F);
+    field_mask = vdupq_n_u8((uint8_t)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (i = 0; i < rs->num_roots; i++) {
+            accumulators[i] = vdupq_n_u8(0);
+        }
+
+        for (j = 0; j < size + rs->num_roots; j++) {
+            row = (j < size) ? &data[j * stride + lane] : &parity[(j - size) * stride + lane];
+            symbols = vandq_u8(vld1q_u8(row), field_mask);
+
+            for (i = 0; i < rs->num_roots; i++) {
+                accumulators[i] = veorq_u8(
+                    gf_mul_neon(gf_nibble_table(rs->gf, rs->root_powers[i * RS_ROOT_POWERS]), accumulators[i], mask),
+                    symbols);
+            }
+        }
+
+        for (i = 0; i < rs->num_roots; i++) {
+            vst1q_u8(&syndrome[i * stride + lane], accumulators[i]);
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_rs_syndrome_interleaved_scalar(rs, &data[lane], size, &parity[lane], stride, lanes - lane,
+                                               &syndrome[lane]);
+    }
+}
+
+static void gf_muladd_region_neon(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                                  size_t size)
+{
+    uint8x16_t mask;
+    const uint8_t *table;
+    size_t i;
+
+    mask = vdupq_n_u8(0x0F);
+    table = gf_nibble_table(gf, multiplier);
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        vst1q_u8(&dst[i], veorq_u8(vld1q_u8(&dst[i]), gf_mul_neon(table, vld1q_u8(&src[i]), mask)));
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= gf_nibble_mul(table, src[i]);
+    }
+}
+
+static void gf_dot_region_neon(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                               size_t count, uint8_t *dst, size_t size)
+{
+    uint8x16_t mask, accumulator;
+    size_t i, k;
+
+    mask = vdupq_n_u8(0x0F);
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        accumulator = vdupq_n_u8(0);
+        for (k = 0; k < count; k++) {
+            accumulator = veorq_u8(accumulator,
+                                   gf_mul_neon(gf_nibble_table(gf, coefficients[k]), vld1q_u8(&sources[k][i]), mask));
+        }
+
+        vst1q_u8(&dst[i], accumulator);
+    }
+
+    gf_dot_bytes(gf, coefficients, sources, count, dst, i, size);
+}
+
+const poporon_kernel_t poporon_kernel_neon = {
+    PPRN_SIMD_NEON,
+    rs_encode_neon,
+    rs_syndrome_neon,
+    poporon_rs_chien_scalar,
+    rs_encode_interleaved_neon,
+    rs_syndrome_interleaved_neon,
+    poporon_rs_encode_u16_scalar,
+    poporon_rs_syndrome_u16_scalar,
+    poporon_rs_chien_u16_scalar,
+    gf_muladd_region_neon,
+    gf_dot_region_neon,
+    poporon_gf_mul_region_u16_scalar,
+    poporon_gf_muladd_region_u16_scalar,
+    poporon_ldpc_check_node_scalar,
+};
+
+#endif
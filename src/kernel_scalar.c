@@ -0,0 +1,482 @@
+/*
+ * libpoporon - kernel_scalar.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/kernel.h"
+#include "internal/ldpc.h"
+
+extern void poporon_rs_encode_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    rs_encode_window_t window;
+    uint8_t *registers;
+    size_t i;
+    uint16_t j, fb;
+
+    registers = rs_window_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = rs->gf->exp2log[(((uint16_t)data[i]) & ((uint16_t)rs->gf->field_size)) ^ registers[0]];
+        registers = rs_window_shift(&window, rs->num_roots, 1);
+
+        if (fb != rs->gf->field_size) {
+            for (j = 0; j < rs->num_roots; j++) {
+                registers[j] ^= gf_exp(rs->gf, fb + rs->generator_polynomial[rs->num_roots - 1 - j]);
+            }
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots);
+}
+
+extern bool poporon_rs_syndrome_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                                       uint16_t *syndrome)
+{
+    int16_t i, j;
+    uint16_t syndrome_error_flag = 0, root_logs[UINT8_MAX + 1];
+
+    /* root logs reduced once up front, the per symbol updates then index exp_table directly */
+    for (i = 0; i < rs->num_roots; i++) {
+        root_logs[i] = gf_mod(rs->gf, (rs->first_consecutive_root + i) * rs->primitive_element);
+        syndrome[i] = data[0] & ((uint16_t)rs->gf->field_size);
+    }
+
+    for (j = 1; j < size; j++) {
+        for (i = 0; i < rs->num_roots; i++) {
+            if (syndrome[i] == 0) {
+                syndrome[i] = data[j] & ((uint16_t)rs->gf->field_size);
+            } else {
+                syndrome[i] = (data[j] & ((uint16_t)rs->gf->field_size)) ^
+                              gf_exp(rs->gf, rs->gf->exp2log[syndrome[i]] + root_logs[i]);
+            }
+        }
+    }
+
+    for (j = 0; j < rs->num_roots; j++) {
+        for (i = 0; i < rs->num_roots; i++) {
+            if (syndrome[i] == 0) {
+                syndrome[i] = parity[j] & ((uint16_t)rs->gf->field_size);
+            } else {
+                syndrome[i] = (parity[j] & ((uint16_t)rs->gf->field_size)) ^
+                              gf_exp(rs->gf, rs->gf->exp2log[syndrome[i]] + root_logs[i]);
+            }
+        }
+    }
+
+    for (i = 0; i < rs->num_roots; i++) {
+        syndrome_error_flag |= syndrome[i];
+        syndrome[i] = rs->gf->exp2log[syndrome[i]];
+    }
+
+    return syndrome_error_flag != 0;
+}
+
+static inline const uint8_t *slice_row(const poporon_rs_t *rs, size_t slice, uint8_t value)
+{
+    return &rs->slice_tables[(slice * 256 + value) * rs->slice_stride];
+}
+
+/* slice_stride is a multiple of 8 and the window slack covers the padding, so whole words are always in bounds */
+static inline void slice_xor_rows(const poporon_rs_t *rs, uint8_t *registers, const uint8_t **rows, size_t count)
+{
+    uint64_t accumulator, word;
+    size_t j, t;
+
+    for (j = 0; j < rs->slice_stride; j += sizeof(uint64_t)) {
+        pmemcpy(&accumulator, &registers[j], sizeof(uint64_t));
+
+        for (t = 0; t < count; t++) {
+            pmemcpy(&word, &rows[t][j], sizeof(uint64_t));
+            accumulator ^= word;
+        }
+
+        pmemcpy(&registers[j], &accumulator, sizeof(uint64_t));
+    }
+}
+
+/* absorbs encode_slices message bytes per step through rs->slice_tables, the tail goes one byte at a time */
+extern void poporon_rs_encode_slice(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    rs_encode_window_t window;
+    const uint8_t *rows[RS_ENCODE_MAX_SLICES];
+    uint8_t *registers;
+    size_t i, t, slices;
+
+    slices = rs->encode_slices;
+    registers = rs_window_reset(&window, rs->num_roots);
+
+    for (i = 0; i + slices <= size; i += slices) {
+        for (t = 0; t < slices; t++) {
+            rows[t] = slice_row(rs, t, (data[i + t] & rs->gf->field_size) ^ registers[t]);
+        }
+
+        registers = rs_window_shift(&window, rs->num_roots, slices);
+        slice_xor_rows(rs, registers, rows, slices);
+    }
+
+    for (; i < size; i++) {
+        rows[0] = slice_row(rs, slices - 1, (data[i] & rs->gf->field_size) ^ registers[0]);
+        registers = rs_window_shift(&window, rs->num_roots, 1);
+        slice_xor_rows(rs, registers, rows, 1);
+    }
+
+    pmemcpy(parity, registers, rs->num_roots);
+}
+
+static inline void syndrome_nibble_step(const poporon_rs_t *rs, uint8_t *values, uint8_t symbol)
+{
+    uint16_t i;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        values[i] = gf_nibble_mul(gf_nibble_table(rs->gf, rs->root_powers[i * RS_ROOT_POWERS]), values[i]) ^ symbol;
+    }
+}
+
+/*
+ * Horner in polynomial form with each root's nibble table, no zero special case and no gf_mod. Roots are the inner
+ * loop so that their independent multiply chains overlap.
+ */
+static bool rs_syndrome_nibble(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                               uint16_t *syndrome)
+{
+    uint8_t values[RS_STAGED_CODEWORD_SIZE];
+    size_t j;
+    uint16_t i, error_flag;
+
+    pmemset(values, 0, rs->num_roots);
+
+    for (j = 0; j < size; j++) {
+        syndrome_nibble_step(rs, values, data[j] & rs->gf->field_size);
+    }
+
+    for (j = 0; j < rs->num_roots; j++) {
+        syndrome_nibble_step(rs, values, parity[j] & rs->gf->field_size);
+    }
+
+    error_flag = 0;
+    for (i = 0; i < rs->num_roots; i++) {
+        error_flag |= values[i];
+        syndrome[i] = rs->gf->exp2log[values[i]];
+    }
+
+    return error_flag != 0;
+}
+
+extern uint16_t poporon_rs_chien_scalar(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                        uint16_t primitive_inverse, uint16_t *registers, uint16_t *error_roots,
+                                        uint16_t *error_locations)
+{
+    uint16_t i, j, k, polynomial_evaluation, error_count;
+
+    pmemcpy(&registers[1], &error_locator[1], degree * sizeof(registers[0]));
+
+    error_count = 0;
+
+    for (i = 1, k = primitive_inverse - 1; i <= rs->gf->field_size;
+         i++, k = gf_log_wrap(rs->gf, k + primitive_inverse)) {
+        polynomial_evaluation = 1;
+
+        for (j = degree; j > 0; j--) {
+            if (registers[j] != rs->gf->field_size) {
+                registers[j] = gf_log_wrap(rs->gf, registers[j] + j);
+                polynomial_evaluation ^= rs->gf->log2exp[registers[j]];
+            }
+        }
+
+        if (polynomial_evaluation != 0) {
+            continue;
+        }
+
+        error_roots[error_count] = i;
+        error_locations[error_count] = k;
+        if (++error_count == degree) {
+            break;
+        }
+    }
+
+    return error_count;
+}
+
+/*
+ * Chien search over the codeword positions only, a shortened GF(2^16) code covers a small part of the 65535 candidate
+ * roots. Position k is the root (k + 1) * primitive_element, each step advances register j by primitive_element * j.
+ */
+extern uint16_t poporon_rs_chien_u16_scalar(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                                            int32_t padding_length, uint16_t *registers, uint16_t *error_roots,
+                                            uint16_t *error_locations)
+{
+    uint16_t steps[UINT8_MAX + 1], root, root_step, polynomial_evaluation, error_count, j;
+    uint32_t k;
+
+    root_step = gf_mod(rs->gf, rs->primitive_element);
+    root = gf_mod(rs->gf, (uint32_t)(padding_length + 1) * root_step);
+
+    for (j = 1; j <= degree; j++) {
+        steps[j] = gf_mod(rs->gf, (uint32_t)root_step * j);
+        registers[j] = (error_locator[j] == rs->gf->field_size)
+                           ? rs->gf->field_size
+                           : gf_mod(rs->gf, error_locator[j] + (uint32_t)root * j);
+    }
+
+    error_count = 0;
+
+    for (k = (uint32_t)padding_length; k < rs->gf->field_size; k++, root = gf_log_wrap(rs->gf, root + root_step)) {
+        polynomial_evaluation = 1;
+
+        for (j = 1; j <= degree; j++) {
+            if (registers[j] != rs->gf->field_size) {
+                polynomial_evaluation ^= rs->gf->log2exp[registers[j]];
+                registers[j] = gf_log_wrap(rs->gf, registers[j] + steps[j]);
+            }
+        }
+
+        if (polynomial_evaluation != 0) {
+            continue;
+        }
+
+        error_roots[error_count] = root;
+        error_locations[error_count] = (uint16_t)k;
+        if (++error_count == degree) {
+            break;
+        }
+    }
+
+    return error_count;
+}
+
+extern void poporon_ldpc_check_node_scalar(const uint32_t *row_ptr, uint32_t num_checks, const int16_t *var_to_check,
+                                           int16_t *check_to_var)
+{
+    uint32_t min1_idx;
+    int16_t min1, min2, sign, msg, abs_msg;
+    size_t i, j, k;
+
+    for (i = 0; i < num_checks; i++) {
+        sign = 1;
+        min1 = LLR_MAX;
+        min2 = LLR_MAX;
+        min1_idx = 0;
+
+        for (j = row_ptr[i]; j < row_ptr[i + 1]; j++) {
+            msg = var_to_check[j];
+            if (msg < 0) {
+                sign = -sign;
+                abs_msg = -msg;
+            } else {
+                abs_msg = msg;
+            }
+
+            if (abs_msg < min1) {
+                min2 = min1;
+                min1 = abs_msg;
+                min1_idx = (uint32_t)j;
+            } else if (abs_msg < min2) {
+                min2 = abs_msg;
+            }
+        }
+
+        for (j = row_ptr[i]; j < row_ptr[i + 1]; j++) {
+            msg = var_to_check[j];
+
+            if (j == min1_idx) {
+                abs_msg = min2;
+            } else {
+                abs_msg = min1;
+            }
+
+            abs_msg = (int16_t)((int32_t)abs_msg * MINSUM_ALPHA_NUMERATOR / MINSUM_ALPHA_DENOMINATOR);
+
+            k = (msg < 0) ? -sign : sign;
+            check_to_var[j] = (int16_t)(k * abs_msg);
+        }
+    }
+}
+
+/* one codeword at a time through the regular kernels, used for the lanes left over by the vector kernels */
+extern void poporon_rs_encode_interleaved_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                                 size_t stride, size_t lanes, uint8_t *parity)
+{
+    uint8_t codeword[RS_STAGED_CODEWORD_SIZE], check[RS_STAGED_CODEWORD_SIZE];
+    size_t lane, i;
+
+    for (lane = 0; lane < lanes; lane++) {
+        for (i = 0; i < size; i++) {
+            codeword[i] = data[i * stride + lane];
+        }
+
+        poporon_rs_encode_scalar(rs, codeword, size, check);
+
+        for (i = 0; i < rs->num_roots; i++) {
+            parity[i * stride + lane] = check[i];
+        }
+    }
+}
+
+extern void poporon_rs_syndrome_interleaved_scalar(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                                   const uint8_t *parity, size_t stride, size_t lanes,
+                                                   uint8_t *syndrome)
+{
+    uint8_t codeword[RS_STAGED_CODEWORD_SIZE], check[RS_STAGED_CODEWORD_SIZE];
+    uint16_t values[RS_STAGED_CODEWORD_SIZE];
+    size_t lane, i;
+
+    for (lane = 0; lane < lanes; lane++) {
+        for (i = 0; i < size; i++) {
+            codeword[i] = data[i * stride + lane];
+        }
+
+        for (i = 0; i < rs->num_roots; i++) {
+            check[i] = parity[i * stride + lane];
+        }
+
+        poporon_rs_syndrome_scalar(rs, codeword, size, check, values);
+
+        for (i = 0; i < rs->num_roots; i++) {
+            syndrome[i * stride + lane] = (uint8_t)rs->gf->log2exp[values[i]];
+        }
+    }
+}
+
+/* LFSR over 16-bit symbols, each feedback symbol xors its four feedback_split rows into the register */
+extern void poporon_rs_encode_u16_scalar(const poporon_rs_t *rs, const uint16_t *data, size_t size, uint16_t *parity)
+{
+    rs_encode_window_u16_t window;
+    const uint16_t *row0, *row1, *row2, *row3;
+    uint16_t *registers, fb;
+    size_t i;
+    uint16_t j;
+
+    registers = rs_window_u16_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_u16_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        row0 = rs_split_row(rs, 0, fb);
+        row1 = rs_split_row(rs, 1, fb);
+        row2 = rs_split_row(rs, 2, fb);
+        row3 = rs_split_row(rs, 3, fb);
+
+        for (j = 0; j < rs->num_roots; j++) {
+            registers[j] ^= row0[j] ^ row1[j] ^ row2[j] ^ row3[j];
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots * sizeof(uint16_t));
+}
+
+/*
+ * Horner through the log tables, roots inner so that their chains overlap. Two lookups per root beat the eight of a
+ * split table here, the vector kernels are where split tables pay off.
+ */
+extern bool poporon_rs_syndrome_u16_scalar(const poporon_rs_t *rs, const uint16_t *data, size_t size,
+                                           const uint16_t *parity, uint16_t *syndrome)
+{
+    uint16_t values[UINT8_MAX + 1], root_logs[UINT8_MAX + 1], i, symbol, error_flag;
+    size_t j;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        root_logs[i] = gf_mod(rs->gf, (uint32_t)gf_mod(rs->gf, (uint32_t)rs->first_consecutive_root + i) *
+                                          rs->primitive_element);
+        values[i] = 0;
+    }
+
+    for (j = 0; j < size + rs->num_roots; j++) {
+        symbol = (j < size ? data[j] : parity[j - size]) & rs->gf->field_size;
+
+        for (i = 0; i < rs->num_roots; i++) {
+            values[i] = symbol ^ (values[i] ? gf_exp(rs->gf, rs->gf->exp2log[values[i]] + root_logs[i]) : 0);
+        }
+    }
+
+    error_flag = 0;
+    for (i = 0; i < rs->num_roots; i++) {
+        error_flag |= values[i];
+        syndrome[i] = rs->gf->exp2log[values[i]];
+    }
+
+    return error_flag != 0;
+}
+
+extern void poporon_gf_muladd_region_scalar(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src,
+                                            uint8_t *dst, size_t size)
+{
+    const uint8_t *table;
+    size_t i;
+
+    table = gf_nibble_table(gf, multiplier);
+
+    for (i = 0; i < size; i++) {
+        dst[i] ^= gf_nibble_mul(table, src[i]);
+    }
+}
+
+extern void poporon_gf_dot_region_scalar(const poporon_gf_t *gf, const uint8_t *coefficients,
+                                         const uint8_t *const *sources, size_t count, uint8_t *dst, size_t size)
+{
+    gf_dot_bytes(gf, coefficients, sources, count, dst, 0, size);
+}
+
+/* one log per multiplier and per symbol, the split tables only pay off in the vector kernels */
+extern void poporon_gf_mul_region_u16_scalar(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                             uint16_t *dst, size_t size)
+{
+    uint16_t log_multiplier, symbol;
+    size_t i;
+
+    log_multiplier = gf->exp2log[multiplier & gf->field_size];
+    if (log_multiplier == gf->field_size) {
+        pmemset(dst, 0, size * sizeof(uint16_t));
+
+        return;
+    }
+
+    for (i = 0; i < size; i++) {
+        symbol = src[i] & gf->field_size;
+        dst[i] = symbol ? gf_exp(gf, (uint32_t)gf->exp2log[symbol] + log_multiplier) : 0;
+    }
+}
+
+extern void poporon_gf_muladd_region_u16_scalar(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                                uint16_t *dst, size_t size)
+{
+    uint16_t log_multiplier, symbol;
+    size_t i;
+
+    log_multiplier = gf->exp2log[multiplier & gf->field_size];
+    if (log_multiplier == gf->field_size) {
+        return;
+    }
+
+    for (i = 0; i < size; i++) {
+        symbol = src[i] & gf->field_size;
+        if (symbol) {
+            dst[i] ^= gf_exp(gf, (uint32_t)gf->exp2log[symbol] + log_multiplier);
+        }
+    }
+}
+
+const poporon_kernel_t poporon_kernel_scalar = {
+    PPRN_SIMD_SCALAR,
+    poporon_rs_encode_scalar,
+    rs_syndrome_nibble,
+    poporon_rs_chien_scalar,
+    poporon_rs_encode_interleaved_scalar,
+    poporon_rs_syndrome_interleaved_scalar,
+    poporon_rs_encode_u16_scalar,
+    poporon_rs_syndrome_u16_scalar,
+    poporon_rs_chien_u16_scalar,
+    poporon_gf_muladd_region_scalar,
+    poporon_gf_dot_region_scalar,
+    poporon_gf_mul_region_u16_scalar,
+    poporon_gf_muladd_region_u16_scalar,
+    poporon_ldpc_check_node_scalar,
+};
@@ -0,0 +1,561 @@
+/*
+ * libpoporon - kernel_ssse3.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/kernel.h"
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_X86)
+
+#include "internal/ldpc.h"
+#include "internal/simd.h"
+
+#define SYNDROME_LANES     16
+#define SYNDROME_U16_LANES 8
+#define INTERLEAVED_LANES  16
+#define CHIEN_LANES        16
+#define CHECK_NODE_LANES   8
+
+static inline __m128i gf_mul_ssse3(const uint8_t *table, __m128i value, __m128i mask)
+{
+    __m128i table_lo, table_hi;
+
+    table_lo = _mm_loadu_si128((const __m128i *)table);
+    table_hi = _mm_loadu_si128((const __m128i *)(table + 16));
+
+    return _mm_xor_si128(_mm_shuffle_epi8(table_lo, _mm_and_si128(value, mask)),
+                         _mm_shuffle_epi8(table_hi, _mm_and_si128(_mm_srli_epi16(value, 4), mask)));
+}
+
+/* 8 products of 16-bit symbols, the index high bytes are 0 and so is entry 0 of every table */
+static inline __m128i gf_split_mul_ssse3(const uint8_t *table, __m128i value, __m128i mask)
+{
+    __m128i n0, n1, n2, n3, lo, hi;
+
+    n0 = _mm_and_si128(value, mask);
+    n1 = _mm_and_si128(_mm_srli_epi16(value, 4), mask);
+    n2 = _mm_and_si128(_mm_srli_epi16(value, 8), mask);
+    n3 = _mm_srli_epi16(value, 12);
+
+    lo = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)table), n0),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 32)), n1)),
+                       _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 64)), n2),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 96)), n3)));
+    hi = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 16)), n0),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 48)), n1)),
+                       _mm_xor_si128(_mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 80)), n2),
+                                     _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(table + 112)), n3)));
+
+    return _mm_xor_si128(lo, _mm_slli_epi16(hi, 8));
+}
+
+static void rs_encode_ssse3(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    rs_encode_window_t window;
+    __m128i table_lo, table_hi, mask, generator_vec, parity_vec, product_vec;
+    const uint8_t *table;
+    uint8_t *registers;
+    size_t i;
+    uint16_t j;
+    uint8_t fb;
+
+    mask = _mm_set1_epi8(0x0F);
+    registers = rs_window_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        table = gf_nibble_table(rs->gf, fb);
+        table_lo = _mm_loadu_si128((const __m128i *)table);
+        table_hi = _mm_loadu_si128((const __m128i *)(table + 16));
+
+        for (j = 0; j < rs->num_roots; j += 16) {
+            generator_vec = _mm_loadu_si128((const __m128i *)&rs->feedback_polynomial[j]);
+            product_vec =
+                _mm_xor_si128(_mm_shuffle_epi8(table_lo, _mm_and_si128(generator_vec, mask)),
+                              _mm_shuffle_epi8(table_hi, _mm_and_si128(_mm_srli_epi16(generator_vec, 4), mask)));
+            parity_vec = _mm_loadu_si128((__m128i *)&registers[j]);
+            _mm_storeu_si128((__m128i *)&registers[j], _mm_xor_si128(parity_vec, product_vec));
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots);
+}
+
+/* lanes hold codeword positions, Horner with root^16 per block then folded with root^8 ... root^1 */
+static bool rs_syndrome_ssse3(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                              uint16_t *syndrome)
+{
+    uint8_t staged[RS_STAGED_CODEWORD_SIZE];
+    __m128i mask, accumulator;
+    const uint8_t *powers, *horner;
+    size_t num_blocks, b;
+    uint16_t i, error_flag;
+    uint8_t value;
+
+    num_blocks = rs_stage_codeword(rs, data, size, parity, staged, SYNDROME_LANES);
+    if (!num_blocks) {
+        return poporon_rs_syndrome_scalar(rs, data, size, parity, syndrome);
+    }
+
+    mask = _mm_set1_epi8(0x0F);
+    error_flag = 0;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        powers = &rs->root_powers[i * RS_ROOT_POWERS];
+        horner = gf_nibble_table(rs->gf, powers[4]);
+
+        accumulator = _mm_loadu_si128((const __m128i *)staged);
+        for (b = 1; b < num_blocks; b++) {
+            accumulator = _mm_xor_si128(gf_mul_ssse3(horner, accumulator, mask),
+                                        _mm_loadu_si128((const __m128i *)&staged[b * SYNDROME_LANES]));
+        }
+
+        accumulator = _mm_xor_si128(gf_mul_ssse3(gf_nibble_table(rs->gf, powers[3]), accumulator, mask),
+                                    _mm_srli_si128(accumulator, 8));
+        accumulator = _mm_xor_si128(gf_mul_ssse3(gf_nibble_table(rs->gf, powers[2]), accumulator, mask),
+                                    _mm_srli_si128(accumulator, 4));
+        accumulator = _mm_xor_si128(gf_mul_ssse3(gf_nibble_table(rs->gf, powers[1]), accumulator, mask),
+                                    _mm_srli_si128(accumulator, 2));
+        accumulator = _mm_xor_si128(gf_mul_ssse3(gf_nibble_table(rs->gf, powers[0]), accumulator, mask),
+                                    _mm_srli_si128(accumulator, 1));
+
+        value = (uint8_t)_mm_cvtsi128_si32(accumulator);
+        error_flag |= value;
+        syndrome[i] = rs->gf->exp2log[value];
+    }
+
+    return error_flag != 0;
+}
+
+/*
+ * Chien search over CHIEN_LANES field points per step: lane t of a register holds lambda_j * alpha^(j * (i + t)), and
+ * moving to the next block multiplies it by the constant alpha^(j * CHIEN_LANES) with nibble tables, no log lookups.
+ */
+static uint16_t rs_chien_ssse3(const poporon_rs_t *rs, const uint16_t *error_locator, uint16_t degree,
+                               uint16_t primitive_inverse, uint16_t *registers, uint16_t *error_roots,
+                               uint16_t *error_locations)
+{
+    uint8_t values[(UINT8_MAX + 1) * CHIEN_LANES];
+    const uint8_t *tables[UINT8_MAX + 1];
+    __m128i mask, zero, evaluation, value;
+    uint16_t active, error_count, i, j;
+    uint32_t found;
+
+    (void)registers;
+
+    mask = _mm_set1_epi8(0x0F);
+    zero = _mm_setzero_si128();
+    active = rs_chien_lanes(rs, error_locator, degree, CHIEN_LANES, values, tables);
+    error_count = 0;
+
+    for (i = 1; i <= rs->gf->field_size; i += CHIEN_LANES) {
+        evaluation = _mm_set1_epi8(1);
+
+        for (j = 0; j < active; j++) {
+            value = _mm_loadu_si128((const __m128i *)&values[(size_t)j * CHIEN_LANES]);
+            evaluation = _mm_xor_si128(evaluation, value);
+            _mm_storeu_si128((__m128i *)&values[(size_t)j * CHIEN_LANES], gf_mul_ssse3(tables[j], value, mask));
+        }
+
+        found = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(evaluation, zero));
+        if (found != 0 && rs_chien_record(rs, found, i, degree, primitive_inverse, error_roots, error_locations,
+                                          &error_count)) {
+            break;
+        }
+    }
+
+    return error_count;
+}
+
+static void rs_encode_u16_ssse3(const poporon_rs_t *rs, const uint16_t *data, size_t size, uint16_t *parity)
+{
+    rs_encode_window_u16_t window;
+    const uint16_t *row0, *row1, *row2, *row3;
+    __m128i rows;
+    uint16_t *registers, fb, j;
+    size_t i;
+
+    registers = rs_window_u16_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_u16_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        row0 = rs_split_row(rs, 0, fb);
+        row1 = rs_split_row(rs, 1, fb);
+        row2 = rs_split_row(rs, 2, fb);
+        row3 = rs_split_row(rs, 3, fb);
+
+        for (j = 0; j < rs->num_roots; j += SYNDROME_U16_LANES) {
+            rows = _mm_xor_si128(_mm_xor_si128(_mm_loadu_si128((const __m128i *)&row0[j]),
+                                               _mm_loadu_si128((const __m128i *)&row1[j])),
+                                 _mm_xor_si128(_mm_loadu_si128((const __m128i *)&row2[j]),
+                                               _mm_loadu_si128((const __m128i *)&row3[j])));
+            _mm_storeu_si128((__m128i *)&registers[j],
+                             _mm_xor_si128(_mm_loadu_si128((const __m128i *)&registers[j]), rows));
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots * sizeof(uint16_t));
+}
+
+/*
+ * Blocks outer so that a long codeword is read once, every root keeps a Horner accumulator over 8 positions that is
+ * folded with root^4, root^2 and root^1 at the end.
+ */
+static bool rs_syndrome_u16_ssse3(const poporon_rs_t *rs, const uint16_t *data, size_t size, const uint16_t *parity,
+                                  uint16_t *syndrome)
+{
+    __m128i accumulators[UINT8_MAX + 1], mask, block, accumulator;
+    uint16_t staged[SYNDROME_U16_LANES], i, value, error_flag;
+    size_t num_blocks, offset, b;
+
+    mask = _mm_set1_epi16(0x0F);
+    num_blocks = rs_u16_blocks(rs, size, SYNDROME_U16_LANES, &offset);
+
+    for (i = 0; i < rs->num_roots; i++) {
+        accumulators[i] = _mm_setzero_si128();
+    }
+
+    for (b = 0; b < num_blocks; b++) {
+        block = _mm_loadu_si128(
+            (const __m128i *)rs_u16_block(rs, data, size, parity, offset, b, SYNDROME_U16_LANES, staged));
+
+        for (i = 0; i < rs->num_roots; i++) {
+            accumulators[i] = _mm_xor_si128(gf_split_mul_ssse3(rs_root_split(rs, i, 3), accumulators[i], mask), block);
+        }
+    }
+
+    error_flag = 0;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        accumulator = accumulators[i];
+        accumulator = _mm_xor_si128(gf_split_mul_ssse3(rs_root_split(rs, i, 2), accumulator, mask),
+                                    _mm_srli_si128(accumulator, 8));
+        accumulator = _mm_xor_si128(gf_split_mul_ssse3(rs_root_split(rs, i, 1), accumulator, mask),
+                                    _mm_srli_si128(accumulator, 4));
+        accumulator = _mm_xor_si128(gf_split_mul_ssse3(rs_root_split(rs, i, 0), accumulator, mask),
+                                    _mm_srli_si128(accumulator, 2));
+
+        value = (uint16_t)_mm_cvtsi128_si32(accumulator);
+        error_flag |= value;
+        syndrome[i] = rs->gf->exp2log[value];
+    }
+
+    return error_flag != 0;
+}
+
+/* 16 codewords per vector, a trailing partial group goes through the scalar kernel */
+static void rs_encode_interleaved_ssse3(const poporon_rs_t *rs, const uint8_t *data, size_t size, size_t stride,
+                                        size_t lanes, uint8_t *parity)
+{
+    __m128i registers[RS_STAGED_CODEWORD_SIZE], mask, field_mask, fb;
+    size_t lane, i;
+    uint16_t head, j, k;
+
+    mask = _mm_set1_epi8(0x0F);
+    field_mask = _mm_set1_epi8((char)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (j = 0; j < rs->num_roots; j++) {
+            registers[j] = _mm_setzero_si128();
+        }
+        head = 0;
+
+        for (i = 0; i < size; i++) {
+            fb = _mm_and_si128(_mm_loadu_si128((const __m128i *)&data[i * stride + lane]), field_mask);
+            fb = _mm_xor_si128(fb, registers[head]);
+
+            k = 0;
+            for (j = head + 1; j < rs->num_roots; j++, k++) {
+                registers[j] = _mm_xor_si128(
+                    registers[j], gf_mul_ssse3(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            for (j = 0; j < head; j++, k++) {
+                registers[j] = _mm_xor_si128(
+                    registers[j], gf_mul_ssse3(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            registers[head] = gf_mul_ssse3(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+
+        for (j = 0; j < rs->num_roots; j++) {
+            _mm_storeu_si128((__m128i *)&parity[j * stride + lane], registers[head]);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_rs_encode_interleaved_scalar(rs, &data[lane], size, stride, lanes - lane, &parity[lane]);
+    }
+}
+
+static void rs_syndrome_interleaved_ssse3(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                          const uint8_t *parity, size_t stride, size_t lanes, uint8_t *syndrome)
+{
+    __m128i accumulators[RS_STAGED_CODEWORD_SIZE], mask, field_mask, symbols;
+    const uint8_t *row;
+    size_t lane, j;
+    uint16_t i;
+
+    mask = _mm_set1_epi8(0x0F);
+    field_mask = _mm_set1_epi8((char)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (i = 0; i < rs->num_roots; i++) {
+            accumulators[i] = _mm_setzero_si128();
+        }
+
+        for (j = 0; j < size + rs->num_roots; j++) {
+            row = (j < size) ? &data[j * stride + lane] : &parity[(j - size) * stride + lane];
+            symbols = _mm_and_si128(_mm_loadu_si128((const __m128i *)row), field_mask);
+
+            for (i = 0; i < rs->num_roots; i++) {
+                accumulators[i] = _mm_xor_si128(
+                    gf_mul_ssse3(gf_nibble_table(rs->gf, rs->root_powers[i * RS_ROOT_POWERS]), accumulators[i], mask),
+                    symbols);
+            }
+        }
+
+        for (i = 0; i < rs->num_roots; i++) {
+            _mm_storeu_si128((__m128i *)&syndrome[i * stride + lane], accumulators[i]);
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_rs_syndrome_interleaved_scalar(rs, &data[lane], size, &parity[lane], stride, lanes - lane,
+                                               &syndrome[lane]);
+    }
+}
+
+static void gf_muladd_region_ssse3(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                                   size_t size)
+{
+    __m128i mask, product;
+    const uint8_t *table;
+    size_t i;
+
+    mask = _mm_set1_epi8(0x0F);
+    table = gf_nibble_table(gf, multiplier);
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        product = gf_mul_ssse3(table, _mm_loadu_si128((const __m128i *)&src[i]), mask);
+        _mm_storeu_si128((__m128i *)&dst[i], _mm_xor_si128(_mm_loadu_si128((const __m128i *)&dst[i]), product));
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= gf_nibble_mul(table, src[i]);
+    }
+}
+
+static void gf_dot_region_ssse3(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                                size_t count, uint8_t *dst, size_t size)
+{
+    __m128i mask, accumulator;
+    size_t i, k;
+
+    mask = _mm_set1_epi8(0x0F);
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        accumulator = _mm_setzero_si128();
+        for (k = 0; k < count; k++) {
+            accumulator = _mm_xor_si128(accumulator, gf_mul_ssse3(gf_nibble_table(gf, coefficients[k]),
+                                                                  _mm_loadu_si128((const __m128i *)&sources[k][i]),
+                                                                  mask));
+        }
+
+        _mm_storeu_si128((__m128i *)&dst[i], accumulator);
+    }
+
+    gf_dot_bytes(gf, coefficients, sources, count, dst, i, size);
+}
+
+static inline void gf_region_u16_ssse3(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                       uint16_t *dst, size_t size, bool accumulate)
+{
+    uint8_t table[GF_SPLIT_TABLE_SIZE];
+    __m128i mask, product;
+    size_t i;
+
+    mask = _mm_set1_epi16(0x0F);
+    poporon_gf_split_table(gf, multiplier, table);
+
+    for (i = 0; i + SYNDROME_U16_LANES <= size; i += SYNDROME_U16_LANES) {
+        product = gf_split_mul_ssse3(table, _mm_loadu_si128((const __m128i *)&src[i]), mask);
+        if (accumulate) {
+            product = _mm_xor_si128(_mm_loadu_si128((const __m128i *)&dst[i]), product);
+        }
+        _mm_storeu_si128((__m128i *)&dst[i], product);
+    }
+
+    for (; i < size; i++) {
+        dst[i] = (uint16_t)((accumulate ? dst[i] : 0) ^ gf_split_mul(table, src[i]));
+    }
+}
+
+static void gf_mul_region_u16_ssse3(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src, uint16_t *dst,
+                                    size_t size)
+{
+    gf_region_u16_ssse3(gf, multiplier, src, dst, size, false);
+}
+
+static void gf_muladd_region_u16_ssse3(const poporon_gf_t *gf, uint16_t multiplier, const uint16_t *src,
+                                       uint16_t *dst, size_t size)
+{
+    gf_region_u16_ssse3(gf, multiplier, src, dst, size, true);
+}
+
+static inline int16_t reduce_min_epi16(__m128i value)
+{
+    value = _mm_min_epi16(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(1, 0, 3, 2)));
+    value = _mm_min_epi16(value, _mm_shuffle_epi32(value, _MM_SHUFFLE(2, 3, 0, 1)));
+    value = _mm_min_epi16(value, _mm_srli_epi32(value, 16));
+
+    return (int16_t)_mm_cvtsi128_si32(value);
+}
+
+/* no pblendvb before SSE4.1, select is all ones or all zeros per lane */
+static inline __m128i select_epi16(__m128i a, __m128i b, __m128i select)
+{
+    return _mm_or_si128(_mm_andnot_si128(select, a), _mm_and_si128(select, b));
+}
+
+/* lane index of the lowest set lane in a movemask of 16-bit lanes, bits must be non-zero */
+static inline uint32_t lowest_lane(uint32_t bits)
+{
+    uint32_t index = 0;
+
+    while (!(bits & 1)) {
+        bits >>= 2;
+        index++;
+    }
+
+    return index;
+}
+
+static inline uint32_t parity32(uint32_t bits)
+{
+    bits ^= bits >> 16;
+    bits ^= bits >> 8;
+    bits ^= bits >> 4;
+    bits ^= bits >> 2;
+
+    return (bits ^ (bits >> 1)) & 1;
+}
+
+/* 8 edges per vector, the edges of a row past its last full vector take the scalar steps */
+static void ldpc_check_node_ssse3(const uint32_t *row_ptr, uint32_t num_checks, const int16_t *var_to_check,
+                                  int16_t *check_to_var)
+{
+    __m128i fill, index, zero, msg, abs_msg, signs, min_vec, min1_vec, min2_vec, parity_vec, select, flip, out;
+    uint32_t i, j, start, end, full, min1_idx, negative_parity, bits;
+    int16_t min1, min2, value;
+
+    fill = _mm_set1_epi16(LLR_MAX);
+    index = _mm_setr_epi16(0, 1, 2, 3, 4, 5, 6, 7);
+    zero = _mm_setzero_si128();
+
+    for (i = 0; i < num_checks; i++) {
+        start = row_ptr[i];
+        end = row_ptr[i + 1];
+        full = start + (end - start) / CHECK_NODE_LANES * CHECK_NODE_LANES;
+
+        /* the sign bit of the xor of every message is the parity of the negative ones in that lane */
+        min_vec = fill;
+        signs = zero;
+        for (j = start; j < full; j += CHECK_NODE_LANES) {
+            msg = _mm_loadu_si128((const __m128i *)&var_to_check[j]);
+            signs = _mm_xor_si128(signs, msg);
+            min_vec = _mm_min_epi16(min_vec, _mm_abs_epi16(msg));
+        }
+        min1 = reduce_min_epi16(min_vec);
+        negative_parity = parity32((uint32_t)_mm_movemask_epi8(signs) & 0xAAAAU);
+        for (; j < end; j++) {
+            value = var_to_check[j];
+            negative_parity ^= (uint32_t)(value < 0);
+            value = (int16_t)((value < 0) ? -value : value);
+            min1 = (value < min1) ? value : min1;
+        }
+
+        min1_vec = _mm_set1_epi16(min1);
+        min1_idx = end;
+        min_vec = fill;
+        for (j = start; j < full; j += CHECK_NODE_LANES) {
+            abs_msg = _mm_abs_epi16(_mm_loadu_si128((const __m128i *)&var_to_check[j]));
+            if (min1_idx == end) {
+                bits = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi16(abs_msg, min1_vec));
+                if (bits) {
+                    min1_idx = j + lowest_lane(bits);
+                    select = _mm_cmpeq_epi16(index, _mm_set1_epi16((int16_t)(min1_idx - j)));
+                    abs_msg = select_epi16(abs_msg, fill, select);
+                }
+            }
+            min_vec = _mm_min_epi16(min_vec, abs_msg);
+        }
+        min2 = reduce_min_epi16(min_vec);
+        for (; j < end; j++) {
+            value = var_to_check[j];
+            value = (int16_t)((value < 0) ? -value : value);
+            if (min1_idx == end && value == min1) {
+                min1_idx = j;
+            } else if (value < min2) {
+                min2 = value;
+            }
+        }
+
+        min1 -= (int16_t)((min1 + 15) >> 4);
+        min2 -= (int16_t)((min2 + 15) >> 4);
+        min1_vec = _mm_set1_epi16(min1);
+        min2_vec = _mm_set1_epi16(min2);
+        parity_vec = negative_parity ? _mm_set1_epi16(-1) : zero;
+
+        /* (x ^ flip) - flip negates the lanes whose flip is all ones */
+        for (j = start; j < full; j += CHECK_NODE_LANES) {
+            msg = _mm_loadu_si128((const __m128i *)&var_to_check[j]);
+            flip = _mm_xor_si128(_mm_srai_epi16(msg, 15), parity_vec);
+            out = min1_vec;
+            if (min1_idx >= j && min1_idx < j + CHECK_NODE_LANES) {
+                select = _mm_cmpeq_epi16(index, _mm_set1_epi16((int16_t)(min1_idx - j)));
+                out = select_epi16(out, min2_vec, select);
+            }
+            _mm_storeu_si128((__m128i *)&check_to_var[j], _mm_sub_epi16(_mm_xor_si128(out, flip), flip));
+        }
+        for (; j < end; j++) {
+            value = (j == min1_idx) ? min2 : min1;
+            check_to_var[j] = ((uint32_t)(var_to_check[j] < 0) ^ negative_parity) ? (int16_t)-value : value;
+        }
+    }
+}
+
+const poporon_kernel_t poporon_kernel_ssse3 = {
+    PPRN_SIMD_SSSE3,
+    rs_encode_ssse3,
+    rs_syndrome_ssse3,
+    rs_chien_ssse3,
+    rs_encode_interleaved_ssse3,
+    rs_syndrome_interleaved_ssse3,
+    rs_encode_u16_ssse3,
+    rs_syndrome_u16_ssse3,
+    poporon_rs_chien_u16_scalar,
+    gf_muladd_region_ssse3,
+    gf_dot_region_ssse3,
+    gf_mul_region_u16_ssse3,
+    gf_muladd_region_u16_ssse3,
+    ldpc_check_node_ssse3,
+};
+
+#endif
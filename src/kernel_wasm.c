@@ -0,0 +1,250 @@
+/*
+ * libpoporon - kernel_wasm.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/kernel.h"
+
+#if POPORON_USE_SIMD && defined(POPORON_SIMD_WASM)
+
+#include "internal/simd.h"
+
+#define SYNDROME_LANES    16
+#define INTERLEAVED_LANES 16
+
+static inline v128_t gf_mul_wasm(const uint8_t *table, v128_t value, v128_t mask)
+{
+    return wasm_v128_xor(wasm_i8x16_swizzle(wasm_v128_load(table), wasm_v128_and(value, mask)),
+                         wasm_i8x16_swizzle(wasm_v128_load(table + 16), wasm_u8x16_shr(value, 4)));
+}
+
+static void rs_encode_wasm(const poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    rs_encode_window_t window;
+    v128_t mask, generator_vec, parity_vec;
+    const uint8_t *table;
+    uint8_t *registers;
+    size_t i;
+    uint16_t j;
+    uint8_t fb;
+
+    mask = wasm_i8x16_splat(0x0F);
+    registers = rs_window_reset(&window, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = (data[i] & rs->gf->field_size) ^ registers[0];
+        registers = rs_window_shift(&window, rs->num_roots, 1);
+
+        if (fb == 0) {
+            continue;
+        }
+
+        table = gf_nibble_table(rs->gf, fb);
+
+        for (j = 0; j < rs->num_roots; j += 16) {
+            generator_vec = wasm_v128_load(&rs->feedback_polynomial[j]);
+            parity_vec = wasm_v128_load(&registers[j]);
+            wasm_v128_store(&registers[j], wasm_v128_xor(parity_vec, gf_mul_wasm(table, generator_vec, mask)));
+        }
+    }
+
+    pmemcpy(parity, registers, rs->num_roots);
+}
+
+/* lanes hold codeword positions, Horner with root^16 per block then folded with root^8 ... root^1 */
+static bool rs_syndrome_wasm(const poporon_rs_t *rs, const uint8_t *data, size_t size, const uint8_t *parity,
+                             uint16_t *syndrome)
+{
+    uint8_t staged[RS_STAGED_CODEWORD_SIZE];
+    v128_t mask, zero, accumulator;
+    const uint8_t *powers, *horner;
+    size_t num_blocks, b;
+    uint16_t i, error_flag;
+    uint8_t value;
+
+    num_blocks = rs_stage_codeword(rs, data, size, parity, staged, SYNDROME_LANES);
+    if (!num_blocks) {
+        return poporon_rs_syndrome_scalar(rs, data, size, parity, syndrome);
+    }
+
+    mask = wasm_i8x16_splat(0x0F);
+    zero = wasm_i8x16_splat(0);
+    error_flag = 0;
+
+    for (i = 0; i < rs->num_roots; i++) {
+        powers = &rs->root_powers[i * RS_ROOT_POWERS];
+        horner = gf_nibble_table(rs->gf, powers[4]);
+
+        accumulator = wasm_v128_load(staged);
+        for (b = 1; b < num_blocks; b++) {
+            accumulator =
+                wasm_v128_xor(gf_mul_wasm(horner, accumulator, mask), wasm_v128_load(&staged[b * SYNDROME_LANES]));
+        }
+
+        accumulator = wasm_v128_xor(
+            gf_mul_wasm(gf_nibble_table(rs->gf, powers[3]), accumulator, mask),
+            wasm_i8x16_shuffle(accumulator, zero, 8, 9, 10, 11, 12, 13, 14, 15, 16, 16, 16, 16, 16, 16, 16, 16));
+        accumulator = wasm_v128_xor(
+            gf_mul_wasm(gf_nibble_table(rs->gf, powers[2]), accumulator, mask),
+            wasm_i8x16_shuffle(accumulator, zero, 4, 5, 6, 7, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16));
+        accumulator = wasm_v128_xor(
+            gf_mul_wasm(gf_nibble_table(rs->gf, powers[1]), accumulator, mask),
+            wasm_i8x16_shuffle(accumulator, zero, 2, 3, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16));
+        accumulator = wasm_v128_xor(
+            gf_mul_wasm(gf_nibble_table(rs->gf, powers[0]), accumulator, mask),
+            wasm_i8x16_shuffle(accumulator, zero, 1, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16, 16));
+
+        value = wasm_u8x16_extract_lane(accumulator, 0);
+        error_flag |= value;
+        syndrome[i] = rs->gf->exp2log[value];
+    }
+
+    return error_flag != 0;
+}
+
+/* 16 codewords per vector, a trailing partial group goes through the scalar kernel */
+static void rs_encode_interleaved_wasm(const poporon_rs_t *rs, const uint8_t *data, size_t size, size_t stride,
+                                       size_t lanes, uint8_t *parity)
+{
+    v128_t registers[RS_STAGED_CODEWORD_SIZE], mask, field_mask, fb;
+    size_t lane, i;
+    uint16_t head, j, k;
+
+    mask = wasm_i8x16_splat(0x0F);
+    field_mask = wasm_i8x16_splat((char)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (j = 0; j < rs->num_roots; j++) {
+            registers[j] = wasm_i8x16_splat(0);
+        }
+        head = 0;
+
+        for (i = 0; i < size; i++) {
+            fb = wasm_v128_and(wasm_v128_load(&data[i * stride + lane]), field_mask);
+            fb = wasm_v128_xor(fb, registers[head]);
+
+            k = 0;
+            for (j = head + 1; j < rs->num_roots; j++, k++) {
+                registers[j] = wasm_v128_xor(
+                    registers[j], gf_mul_wasm(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            for (j = 0; j < head; j++, k++) {
+                registers[j] = wasm_v128_xor(
+                    registers[j], gf_mul_wasm(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask));
+            }
+            registers[head] = gf_mul_wasm(gf_nibble_table(rs->gf, rs->feedback_polynomial[k]), fb, mask);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+
+        for (j = 0; j < rs->num_roots; j++) {
+            wasm_v128_store(&parity[j * stride + lane], registers[head]);
+            head = (head + 1 == rs->num_roots) ? 0 : head + 1;
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_rs_encode_interleaved_scalar(rs, &data[lane], size, stride, lanes - lane, &parity[lane]);
+    }
+}
+
+static void rs_syndrome_interleaved_wasm(const poporon_rs_t *rs, const uint8_t *data, size_t size,
+                                         const uint8_t *parity, size_t stride, size_t lanes, uint8_t *syndrome)
+{
+    v128_t accumulators[RS_STAGED_CODEWORD_SIZE], mask, field_mask, symbols;
+    const uint8_t *row;
+    size_t lane, j;
+    uint16_t i;
+
+    mask = wasm_i8x16_splat(0x0F);
+    field_mask = wasm_i8x16_splat((char)rs->gf->field_size);
+
+    for (lane = 0; lane + INTERLEAVED_LANES <= lanes; lane += INTERLEAVED_LANES) {
+        for (i = 0; i < rs->num_roots; i++) {
+            accumulators[i] = wasm_i8x16_splat(0);
+        }
+
+        for (j = 0; j < size + rs->num_roots; j++) {
+            row = (j < size) ? &data[j * stride + lane] : &parity[(j - size) * stride + lane];
+            symbols = wasm_v128_and(wasm_v128_load(row), field_mask);
+
+            for (i = 0; i < rs->num_roots; i++) {
+                accumulators[i] = wasm_v128_xor(
+                    gf_mul_wasm(gf_nibble_table(rs->gf, rs->root_powers[i * RS_ROOT_POWERS]), accumulators[i], mask),
+                    symbols);
+            }
+        }
+
+        for (i = 0; i < rs->num_roots; i++) {
+            wasm_v128_store(&syndrome[i * stride + lane], accumulators[i]);
+        }
+    }
+
+    if (lane < lanes) {
+        poporon_rs_syndrome_interleaved_scalar(rs, &data[lane], size, &parity[lane], stride, lanes - lane,
+                                               &syndrome[lane]);
+    }
+}
+
+static void gf_muladd_region_wasm(const poporon_gf_t *gf, uint8_t multiplier, const uint8_t *src, uint8_t *dst,
+                                  size_t size)
+{
+    v128_t mask;
+    const uint8_t *table;
+    size_t i;
+
+    mask = wasm_i8x16_splat(0x0F);
+    table = gf_nibble_table(gf, multiplier);
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        wasm_v128_store(&dst[i],
+                        wasm_v128_xor(wasm_v128_load(&dst[i]), gf_mul_wasm(table, wasm_v128_load(&src[i]), mask)));
+    }
+
+    for (; i < size; i++) {
+        dst[i] ^= gf_nibble_mul(table, src[i]);
+    }
+}
+
+static void gf_dot_region_wasm(const poporon_gf_t *gf, const uint8_t *coefficients, const uint8_t *const *sources,
+                               size_t count, uint8_t *dst, size_t size)
+{
+    v128_t mask, accumulator;
+    size_t i, k;
+
+    mask = wasm_i8x16_splat(0x0F);
+
+    for (i = 0; i + 16 <= size; i += 16) {
+        accumulator = wasm_i8x16_splat(0);
+        for (k = 0; k < count; k++) {
+            accumulator = wasm_v128_xor(
+                accumulator, gf_mul_wasm(gf_nibble_table(gf, coefficients[k]), wasm_v128_load(&sources[k][i]), mask));
+        }
+
+        wasm_v128_store(&dst[i], accumulator);
+    }
+
+    gf_dot_bytes(gf, coefficients, sources, count, dst, i, size);
+}
+
+const poporon_kernel_t poporon_kernel_wasm = {
+    PPRN_SIMD_WASM,
+    rs_encode_wasm,
+    rs_syndrome_wasm,
+    poporon_rs_chien_scalar,
+    rs_encode_interleaved_wasm,
+    rs_syndrome_interleaved_wasm,
+    poporon_rs_encode_u16_scalar,
+    poporon_rs_syndrome_u16_scalar,
+    poporon_rs_chien_u16_scalar,
+    gf_muladd_region_wasm,
+    gf_dot_region_wasm,
+    poporon_gf_mul_region_u16_scalar,
+    poporon_gf_muladd_region_u16_scalar,
+    poporon_ldpc_check_node_scalar,
+};
+
+#endif
@@ -7,6 +7,7 @@
  * SPDX-License-Identifier: MIT
  */
 
+#include "internal/kernel.h"
 #include "internal/ldpc.h"
 
 #include <poporon/rng.h>
@@ -32,8 +33,11 @@
 #define MIN_LIFTING_FACTOR          4
 #define MAX_LIFTING_FACTOR          256
 
-#define MINSUM_ALPHA_NUMERATOR   15
-#define MINSUM_ALPHA_DENOMINATOR 16
+typedef struct {
+    size_t block_size;
+    poporon_ldpc_rate_t rate;
+    poporon_ldpc_params_t config;
+} ldpc_key_t;
 
 static inline void get_rate_params(poporon_ldpc_rate_t rate, uint32_t *info_num, uint32_t *parity_num)
 {
@@ -600,48 +604,47 @@ static inline bool build_parity_check_matrix(poporon_ldpc_t *ldpc)
     }
 }
 
-static inline bool allocate_messages(poporon_ldpc_t *ldpc)
+static inline bool check_syndrome(const poporon_ldpc_t *ldpc, const uint8_t *codeword)
 {
-    ldpc->msg.check_to_var = (int16_t *)pcalloc(ldpc->parity_matrix.num_edges, sizeof(int16_t));
-    ldpc->msg.var_to_check = (int16_t *)pcalloc(ldpc->parity_matrix.num_edges, sizeof(int16_t));
-    ldpc->msg.llr_total = (int16_t *)pcalloc(ldpc->parity_matrix.num_bits, sizeof(int16_t));
-    ldpc->temp_codeword = (uint8_t *)pmalloc(ldpc->codeword_bytes);
+    uint8_t syndrome_bit;
+    size_t i, j;
 
-    if (!ldpc->msg.check_to_var || !ldpc->msg.var_to_check || !ldpc->msg.llr_total || !ldpc->temp_codeword) {
-        return false;
-    }
+    for (i = 0; i < ldpc->parity_matrix.num_checks; i++) {
+        syndrome_bit = 0;
 
-    if (ldpc->config.use_inner_interleave) {
-        ldpc->temp_interleaved = (uint8_t *)pmalloc(ldpc->codeword_bytes);
-        if (!ldpc->temp_interleaved) {
-            return false;
+        for (j = ldpc->parity_matrix.row_ptr[i]; j < ldpc->parity_matrix.row_ptr[i + 1]; j++) {
+            syndrome_bit ^= get_bit(codeword, ldpc->parity_matrix.col_idx[j]);
         }
-    } else {
-        ldpc->temp_interleaved = NULL;
-    }
 
-    if (ldpc->config.use_outer_interleave) {
-        ldpc->temp_outer = (uint8_t *)pmalloc(ldpc->info_bytes);
-        if (!ldpc->temp_outer) {
+        if (syndrome_bit != 0) {
             return false;
         }
-    } else {
-        ldpc->temp_outer = NULL;
     }
 
     return true;
 }
 
-static inline bool check_syndrome(const poporon_ldpc_t *ldpc, const uint8_t *codeword)
+/*
+ * check_syndrome() on info || parity as sent, read in place: the two halves stay in their own buffers and the inner
+ * interleaver maps each codeword bit to its position on the channel.
+ */
+static inline bool check_syndrome_split(const poporon_ldpc_t *ldpc, const uint8_t *info, const uint8_t *parity)
 {
+    const uint32_t *forward = NULL;
     uint8_t syndrome_bit;
-    size_t i, j;
+    size_t i, j, bit_idx;
+
+    if (ldpc->config.use_inner_interleave) {
+        forward = ldpc->interleaver.forward;
+    }
 
     for (i = 0; i < ldpc->parity_matrix.num_checks; i++) {
         syndrome_bit = 0;
 
         for (j = ldpc->parity_matrix.row_ptr[i]; j < ldpc->parity_matrix.row_ptr[i + 1]; j++) {
-            syndrome_bit ^= get_bit(codeword, ldpc->parity_matrix.col_idx[j]);
+            bit_idx = forward ? forward[ldpc->parity_matrix.col_idx[j]] : ldpc->parity_matrix.col_idx[j];
+            syndrome_bit ^=
+                bit_idx < ldpc->info_bits ? get_bit(info, bit_idx) : get_bit(parity, bit_idx - ldpc->info_bits);
         }
 
         if (syndrome_bit != 0) {
@@ -652,92 +655,51 @@ static inline bool check_syndrome(const poporon_ldpc_t *ldpc, const uint8_t *cod
     return true;
 }
 
-static inline void initialize_messages_soft(poporon_ldpc_t *ldpc, const int8_t *llr)
+static inline void initialize_messages_soft(const poporon_ldpc_t *ldpc, messages_t *msg, const int8_t *llr)
 {
     int16_t llr_val;
     size_t i, j;
 
     for (i = 0; i < ldpc->codeword_bits; i++) {
         llr_val = (int16_t)llr[i] * LLR_SCALE_FACTOR;
-        ldpc->msg.llr_total[i] = ldpc_saturate(llr_val);
+        msg->llr_total[i] = ldpc_saturate(llr_val);
     }
 
     for (i = 0; i < ldpc->parity_matrix.num_bits; i++) {
         for (j = ldpc->parity_matrix_cols.col_ptr[i]; j < ldpc->parity_matrix_cols.col_ptr[i + 1]; j++) {
-            ldpc->msg.var_to_check[ldpc->parity_matrix_cols.edge_idx[j]] = ldpc->msg.llr_total[i];
+            msg->var_to_check[ldpc->parity_matrix_cols.edge_idx[j]] = msg->llr_total[i];
         }
     }
 
-    pmemset(ldpc->msg.check_to_var, 0, ldpc->parity_matrix.num_edges * sizeof(int16_t));
+    pmemset(msg->check_to_var, 0, ldpc->parity_matrix.num_edges * sizeof(int16_t));
 }
 
-static inline void initialize_messages_hard(poporon_ldpc_t *ldpc, const uint8_t *codeword)
+static inline void initialize_messages_hard(const poporon_ldpc_t *ldpc, messages_t *msg, const uint8_t *codeword)
 {
     int16_t llr_val;
     size_t i, j;
 
     for (i = 0; i < ldpc->codeword_bits; i++) {
         llr_val = get_bit(codeword, i) ? -LLR_INFINITY : LLR_INFINITY;
-        ldpc->msg.llr_total[i] = llr_val;
+        msg->llr_total[i] = llr_val;
     }
 
     for (i = 0; i < ldpc->parity_matrix.num_bits; i++) {
         for (j = ldpc->parity_matrix_cols.col_ptr[i]; j < ldpc->parity_matrix_cols.col_ptr[i + 1]; j++) {
-            ldpc->msg.var_to_check[ldpc->parity_matrix_cols.edge_idx[j]] = ldpc->msg.llr_total[i];
+            msg->var_to_check[ldpc->parity_matrix_cols.edge_idx[j]] = msg->llr_total[i];
         }
     }
 
-    pmemset(ldpc->msg.check_to_var, 0, ldpc->parity_matrix.num_edges * sizeof(int16_t));
+    pmemset(msg->check_to_var, 0, ldpc->parity_matrix.num_edges * sizeof(int16_t));
 }
 
-static inline void check_node_update(poporon_ldpc_t *ldpc)
+static inline void check_node_update(const poporon_ldpc_t *ldpc, messages_t *msg)
 {
-    uint32_t min1_idx;
-    int16_t min1, min2, sign, msg, abs_msg;
-    size_t i, j, k;
-
-    for (i = 0; i < ldpc->parity_matrix.num_checks; i++) {
-        sign = 1;
-        min1 = LLR_MAX;
-        min2 = LLR_MAX;
-        min1_idx = 0;
-
-        for (j = ldpc->parity_matrix.row_ptr[i]; j < ldpc->parity_matrix.row_ptr[i + 1]; j++) {
-            msg = ldpc->msg.var_to_check[j];
-            if (msg < 0) {
-                sign = -sign;
-                abs_msg = -msg;
-            } else {
-                abs_msg = msg;
-            }
-
-            if (abs_msg < min1) {
-                min2 = min1;
-                min1 = abs_msg;
-                min1_idx = (uint32_t)j;
-            } else if (abs_msg < min2) {
-                min2 = abs_msg;
-            }
-        }
-
-        for (j = ldpc->parity_matrix.row_ptr[i]; j < ldpc->parity_matrix.row_ptr[i + 1]; j++) {
-            msg = ldpc->msg.var_to_check[j];
-
-            if (j == min1_idx) {
-                abs_msg = min2;
-            } else {
-                abs_msg = min1;
-            }
-
-            abs_msg = (int16_t)((int32_t)abs_msg * MINSUM_ALPHA_NUMERATOR / MINSUM_ALPHA_DENOMINATOR);
-
-            k = (msg < 0) ? -sign : sign;
-            ldpc->msg.check_to_var[j] = (int16_t)(k * abs_msg);
-        }
-    }
+    poporon_kernel()->ldpc_check_node(ldpc->parity_matrix.row_ptr, ldpc->parity_matrix.num_checks,
+                                      msg->var_to_check, msg->check_to_var);
 }
 
-static inline void variable_node_update(poporon_ldpc_t *ldpc, const int8_t *channel_llr)
+static inline void variable_node_update(const poporon_ldpc_t *ldpc, messages_t *msg, const int8_t *channel_llr)
 {
     int32_t sum;
     int16_t channel;
@@ -747,31 +709,31 @@ static inline void variable_node_update(poporon_ldpc_t *ldpc, const int8_t *chan
         if (channel_llr) {
             channel = (int16_t)channel_llr[i] * LLR_SCALE_FACTOR;
         } else {
-            channel = ldpc->msg.llr_total[i];
+            channel = msg->llr_total[i];
         }
 
         sum = channel;
 
         for (j = ldpc->parity_matrix_cols.col_ptr[i]; j < ldpc->parity_matrix_cols.col_ptr[i + 1]; j++) {
-            sum += ldpc->msg.check_to_var[ldpc->parity_matrix_cols.edge_idx[j]];
+            sum += msg->check_to_var[ldpc->parity_matrix_cols.edge_idx[j]];
         }
 
-        ldpc->msg.llr_total[i] = ldpc_saturate(sum);
+        msg->llr_total[i] = ldpc_saturate(sum);
 
         for (j = ldpc->parity_matrix_cols.col_ptr[i]; j < ldpc->parity_matrix_cols.col_ptr[i + 1]; j++) {
-            ldpc->msg.var_to_check[ldpc->parity_matrix_cols.edge_idx[j]] =
-                ldpc_saturate(sum - ldpc->msg.check_to_var[ldpc->parity_matrix_cols.edge_idx[j]]);
+            msg->var_to_check[ldpc->parity_matrix_cols.edge_idx[j]] =
+                ldpc_saturate(sum - msg->check_to_var[ldpc->parity_matrix_cols.edge_idx[j]]);
         }
     }
 }
 
-static inline void make_hard_decision(poporon_ldpc_t *ldpc, uint8_t *codeword)
+static inline void make_hard_decision(const poporon_ldpc_t *ldpc, const messages_t *msg, uint8_t *codeword)
 {
     size_t i;
 
     pmemset(codeword, 0, ldpc->codeword_bytes);
     for (i = 0; i < ldpc->codeword_bits; i++) {
-        if (ldpc->msg.llr_total[i] < 0) {
+        if (msg->llr_total[i] < 0) {
             set_bit(codeword, i, 1);
         }
     }
@@ -863,11 +825,6 @@ extern poporon_ldpc_t *poporon_ldpc_create(size_t block_size, poporon_ldpc_rate_
         return NULL;
     }
 
-    if (!allocate_messages(ldpc)) {
-        poporon_ldpc_destroy(ldpc);
-        return NULL;
-    }
-
     return ldpc;
 }
 
@@ -886,15 +843,114 @@ extern void poporon_ldpc_destroy(poporon_ldpc_t *ldpc)
     pfree(ldpc->interleaver.inverse);
     pfree(ldpc->outer_interleaver.forward);
     pfree(ldpc->outer_interleaver.inverse);
-    pfree(ldpc->msg.check_to_var);
-    pfree(ldpc->msg.var_to_check);
-    pfree(ldpc->msg.llr_total);
-    pfree(ldpc->temp_codeword);
-    pfree(ldpc->temp_interleaved);
-    pfree(ldpc->temp_outer);
     pfree(ldpc);
 }
 
+static void *ldpc_registry_create(const void *key)
+{
+    const ldpc_key_t *ldpc_key = (const ldpc_key_t *)key;
+
+    return poporon_ldpc_create(ldpc_key->block_size, ldpc_key->rate, &ldpc_key->config);
+}
+
+static void ldpc_registry_destroy(void *object)
+{
+    poporon_ldpc_destroy((poporon_ldpc_t *)object);
+}
+
+extern poporon_ldpc_t *poporon_ldpc_acquire(size_t block_size, poporon_ldpc_rate_t rate,
+                                            const poporon_ldpc_params_t *config)
+{
+    ldpc_key_t key;
+
+    /* field by field over a zeroed key, so struct padding never takes part in the comparison */
+    pmemset(&key, 0, sizeof(key));
+    key.block_size = block_size;
+    key.rate = rate;
+    if (config) {
+        key.config.matrix_type = config->matrix_type;
+        key.config.column_weight = config->column_weight;
+        key.config.use_inner_interleave = config->use_inner_interleave;
+        key.config.use_outer_interleave = config->use_outer_interleave;
+        key.config.interleave_depth = config->interleave_depth;
+        key.config.lifting_factor = config->lifting_factor;
+        key.config.seed = config->seed;
+    } else {
+        poporon_ldpc_params_default(&key.config);
+    }
+
+    return (poporon_ldpc_t *)poporon_registry_acquire(REGISTRY_LDPC, &key, sizeof(key), ldpc_registry_create,
+                                                      ldpc_registry_destroy);
+}
+
+extern void poporon_ldpc_release(poporon_ldpc_t *ldpc)
+{
+    poporon_registry_release(ldpc);
+}
+
+extern poporon_ldpc_workspace_t *poporon_ldpc_workspace_create(const poporon_ldpc_t *ldpc)
+{
+    poporon_ldpc_workspace_t *workspace;
+
+    if (!ldpc) {
+        return NULL;
+    }
+
+    workspace = (poporon_ldpc_workspace_t *)pcalloc(1, sizeof(poporon_ldpc_workspace_t));
+    if (!workspace) {
+        return NULL;
+    }
+
+    workspace->num_edges = ldpc->parity_matrix.num_edges;
+    workspace->codeword_bits = ldpc->codeword_bits;
+    workspace->codeword_bytes = ldpc->codeword_bytes;
+    workspace->info_bytes = ldpc->info_bytes;
+
+    workspace->msg.check_to_var = (int16_t *)pcalloc(ldpc->parity_matrix.num_edges, sizeof(int16_t));
+    workspace->msg.var_to_check = (int16_t *)pcalloc(ldpc->parity_matrix.num_edges, sizeof(int16_t));
+    workspace->msg.llr_total = (int16_t *)pcalloc(ldpc->parity_matrix.num_bits, sizeof(int16_t));
+    workspace->temp_codeword = (uint8_t *)pmalloc(ldpc->codeword_bytes);
+    workspace->temp_interleaved = (uint8_t *)pmalloc(ldpc->codeword_bytes);
+    workspace->temp_outer = (uint8_t *)pmalloc(ldpc->info_bytes);
+    workspace->temp_llr = (int8_t *)pmalloc(ldpc->codeword_bits);
+
+    if (!workspace->msg.check_to_var || !workspace->msg.var_to_check || !workspace->msg.llr_total ||
+        !workspace->temp_codeword || !workspace->temp_interleaved || !workspace->temp_outer || !workspace->temp_llr) {
+        poporon_ldpc_workspace_destroy(workspace);
+        return NULL;
+    }
+
+    return workspace;
+}
+
+extern void poporon_ldpc_workspace_destroy(poporon_ldpc_workspace_t *workspace)
+{
+    if (!workspace) {
+        return;
+    }
+
+    pfree(workspace->msg.check_to_var);
+    pfree(workspace->msg.var_to_check);
+    pfree(workspace->msg.llr_total);
+    pfree(workspace->temp_codeword);
+    pfree(workspace->temp_interleaved);
+    pfree(workspace->temp_outer);
+    pfree(workspace->temp_llr);
+    pfree(workspace);
+}
+
+/* any code with the same dimensions can run on the workspace, not only the one it was created from */
+extern bool poporon_ldpc_workspace_fits(const poporon_ldpc_t *ldpc, const poporon_ldpc_workspace_t *workspace)
+{
+    if (!ldpc || !workspace) {
+        return false;
+    }
+
+    return workspace->num_edges >= ldpc->parity_matrix.num_edges &&
+           workspace->codeword_bits >= ldpc->codeword_bits && workspace->codeword_bytes >= ldpc->codeword_bytes &&
+           workspace->info_bytes >= ldpc->info_bytes;
+}
+
 extern size_t poporon_ldpc_info_size(const poporon_ldpc_t *ldpc)
 {
     if (!ldpc) {
@@ -922,19 +978,18 @@ extern size_t poporon_ldpc_parity_size(const poporon_ldpc_t *ldpc)
     return ldpc->parity_bytes;
 }
 
-extern bool poporon_ldpc_encode(poporon_ldpc_t *ldpc, const uint8_t *info, uint8_t *parity)
+extern bool poporon_ldpc_encode(const poporon_ldpc_t *ldpc, const uint8_t *info, uint8_t *parity)
 {
     uint32_t col;
-    uint8_t xor_val, prev_parity, *codeword;
+    uint8_t xor_val, prev_parity;
     size_t i, j;
 
     if (!ldpc || !info || !parity) {
         return false;
     }
 
-    codeword = ldpc->temp_codeword;
-    pmemset(codeword, 0, ldpc->codeword_bytes);
-    pmemcpy(codeword, info, ldpc->info_bytes);
+    /* info_bits is a whole number of bytes, so parity bit i is bit i of parity[] */
+    pmemset(parity, 0, ldpc->parity_bytes);
 
     prev_parity = 0;
 
@@ -944,18 +999,16 @@ extern bool poporon_ldpc_encode(poporon_ldpc_t *ldpc, const uint8_t *info, uint8
         for (j = ldpc->parity_matrix.row_ptr[i]; j < ldpc->parity_matrix.row_ptr[i + 1]; j++) {
             col = ldpc->parity_matrix.col_idx[j];
             if (col < ldpc->info_bits) {
-                xor_val ^= get_bit(codeword, col);
+                xor_val ^= get_bit(info, col);
             }
         }
 
         xor_val ^= prev_parity;
 
-        set_bit(codeword, ldpc->info_bits + i, xor_val);
+        set_bit(parity, i, xor_val);
         prev_parity = xor_val;
     }
 
-    pmemcpy(parity, codeword + ldpc->info_bytes, ldpc->parity_bytes);
-
     return true;
 }
 
@@ -968,13 +1021,22 @@ extern bool poporon_ldpc_check(const poporon_ldpc_t *ldpc, const uint8_t *codewo
     return check_syndrome(ldpc, codeword);
 }
 
-extern bool poporon_ldpc_decode_hard(poporon_ldpc_t *ldpc, uint8_t *codeword, uint32_t max_iterations,
-                                     uint32_t *iterations_used)
+extern bool poporon_ldpc_check_split(const poporon_ldpc_t *ldpc, const uint8_t *info, const uint8_t *parity)
+{
+    if (!ldpc || !info || !parity) {
+        return false;
+    }
+
+    return check_syndrome_split(ldpc, info, parity);
+}
+
+extern bool poporon_ldpc_decode_hard(const poporon_ldpc_t *ldpc, poporon_ldpc_workspace_t *workspace,
+                                     uint8_t *codeword, uint32_t max_iterations, uint32_t *iterations_used)
 {
     uint32_t iter;
     uint8_t *working_codeword;
 
-    if (!ldpc || !codeword) {
+    if (!ldpc || !codeword || !poporon_ldpc_workspace_fits(ldpc, workspace)) {
         return false;
     }
 
@@ -982,10 +1044,10 @@ extern bool poporon_ldpc_decode_hard(poporon_ldpc_t *ldpc, uint8_t *codeword, ui
         max_iterations = DEFAULT_MAX_ITERATIONS;
     }
 
-    working_codeword = ldpc->temp_codeword;
+    working_codeword = workspace->temp_codeword;
     if (ldpc->config.use_inner_interleave && ldpc->interleaver.inverse) {
         deinterleave_bits(ldpc, codeword, working_codeword);
-    } else {
+    } else if (working_codeword != codeword) {
         pmemcpy(working_codeword, codeword, ldpc->codeword_bytes);
     }
 
@@ -997,13 +1059,13 @@ extern bool poporon_ldpc_decode_hard(poporon_ldpc_t *ldpc, uint8_t *codeword, ui
         return true;
     }
 
-    initialize_messages_hard(ldpc, working_codeword);
+    initialize_messages_hard(ldpc, &workspace->msg, working_codeword);
 
     for (iter = 0; iter < max_iterations; iter++) {
-        check_node_update(ldpc);
-        variable_node_update(ldpc, NULL);
+        check_node_update(ldpc, &workspace->msg);
+        variable_node_update(ldpc, &workspace->msg, NULL);
 
-        make_hard_decision(ldpc, working_codeword);
+        make_hard_decision(ldpc, &workspace->msg, working_codeword);
 
         if (check_syndrome(ldpc, working_codeword)) {
             pmemcpy(codeword, working_codeword, ldpc->codeword_bytes);
@@ -1024,14 +1086,15 @@ extern bool poporon_ldpc_decode_hard(poporon_ldpc_t *ldpc, uint8_t *codeword, ui
     return false;
 }
 
-extern bool poporon_ldpc_decode_soft(poporon_ldpc_t *ldpc, const int8_t *llr, uint8_t *codeword,
-                                     uint32_t max_iterations, uint32_t *iterations_used)
+extern bool poporon_ldpc_decode_soft(const poporon_ldpc_t *ldpc, poporon_ldpc_workspace_t *workspace,
+                                     const int8_t *llr, uint8_t *codeword, uint32_t max_iterations,
+                                     uint32_t *iterations_used)
 {
     uint32_t iter;
     uint8_t *working_codeword;
-    int8_t *working_llr;
+    const int8_t *working_llr;
 
-    if (!ldpc || !llr || !codeword) {
+    if (!ldpc || !llr || !codeword || !poporon_ldpc_workspace_fits(ldpc, workspace)) {
         return false;
     }
 
@@ -1039,32 +1102,24 @@ extern bool poporon_ldpc_decode_soft(poporon_ldpc_t *ldpc, const int8_t *llr, ui
         max_iterations = DEFAULT_MAX_ITERATIONS;
     }
 
-    working_llr = NULL;
+    working_llr = llr;
     if (ldpc->config.use_inner_interleave && ldpc->interleaver.inverse) {
-        working_llr = (int8_t *)pmalloc(ldpc->codeword_bits);
-        if (!working_llr) {
-            return false;
-        }
-        deinterleave_llr(ldpc, llr, working_llr);
-        initialize_messages_soft(ldpc, working_llr);
-    } else {
-        initialize_messages_soft(ldpc, llr);
+        deinterleave_llr(ldpc, llr, workspace->temp_llr);
+        working_llr = workspace->temp_llr;
     }
+    initialize_messages_soft(ldpc, &workspace->msg, working_llr);
 
-    working_codeword = ldpc->temp_codeword;
+    working_codeword = workspace->temp_codeword;
 
     for (iter = 0; iter < max_iterations; iter++) {
-        check_node_update(ldpc);
-        variable_node_update(ldpc, working_llr ? working_llr : llr);
+        check_node_update(ldpc, &workspace->msg);
+        variable_node_update(ldpc, &workspace->msg, working_llr);
 
-        make_hard_decision(ldpc, working_codeword);
+        make_hard_decision(ldpc, &workspace->msg, working_codeword);
 
         if (check_syndrome(ldpc, working_codeword)) {
             pmemcpy(codeword, working_codeword, ldpc->codeword_bytes);
 
-            if (working_llr) {
-                pfree(working_llr);
-            }
             if (iterations_used) {
                 *iterations_used = iter + 1;
             }
@@ -1074,9 +1129,6 @@ extern bool poporon_ldpc_decode_soft(poporon_ldpc_t *ldpc, const int8_t *llr, ui
 
     pmemcpy(codeword, working_codeword, ldpc->codeword_bytes);
 
-    if (working_llr) {
-        pfree(working_llr);
-    }
     if (iterations_used) {
         *iterations_used = max_iterations;
     }
@@ -0,0 +1,382 @@
+/*
+ * libpoporon - pool.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/common.h"
+#include "internal/thread.h"
+
+#define POOL_FEC_TYPES 3 /* one cached workspace per FEC type (RS, LDPC, BCH) in every worker */
+
+typedef struct {
+    bool encode;
+    poporon_pool_job_t *jobs; /* heterogeneous job list, NULL for a single-codec batch */
+    const poporon_t *pprn;
+    batch_layout_t layout;
+    size_t size;
+    bool *results;
+    size_t *corrected_num;
+} pool_task_t;
+
+/* a contiguous range of job indices, the owner pops from head and thieves split off the tail */
+typedef struct {
+    pmutex_t lock;
+    size_t head;
+    size_t tail;
+} pool_deque_t;
+
+typedef struct {
+    poporon_pool_t *pool;
+    size_t index;
+    pool_deque_t deque;
+    poporon_workspace_t *workspaces[POOL_FEC_TYPES];
+    pthrd_t thread;
+    bool failed;
+} pool_worker_t;
+
+struct _poporon_pool_t {
+    size_t num_threads;
+    size_t num_spawned;
+    pool_worker_t *workers; /* workers[0] is the thread that submits the batch */
+    pmutex_t submit;        /* serializes batches */
+    pmutex_t lock;          /* guards everything below */
+    pcond_t wake;
+    pcond_t done;
+    const pool_task_t *task;
+    uint64_t generation;
+    size_t running;
+    bool shutdown;
+};
+
+static inline bool pool_pop(pool_worker_t *worker, size_t *index)
+{
+    bool found = false;
+
+    pmutex_lock(&worker->deque.lock);
+    if (worker->deque.head < worker->deque.tail) {
+        *index = worker->deque.head++;
+        found = true;
+    }
+    pmutex_unlock(&worker->deque.lock);
+
+    return found;
+}
+
+/* takes the upper half of the first non-empty victim, so a worker stuck on a slow frame loses its queued ones */
+static inline bool pool_steal(pool_worker_t *worker, size_t *index)
+{
+    poporon_pool_t *pool = worker->pool;
+    pool_worker_t *victim;
+    size_t i, remaining, first, last;
+
+    for (i = 1; i < pool->num_threads; i++) {
+        victim = &pool->workers[(worker->index + i) % pool->num_threads];
+
+        pmutex_lock(&victim->deque.lock);
+        remaining = victim->deque.tail - victim->deque.head;
+        if (remaining == 0) {
+            pmutex_unlock(&victim->deque.lock);
+            continue;
+        }
+        last = victim->deque.tail;
+        first = last - (remaining + 1) / 2;
+        victim->deque.tail = first;
+        pmutex_unlock(&victim->deque.lock);
+
+        pmutex_lock(&worker->deque.lock);
+        worker->deque.head = first + 1;
+        worker->deque.tail = last;
+        pmutex_unlock(&worker->deque.lock);
+
+        *index = first;
+
+        return true;
+    }
+
+    return false;
+}
+
+static inline poporon_workspace_t *pool_workspace(pool_worker_t *worker, const poporon_t *pprn)
+{
+    poporon_workspace_t **slot;
+
+    if (!pprn || pprn->fec_type < PPLN_FEC_RS || pprn->fec_type > PPLN_FEC_BCH) {
+        return NULL;
+    }
+
+    /* a workspace sized for a larger code of the same type is reused as is */
+    slot = &worker->workspaces[pprn->fec_type - PPLN_FEC_RS];
+    if (!poporon_workspace_fits(pprn, *slot)) {
+        poporon_workspace_destroy(*slot);
+        *slot = poporon_workspace_create(pprn);
+    }
+
+    return *slot;
+}
+
+static inline bool pool_run_job(pool_worker_t *worker, const pool_task_t *task, size_t index)
+{
+    poporon_pool_job_t *job;
+    poporon_workspace_t *workspace;
+    const poporon_t *pprn;
+    uint8_t *data, *parity;
+    size_t size, corrected = 0;
+    bool ok;
+
+    if (task->jobs) {
+        job = &task->jobs[index];
+        pprn = job->pprn;
+        data = job->data;
+        size = job->size;
+        parity = job->parity;
+    } else {
+        job = NULL;
+        pprn = task->pprn;
+        data = batch_data(&task->layout, index);
+        size = task->size;
+        parity = batch_parity(&task->layout, index);
+    }
+
+    workspace = pool_workspace(worker, pprn);
+    if (task->encode) {
+        ok = workspace && poporon_encode_with_workspace(pprn, workspace, data, size, parity);
+    } else {
+        ok = workspace && poporon_decode_with_workspace(pprn, workspace, data, size, parity, &corrected);
+    }
+
+    if (job) {
+        job->result = ok;
+        job->corrected_num = corrected;
+    } else {
+        if (task->results) {
+            task->results[index] = ok;
+        }
+
+        if (task->corrected_num) {
+            task->corrected_num[index] = corrected;
+        }
+    }
+
+    return ok;
+}
+
+static void pool_work(pool_worker_t *worker, const pool_task_t *task)
+{
+    size_t index;
+
+    while (pool_pop(worker, &index) || pool_steal(worker, &index)) {
+        if (!pool_run_job(worker, task, index)) {
+            worker->failed = true;
+        }
+    }
+}
+
+static PTHRD_ROUTINE(pool_thread_main, arg)
+{
+    pool_worker_t *worker = (pool_worker_t *)arg;
+    poporon_pool_t *pool = worker->pool;
+    const pool_task_t *task;
+    uint64_t seen = 0;
+
+    pmutex_lock(&pool->lock);
+    for (;;) {
+        while (!pool->shutdown && pool->generation == seen) {
+            pcond_wait(&pool->wake, &pool->lock);
+        }
+
+        if (pool->shutdown) {
+            break;
+        }
+
+        seen = pool->generation;
+        task = pool->task;
+        pmutex_unlock(&pool->lock);
+
+        pool_work(worker, task);
+
+        pmutex_lock(&pool->lock);
+        if (--pool->running == 0) {
+            pcond_broadcast(&pool->done);
+        }
+    }
+    pmutex_unlock(&pool->lock);
+
+    PTHRD_RETURN;
+}
+
+static bool pool_run(poporon_pool_t *pool, const pool_task_t *task, size_t count)
+{
+    size_t i;
+    bool failed = false;
+
+    pmutex_lock(&pool->submit);
+
+    /* even split up front, stealing evens out frames whose decode cost differs */
+    for (i = 0; i < pool->num_threads; i++) {
+        pool->workers[i].deque.head = count * i / pool->num_threads;
+        pool->workers[i].deque.tail = count * (i + 1) / pool->num_threads;
+        pool->workers[i].failed = false;
+    }
+
+    pmutex_lock(&pool->lock);
+    pool->task = task;
+    pool->running = pool->num_spawned;
+    pool->generation++;
+    pcond_broadcast(&pool->wake);
+    pmutex_unlock(&pool->lock);
+
+    pool_work(&pool->workers[0], task);
+
+    pmutex_lock(&pool->lock);
+    while (pool->running > 0) {
+        pcond_wait(&pool->done, &pool->lock);
+    }
+    pool->task = NULL;
+    pmutex_unlock(&pool->lock);
+
+    for (i = 0; i < pool->num_threads; i++) {
+        failed |= pool->workers[i].failed;
+    }
+
+    pmutex_unlock(&pool->submit);
+
+    return !failed;
+}
+
+extern poporon_pool_t *poporon_pool_create(size_t num_threads)
+{
+    poporon_pool_t *pool;
+    size_t i;
+
+#if POPORON_USE_THREADS
+    if (num_threads == 0) {
+        num_threads = pcpu_count();
+    }
+#else
+    num_threads = 1;
+#endif
+
+    pool = (poporon_pool_t *)pcalloc(1, sizeof(poporon_pool_t));
+    if (!pool) {
+        return NULL;
+    }
+
+    pool->workers = (pool_worker_t *)pcalloc(num_threads, sizeof(pool_worker_t));
+    if (!pool->workers) {
+        pfree(pool);
+        return NULL;
+    }
+
+    pool->num_threads = num_threads;
+    pmutex_init(&pool->submit);
+    pmutex_init(&pool->lock);
+    pcond_init(&pool->wake);
+    pcond_init(&pool->done);
+
+    for (i = 0; i < num_threads; i++) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        pmutex_init(&pool->workers[i].deque.lock);
+    }
+
+    for (i = 1; i < num_threads; i++) {
+        if (!pthrd_create(&pool->workers[i].thread, pool_thread_main, &pool->workers[i])) {
+            poporon_pool_destroy(pool);
+            return NULL;
+        }
+        pool->num_spawned++;
+    }
+
+    return pool;
+}
+
+extern void poporon_pool_destroy(poporon_pool_t *pool)
+{
+    size_t i, j;
+
+    if (!pool) {
+        return;
+    }
+
+    pmutex_lock(&pool->lock);
+    pool->shutdown = true;
+    pcond_broadcast(&pool->wake);
+    pmutex_unlock(&pool->lock);
+
+    for (i = 1; i <= pool->num_spawned; i++) {
+        pthrd_join(pool->workers[i].thread);
+    }
+
+    for (i = 0; i < pool->num_threads; i++) {
+        for (j = 0; j < POOL_FEC_TYPES; j++) {
+            poporon_workspace_destroy(pool->workers[i].workspaces[j]);
+        }
+        pmutex_destroy(&pool->workers[i].deque.lock);
+    }
+
+    pcond_destroy(&pool->done);
+    pcond_destroy(&pool->wake);
+    pmutex_destroy(&pool->lock);
+    pmutex_destroy(&pool->submit);
+    pfree(pool->workers);
+    pfree(pool);
+}
+
+extern size_t poporon_pool_get_num_threads(const poporon_pool_t *pool)
+{
+    if (!pool) {
+        return 0;
+    }
+
+    return pool->num_threads;
+}
+
+extern bool poporon_pool_encode(poporon_pool_t *pool, poporon_pool_job_t *jobs, size_t count)
+{
+    pool_task_t task = {true, jobs, NULL, {NULL, NULL, NULL, NULL, 0, 0}, 0, NULL, NULL};
+
+    if (!pool || !jobs) {
+        return false;
+    }
+
+    return pool_run(pool, &task, count);
+}
+
+extern bool poporon_pool_decode(poporon_pool_t *pool, poporon_pool_job_t *jobs, size_t count)
+{
+    pool_task_t task = {false, jobs, NULL, {NULL, NULL, NULL, NULL, 0, 0}, 0, NULL, NULL};
+
+    if (!pool || !jobs) {
+        return false;
+    }
+
+    return pool_run(pool, &task, count);
+}
+
+extern bool poporon_pool_encode_batch(poporon_pool_t *pool, const poporon_t *pprn, uint8_t *const *data, size_t size,
+                                      uint8_t *const *parity, size_t count, bool *results)
+{
+    pool_task_t task = {true, NULL, pprn, {data, parity, NULL, NULL, 0, 0}, size, results, NULL};
+
+    if (!pool || !pprn || !data || !parity) {
+        return false;
+    }
+
+    return pool_run(pool, &task, count);
+}
+
+extern bool poporon_pool_decode_batch(poporon_pool_t *pool, const poporon_t *pprn, uint8_t *const *data, size_t size,
+                                      uint8_t *const *parity, size_t count, bool *results, size_t *corrected_num)
+{
+    pool_task_t task = {false, NULL, pprn, {data, parity, NULL, NULL, 0, 0}, size, results, corrected_num};
+
+    if (!pool || !pprn || !data || !parity) {
+        return false;
+    }
+
+    return pool_run(pool, &task, count);
+}
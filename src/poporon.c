@@ -11,6 +11,7 @@
 
 #include "internal/common.h"
 #include "internal/config.h"
+#include "internal/kernel.h"
 #include "internal/ldpc.h"
 
 static inline void decoder_buffer_destroy(decoder_buffer_t *buffer)
@@ -30,14 +31,13 @@ static inline decoder_buffer_t *decoder_buffer_create(uint16_t num_roots)
         return NULL;
     }
 
-    raw_buffer = (uint16_t *)pmalloc(8 * (num_roots + 1) * sizeof(uint16_t));
+    raw_buffer = (uint16_t *)pmalloc((8 * (num_roots + 1) + 3 * RIBM_ROW_SIZE(num_roots)) * sizeof(uint16_t));
     if (!raw_buffer) {
         pfree(buffer);
 
         return NULL;
     }
 
-    buffer->primitive_inverse = 0;
     buffer->error_locator = raw_buffer;
     buffer->syndrome = buffer->error_locator + (num_roots + 1);
     buffer->coefficients = buffer->syndrome + (num_roots + 1);
@@ -46,38 +46,123 @@ static inline decoder_buffer_t *decoder_buffer_create(uint16_t num_roots)
     buffer->error_roots = buffer->error_evaluator + (num_roots + 1);
     buffer->register_coefficients = buffer->error_roots + (num_roots + 1);
     buffer->error_locations = buffer->register_coefficients + (num_roots + 1);
+    buffer->ribm = buffer->error_locations + (num_roots + 1);
 
-    for (i = 0; i < 8 * (num_roots + 1); i++) {
+    for (i = 0; i < 8 * (num_roots + 1) + 3 * RIBM_ROW_SIZE(num_roots); i++) {
         raw_buffer[i] = 0;
     }
 
     return buffer;
 }
 
-static inline poporon_t *poporon_create_rs_internal(const poporon_config_t *cfg)
+extern poporon_workspace_t *poporon_workspace_create(const poporon_t *pprn)
 {
-    poporon_t *pprn;
-    poporon_rs_t *rs;
-    decoder_buffer_t *buffer;
-    uint32_t iterations;
-    uint16_t primitive_inverse;
+    poporon_workspace_t *workspace;
 
-    rs = poporon_rs_create(cfg->params.rs.symbol_size, cfg->params.rs.generator_polynomial,
-                           cfg->params.rs.first_consecutive_root, cfg->params.rs.primitive_element,
-                           cfg->params.rs.num_roots);
-    if (!rs) {
+    if (!pprn) {
         return NULL;
     }
 
-    buffer = decoder_buffer_create(cfg->params.rs.num_roots);
-    if (!buffer) {
-        poporon_rs_destroy(rs);
+    workspace = (poporon_workspace_t *)pcalloc(1, sizeof(poporon_workspace_t));
+    if (!workspace) {
+        return NULL;
+    }
+
+    workspace->fec_type = pprn->fec_type;
+
+    switch (pprn->fec_type) {
+    case PPLN_FEC_RS:
+        workspace->ctx.rs.num_roots = pprn->ctx.rs.rs->num_roots;
+        workspace->ctx.rs.buffer = decoder_buffer_create(workspace->ctx.rs.num_roots);
+        if (!workspace->ctx.rs.buffer) {
+            pfree(workspace);
+            return NULL;
+        }
+        break;
+    case PPLN_FEC_LDPC:
+        workspace->ctx.ldpc.ldpc = poporon_ldpc_workspace_create(pprn->ctx.ldpc.ldpc);
+        if (!workspace->ctx.ldpc.ldpc) {
+            pfree(workspace);
+            return NULL;
+        }
+        break;
+    case PPLN_FEC_BCH:
+        break;
+    default:
+        pfree(workspace);
+        return NULL;
+    }
+
+    return workspace;
+}
+
+extern void poporon_workspace_destroy(poporon_workspace_t *workspace)
+{
+    if (!workspace) {
+        return;
+    }
+
+    switch (workspace->fec_type) {
+    case PPLN_FEC_RS:
+        decoder_buffer_destroy(workspace->ctx.rs.buffer);
+        pfree(workspace->ctx.rs.lane_syndromes);
+        break;
+    case PPLN_FEC_LDPC:
+        poporon_ldpc_workspace_destroy(workspace->ctx.ldpc.ldpc);
+        break;
+    default:
+        break;
+    }
+
+    pfree(workspace);
+}
+
+extern bool poporon_workspace_fits(const poporon_t *pprn, const poporon_workspace_t *workspace)
+{
+    if (!pprn || !workspace || workspace->fec_type != pprn->fec_type) {
+        return false;
+    }
+
+    switch (pprn->fec_type) {
+    case PPLN_FEC_RS:
+        return workspace->ctx.rs.num_roots >= pprn->ctx.rs.rs->num_roots;
+    case PPLN_FEC_LDPC:
+        return poporon_ldpc_workspace_fits(pprn->ctx.ldpc.ldpc, workspace->ctx.ldpc.ldpc);
+    case PPLN_FEC_BCH:
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* the default workspace keeps poporon_encode() / poporon_decode() working without one */
+static inline poporon_t *poporon_attach_workspace(poporon_t *pprn)
+{
+    pprn->workspace = poporon_workspace_create(pprn);
+    if (!pprn->workspace) {
+        poporon_destroy(pprn);
         return NULL;
     }
 
+    return pprn;
+}
+
+static inline poporon_t *poporon_create_rs_internal(const poporon_config_t *cfg)
+{
+    poporon_t *pprn;
+    poporon_rs_t *rs;
+    uint64_t primitive_inverse;
+    uint32_t iterations;
+
     if (cfg->params.rs.primitive_element == 0) {
-        decoder_buffer_destroy(buffer);
-        poporon_rs_destroy(rs);
+        return NULL;
+    }
+
+    /* instances with identical parameters share one code, including its encoder tables */
+    rs = poporon_rs_acquire(cfg->params.rs.symbol_size, cfg->params.rs.generator_polynomial,
+                            cfg->params.rs.first_consecutive_root, cfg->params.rs.primitive_element,
+                            cfg->params.rs.num_roots, cfg->params.rs.encode_mode);
+    if (!rs) {
         return NULL;
     }
 
@@ -85,28 +170,26 @@ static inline poporon_t *poporon_create_rs_internal(const poporon_config_t *cfg)
     for (primitive_inverse = 1; (primitive_inverse % cfg->params.rs.primitive_element) != 0;
          primitive_inverse += rs->gf->field_size) {
         if (++iterations > rs->gf->field_size * 2) {
-            decoder_buffer_destroy(buffer);
-            poporon_rs_destroy(rs);
+            poporon_rs_release(rs);
             return NULL;
         }
     }
-    buffer->primitive_inverse = primitive_inverse / cfg->params.rs.primitive_element;
 
     pprn = (poporon_t *)pcalloc(1, sizeof(poporon_t));
     if (!pprn) {
-        decoder_buffer_destroy(buffer);
-        poporon_rs_destroy(rs);
+        poporon_rs_release(rs);
         return NULL;
     }
 
     pprn->fec_type = PPLN_FEC_RS;
     pprn->ctx.rs.rs = rs;
-    pprn->ctx.rs.buffer = buffer;
     pprn->ctx.rs.erasure = cfg->params.rs.erasure;
     pprn->ctx.rs.ext_syndrome = cfg->params.rs.syndrome;
-    pprn->ctx.rs.last_corrected = 0;
+    pprn->ctx.rs.primitive_inverse = (uint16_t)(primitive_inverse / cfg->params.rs.primitive_element);
+    pprn->ctx.rs.decode_mode = cfg->params.rs.decode_mode;
+    pprn->ctx.rs.syndrome_mode = cfg->params.rs.syndrome_mode;
 
-    return pprn;
+    return poporon_attach_workspace(pprn);
 }
 
 static inline poporon_t *poporon_create_ldpc_internal(const poporon_config_t *cfg)
@@ -123,14 +206,14 @@ static inline poporon_t *poporon_create_ldpc_internal(const poporon_config_t *cf
     ldpc_params.lifting_factor = cfg->params.ldpc.lifting_factor;
     ldpc_params.seed = cfg->params.ldpc.seed;
 
-    ldpc = poporon_ldpc_create(cfg->params.ldpc.block_size, cfg->params.ldpc.rate, &ldpc_params);
+    ldpc = poporon_ldpc_acquire(cfg->params.ldpc.block_size, cfg->params.ldpc.rate, &ldpc_params);
     if (!ldpc) {
         return NULL;
     }
 
     pprn = (poporon_t *)pcalloc(1, sizeof(poporon_t));
     if (!pprn) {
-        poporon_ldpc_destroy(ldpc);
+        poporon_ldpc_release(ldpc);
         return NULL;
     }
 
@@ -140,9 +223,8 @@ static inline poporon_t *poporon_create_ldpc_internal(const poporon_config_t *cf
     pprn->ctx.ldpc.soft_llr_size = cfg->params.ldpc.soft_llr_size;
     pprn->ctx.ldpc.use_soft_decode = cfg->params.ldpc.use_soft_decode;
     pprn->ctx.ldpc.max_iterations = cfg->params.ldpc.max_iterations;
-    pprn->ctx.ldpc.last_iterations = 0;
 
-    return pprn;
+    return poporon_attach_workspace(pprn);
 }
 
 static inline poporon_t *poporon_create_bch_internal(const poporon_config_t *cfg)
@@ -164,9 +246,8 @@ static inline poporon_t *poporon_create_bch_internal(const poporon_config_t *cfg
 
     pprn->fec_type = PPLN_FEC_BCH;
     pprn->ctx.bch.bch = bch;
-    pprn->ctx.bch.last_num_errors = 0;
 
-    return pprn;
+    return poporon_attach_workspace(pprn);
 }
 
 extern poporon_t *poporon_create(const poporon_config_t *config)
@@ -175,6 +256,9 @@ extern poporon_t *poporon_create(const poporon_config_t *config)
         return NULL;
     }
 
+    /* resolve the SIMD kernel table up front so the first encode/decode does not pay for CPUID */
+    poporon_kernel();
+
     switch (config->fec_type) {
     case PPLN_FEC_RS:
         return poporon_create_rs_internal(config);
@@ -193,15 +277,14 @@ extern void poporon_destroy(poporon_t *pprn)
         return;
     }
 
+    poporon_workspace_destroy(pprn->workspace);
+
     switch (pprn->fec_type) {
     case PPLN_FEC_RS:
-        if (pprn->ctx.rs.buffer) {
-            decoder_buffer_destroy(pprn->ctx.rs.buffer);
-        }
-        poporon_rs_destroy(pprn->ctx.rs.rs);
+        poporon_rs_release(pprn->ctx.rs.rs);
         break;
     case PPLN_FEC_LDPC:
-        poporon_ldpc_destroy(pprn->ctx.ldpc.ldpc);
+        poporon_ldpc_release(pprn->ctx.ldpc.ldpc);
         break;
     case PPLN_FEC_BCH:
         poporon_bch_destroy(pprn->ctx.bch.bch);
@@ -278,6 +361,56 @@ extern poporon_config_t *poporon_bch_config_create(uint8_t symbol_size, uint16_t
     return config;
 }
 
+extern bool poporon_rs_config_set_encode_mode(poporon_config_t *config, poporon_rs_encode_mode_t mode)
+{
+    if (!config || config->fec_type != PPLN_FEC_RS) {
+        return false;
+    }
+
+    switch (mode) {
+    case PPRN_RS_ENCODE_LFSR:
+    case PPRN_RS_ENCODE_MATRIX:
+    case PPRN_RS_ENCODE_SLICE_4:
+    case PPRN_RS_ENCODE_SLICE_8:
+        config->params.rs.encode_mode = mode;
+        return true;
+    default:
+        return false;
+    }
+}
+
+extern bool poporon_rs_config_set_decode_mode(poporon_config_t *config, poporon_rs_decode_mode_t mode)
+{
+    if (!config || config->fec_type != PPLN_FEC_RS) {
+        return false;
+    }
+
+    switch (mode) {
+    case PPRN_RS_DECODE_BM:
+    case PPRN_RS_DECODE_RIBM:
+        config->params.rs.decode_mode = mode;
+        return true;
+    default:
+        return false;
+    }
+}
+
+extern bool poporon_rs_config_set_syndrome_mode(poporon_config_t *config, poporon_rs_syndrome_mode_t mode)
+{
+    if (!config || config->fec_type != PPLN_FEC_RS) {
+        return false;
+    }
+
+    switch (mode) {
+    case PPRN_RS_SYNDROME_HORNER:
+    case PPRN_RS_SYNDROME_REMAINDER:
+        config->params.rs.syndrome_mode = mode;
+        return true;
+    default:
+        return false;
+    }
+}
+
 extern poporon_config_t *poporon_config_rs_default(void)
 {
     return poporon_rs_config_create(8, 0x11D, 1, 1, 32, NULL, NULL);
@@ -318,7 +451,7 @@ extern uint32_t poporon_get_iterations_used(const poporon_t *pprn)
         return 0;
     }
 
-    return pprn->ctx.ldpc.last_iterations;
+    return pprn->workspace->ctx.ldpc.last_iterations;
 }
 
 extern size_t poporon_get_parity_size(const poporon_t *pprn)
@@ -362,6 +495,61 @@ extern size_t poporon_get_info_size(const poporon_t *pprn)
     }
 }
 
+extern bool poporon_interleave(const uint8_t *const *codewords, size_t size, size_t count, uint8_t *interleaved)
+{
+    size_t block, block_end, row, c;
+
+    if (!codewords || !interleaved) {
+        return false;
+    }
+
+    /* a block of codewords at a time keeps the row writes contiguous */
+    for (block = 0; block < count; block = block_end) {
+        block_end = (count - block > INTERLEAVE_BLOCK) ? block + INTERLEAVE_BLOCK : count;
+
+        for (c = block; c < block_end; c++) {
+            if (!codewords[c]) {
+                return false;
+            }
+        }
+
+        for (row = 0; row < size; row++) {
+            for (c = block; c < block_end; c++) {
+                interleaved[row * count + c] = codewords[c][row];
+            }
+        }
+    }
+
+    return true;
+}
+
+extern bool poporon_deinterleave(const uint8_t *interleaved, size_t size, size_t count, uint8_t *const *codewords)
+{
+    size_t block, block_end, row, c;
+
+    if (!interleaved || !codewords) {
+        return false;
+    }
+
+    for (block = 0; block < count; block = block_end) {
+        block_end = (count - block > INTERLEAVE_BLOCK) ? block + INTERLEAVE_BLOCK : count;
+
+        for (c = block; c < block_end; c++) {
+            if (!codewords[c]) {
+                return false;
+            }
+        }
+
+        for (row = 0; row < size; row++) {
+            for (c = block; c < block_end; c++) {
+                codewords[c][row] = interleaved[row * count + c];
+            }
+        }
+    }
+
+    return true;
+}
+
 extern uint32_t poporon_version_id()
 {
     return (uint32_t)POPORON_VERSION_ID;
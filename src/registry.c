@@ -0,0 +1,142 @@
+/*
+ * libpoporon - registry.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include "internal/common.h"
+#include "internal/thread.h"
+
+typedef struct _registry_entry_t registry_entry_t;
+
+struct _registry_entry_t {
+    registry_entry_t *next;
+    void *object;
+    registry_destroy_t destroy;
+    size_t refcount;
+    registry_kind_t kind;
+    size_t key_size;
+    uint8_t key[];
+};
+
+static pmutex_t registry_lock = PMUTEX_INITIALIZER;
+static registry_entry_t *registry_head = NULL;
+
+static inline registry_entry_t *registry_find(registry_kind_t kind, const void *key, size_t key_size)
+{
+    registry_entry_t *entry;
+
+    for (entry = registry_head; entry; entry = entry->next) {
+        if (entry->kind == kind && entry->key_size == key_size && pmemcmp(entry->key, key, key_size) == 0) {
+            return entry;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Construction runs outside the lock since creators may acquire other entries (an RS code acquires its field), a
+ * thread that loses the race to insert the same key drops its copy and takes the winner's.
+ */
+extern void *poporon_registry_acquire(registry_kind_t kind, const void *key, size_t key_size,
+                                      registry_create_t create, registry_destroy_t destroy)
+{
+    registry_entry_t *entry, *created;
+    void *object;
+
+    pmutex_lock(&registry_lock);
+    entry = registry_find(kind, key, key_size);
+    if (entry) {
+        entry->refcount++;
+        object = entry->object;
+        pmutex_unlock(&registry_lock);
+
+        return object;
+    }
+    pmutex_unlock(&registry_lock);
+
+    created = (registry_entry_t *)pmalloc(sizeof(registry_entry_t) + key_size);
+    if (!created) {
+        return NULL;
+    }
+
+    created->object = create(key);
+    if (!created->object) {
+        pfree(created);
+        return NULL;
+    }
+
+    created->destroy = destroy;
+    created->refcount = 1;
+    created->kind = kind;
+    created->key_size = key_size;
+    pmemcpy(created->key, key, key_size);
+
+    pmutex_lock(&registry_lock);
+    entry = registry_find(kind, key, key_size);
+    if (entry) {
+        entry->refcount++;
+        object = entry->object;
+    } else {
+        created->next = registry_head;
+        registry_head = created;
+        object = created->object;
+        created = NULL;
+    }
+    pmutex_unlock(&registry_lock);
+
+    if (created) {
+        created->destroy(created->object);
+        pfree(created);
+    }
+
+    return object;
+}
+
+extern bool poporon_registry_release(void *object)
+{
+    registry_entry_t **link, *entry = NULL;
+    bool found = false;
+
+    if (!object) {
+        return false;
+    }
+
+    pmutex_lock(&registry_lock);
+    for (link = &registry_head; *link; link = &(*link)->next) {
+        if ((*link)->object == object) {
+            found = true;
+            if (--(*link)->refcount == 0) {
+                entry = *link;
+                *link = entry->next;
+            }
+            break;
+        }
+    }
+    pmutex_unlock(&registry_lock);
+
+    if (entry) {
+        entry->destroy(entry->object);
+        pfree(entry);
+    }
+
+    return found;
+}
+
+extern size_t poporon_registry_size(void)
+{
+    registry_entry_t *entry;
+    size_t size = 0;
+
+    pmutex_lock(&registry_lock);
+    for (entry = registry_head; entry; entry = entry->next) {
+        size++;
+    }
+    pmutex_unlock(&registry_lock);
+
+    return size;
+}
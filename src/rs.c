@@ -9,6 +9,15 @@
 
 #include "internal/common.h"
 
+typedef struct {
+    uint8_t symbol_size;
+    uint8_t num_roots;
+    uint16_t generator_polynomial;
+    uint16_t first_consecutive_root;
+    uint16_t primitive_element;
+    poporon_rs_encode_mode_t encode_mode;
+} rs_key_t;
+
 void poporon_rs_destroy(poporon_rs_t *rs)
 {
     if (!rs) {
@@ -16,31 +25,106 @@ void poporon_rs_destroy(poporon_rs_t *rs)
     }
 
     if (rs->gf) {
-        poporon_gf_destroy(rs->gf);
+        poporon_gf_release(rs->gf);
     }
 
     if (rs->generator_polynomial) {
         pfree(rs->generator_polynomial);
     }
 
+    if (rs->feedback_polynomial) {
+        pfree(rs->feedback_polynomial);
+    }
+
+    if (rs->feedback_split) {
+        pfree(rs->feedback_split);
+    }
+
+    if (rs->root_splits) {
+        pfree(rs->root_splits);
+    }
+
+    if (rs->root_powers) {
+        pfree(rs->root_powers);
+    }
+
+    if (rs->quadratic_roots) {
+        pfree(rs->quadratic_roots);
+    }
+
+    if (rs->slice_tables) {
+        pfree(rs->slice_tables);
+    }
+
+    if (rs->encode_matrix) {
+        pfree(rs->encode_matrix);
+    }
+
     pfree(rs);
 }
 
+/*
+ * Fields above GF(2^8) have no nibble tables, their kernels multiply through split tables instead: feedback_split
+ * holds g(x) (register order) times every nibble at every nibble position, so an LFSR step xors four rows, and
+ * root_splits replaces root_powers.
+ */
+static bool rs_build_split_tables(poporon_rs_t *rs)
+{
+    poporon_gf_t *gf = rs->gf;
+    uint16_t *row, feedback, nibble;
+    uint32_t root_log;
+    uint16_t i, j, k, position;
+
+    /* rows padded so that 256-bit lanes past num_roots stay in bounds */
+    rs->split_stride = (uint16_t)((rs->num_roots + 31) & ~31);
+    rs->feedback_split = (uint16_t *)pcalloc((size_t)4 * 16 * rs->split_stride, sizeof(uint16_t));
+    rs->root_splits = (uint8_t *)pcalloc((size_t)rs->num_roots * RS_ROOT_POWERS, GF_SPLIT_TABLE_SIZE);
+    if (!rs->feedback_split || !rs->root_splits) {
+        return false;
+    }
+
+    for (j = 0; j < rs->num_roots; j++) {
+        feedback = gf->log2exp[rs->generator_polynomial[rs->num_roots - 1 - j]];
+
+        for (position = 0; position < 4; position++) {
+            for (i = 1; i < 16 && (uint32_t)i << (4 * position) <= gf->field_size; i++) {
+                nibble = (uint16_t)(i << (4 * position));
+                row = &rs->feedback_split[(position * 16 + i) * rs->split_stride];
+                row[j] = gf_mul(gf, feedback, nibble);
+            }
+        }
+    }
+
+    for (i = 0; i < rs->num_roots; i++) {
+        root_log = ((uint32_t)(rs->first_consecutive_root + i) % gf->field_size) *
+                   (rs->primitive_element % gf->field_size) % gf->field_size;
+
+        for (k = 0; k < RS_ROOT_POWERS; k++) {
+            poporon_gf_split_table(gf, gf->log2exp[root_log],
+                                   &rs->root_splits[((size_t)i * RS_ROOT_POWERS + k) * GF_SPLIT_TABLE_SIZE]);
+            root_log = (root_log * 2) % gf->field_size;
+        }
+    }
+
+    return true;
+}
+
 poporon_rs_t *poporon_rs_create(uint8_t symbol_size, uint16_t generator_polynomial, uint16_t first_consecutive_root,
                                 uint16_t primitive_element, uint8_t num_roots)
 {
     poporon_rs_t *rs;
     poporon_gf_t *gf;
-    uint16_t i, j, generator_root;
+    uint32_t root_log, generator_root;
+    uint16_t i, j, k;
 
-    gf = poporon_gf_create(symbol_size, generator_polynomial);
+    gf = poporon_gf_acquire(symbol_size, generator_polynomial);
     if (!gf) {
         return NULL;
     }
 
-    rs = (poporon_rs_t *)pmalloc(sizeof(poporon_rs_t));
+    rs = (poporon_rs_t *)pcalloc(1, sizeof(poporon_rs_t));
     if (!rs) {
-        poporon_gf_destroy(gf);
+        poporon_gf_release(gf);
 
         return NULL;
     }
@@ -57,8 +141,8 @@ poporon_rs_t *poporon_rs_create(uint8_t symbol_size, uint16_t generator_polynomi
     }
 
     rs->generator_polynomial[0] = 1;
-    for (i = 0, generator_root = first_consecutive_root * primitive_element; i < num_roots;
-         i++, generator_root += primitive_element) {
+    for (i = 0, generator_root = gf_mod(gf, (uint32_t)first_consecutive_root * primitive_element); i < num_roots;
+         i++, generator_root = gf_mod(gf, generator_root + primitive_element)) {
         rs->generator_polynomial[i + 1] = 1;
 
         for (j = i; j > 0; j--) {
@@ -79,5 +163,215 @@ poporon_rs_t *poporon_rs_create(uint8_t symbol_size, uint16_t generator_polynomi
         rs->generator_polynomial[i] = gf->exp2log[rs->generator_polynomial[i]];
     }
 
+    if (gf->nibble_tables) {
+        /* padded so that vector kernels may load whole lanes past num_roots */
+        rs->feedback_polynomial = (uint8_t *)pcalloc((num_roots + 64) & ~63, sizeof(uint8_t));
+        if (!rs->feedback_polynomial) {
+            poporon_rs_destroy(rs);
+
+            return NULL;
+        }
+
+        for (i = 0; i < num_roots; i++) {
+            rs->feedback_polynomial[i] = (uint8_t)gf->log2exp[rs->generator_polynomial[num_roots - 1 - i]];
+        }
+
+        rs->root_powers = (uint8_t *)pcalloc((size_t)num_roots * RS_ROOT_POWERS + 1, sizeof(uint8_t));
+        if (!rs->root_powers) {
+            poporon_rs_destroy(rs);
+
+            return NULL;
+        }
+
+        for (i = 0; i < num_roots; i++) {
+            root_log = ((uint32_t)(first_consecutive_root + i) % gf->field_size) *
+                       (primitive_element % gf->field_size) % gf->field_size;
+
+            for (k = 0; k < RS_ROOT_POWERS; k++) {
+                rs->root_powers[i * RS_ROOT_POWERS + k] = (uint8_t)gf->log2exp[root_log];
+                root_log = (root_log * 2) % gf->field_size;
+            }
+        }
+
+        /* y and y + 1 share y^2 + y, which solves the locator of two errors without a Chien search */
+        rs->quadratic_roots = (uint8_t *)pcalloc((size_t)gf->field_size + 1, sizeof(uint8_t));
+        if (!rs->quadratic_roots) {
+            poporon_rs_destroy(rs);
+
+            return NULL;
+        }
+
+        for (i = 1; i <= gf->field_size; i++) {
+            rs->quadratic_roots[gf_mul(gf, i, i) ^ i] = (uint8_t)i;
+        }
+    }
+
+    if (symbol_size > 8 && !rs_build_split_tables(rs)) {
+        poporon_rs_destroy(rs);
+
+        return NULL;
+    }
+
     return rs;
 }
+
+/*
+ * Slice-by-N tables in the spirit of slice-by-8 CRC: with x[t] = data[t] ^ register[t], N LFSR steps equal shifting
+ * the register by N and xoring the rows table[t][x[t]], the register contents left after feeding x[t] alone at step t
+ * into a zero register.
+ */
+bool poporon_rs_enable_encode_slices(poporon_rs_t *rs, uint8_t slices)
+{
+    uint8_t *impulse, *row, fb;
+    uint16_t t, step, value, j;
+
+    if (!rs || slices < 2 || slices > RS_ENCODE_MAX_SLICES) {
+        return false;
+    }
+
+    if (!rs->feedback_polynomial || slices > rs->num_roots) {
+        /* too few roots to absorb a whole slice, the LFSR kernels stay in charge */
+        return true;
+    }
+
+    rs->slice_stride = (uint16_t)((rs->num_roots + 7) & ~7);
+    rs->slice_tables = (uint8_t *)pcalloc((size_t)slices * 256 * rs->slice_stride, sizeof(uint8_t));
+    impulse = (uint8_t *)pmalloc(rs->num_roots + 1);
+    if (!rs->slice_tables || !impulse) {
+        pfree(rs->slice_tables);
+        pfree(impulse);
+        rs->slice_tables = NULL;
+
+        return false;
+    }
+
+    for (t = 0; t < slices; t++) {
+        pmemcpy(impulse, rs->feedback_polynomial, rs->num_roots);
+
+        for (step = t + 1; step < slices; step++) {
+            fb = impulse[0];
+            pmemmove(&impulse[0], &impulse[1], rs->num_roots - 1);
+            impulse[rs->num_roots - 1] = 0;
+
+            for (j = 0; j < rs->num_roots; j++) {
+                impulse[j] ^= gf_nibble_mul(gf_nibble_table(rs->gf, fb), rs->feedback_polynomial[j]);
+            }
+        }
+
+        for (value = 1; value <= rs->gf->field_size; value++) {
+            row = &rs->slice_tables[((size_t)t * 256 + value) * rs->slice_stride];
+
+            for (j = 0; j < rs->num_roots; j++) {
+                row[j] = gf_nibble_mul(gf_nibble_table(rs->gf, (uint8_t)value), impulse[j]);
+            }
+        }
+    }
+
+    pfree(impulse);
+    rs->encode_slices = slices;
+
+    return true;
+}
+
+/*
+ * Systematic parity as a matrix-vector product: parity = sum(data[i] * row[i]), where row[i] is the register left by
+ * a single 1 at message position i of a full length codeword. Shortened messages use the trailing rows.
+ */
+bool poporon_rs_enable_encode_matrix(poporon_rs_t *rs)
+{
+    uint8_t *row, *next, fb;
+    uint16_t rows, r, j;
+
+    if (!rs) {
+        return false;
+    }
+
+    if (!rs->feedback_polynomial || rs->num_roots == 0 || rs->num_roots >= rs->gf->field_size) {
+        /* nothing to precompute, the LFSR kernels stay in charge */
+        return true;
+    }
+
+    rows = rs->gf->field_size - rs->num_roots;
+    rs->matrix_stride = (uint16_t)((rs->num_roots + 63) & ~63);
+    rs->encode_matrix = (uint8_t *)pcalloc((size_t)rows * rs->matrix_stride, sizeof(uint8_t));
+    if (!rs->encode_matrix) {
+        return false;
+    }
+
+    row = &rs->encode_matrix[(size_t)(rows - 1) * rs->matrix_stride];
+    pmemcpy(row, rs->feedback_polynomial, rs->num_roots);
+
+    for (r = rows - 1; r > 0; r--) {
+        row = &rs->encode_matrix[(size_t)r * rs->matrix_stride];
+        next = &rs->encode_matrix[(size_t)(r - 1) * rs->matrix_stride];
+        fb = row[0];
+
+        for (j = 0; j < rs->num_roots; j++) {
+            next[j] = (j + 1 < rs->num_roots ? row[j + 1] : 0) ^
+                      gf_nibble_mul(gf_nibble_table(rs->gf, fb), rs->feedback_polynomial[j]);
+        }
+    }
+
+    return true;
+}
+
+static void *rs_registry_create(const void *key)
+{
+    const rs_key_t *rs_key = (const rs_key_t *)key;
+    poporon_rs_t *rs;
+    bool ok;
+
+    rs = poporon_rs_create(rs_key->symbol_size, rs_key->generator_polynomial, rs_key->first_consecutive_root,
+                           rs_key->primitive_element, rs_key->num_roots);
+    if (!rs) {
+        return NULL;
+    }
+
+    switch (rs_key->encode_mode) {
+    case PPRN_RS_ENCODE_MATRIX:
+        ok = poporon_rs_enable_encode_matrix(rs);
+        break;
+    case PPRN_RS_ENCODE_SLICE_4:
+    case PPRN_RS_ENCODE_SLICE_8:
+        ok = poporon_rs_enable_encode_slices(rs, (uint8_t)rs_key->encode_mode);
+        break;
+    default:
+        ok = true;
+        break;
+    }
+
+    if (!ok) {
+        poporon_rs_destroy(rs);
+
+        return NULL;
+    }
+
+    return rs;
+}
+
+static void rs_registry_destroy(void *object)
+{
+    poporon_rs_destroy((poporon_rs_t *)object);
+}
+
+poporon_rs_t *poporon_rs_acquire(uint8_t symbol_size, uint16_t generator_polynomial, uint16_t first_consecutive_root,
+                                 uint16_t primitive_element, uint8_t num_roots, poporon_rs_encode_mode_t encode_mode)
+{
+    rs_key_t key;
+
+    pmemset(&key, 0, sizeof(key));
+    key.symbol_size = symbol_size;
+    key.num_roots = num_roots;
+    key.generator_polynomial = generator_polynomial;
+    key.first_consecutive_root = first_consecutive_root;
+    key.primitive_element = primitive_element;
+    key.encode_mode = encode_mode;
+
+    return (poporon_rs_t *)poporon_registry_acquire(REGISTRY_RS, &key, sizeof(key), rs_registry_create,
+                                                    rs_registry_destroy);
+}
+
+void poporon_rs_release(poporon_rs_t *rs)
+{
+    poporon_registry_release(rs);
+}
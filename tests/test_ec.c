@@ -0,0 +1,322 @@
+/*
+ * libpoporon - test_ec.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <poporon.h>
+
+#include "internal/common.h"
+#include "unity.h"
+#include "util.h"
+
+#define SHARD_SIZE     (EC_BLOCK_SIZE + 1037)          /* a full block and a tail no multiple of any vector width */
+#define XOR_SHARD_SIZE (2 * 8 * EC_PACKET_SIZE + 192) /* two full blocks and one of 24 byte packets */
+
+typedef struct {
+    poporon_ec_t *ec;
+    shard_set_t set;
+} ec_fixture_t;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static bool codec_encode(const void *handle, const uint8_t *const *data, uint8_t *const *parity, size_t size)
+{
+    return poporon_ec_encode((const poporon_ec_t *)handle, data, parity, size);
+}
+
+static bool codec_reconstruct(const void *handle, uint8_t *const *shards, const bool *present, size_t size)
+{
+    return poporon_ec_reconstruct((const poporon_ec_t *)handle, shards, present, size);
+}
+
+static void fixture_create(ec_fixture_t *fixture, uint16_t data_shards, uint16_t parity_shards,
+                           poporon_ec_matrix_t matrix)
+{
+    shard_codec_t codec;
+
+    fixture->ec = poporon_ec_create(data_shards, parity_shards, matrix);
+    TEST_ASSERT_NOT_NULL(fixture->ec);
+    codec.handle = fixture->ec;
+    codec.encode = codec_encode;
+    codec.reconstruct = codec_reconstruct;
+    TEST_ASSERT_TRUE(shard_set_create(&fixture->set, &codec, data_shards, parity_shards,
+                                      (matrix == PPRN_EC_CAUCHY_XOR) ? XOR_SHARD_SIZE : SHARD_SIZE));
+}
+
+static void fixture_destroy(ec_fixture_t *fixture)
+{
+    shard_set_destroy(&fixture->set);
+    poporon_ec_destroy(fixture->ec);
+}
+
+/* drops the shards whose bit is set in lost and checks that reconstruction restores every shard */
+static void fixture_check(ec_fixture_t *fixture, uint32_t lost)
+{
+    shard_set_lose_mask(&fixture->set, lost);
+    TEST_ASSERT_TRUE(shard_set_check(&fixture->set));
+}
+
+void test_ec_create_destroy(void)
+{
+    poporon_ec_t *ec;
+
+    ec = poporon_ec_create(10, 4, PPRN_EC_VANDERMONDE);
+    TEST_ASSERT_NOT_NULL(ec);
+    TEST_ASSERT_EQUAL_UINT16(10, poporon_ec_get_data_shards(ec));
+    TEST_ASSERT_EQUAL_UINT16(4, poporon_ec_get_parity_shards(ec));
+    poporon_ec_destroy(ec);
+
+    ec = poporon_ec_create(200, 56, PPRN_EC_CAUCHY);
+    TEST_ASSERT_NOT_NULL(ec);
+    poporon_ec_destroy(ec);
+
+    ec = poporon_ec_create(255, 1, PPRN_EC_VANDERMONDE);
+    TEST_ASSERT_NOT_NULL(ec);
+    poporon_ec_destroy(ec);
+
+    TEST_ASSERT_NULL(poporon_ec_create(0, 4, PPRN_EC_CAUCHY));
+    TEST_ASSERT_NULL(poporon_ec_create(10, 0, PPRN_EC_CAUCHY));
+    TEST_ASSERT_NULL(poporon_ec_create(200, 57, PPRN_EC_CAUCHY));
+    TEST_ASSERT_NULL(poporon_ec_create(10, 4, (poporon_ec_matrix_t)99));
+
+    TEST_ASSERT_EQUAL_UINT16(0, poporon_ec_get_data_shards(NULL));
+    TEST_ASSERT_EQUAL_UINT16(0, poporon_ec_get_parity_shards(NULL));
+    poporon_ec_destroy(NULL);
+}
+
+/* the generator is systematic and every pattern of up to parity_shards lost shards is recoverable */
+void test_ec_reconstruct_all_patterns(void)
+{
+    static const poporon_ec_matrix_t matrices[] = {PPRN_EC_VANDERMONDE, PPRN_EC_CAUCHY, PPRN_EC_CAUCHY_XOR};
+    static const poporon_simd_level_t levels[] = {PPRN_SIMD_SCALAR, PPRN_SIMD_AUTO};
+    ec_fixture_t fixture;
+    uint32_t lost;
+    size_t m, l;
+
+    for (l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        TEST_ASSERT_TRUE(poporon_simd_set_level(levels[l]));
+
+        for (m = 0; m < sizeof(matrices) / sizeof(matrices[0]); m++) {
+            fixture_create(&fixture, 6, 3, matrices[m]);
+
+            for (lost = 0; lost < (1U << fixture.set.total); lost++) {
+                if (popcount(lost) <= 3) {
+                    fixture_check(&fixture, lost);
+                }
+            }
+
+            fixture_destroy(&fixture);
+        }
+    }
+
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+}
+
+void test_ec_reconstruct_wide(void)
+{
+    static const poporon_ec_matrix_t matrices[] = {PPRN_EC_VANDERMONDE, PPRN_EC_CAUCHY, PPRN_EC_CAUCHY_XOR};
+    ec_fixture_t fixture;
+    uint32_t lost;
+    size_t m, trial;
+    uint16_t i;
+
+    for (m = 0; m < sizeof(matrices) / sizeof(matrices[0]); m++) {
+        fixture_create(&fixture, 10, 4, matrices[m]);
+
+        fixture_check(&fixture, 0x000F);
+        fixture_check(&fixture, 0x3C00);
+        fixture_check(&fixture, 0x2211);
+
+        for (trial = 0; trial < 16; trial++) {
+            lost = 0;
+            for (i = 0; i < 4; i++) {
+                lost |= 1U << (rand() % fixture.set.total);
+            }
+            fixture_check(&fixture, lost);
+        }
+
+        fixture_destroy(&fixture);
+    }
+}
+
+void test_ec_invalid(void)
+{
+    ec_fixture_t fixture;
+    shard_set_t *set = &fixture.set;
+    uint16_t i;
+
+    fixture_create(&fixture, 6, 3, PPRN_EC_CAUCHY);
+
+    for (i = 0; i < set->total; i++) {
+        memcpy(set->shards[i], set->original[i], set->size);
+        set->present[i] = i >= 4;
+    }
+
+    /* four lost with three parity shards */
+    TEST_ASSERT_FALSE(poporon_ec_reconstruct(fixture.ec, set->shards, set->present, set->size));
+
+    TEST_ASSERT_FALSE(poporon_ec_reconstruct(NULL, set->shards, set->present, set->size));
+    TEST_ASSERT_FALSE(poporon_ec_reconstruct(fixture.ec, NULL, set->present, set->size));
+    TEST_ASSERT_FALSE(poporon_ec_reconstruct(fixture.ec, set->shards, NULL, set->size));
+    TEST_ASSERT_FALSE(poporon_ec_encode(NULL, (const uint8_t *const *)set->shards, &set->shards[6], set->size));
+    TEST_ASSERT_FALSE(poporon_ec_encode(fixture.ec, NULL, &set->shards[6], set->size));
+    TEST_ASSERT_FALSE(poporon_ec_encode(fixture.ec, (const uint8_t *const *)set->shards, NULL, set->size));
+
+    TEST_ASSERT_TRUE(poporon_ec_encode(fixture.ec, (const uint8_t *const *)set->shards, &set->shards[6], 0));
+
+    fixture_destroy(&fixture);
+}
+
+/* parity straight from the bit matrix definition, packet r of an output is the sum of bit r of e * x^c times packet c */
+void test_ec_xor_reference(void)
+{
+    ec_fixture_t fixture;
+    shard_set_t *set = &fixture.set;
+    uint8_t *expected, e, product;
+    size_t offset, packet_size, b;
+    uint32_t naive;
+    uint16_t i, j, r, c;
+
+    fixture_create(&fixture, 10, 4, PPRN_EC_CAUCHY_XOR);
+    expected = (uint8_t *)malloc(set->size);
+    TEST_ASSERT_NOT_NULL(expected);
+
+    naive = 0;
+    for (i = 0; i < 4; i++) {
+        memset(expected, 0, set->size);
+
+        for (offset = 0; offset < set->size; offset += 8 * packet_size) {
+            packet_size = (set->size - offset) / 8;
+            packet_size = packet_size < EC_PACKET_SIZE ? packet_size : EC_PACKET_SIZE;
+
+            for (j = 0; j < 10; j++) {
+                e = fixture.ec->parity_matrix[i * 10 + j];
+                for (c = 0; c < 8; c++) {
+                    product = (uint8_t)gf_mul(fixture.ec->gf, e, (uint16_t)(1U << c));
+                    for (r = 0; r < 8; r++) {
+                        if (!(product & (1U << r))) {
+                            continue;
+                        }
+
+                        naive += (offset == 0);
+                        for (b = 0; b < packet_size; b++) {
+                            expected[offset + r * packet_size + b] ^= set->original[j][offset + c * packet_size + b];
+                        }
+                    }
+                }
+            }
+        }
+
+        TEST_ASSERT_EQUAL_MEMORY(expected, set->original[10 + i], set->size);
+    }
+
+    /* shared partial sums beat one XOR per one bit */
+    TEST_ASSERT_TRUE(fixture.ec->encode_schedule.count < naive);
+
+    free(expected);
+    fixture_destroy(&fixture);
+}
+
+void test_ec_xor_alignment(void)
+{
+    ec_fixture_t fixture;
+    uint16_t i;
+
+    fixture_create(&fixture, 6, 3, PPRN_EC_CAUCHY_XOR);
+
+    for (i = 0; i < fixture.set.total; i++) {
+        fixture.set.present[i] = true;
+    }
+
+    TEST_ASSERT_FALSE(poporon_ec_encode(fixture.ec, (const uint8_t *const *)fixture.set.original,
+                                        &fixture.set.original[6], POPORON_EC_XOR_ALIGNMENT + 8));
+    TEST_ASSERT_FALSE(
+        poporon_ec_reconstruct(fixture.ec, fixture.set.original, fixture.set.present, POPORON_EC_XOR_ALIGNMENT + 8));
+    TEST_ASSERT_TRUE(poporon_ec_encode(fixture.ec, (const uint8_t *const *)fixture.set.original, &fixture.set.shards[6],
+                                       POPORON_EC_XOR_ALIGNMENT));
+
+    fixture_destroy(&fixture);
+}
+
+static void cache_stats(const ec_fixture_t *fixture, uint64_t expected_hits, uint64_t expected_misses)
+{
+    uint64_t hits, misses;
+
+    TEST_ASSERT_TRUE(poporon_ec_get_cache_stats(fixture->ec, &hits, &misses));
+    TEST_ASSERT_EQUAL_UINT64(expected_hits, hits);
+    TEST_ASSERT_EQUAL_UINT64(expected_misses, misses);
+}
+
+/* one plan per erasure pattern, least recently used out first, and results never depend on the cache */
+void test_ec_cache(void)
+{
+    static const poporon_ec_matrix_t matrices[] = {PPRN_EC_CAUCHY, PPRN_EC_CAUCHY_XOR};
+    ec_fixture_t fixture;
+    size_t m;
+
+    for (m = 0; m < sizeof(matrices) / sizeof(matrices[0]); m++) {
+        fixture_create(&fixture, 6, 3, matrices[m]);
+        cache_stats(&fixture, 0, 0);
+
+        /* nothing lost needs no plan */
+        fixture_check(&fixture, 0);
+        cache_stats(&fixture, 0, 0);
+
+        fixture_check(&fixture, 0x003);
+        fixture_check(&fixture, 0x003);
+        fixture_check(&fixture, 0x003);
+        cache_stats(&fixture, 2, 1);
+
+        /* lost parity alone is a pattern too */
+        fixture_check(&fixture, 0x100);
+        fixture_check(&fixture, 0x100);
+        cache_stats(&fixture, 3, 2);
+
+        /* two plans fit, 0x003 is the least recently used one */
+        TEST_ASSERT_TRUE(poporon_ec_set_cache_capacity(fixture.ec, 2));
+        fixture_check(&fixture, 0x041);
+        fixture_check(&fixture, 0x100);
+        fixture_check(&fixture, 0x003);
+        cache_stats(&fixture, 4, 4);
+
+        /* shrinking drops plans at once, 0 keeps nothing */
+        TEST_ASSERT_TRUE(poporon_ec_set_cache_capacity(fixture.ec, 0));
+        fixture_check(&fixture, 0x003);
+        fixture_check(&fixture, 0x003);
+        cache_stats(&fixture, 4, 6);
+
+        fixture_destroy(&fixture);
+    }
+
+    TEST_ASSERT_FALSE(poporon_ec_set_cache_capacity(NULL, 1));
+    TEST_ASSERT_FALSE(poporon_ec_get_cache_stats(NULL, NULL, NULL));
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_ec_create_destroy);
+    RUN_TEST(test_ec_reconstruct_all_patterns);
+    RUN_TEST(test_ec_reconstruct_wide);
+    RUN_TEST(test_ec_invalid);
+    RUN_TEST(test_ec_xor_reference);
+    RUN_TEST(test_ec_xor_alignment);
+    RUN_TEST(test_ec_cache);
+
+    return UNITY_END();
+}
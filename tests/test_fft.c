@@ -0,0 +1,248 @@
+/*
+ * libpoporon - test_fft.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <poporon.h>
+
+#include "internal/common.h"
+#include "unity.h"
+#include "util.h"
+
+#define SHARD_SIZE      (4 * FFT_MIN_BLOCK_SIZE + 38) /* even, no multiple of a vector width */
+#define WIDE_SHARD_SIZE (2 * FFT_MIN_BLOCK_SIZE)
+
+typedef struct {
+    poporon_fft_t *fft;
+    shard_set_t set;
+} fft_fixture_t;
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+static bool codec_encode(const void *handle, const uint8_t *const *data, uint8_t *const *parity, size_t size)
+{
+    return poporon_fft_encode((const poporon_fft_t *)handle, data, parity, size);
+}
+
+static bool codec_reconstruct(const void *handle, uint8_t *const *shards, const bool *present, size_t size)
+{
+    return poporon_fft_reconstruct((const poporon_fft_t *)handle, shards, present, size);
+}
+
+static void fixture_create(fft_fixture_t *fixture, uint8_t symbol_size, uint16_t data_shards, uint16_t parity_shards,
+                           size_t size)
+{
+    shard_codec_t codec;
+
+    fixture->fft = poporon_fft_create(symbol_size, data_shards, parity_shards);
+    TEST_ASSERT_NOT_NULL(fixture->fft);
+    codec.handle = fixture->fft;
+    codec.encode = codec_encode;
+    codec.reconstruct = codec_reconstruct;
+    TEST_ASSERT_TRUE(shard_set_create(&fixture->set, &codec, data_shards, parity_shards, size));
+}
+
+static void fixture_destroy(fft_fixture_t *fixture)
+{
+    shard_set_destroy(&fixture->set);
+    poporon_fft_destroy(fixture->fft);
+}
+
+void test_fft_create_destroy(void)
+{
+    poporon_fft_t *fft;
+
+    fft = poporon_fft_create(8, 10, 4);
+    TEST_ASSERT_NOT_NULL(fft);
+    TEST_ASSERT_EQUAL_UINT16(10, poporon_fft_get_data_shards(fft));
+    TEST_ASSERT_EQUAL_UINT16(4, poporon_fft_get_parity_shards(fft));
+    poporon_fft_destroy(fft);
+
+    /* 128 parity positions and 128 data positions fill GF(2^8) */
+    fft = poporon_fft_create(8, 128, 128);
+    TEST_ASSERT_NOT_NULL(fft);
+    poporon_fft_destroy(fft);
+
+    fft = poporon_fft_create(16, 60000, 4000);
+    TEST_ASSERT_NOT_NULL(fft);
+    poporon_fft_destroy(fft);
+
+    TEST_ASSERT_NULL(poporon_fft_create(8, 129, 128));
+    TEST_ASSERT_NULL(poporon_fft_create(8, 200, 33));
+    TEST_ASSERT_NULL(poporon_fft_create(16, 61441, 4096));
+    TEST_ASSERT_NULL(poporon_fft_create(12, 10, 4));
+    TEST_ASSERT_NULL(poporon_fft_create(8, 0, 4));
+    TEST_ASSERT_NULL(poporon_fft_create(8, 10, 0));
+
+    TEST_ASSERT_EQUAL_UINT16(0, poporon_fft_get_data_shards(NULL));
+    TEST_ASSERT_EQUAL_UINT16(0, poporon_fft_get_parity_shards(NULL));
+    poporon_fft_destroy(NULL);
+}
+
+/* every pattern of up to parity_shards lost shards is recoverable, data runs partial and parity_span unfilled */
+void test_fft_reconstruct_all_patterns(void)
+{
+    static const uint8_t symbol_sizes[] = {8, 16};
+    static const poporon_simd_level_t levels[] = {PPRN_SIMD_SCALAR, PPRN_SIMD_AUTO};
+    fft_fixture_t fixture;
+    uint32_t lost;
+    size_t s, l;
+
+    for (l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        TEST_ASSERT_TRUE(poporon_simd_set_level(levels[l]));
+
+        for (s = 0; s < sizeof(symbol_sizes) / sizeof(symbol_sizes[0]); s++) {
+            fixture_create(&fixture, symbol_sizes[s], 7, 3, SHARD_SIZE);
+
+            for (lost = 0; lost < (1U << fixture.set.total); lost++) {
+                if (popcount(lost) <= 3) {
+                    shard_set_lose_mask(&fixture.set, lost);
+                    TEST_ASSERT_TRUE(shard_set_check(&fixture.set));
+                }
+            }
+
+            fixture_destroy(&fixture);
+        }
+    }
+
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+}
+
+/* a single parity shard is the XOR of the data */
+void test_fft_single_parity(void)
+{
+    fft_fixture_t fixture;
+    uint8_t *expected;
+    uint16_t i;
+    size_t b;
+
+    fixture_create(&fixture, 8, 5, 1, SHARD_SIZE);
+
+    expected = (uint8_t *)calloc(1, fixture.set.size);
+    TEST_ASSERT_NOT_NULL(expected);
+    for (i = 0; i < 5; i++) {
+        for (b = 0; b < fixture.set.size; b++) {
+            expected[b] ^= fixture.set.original[i][b];
+        }
+    }
+    TEST_ASSERT_EQUAL_MEMORY(expected, fixture.set.original[5], fixture.set.size);
+
+    for (i = 0; i < 6; i++) {
+        shard_set_lose_mask(&fixture.set, 1U << i);
+        TEST_ASSERT_TRUE(shard_set_check(&fixture.set));
+    }
+
+    free(expected);
+    fixture_destroy(&fixture);
+}
+
+/* shards larger than one pass, GF(2^8) at its widest */
+void test_fft_reconstruct_blocks(void)
+{
+    fft_fixture_t fixture;
+    uint32_t trial;
+
+    fixture_create(&fixture, 8, 100, 100, FFT_WORKING_SET / 256 * 3 + 27);
+
+    shard_set_lose_random(&fixture.set, 100);
+    TEST_ASSERT_TRUE(shard_set_check(&fixture.set));
+    for (trial = 0; trial < 4; trial++) {
+        shard_set_lose_random(&fixture.set, (uint32_t)rand() % 101);
+        TEST_ASSERT_TRUE(shard_set_check(&fixture.set));
+    }
+
+    fixture_destroy(&fixture);
+}
+
+/* thousands of small packets over GF(2^16) */
+void test_fft_reconstruct_wide(void)
+{
+    fft_fixture_t fixture;
+    uint32_t trial, i;
+
+    fixture_create(&fixture, 16, 1000, 300, WIDE_SHARD_SIZE);
+
+    /* all parity, then the first data shards */
+    for (i = 0; i < fixture.set.total; i++) {
+        fixture.set.present[i] = i < 1000;
+    }
+    TEST_ASSERT_TRUE(shard_set_check(&fixture.set));
+
+    for (i = 0; i < fixture.set.total; i++) {
+        fixture.set.present[i] = i >= 300;
+    }
+    TEST_ASSERT_TRUE(shard_set_check(&fixture.set));
+
+    for (trial = 0; trial < 4; trial++) {
+        shard_set_lose_random(&fixture.set, 300 - trial * 70);
+        TEST_ASSERT_TRUE(shard_set_check(&fixture.set));
+    }
+
+    fixture_destroy(&fixture);
+}
+
+void test_fft_invalid(void)
+{
+    fft_fixture_t fixture;
+    shard_set_t *set = &fixture.set;
+    uint32_t i;
+
+    fixture_create(&fixture, 16, 6, 3, SHARD_SIZE);
+
+    for (i = 0; i < set->total; i++) {
+        memcpy(set->shards[i], set->original[i], set->size);
+        set->present[i] = i >= 4;
+    }
+
+    /* four lost with three parity shards */
+    TEST_ASSERT_FALSE(poporon_fft_reconstruct(fixture.fft, set->shards, set->present, set->size));
+
+    for (i = 0; i < set->total; i++) {
+        set->present[i] = true;
+    }
+
+    /* uint16_t symbols */
+    TEST_ASSERT_FALSE(poporon_fft_reconstruct(fixture.fft, set->shards, set->present, set->size - 1));
+    TEST_ASSERT_FALSE(
+        poporon_fft_encode(fixture.fft, (const uint8_t *const *)set->shards, &set->shards[6], set->size - 1));
+
+    TEST_ASSERT_FALSE(poporon_fft_reconstruct(NULL, set->shards, set->present, set->size));
+    TEST_ASSERT_FALSE(poporon_fft_reconstruct(fixture.fft, NULL, set->present, set->size));
+    TEST_ASSERT_FALSE(poporon_fft_reconstruct(fixture.fft, set->shards, NULL, set->size));
+    TEST_ASSERT_FALSE(poporon_fft_encode(NULL, (const uint8_t *const *)set->shards, &set->shards[6], set->size));
+    TEST_ASSERT_FALSE(poporon_fft_encode(fixture.fft, NULL, &set->shards[6], set->size));
+    TEST_ASSERT_FALSE(poporon_fft_encode(fixture.fft, (const uint8_t *const *)set->shards, NULL, set->size));
+
+    TEST_ASSERT_TRUE(poporon_fft_encode(fixture.fft, (const uint8_t *const *)set->shards, &set->shards[6], 0));
+    TEST_ASSERT_TRUE(poporon_fft_reconstruct(fixture.fft, set->shards, set->present, set->size));
+
+    fixture_destroy(&fixture);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_fft_create_destroy);
+    RUN_TEST(test_fft_reconstruct_all_patterns);
+    RUN_TEST(test_fft_single_parity);
+    RUN_TEST(test_fft_reconstruct_blocks);
+    RUN_TEST(test_fft_reconstruct_wide);
+    RUN_TEST(test_fft_invalid);
+
+    return UNITY_END();
+}
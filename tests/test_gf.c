@@ -14,6 +14,7 @@
 #include <poporon.h>
 #include <poporon/gf.h>
 
+#include "internal/common.h"
 #include "unity.h"
 #include "util.h"
 
@@ -78,12 +79,304 @@ void test_gf_mod(void)
     poporon_gf_destroy(gf);
 }
 
+void test_gf_exp_table(void)
+{
+    static const struct {
+        uint8_t symbol_size;
+        uint16_t generator_polynomial;
+    } fields[] = {{4, 0x13}, {5, 0x25}, {SYMBOL_SIZE, GENERATER_POLYNOMIAL}, {SYMBOL_SIZE, 0x1D}};
+    poporon_gf_t *gf;
+    uint32_t log, a, b;
+    size_t f;
+
+    for (f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        gf = poporon_gf_create(fields[f].symbol_size, fields[f].generator_polynomial);
+        TEST_ASSERT_NOT_NULL(gf);
+
+        for (log = 0; log < GF_EXP_PERIODS * (uint32_t)gf->field_size; log++) {
+            TEST_ASSERT_EQUAL_UINT16(gf->log2exp[log % gf->field_size], gf_exp(gf, log));
+        }
+
+        /* the largest three log sum the decoder forms, and the wrap used for stored logs */
+        a = gf->field_size - 1;
+        b = gf->field_size - 1;
+        TEST_ASSERT_EQUAL_UINT16(gf->log2exp[(a + b) % gf->field_size], gf_exp(gf, a + b + gf->field_size));
+        TEST_ASSERT_EQUAL_UINT16((a + b) % gf->field_size, gf_log_wrap(gf, a + b));
+        TEST_ASSERT_EQUAL_UINT16(0, gf_log_wrap(gf, gf->field_size));
+
+        poporon_gf_destroy(gf);
+    }
+}
+
+void test_gf_static_tables(void)
+{
+    static const uint16_t polynomials[] = {0x11D, 0x187};
+    poporon_gf_t *gf, *again, *runtime;
+    size_t i;
+
+    for (i = 0; i < sizeof(polynomials) / sizeof(polynomials[0]); i++) {
+        gf = poporon_gf_create(SYMBOL_SIZE, polynomials[i]);
+        again = poporon_gf_create(SYMBOL_SIZE, polynomials[i]);
+        TEST_ASSERT_NOT_NULL(gf);
+        TEST_ASSERT_NOT_NULL(again);
+
+        /* the bit above the field is dropped by the reduction, so this builds the same field at runtime */
+        runtime = poporon_gf_create(SYMBOL_SIZE, polynomials[i] & 0xFF);
+        TEST_ASSERT_NOT_NULL(runtime);
+        TEST_ASSERT_FALSE(runtime->is_static);
+
+        if (gf->is_static) {
+            TEST_ASSERT_TRUE(gf == again);
+            TEST_ASSERT_TRUE(gf == poporon_gf_acquire(SYMBOL_SIZE, polynomials[i]));
+            poporon_gf_release(gf);
+        }
+
+        TEST_ASSERT_EQUAL_UINT8(runtime->field_size, gf->field_size);
+        TEST_ASSERT_EQUAL(polynomials[i], gf->generator_polynomial);
+        TEST_ASSERT_EQUAL_MEMORY(runtime->log2exp, gf->log2exp, 256 * sizeof(uint16_t));
+        TEST_ASSERT_EQUAL_MEMORY(runtime->exp2log, gf->exp2log, 256 * sizeof(uint16_t));
+        TEST_ASSERT_EQUAL_MEMORY(runtime->exp_table, gf->exp_table, GF_EXP_PERIODS * 255 * sizeof(uint16_t));
+        TEST_ASSERT_EQUAL_MEMORY(runtime->nibble_tables, gf->nibble_tables, 256 * GF_NIBBLE_TABLE_SIZE);
+
+        /* destroying a view leaves the tables in place for every other holder */
+        poporon_gf_destroy(gf);
+        TEST_ASSERT_EQUAL_UINT8(1, poporon_gf_mod(again, 256));
+        poporon_gf_destroy(again);
+        poporon_gf_destroy(runtime);
+    }
+}
+
+void test_gf_region(void)
+{
+    static const struct {
+        uint8_t symbol_size;
+        uint16_t generator_polynomial;
+    } fields[] = {{4, 0x13}, {SYMBOL_SIZE, GENERATER_POLYNOMIAL}};
+    uint8_t src[3][131], dst[131], expected[131];
+    const uint8_t *sources[3];
+    uint8_t coefficients[3];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    poporon_gf_t *gf;
+    uint16_t multiplier;
+    size_t f, i, k;
+
+    for (f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        gf = poporon_gf_create(fields[f].symbol_size, fields[f].generator_polynomial);
+        TEST_ASSERT_NOT_NULL(gf);
+
+        for (k = 0; k < 3; k++) {
+            distinct_data(src[k], sizeof(src[k]), &state);
+            for (i = 0; i < sizeof(src[k]); i++) {
+                src[k][i] &= gf->field_size;
+            }
+            sources[k] = src[k];
+        }
+
+        for (multiplier = 0; multiplier <= gf->field_size; multiplier++) {
+            for (i = 0; i < sizeof(dst); i++) {
+                expected[i] = (uint8_t)gf_mul(gf, multiplier, src[0][i]);
+            }
+
+            memset(dst, 0xA5, sizeof(dst));
+            TEST_ASSERT_TRUE(poporon_gf_mul_region(gf, (uint8_t)multiplier, src[0], dst, sizeof(dst)));
+            TEST_ASSERT_EQUAL_MEMORY(expected, dst, sizeof(dst));
+
+            memcpy(dst, src[1], sizeof(dst));
+            for (i = 0; i < sizeof(dst); i++) {
+                expected[i] ^= src[1][i];
+            }
+            TEST_ASSERT_TRUE(poporon_gf_muladd_region(gf, (uint8_t)multiplier, src[0], dst, sizeof(dst)));
+            TEST_ASSERT_EQUAL_MEMORY(expected, dst, sizeof(dst));
+
+            coefficients[0] = (uint8_t)multiplier;
+            coefficients[1] = (uint8_t)(gf->field_size - multiplier);
+            coefficients[2] = (uint8_t)((multiplier * 7) & gf->field_size);
+            for (i = 0; i < sizeof(dst); i++) {
+                expected[i] = (uint8_t)(gf_mul(gf, coefficients[0], src[0][i]) ^
+                                        gf_mul(gf, coefficients[1], src[1][i]) ^
+                                        gf_mul(gf, coefficients[2], src[2][i]));
+            }
+            TEST_ASSERT_TRUE(poporon_gf_dot_region(gf, coefficients, sources, 3, dst, sizeof(dst)));
+            TEST_ASSERT_EQUAL_MEMORY(expected, dst, sizeof(dst));
+        }
+
+        /* in place scaling, then scaling back by the inverse */
+        memcpy(dst, src[0], sizeof(dst));
+        multiplier = gf->log2exp[1];
+        TEST_ASSERT_TRUE(poporon_gf_mul_region(gf, (uint8_t)multiplier, dst, dst, sizeof(dst)));
+        TEST_ASSERT_TRUE(
+            poporon_gf_mul_region(gf, (uint8_t)gf->log2exp[gf->field_size - 1], dst, dst, sizeof(dst)));
+        TEST_ASSERT_EQUAL_MEMORY(src[0], dst, sizeof(dst));
+
+        /* no sources is the zero vector */
+        memset(dst, 0xA5, sizeof(dst));
+        TEST_ASSERT_TRUE(poporon_gf_dot_region(gf, NULL, NULL, 0, dst, sizeof(dst)));
+        memset(expected, 0, sizeof(expected));
+        TEST_ASSERT_EQUAL_MEMORY(expected, dst, sizeof(dst));
+
+        poporon_gf_destroy(gf);
+    }
+}
+
+void test_gf_region_invalid(void)
+{
+    uint8_t src[16] = {0}, dst[16] = {0}, coefficients[2] = {1, 2};
+    const uint8_t *sources[2] = {src, NULL};
+    poporon_gf_t *gf;
+
+    TEST_ASSERT_FALSE(poporon_gf_mul_region(NULL, 1, src, dst, sizeof(dst)));
+    TEST_ASSERT_FALSE(poporon_gf_muladd_region(NULL, 1, src, dst, sizeof(dst)));
+    TEST_ASSERT_FALSE(poporon_gf_dot_region(NULL, coefficients, sources, 1, dst, sizeof(dst)));
+
+    gf = poporon_gf_create(4, 0x13);
+    TEST_ASSERT_NOT_NULL(gf);
+    TEST_ASSERT_FALSE(poporon_gf_mul_region(gf, 16, src, dst, sizeof(dst)));
+    TEST_ASSERT_FALSE(poporon_gf_mul_region(gf, 1, NULL, dst, sizeof(dst)));
+    TEST_ASSERT_FALSE(poporon_gf_muladd_region(gf, 1, src, NULL, sizeof(dst)));
+    TEST_ASSERT_FALSE(poporon_gf_dot_region(gf, coefficients, sources, 2, dst, sizeof(dst)));
+    TEST_ASSERT_FALSE(poporon_gf_dot_region(gf, NULL, sources, 1, dst, sizeof(dst)));
+    TEST_ASSERT_TRUE(poporon_gf_mul_region(gf, 1, NULL, NULL, 0));
+    poporon_gf_destroy(gf);
+
+    /* wider fields have no byte region form */
+    gf = poporon_gf_create(16, 0x100B);
+    TEST_ASSERT_NOT_NULL(gf);
+    TEST_ASSERT_FALSE(poporon_gf_mul_region(gf, 1, src, dst, sizeof(dst)));
+    poporon_gf_destroy(gf);
+}
+
+/* carry-less product of two polynomials of degree below 16 */
+static uint32_t clmul16(uint16_t a, uint32_t b)
+{
+    uint32_t product = 0;
+    uint8_t i;
+
+    for (i = 0; i < 16; i++) {
+        if (a & (1U << i)) {
+            product ^= b << i;
+        }
+    }
+
+    return product;
+}
+
+void test_gf_bitserial(void)
+{
+    static const struct {
+        uint8_t symbol_size;
+        uint16_t generator_polynomial;
+    } fields[] = {{4, 0x13}, {SYMBOL_SIZE, GENERATER_POLYNOMIAL}, {10, 0x409}, {16, 0x100B}};
+    poporon_gf_t *gf;
+    uint32_t polynomial, product;
+    uint16_t a, b, quotient;
+    size_t f, i;
+
+    for (f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        gf = poporon_gf_create(fields[f].symbol_size, fields[f].generator_polynomial);
+        TEST_ASSERT_NOT_NULL(gf);
+        polynomial = ((uint32_t)1 << gf->symbol_size) | gf->generator_polynomial;
+
+        for (i = 0; i < 20000; i++) {
+            a = (uint16_t)(rand() & gf->field_size);
+            b = (uint16_t)(rand() & gf->field_size);
+            TEST_ASSERT_EQUAL_UINT16(gf_mul(gf, a, b), gf_mul_bitserial(gf, a, b));
+
+            /* the two multiply reduction of the carry-less kernels */
+            quotient = gf_clmul_quotient(gf, b);
+            product = clmul16(a, b);
+            product ^= clmul16((uint16_t)(clmul16(a, quotient) >> gf->symbol_size), polynomial);
+            TEST_ASSERT_EQUAL_UINT16(gf_mul(gf, a, b), product & gf->field_size);
+        }
+
+        poporon_gf_destroy(gf);
+    }
+}
+
+void test_gf_region_u16(void)
+{
+    static const struct {
+        uint8_t symbol_size;
+        uint16_t generator_polynomial;
+    } fields[] = {{10, 0x409}, {16, 0x100B}};
+    static const size_t sizes[] = {1, 7, 8, 15, 16, 17, 33, 1000};
+    uint16_t src[3][1000], dst[1000], expected[1000], coefficients[3];
+    const uint16_t *sources[3];
+    poporon_gf_t *gf;
+    size_t f, s, i, k, size;
+    uint16_t multiplier;
+
+    for (f = 0; f < sizeof(fields) / sizeof(fields[0]); f++) {
+        gf = poporon_gf_create(fields[f].symbol_size, fields[f].generator_polynomial);
+        TEST_ASSERT_NOT_NULL(gf);
+
+        for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+            size = sizes[s];
+            multiplier = (uint16_t)(rand() & gf->field_size);
+
+            /* bits above symbol_size are ignored */
+            for (k = 0; k < 3; k++) {
+                for (i = 0; i < size; i++) {
+                    src[k][i] = (uint16_t)rand();
+                }
+                sources[k] = src[k];
+                coefficients[k] = (uint16_t)(rand() & gf->field_size);
+            }
+
+            for (i = 0; i < size; i++) {
+                expected[i] = gf_mul_bitserial(gf, multiplier, src[0][i] & gf->field_size);
+            }
+            TEST_ASSERT_TRUE(poporon_gf_mul_region_u16(gf, multiplier, src[0], dst, size));
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, dst, size);
+
+            memcpy(dst, src[1], size * sizeof(uint16_t));
+            for (i = 0; i < size; i++) {
+                expected[i] ^= src[1][i];
+            }
+            TEST_ASSERT_TRUE(poporon_gf_muladd_region_u16(gf, multiplier, src[0], dst, size));
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, dst, size);
+
+            for (i = 0; i < size; i++) {
+                expected[i] = 0;
+                for (k = 0; k < 3; k++) {
+                    expected[i] ^= gf_mul_bitserial(gf, coefficients[k], src[k][i] & gf->field_size);
+                }
+            }
+            TEST_ASSERT_TRUE(poporon_gf_dot_region_u16(gf, coefficients, sources, 3, dst, size));
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, dst, size);
+
+            /* dst as the last source */
+            memcpy(dst, src[2], size * sizeof(uint16_t));
+            sources[2] = dst;
+            TEST_ASSERT_TRUE(poporon_gf_dot_region_u16(gf, coefficients, sources, 3, dst, size));
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, dst, size);
+        }
+
+        if (gf->field_size < UINT16_MAX) {
+            TEST_ASSERT_FALSE(poporon_gf_mul_region_u16(gf, (uint16_t)(gf->field_size + 1), src[0], dst, 1));
+        }
+        TEST_ASSERT_FALSE(poporon_gf_muladd_region_u16(gf, 1, NULL, dst, 1));
+        poporon_gf_destroy(gf);
+    }
+
+    /* byte sized fields have no uint16_t region form */
+    gf = poporon_gf_create(SYMBOL_SIZE, GENERATER_POLYNOMIAL);
+    TEST_ASSERT_NOT_NULL(gf);
+    TEST_ASSERT_FALSE(poporon_gf_mul_region_u16(gf, 1, src[0], dst, 1));
+    poporon_gf_destroy(gf);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
 
     RUN_TEST(test_gf_create_destroy);
     RUN_TEST(test_gf_mod);
+    RUN_TEST(test_gf_exp_table);
+    RUN_TEST(test_gf_static_tables);
+    RUN_TEST(test_gf_region);
+    RUN_TEST(test_gf_region_invalid);
+    RUN_TEST(test_gf_bitserial);
+    RUN_TEST(test_gf_region_u16);
 
     return UNITY_END();
 }
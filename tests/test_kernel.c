@@ -0,0 +1,483 @@
+/*
+ * libpoporon - test_kernel.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <poporon.h>
+
+#include "internal/kernel.h"
+#include "internal/ldpc.h"
+
+#include "unity.h"
+#include "util.h"
+
+typedef struct {
+    uint8_t symbol_size;
+    uint16_t generator_polynomial;
+    uint16_t first_consecutive_root;
+    uint16_t primitive_element;
+} rs_params_t;
+
+static const rs_params_t rs_params[] = {
+    {8, 0x11D, 1, 1},
+    {8, 0x11D, 0, 1},
+    {8, 0x187, 112, 11},
+    {4, 0x13, 1, 1},
+};
+
+static const uint8_t num_roots[] = {2, 8, 15, 16, 17, 31, 32, 33, 48, 64, 65, 100};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+}
+
+static void test_kernel_level_selection(void)
+{
+    poporon_simd_level_t level;
+
+    TEST_ASSERT_TRUE(poporon_simd_set_level(PPRN_SIMD_AUTO));
+    level = poporon_simd_get_level();
+    TEST_ASSERT_NOT_EQUAL(PPRN_SIMD_AUTO, level);
+
+    TEST_ASSERT_TRUE(poporon_simd_set_level(PPRN_SIMD_SCALAR));
+    TEST_ASSERT_EQUAL(PPRN_SIMD_SCALAR, poporon_simd_get_level());
+
+    TEST_ASSERT_FALSE(poporon_simd_set_level((poporon_simd_level_t)100));
+    TEST_ASSERT_EQUAL(PPRN_SIMD_SCALAR, poporon_simd_get_level());
+
+    TEST_ASSERT_TRUE(poporon_simd_set_level(level));
+    TEST_ASSERT_EQUAL(level, poporon_simd_get_level());
+}
+
+/* locators with degree distinct roots spread over the field, then arbitrary ones with fewer roots than their degree */
+static void check_rs_chien(const poporon_rs_t *rs)
+{
+    uint16_t locator[256], logs[256], registers[256], roots[256], locations[256], expected_roots[256],
+        expected_locations[256];
+    uint16_t degree, count, expected_count, primitive_inverse, inverse, root, j, k;
+    uint64_t product;
+    bool used[256];
+    size_t d;
+
+    for (product = 1; product % rs->primitive_element != 0; product += rs->gf->field_size) {
+        ;
+    }
+    primitive_inverse = (uint16_t)(product / rs->primitive_element);
+
+    for (d = 0; d < 2 * sizeof(num_roots); d++) {
+        degree = (d < sizeof(num_roots)) ? num_roots[d] : (uint16_t)(1 + rand() % rs->num_roots);
+        if (degree > rs->num_roots || degree >= rs->gf->field_size) {
+            continue;
+        }
+
+        memset(used, 0, sizeof(used));
+        locator[0] = 1;
+        for (j = 1; j <= degree; j++) {
+            do {
+                root = (uint16_t)(1 + rand() % rs->gf->field_size);
+            } while (used[root]);
+            used[root] = true;
+
+            inverse = rs->gf->log2exp[gf_mod(rs->gf, (uint32_t)rs->gf->field_size - root)];
+            locator[j] = 0;
+            for (k = j; k > 0; k--) {
+                locator[k] ^= gf_mul(rs->gf, inverse, locator[k - 1]);
+            }
+        }
+
+        for (j = 0; j <= degree; j++) {
+            logs[j] = rs->gf->exp2log[locator[j]];
+        }
+
+        expected_count = poporon_rs_chien_scalar(rs, logs, degree, primitive_inverse, registers, expected_roots,
+                                                 expected_locations);
+        count = poporon_kernel()->rs_chien(rs, logs, degree, primitive_inverse, registers, roots, locations);
+        TEST_ASSERT_EQUAL_UINT16(degree, expected_count);
+        TEST_ASSERT_EQUAL_UINT16(expected_count, count);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_roots, roots, count);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_locations, locations, count);
+
+        /* random coefficients, zero ones included */
+        for (j = 1; j <= degree; j++) {
+            logs[j] = (rand() % 4 == 0) ? rs->gf->field_size : (uint16_t)(rand() % rs->gf->field_size);
+        }
+        logs[degree] = (uint16_t)(rand() % rs->gf->field_size);
+
+        expected_count = poporon_rs_chien_scalar(rs, logs, degree, primitive_inverse, registers, expected_roots,
+                                                 expected_locations);
+        count = poporon_kernel()->rs_chien(rs, logs, degree, primitive_inverse, registers, roots, locations);
+        TEST_ASSERT_EQUAL_UINT16(expected_count, count);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_roots, roots, count);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_locations, locations, count);
+    }
+}
+
+static void check_rs_kernel(void)
+{
+    poporon_rs_t *rs;
+    uint8_t data[255], parity[255], expected[255];
+    uint16_t syndrome[255], expected_syndrome[255];
+    size_t p, r, size, max_size;
+    bool error, expected_error;
+
+    for (p = 0; p < sizeof(rs_params) / sizeof(rs_params[0]); p++) {
+        for (r = 0; r < sizeof(num_roots); r++) {
+            max_size = (size_t)(1 << rs_params[p].symbol_size) - 1;
+            if (num_roots[r] >= max_size) {
+                continue;
+            }
+
+            rs = poporon_rs_create(rs_params[p].symbol_size, rs_params[p].generator_polynomial,
+                                   rs_params[p].first_consecutive_root, rs_params[p].primitive_element, num_roots[r]);
+            TEST_ASSERT_NOT_NULL(rs);
+            max_size -= num_roots[r];
+
+            for (size = 1; size <= max_size; size += 7) {
+                random_data(data, size);
+
+                poporon_rs_encode_scalar(rs, data, size, expected);
+                poporon_kernel()->rs_encode(rs, data, size, parity);
+                TEST_ASSERT_EQUAL_MEMORY(expected, parity, num_roots[r]);
+
+                error = poporon_kernel()->rs_syndrome(rs, data, size, parity, syndrome);
+                expected_error = poporon_rs_syndrome_scalar(rs, data, size, parity, expected_syndrome);
+                TEST_ASSERT_FALSE(error);
+                TEST_ASSERT_EQUAL(expected_error, error);
+                TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_syndrome, syndrome, num_roots[r]);
+
+                break_data(data, size, 1 + (uint32_t)(size % 5));
+                parity[0] ^= 0x5A;
+
+                error = poporon_kernel()->rs_syndrome(rs, data, size, parity, syndrome);
+                expected_error = poporon_rs_syndrome_scalar(rs, data, size, parity, expected_syndrome);
+                TEST_ASSERT_EQUAL(expected_error, error);
+                TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_syndrome, syndrome, num_roots[r]);
+            }
+
+            check_rs_chien(rs);
+            poporon_rs_destroy(rs);
+        }
+    }
+}
+
+static const int16_t edge_values[] = {LLR_MAX, -LLR_MAX, 0, 1, -1};
+
+static void check_ldpc_kernel(void)
+{
+    uint32_t row_ptr[65], i, edges;
+    int16_t *var_to_check, *check_to_var, *expected;
+
+    row_ptr[0] = 0;
+    for (i = 0; i < 64; i++) {
+        /* cover empty rows, rows shorter than a vector, whole vectors and several vectors with a partial tail */
+        row_ptr[i + 1] = row_ptr[i] + (i * 7) % 71;
+    }
+    edges = row_ptr[64];
+
+    var_to_check = (int16_t *)calloc(edges, sizeof(int16_t));
+    check_to_var = (int16_t *)calloc(edges, sizeof(int16_t));
+    expected = (int16_t *)calloc(edges, sizeof(int16_t));
+    if (!var_to_check || !check_to_var || !expected) {
+        free(var_to_check);
+        free(check_to_var);
+        free(expected);
+        TEST_FAIL_MESSAGE("check node buffers");
+        return;
+    }
+
+    for (i = 0; i < edges; i++) {
+        var_to_check[i] = (int16_t)(rand() % (2 * LLR_MAX + 1) - LLR_MAX);
+        if (i % 13 == 0) {
+            /* ties on the minimum magnitude */
+            var_to_check[i] = (i % 2) ? 17 : -17;
+        }
+    }
+
+    poporon_ldpc_check_node_scalar(row_ptr, 64, var_to_check, expected);
+    poporon_kernel()->ldpc_check_node(row_ptr, 64, var_to_check, check_to_var);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected, check_to_var, edges);
+
+    for (i = 0; i < edges; i++) {
+        var_to_check[i] = (int16_t)(rand() % 64 - 32);
+    }
+
+    poporon_ldpc_check_node_scalar(row_ptr, 64, var_to_check, expected);
+    poporon_kernel()->ldpc_check_node(row_ptr, 64, var_to_check, check_to_var);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected, check_to_var, edges);
+
+    /* saturated and zero messages, zero counts as positive */
+    for (i = 0; i < edges; i++) {
+        var_to_check[i] = edge_values[rand() % (sizeof(edge_values) / sizeof(edge_values[0]))];
+    }
+
+    poporon_ldpc_check_node_scalar(row_ptr, 64, var_to_check, expected);
+    poporon_kernel()->ldpc_check_node(row_ptr, 64, var_to_check, check_to_var);
+    TEST_ASSERT_EQUAL_INT16_ARRAY(expected, check_to_var, edges);
+
+    free(var_to_check);
+    free(check_to_var);
+    free(expected);
+}
+
+static const size_t interleaved_lanes[] = {1, 15, 16, 17, 32, 40, 64, 70};
+
+static void check_rs_interleaved_kernel(void)
+{
+    poporon_rs_t *rs;
+    uint8_t *data, *parity, *syndrome, codeword[255], check[255];
+    uint16_t expected[255];
+    size_t p, r, l, lane, i, size, stride, lanes;
+
+    data = (uint8_t *)malloc(255 * 80);
+    parity = (uint8_t *)malloc(255 * 80);
+    syndrome = (uint8_t *)malloc(255 * 80);
+    TEST_ASSERT_NOT_NULL(data);
+    TEST_ASSERT_NOT_NULL(parity);
+    TEST_ASSERT_NOT_NULL(syndrome);
+
+    for (p = 0; p < sizeof(rs_params) / sizeof(rs_params[0]); p++) {
+        for (r = 0; r < sizeof(num_roots); r += 3) {
+            if (num_roots[r] >= (1 << rs_params[p].symbol_size) - 1) {
+                continue;
+            }
+
+            rs = poporon_rs_create(rs_params[p].symbol_size, rs_params[p].generator_polynomial,
+                                   rs_params[p].first_consecutive_root, rs_params[p].primitive_element, num_roots[r]);
+            TEST_ASSERT_NOT_NULL(rs);
+            size = rs->gf->field_size - num_roots[r];
+
+            for (l = 0; l < sizeof(interleaved_lanes) / sizeof(interleaved_lanes[0]); l++) {
+                lanes = interleaved_lanes[l];
+                /* a stride wider than the batch, as when encoding a column range of a larger one */
+                stride = lanes + 3;
+                random_data(data, size * stride);
+
+                poporon_kernel()->rs_encode_interleaved(rs, data, size, stride, lanes, parity);
+                poporon_kernel()->rs_syndrome_interleaved(rs, data, size, parity, stride, lanes, syndrome);
+
+                for (lane = 0; lane < lanes; lane++) {
+                    for (i = 0; i < size; i++) {
+                        codeword[i] = data[i * stride + lane];
+                    }
+                    poporon_rs_encode_scalar(rs, codeword, size, check);
+
+                    for (i = 0; i < num_roots[r]; i++) {
+                        TEST_ASSERT_EQUAL_UINT8(check[i], parity[i * stride + lane]);
+                        TEST_ASSERT_EQUAL_UINT8(0, syndrome[i * stride + lane]);
+                    }
+                }
+
+                for (lane = 0; lane < lanes; lane += 3) {
+                    data[(lane * 7 % size) * stride + lane] ^= (uint8_t)(lane + 1);
+                }
+
+                poporon_kernel()->rs_syndrome_interleaved(rs, data, size, parity, stride, lanes, syndrome);
+
+                for (lane = 0; lane < lanes; lane++) {
+                    for (i = 0; i < size; i++) {
+                        codeword[i] = data[i * stride + lane];
+                    }
+                    for (i = 0; i < num_roots[r]; i++) {
+                        check[i] = parity[i * stride + lane];
+                    }
+                    poporon_rs_syndrome_scalar(rs, codeword, size, check, expected);
+
+                    for (i = 0; i < num_roots[r]; i++) {
+                        TEST_ASSERT_EQUAL_UINT8(rs->gf->log2exp[expected[i]], syndrome[i * stride + lane]);
+                    }
+                }
+            }
+
+            poporon_rs_destroy(rs);
+        }
+    }
+
+    free(data);
+    free(parity);
+    free(syndrome);
+}
+
+static const rs_params_t rs16_params[] = {
+    {16, 0x100B, 1, 1},
+    {16, 0x100B, 0, 7},
+    {10, 0x409, 1, 1},
+};
+
+static const size_t rs16_sizes[] = {1, 7, 8, 9, 200, 255, 256, 1000, 1023};
+
+/* error locator with roots at the first, the middle and the last position of the shortened codeword */
+static void check_rs_chien_u16(const poporon_rs_t *rs, int32_t padding)
+{
+    uint16_t locator[4], logs[4], registers[4], roots[4], locations[4], expected_roots[4], expected_locations[4];
+    uint16_t degree, count, expected_count, step, root, inverse, j;
+    uint32_t positions[3];
+    size_t e;
+
+    positions[0] = (uint32_t)padding;
+    positions[1] = ((uint32_t)padding + rs->gf->field_size) / 2;
+    positions[2] = rs->gf->field_size - 1;
+
+    step = gf_mod(rs->gf, rs->primitive_element);
+    locator[0] = 1;
+    degree = 0;
+
+    for (e = 0; e < 3; e++) {
+        if (e > 0 && positions[e] == positions[e - 1]) {
+            continue;
+        }
+
+        root = gf_mod(rs->gf, (positions[e] + 1) * (uint32_t)step);
+        inverse = rs->gf->log2exp[gf_mod(rs->gf, (uint32_t)rs->gf->field_size - root)];
+        locator[++degree] = 0;
+        for (j = degree; j > 0; j--) {
+            locator[j] ^= gf_mul(rs->gf, inverse, locator[j - 1]);
+        }
+    }
+
+    for (j = 0; j <= degree; j++) {
+        logs[j] = rs->gf->exp2log[locator[j]];
+    }
+
+    expected_count = poporon_rs_chien_u16_scalar(rs, logs, degree, padding, registers, expected_roots,
+                                                 expected_locations);
+    count = poporon_kernel()->rs_chien_u16(rs, logs, degree, padding, registers, roots, locations);
+    TEST_ASSERT_EQUAL_UINT16(degree, expected_count);
+    TEST_ASSERT_EQUAL_UINT16(expected_count, count);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_roots, roots, count);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_locations, locations, count);
+}
+
+static void check_rs_u16_kernel(void)
+{
+    poporon_rs_t *rs;
+    uint16_t data[1023], parity[255], expected[255], syndrome[255], expected_syndrome[255];
+    size_t p, r, s, i, size;
+    bool error, expected_error;
+
+    for (p = 0; p < sizeof(rs16_params) / sizeof(rs16_params[0]); p++) {
+        for (r = 0; r < sizeof(num_roots); r += 2) {
+            rs = poporon_rs_create(rs16_params[p].symbol_size, rs16_params[p].generator_polynomial,
+                                   rs16_params[p].first_consecutive_root, rs16_params[p].primitive_element,
+                                   num_roots[r]);
+            TEST_ASSERT_NOT_NULL(rs);
+
+            for (s = 0; s < sizeof(rs16_sizes) / sizeof(rs16_sizes[0]); s++) {
+                size = rs16_sizes[s];
+                if (size + num_roots[r] > rs->gf->field_size) {
+                    continue;
+                }
+
+                /* bits above symbol_size are ignored by every kernel */
+                for (i = 0; i < size; i++) {
+                    data[i] = (uint16_t)rand();
+                }
+
+                poporon_rs_encode_u16_scalar(rs, data, size, expected);
+                poporon_kernel()->rs_encode_u16(rs, data, size, parity);
+                TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, parity, num_roots[r]);
+
+                error = poporon_kernel()->rs_syndrome_u16(rs, data, size, parity, syndrome);
+                TEST_ASSERT_FALSE(error);
+
+                data[size / 2] ^= 0x2A5;
+                parity[num_roots[r] - 1] ^= 0x1;
+
+                error = poporon_kernel()->rs_syndrome_u16(rs, data, size, parity, syndrome);
+                expected_error = poporon_rs_syndrome_u16_scalar(rs, data, size, parity, expected_syndrome);
+                TEST_ASSERT_TRUE(error);
+                TEST_ASSERT_EQUAL(expected_error, error);
+                TEST_ASSERT_EQUAL_UINT16_ARRAY(expected_syndrome, syndrome, num_roots[r]);
+
+                check_rs_chien_u16(rs, (int32_t)(rs->gf->field_size - size - num_roots[r]));
+
+                check_rs_chien_u16(rs, (int32_t)(rs->gf->field_size - size - num_roots[r]));
+            }
+
+            poporon_rs_destroy(rs);
+        }
+    }
+}
+
+static void check_gf_kernel(void)
+{
+    poporon_rs_t *rs;
+    uint8_t src[300], dst[300], expected[300], sources[5][300], coefficients[5];
+    const uint8_t *pointers[5];
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    size_t size, count, k;
+    uint16_t multiplier;
+
+    rs = poporon_rs_create(8, 0x11D, 1, 1, 16);
+    TEST_ASSERT_NOT_NULL(rs);
+
+    for (size = 1; size <= sizeof(src); size += 13) {
+        for (multiplier = 0; multiplier < 256; multiplier += 17) {
+            distinct_data(src, size, &state);
+            distinct_data(dst, size, &state);
+            memcpy(expected, dst, size);
+
+            poporon_gf_muladd_region_scalar(rs->gf, (uint8_t)multiplier, src, expected, size);
+            poporon_kernel()->gf_muladd_region(rs->gf, (uint8_t)multiplier, src, dst, size);
+            TEST_ASSERT_EQUAL_MEMORY(expected, dst, size);
+        }
+    }
+
+    /* dot products over up to five sources, the last one being dst itself */
+    for (size = 1; size <= sizeof(src); size += 29) {
+        for (count = 1; count <= 5; count++) {
+            distinct_data(coefficients, sizeof(coefficients), &state);
+            for (k = 0; k < count; k++) {
+                distinct_data(sources[k], size, &state);
+                pointers[k] = sources[k];
+            }
+
+            poporon_gf_dot_region_scalar(rs->gf, coefficients, pointers, count, expected, size);
+            memcpy(dst, sources[count - 1], size);
+            pointers[count - 1] = dst;
+            poporon_kernel()->gf_dot_region(rs->gf, coefficients, pointers, count, dst, size);
+            TEST_ASSERT_EQUAL_MEMORY(expected, dst, size);
+        }
+    }
+
+    poporon_rs_destroy(rs);
+}
+
+static void test_kernel_levels_match_scalar(void)
+{
+    poporon_simd_level_t level;
+
+    for (level = PPRN_SIMD_SCALAR; level <= PPRN_SIMD_WASM; level++) {
+        if (!poporon_simd_set_level(level)) {
+            continue;
+        }
+
+        check_rs_kernel();
+        check_rs_interleaved_kernel();
+        check_rs_u16_kernel();
+        check_gf_kernel();
+        check_ldpc_kernel();
+    }
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_kernel_level_selection);
+    RUN_TEST(test_kernel_levels_match_scalar);
+
+    return UNITY_END();
+}
@@ -23,6 +23,33 @@ void tearDown(void)
 {
 }
 
+/* the decoders write into a workspace, each call here gets a fresh one */
+static bool decode_hard(const poporon_ldpc_t *ldpc, uint8_t *codeword, uint32_t max_iterations,
+                        uint32_t *iterations_used)
+{
+    poporon_ldpc_workspace_t *workspace;
+    bool result;
+
+    workspace = poporon_ldpc_workspace_create(ldpc);
+    result = poporon_ldpc_decode_hard(ldpc, workspace, codeword, max_iterations, iterations_used);
+    poporon_ldpc_workspace_destroy(workspace);
+
+    return result;
+}
+
+static bool decode_soft(const poporon_ldpc_t *ldpc, const int8_t *llr, uint8_t *codeword, uint32_t max_iterations,
+                        uint32_t *iterations_used)
+{
+    poporon_ldpc_workspace_t *workspace;
+    bool result;
+
+    workspace = poporon_ldpc_workspace_create(ldpc);
+    result = poporon_ldpc_decode_soft(ldpc, workspace, llr, codeword, max_iterations, iterations_used);
+    poporon_ldpc_workspace_destroy(workspace);
+
+    return result;
+}
+
 static void test_ldpc_create_destroy(void)
 {
     poporon_ldpc_t *ldpc;
@@ -129,7 +156,7 @@ static void test_ldpc_decode_hard_no_errors(void)
     memcpy(codeword, info, info_size);
     memcpy(codeword + info_size, parity, parity_size);
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 50, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 50, &iterations));
     TEST_ASSERT_EQUAL(0, iterations);
     TEST_ASSERT_EQUAL_MEMORY(info, codeword, info_size);
 
@@ -174,7 +201,7 @@ static void test_ldpc_decode_hard_with_errors(void)
 
     TEST_ASSERT_FALSE(poporon_ldpc_check(ldpc, codeword));
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 50, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 50, &iterations));
     TEST_ASSERT_GREATER_THAN(0, iterations);
     TEST_ASSERT_EQUAL_MEMORY(original, codeword, codeword_size);
 
@@ -223,7 +250,7 @@ static void test_ldpc_decode_soft_basic(void)
         llr[i] = bit ? -64 : 64;
     }
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_soft(ldpc, llr, decoded, 50, &iterations));
+    TEST_ASSERT_TRUE(decode_soft(ldpc, llr, decoded, 50, &iterations));
     TEST_ASSERT_EQUAL_MEMORY(codeword, decoded, codeword_size);
 
     free(info);
@@ -278,7 +305,7 @@ static void test_ldpc_decode_soft_with_noise(void)
     llr[50] = -llr[50];
     llr[100] = -llr[100];
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_soft(ldpc, llr, decoded, 50, &iterations));
+    TEST_ASSERT_TRUE(decode_soft(ldpc, llr, decoded, 50, &iterations));
     TEST_ASSERT_EQUAL_MEMORY(codeword, decoded, codeword_size);
 
     free(info);
@@ -320,7 +347,7 @@ static void test_ldpc_various_rates(void)
         memcpy(codeword + info_size, parity, parity_size);
 
         TEST_ASSERT_TRUE(poporon_ldpc_check(ldpc, codeword));
-        TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 50, &iterations));
+        TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 50, &iterations));
         TEST_ASSERT_EQUAL_MEMORY(info, codeword, info_size);
 
         free(info);
@@ -367,7 +394,7 @@ static void test_ldpc_decode_hard_block256_byte_errors(void)
 
     TEST_ASSERT_FALSE(poporon_ldpc_check(ldpc, codeword));
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 100, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 100, &iterations));
     TEST_ASSERT_GREATER_THAN(0, iterations);
     TEST_ASSERT_EQUAL_MEMORY(original, codeword, codeword_size);
 
@@ -390,8 +417,8 @@ static void test_ldpc_null_params(void)
     TEST_ASSERT_FALSE(poporon_ldpc_encode(ldpc, NULL, parity));
     TEST_ASSERT_FALSE(poporon_ldpc_encode(ldpc, info, NULL));
 
-    TEST_ASSERT_FALSE(poporon_ldpc_decode_hard(NULL, codeword, 50, NULL));
-    TEST_ASSERT_FALSE(poporon_ldpc_decode_hard(ldpc, NULL, 50, NULL));
+    TEST_ASSERT_FALSE(decode_hard(NULL, codeword, 50, NULL));
+    TEST_ASSERT_FALSE(decode_hard(ldpc, NULL, 50, NULL));
 
     TEST_ASSERT_FALSE(poporon_ldpc_check(NULL, codeword));
     TEST_ASSERT_FALSE(poporon_ldpc_check(ldpc, NULL));
@@ -436,7 +463,7 @@ static void test_ldpc_burst_resistant_config(void)
         codeword[i] ^= 0xFF;
     }
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 100, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 100, &iterations));
     TEST_ASSERT_TRUE(poporon_ldpc_check(ldpc, codeword));
 
     TEST_ASSERT_EQUAL_MEMORY(info, codeword, sizeof(info));
@@ -486,13 +513,13 @@ static void test_ldpc_burst_error_resistance(void)
             codeword_burst_resistant[i] ^= 0xFF;
         }
 
-        if (poporon_ldpc_decode_hard(ldpc_default, codeword_default, 100, &iter_default)) {
+        if (decode_hard(ldpc_default, codeword_default, 100, &iter_default)) {
             if (memcmp(codeword_default, info, sizeof(info)) == 0) {
                 default_success++;
             }
         }
 
-        if (poporon_ldpc_decode_hard(ldpc_burst_resistant, codeword_burst_resistant, 100, &iter_burst_resistant)) {
+        if (decode_hard(ldpc_burst_resistant, codeword_burst_resistant, 100, &iter_burst_resistant)) {
             if (memcmp(codeword_burst_resistant, info, sizeof(info)) == 0) {
                 burst_resistant_success++;
             }
@@ -581,7 +608,7 @@ static void test_ldpc_interleave_burst_correction(void)
         received[i] ^= 0xFF;
     }
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, received, 100, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, received, 100, &iterations));
     TEST_ASSERT_TRUE(poporon_ldpc_check(ldpc, received));
 
     TEST_ASSERT_EQUAL_MEMORY(info, received, sizeof(info));
@@ -613,7 +640,7 @@ static void test_ldpc_qc_random_basic(void)
 
     TEST_ASSERT_TRUE(poporon_ldpc_check(ldpc, codeword));
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 50, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 50, &iterations));
     TEST_ASSERT_EQUAL(0, iterations);
     TEST_ASSERT_EQUAL_MEMORY(info, codeword, sizeof(info));
 
@@ -649,7 +676,7 @@ static void test_ldpc_qc_random_with_errors(void)
 
     TEST_ASSERT_FALSE(poporon_ldpc_check(ldpc, codeword));
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 100, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 100, &iterations));
     TEST_ASSERT_GREATER_THAN(0, iterations);
     TEST_ASSERT_EQUAL_MEMORY(original, codeword, sizeof(codeword));
 
@@ -691,7 +718,7 @@ static void test_ldpc_qc_random_various_rates(void)
         memcpy(codeword + info_size, parity, parity_size);
 
         TEST_ASSERT_TRUE(poporon_ldpc_check(ldpc, codeword));
-        TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, codeword, 50, &iterations));
+        TEST_ASSERT_TRUE(decode_hard(ldpc, codeword, 50, &iterations));
         TEST_ASSERT_EQUAL_MEMORY(info, codeword, info_size);
 
         free(info);
@@ -731,7 +758,7 @@ static void test_ldpc_qc_random_with_interleaver(void)
         received[i] ^= 0xFF;
     }
 
-    TEST_ASSERT_TRUE(poporon_ldpc_decode_hard(ldpc, received, 100, &iterations));
+    TEST_ASSERT_TRUE(decode_hard(ldpc, received, 100, &iterations));
     TEST_ASSERT_TRUE(poporon_ldpc_check(ldpc, received));
     TEST_ASSERT_EQUAL_MEMORY(info, received, sizeof(info));
 
@@ -0,0 +1,215 @@
+/*
+ * libpoporon - test_pool.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <poporon.h>
+
+#include "unity.h"
+#include "util.h"
+
+#define POOL_THREADS 4
+#define POOL_FRAMES  96
+#define POOL_DATA    223
+#define POOL_PARITY  64
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+void test_pool_create_destroy(void)
+{
+    poporon_pool_t *pool;
+    size_t num_threads;
+
+    pool = poporon_pool_create(POOL_THREADS);
+    TEST_ASSERT_NOT_NULL(pool);
+    num_threads = poporon_pool_get_num_threads(pool);
+    /* single threaded builds run every job on the caller */
+    TEST_ASSERT_TRUE(num_threads == POOL_THREADS || num_threads == 1);
+    poporon_pool_destroy(pool);
+
+    pool = poporon_pool_create(0);
+    TEST_ASSERT_NOT_NULL(pool);
+    TEST_ASSERT_GREATER_OR_EQUAL(1, poporon_pool_get_num_threads(pool));
+    poporon_pool_destroy(pool);
+
+    poporon_pool_destroy(NULL);
+    TEST_ASSERT_EQUAL(0, poporon_pool_get_num_threads(NULL));
+}
+
+void test_pool_rs_batch(void)
+{
+    poporon_pool_t *pool;
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint8_t data[POOL_FRAMES][POOL_DATA], original[POOL_FRAMES][POOL_DATA], parity[POOL_FRAMES][32], expected[32];
+    uint8_t *data_list[POOL_FRAMES], *parity_list[POOL_FRAMES];
+    size_t corrected[POOL_FRAMES], i;
+    bool results[POOL_FRAMES];
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+    pool = poporon_pool_create(POOL_THREADS);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    for (i = 0; i < POOL_FRAMES; i++) {
+        random_data(data[i], POOL_DATA);
+        data[i][0] = (uint8_t)i;
+        memcpy(original[i], data[i], POOL_DATA);
+        data_list[i] = data[i];
+        parity_list[i] = parity[i];
+    }
+
+    TEST_ASSERT_TRUE(poporon_pool_encode_batch(pool, pprn, data_list, POOL_DATA, parity_list, POOL_FRAMES, results));
+    for (i = 0; i < POOL_FRAMES; i++) {
+        TEST_ASSERT_TRUE(results[i]);
+        TEST_ASSERT_TRUE(poporon_encode(pprn, data[i], POOL_DATA, expected));
+        TEST_ASSERT_EQUAL_MEMORY(expected, parity[i], 32);
+    }
+
+    for (i = 0; i < POOL_FRAMES; i++) {
+        break_data(data[i], POOL_DATA, (uint32_t)(i % 16));
+    }
+    /* beyond the 16 symbol correction capability */
+    break_data(data[POOL_FRAMES / 2], POOL_DATA, 30);
+
+    TEST_ASSERT_FALSE(
+        poporon_pool_decode_batch(pool, pprn, data_list, POOL_DATA, parity_list, POOL_FRAMES, results, corrected));
+    for (i = 0; i < POOL_FRAMES; i++) {
+        if (i == POOL_FRAMES / 2) {
+            TEST_ASSERT_FALSE(results[i]);
+            continue;
+        }
+        TEST_ASSERT_TRUE(results[i]);
+        TEST_ASSERT_EQUAL(i % 16, corrected[i]);
+        TEST_ASSERT_EQUAL_MEMORY(original[i], data[i], POOL_DATA);
+    }
+
+    /* the pool is reusable, and a clean batch succeeds as a whole */
+    memcpy(data[POOL_FRAMES / 2], original[POOL_FRAMES / 2], POOL_DATA);
+    TEST_ASSERT_TRUE(
+        poporon_pool_decode_batch(pool, pprn, data_list, POOL_DATA, parity_list, POOL_FRAMES, NULL, corrected));
+    TEST_ASSERT_TRUE(poporon_pool_decode_batch(pool, pprn, data_list, POOL_DATA, parity_list, 0, NULL, NULL));
+
+    poporon_pool_destroy(pool);
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+void test_pool_mixed_jobs(void)
+{
+    poporon_pool_t *pool;
+    poporon_config_t *configs[3];
+    poporon_t *codecs[3];
+    poporon_pool_job_t jobs[POOL_FRAMES];
+    uint8_t data[POOL_FRAMES][POOL_DATA], original[POOL_FRAMES][POOL_DATA], parity[POOL_FRAMES][POOL_PARITY];
+    size_t i;
+
+    /* two RS codes with different root counts and an LDPC code share the worker workspaces */
+    configs[0] = poporon_config_rs_default();
+    configs[1] = poporon_rs_config_create(8, 0x11D, 1, 1, 10, NULL, NULL);
+    configs[2] = poporon_config_ldpc_default(64, PPRN_LDPC_RATE_1_2);
+    for (i = 0; i < 3; i++) {
+        TEST_ASSERT_NOT_NULL(configs[i]);
+        codecs[i] = poporon_create(configs[i]);
+        TEST_ASSERT_NOT_NULL(codecs[i]);
+    }
+    TEST_ASSERT_TRUE(poporon_get_parity_size(codecs[2]) <= POOL_PARITY);
+
+    pool = poporon_pool_create(POOL_THREADS);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    for (i = 0; i < POOL_FRAMES; i++) {
+        jobs[i].pprn = codecs[i % 3];
+        jobs[i].data = data[i];
+        jobs[i].size = (i % 3 == 2) ? 64 : POOL_DATA;
+        jobs[i].parity = parity[i];
+        random_data(data[i], jobs[i].size);
+        memcpy(original[i], data[i], jobs[i].size);
+    }
+
+    TEST_ASSERT_TRUE(poporon_pool_encode(pool, jobs, POOL_FRAMES));
+
+    for (i = 0; i < POOL_FRAMES; i++) {
+        TEST_ASSERT_TRUE(jobs[i].result);
+        if (i % 3 == 2) {
+            data[i][5] ^= 0x10;
+        } else {
+            break_data(data[i], jobs[i].size, (uint32_t)(i % 3 ? 4 : 12));
+        }
+    }
+
+    TEST_ASSERT_TRUE(poporon_pool_decode(pool, jobs, POOL_FRAMES));
+    for (i = 0; i < POOL_FRAMES; i++) {
+        TEST_ASSERT_TRUE(jobs[i].result);
+        TEST_ASSERT_EQUAL_MEMORY(original[i], data[i], jobs[i].size);
+        if (i % 3 != 2) {
+            TEST_ASSERT_EQUAL(i % 3 ? 4 : 12, jobs[i].corrected_num);
+        }
+    }
+
+    /* a job without a codec fails on its own */
+    jobs[7].pprn = NULL;
+    TEST_ASSERT_FALSE(poporon_pool_decode(pool, jobs, POOL_FRAMES));
+    TEST_ASSERT_FALSE(jobs[7].result);
+    TEST_ASSERT_TRUE(jobs[9].result);
+
+    poporon_pool_destroy(pool);
+    for (i = 0; i < 3; i++) {
+        poporon_destroy(codecs[i]);
+        poporon_config_destroy(configs[i]);
+    }
+}
+
+void test_pool_null(void)
+{
+    poporon_pool_t *pool;
+    poporon_config_t *config;
+    poporon_t *pprn;
+    poporon_pool_job_t job;
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+    pool = poporon_pool_create(2);
+    TEST_ASSERT_NOT_NULL(pool);
+
+    memset(&job, 0, sizeof(job));
+    TEST_ASSERT_FALSE(poporon_pool_encode(NULL, &job, 1));
+    TEST_ASSERT_FALSE(poporon_pool_decode(pool, NULL, 1));
+    TEST_ASSERT_FALSE(poporon_pool_decode(pool, &job, 1));
+    TEST_ASSERT_FALSE(poporon_pool_encode_batch(pool, NULL, NULL, 10, NULL, 1, NULL));
+    TEST_ASSERT_FALSE(poporon_pool_decode_batch(pool, pprn, NULL, 10, NULL, 1, NULL, NULL));
+
+    poporon_pool_destroy(pool);
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pool_create_destroy);
+    RUN_TEST(test_pool_rs_batch);
+    RUN_TEST(test_pool_mixed_jobs);
+    RUN_TEST(test_pool_null);
+
+    return UNITY_END();
+}
@@ -0,0 +1,190 @@
+/*
+ * libpoporon - test_registry.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <unity.h>
+
+#include "internal/ldpc.h"
+
+static size_t created, destroyed;
+
+static void *counting_create(const void *key)
+{
+    created++;
+
+    return malloc(*(const uint32_t *)key);
+}
+
+static void counting_destroy(void *object)
+{
+    destroyed++;
+    free(object);
+}
+
+void setUp(void)
+{
+    created = 0;
+    destroyed = 0;
+}
+
+void tearDown(void)
+{
+}
+
+static void test_registry_refcount(void)
+{
+    uint32_t key_a = 16, key_b = 32;
+    void *a1, *a2, *b;
+    size_t baseline;
+
+    baseline = poporon_registry_size();
+
+    a1 = poporon_registry_acquire(REGISTRY_GF, &key_a, sizeof(key_a), counting_create, counting_destroy);
+    a2 = poporon_registry_acquire(REGISTRY_GF, &key_a, sizeof(key_a), counting_create, counting_destroy);
+    b = poporon_registry_acquire(REGISTRY_GF, &key_b, sizeof(key_b), counting_create, counting_destroy);
+    TEST_ASSERT_NOT_NULL(a1);
+    TEST_ASSERT_NOT_NULL(b);
+    TEST_ASSERT_TRUE(a1 == a2);
+    TEST_ASSERT_TRUE(a1 != b);
+    TEST_ASSERT_EQUAL(2, created);
+    TEST_ASSERT_EQUAL(baseline + 2, poporon_registry_size());
+
+    /* the same key bytes under another kind are a different entry */
+    a2 = poporon_registry_acquire(REGISTRY_LDPC, &key_a, sizeof(key_a), counting_create, counting_destroy);
+    TEST_ASSERT_TRUE(a1 != a2);
+    TEST_ASSERT_TRUE(poporon_registry_release(a2));
+
+    TEST_ASSERT_TRUE(poporon_registry_release(a1));
+    TEST_ASSERT_EQUAL(1, destroyed);
+    TEST_ASSERT_TRUE(poporon_registry_release(a1));
+    TEST_ASSERT_EQUAL(2, destroyed);
+    TEST_ASSERT_TRUE(poporon_registry_release(b));
+    TEST_ASSERT_EQUAL(3, destroyed);
+    TEST_ASSERT_EQUAL(baseline, poporon_registry_size());
+
+    TEST_ASSERT_FALSE(poporon_registry_release(&key_a));
+    TEST_ASSERT_FALSE(poporon_registry_release(NULL));
+}
+
+static void test_registry_rs_bch_share(void)
+{
+    poporon_config_t *config_a, *config_b, *config_bch, *config_rs16;
+    poporon_t *a1, *a2, *b, *bch, *rs16;
+    size_t baseline, field;
+
+    baseline = poporon_registry_size();
+
+    config_a = poporon_rs_config_create(8, 0x11D, 1, 1, 32, NULL, NULL);
+    config_b = poporon_rs_config_create(8, 0x11D, 1, 1, 16, NULL, NULL);
+    config_bch = poporon_bch_config_create(4, 0x13, 3);
+    config_rs16 = poporon_rs_config_create(4, 0x13, 1, 1, 4, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(config_a);
+    TEST_ASSERT_NOT_NULL(config_b);
+    TEST_ASSERT_NOT_NULL(config_bch);
+    TEST_ASSERT_NOT_NULL(config_rs16);
+
+    a1 = poporon_create(config_a);
+    a2 = poporon_create(config_a);
+    b = poporon_create(config_b);
+    TEST_ASSERT_NOT_NULL(a1);
+    TEST_ASSERT_NOT_NULL(a2);
+    TEST_ASSERT_NOT_NULL(b);
+
+    /* one code for identical parameters, one field for every code over it */
+    TEST_ASSERT_TRUE(a1->ctx.rs.rs == a2->ctx.rs.rs);
+    TEST_ASSERT_TRUE(a1->ctx.rs.rs != b->ctx.rs.rs);
+    TEST_ASSERT_TRUE(a1->ctx.rs.rs->gf == b->ctx.rs.rs->gf);
+    /* a field served from static tables is shared without an entry */
+    field = a1->ctx.rs.rs->gf->is_static ? 0 : 1;
+    TEST_ASSERT_EQUAL(baseline + field + 2, poporon_registry_size());
+
+    /* a BCH code registers its field, an RS code over that field then only adds itself */
+    bch = poporon_create(config_bch);
+    TEST_ASSERT_NOT_NULL(bch);
+    TEST_ASSERT_EQUAL(baseline + field + 3, poporon_registry_size());
+    rs16 = poporon_create(config_rs16);
+    TEST_ASSERT_NOT_NULL(rs16);
+    TEST_ASSERT_EQUAL(baseline + field + 4, poporon_registry_size());
+
+    /* the encode mode shapes the code, so it is part of the key */
+    TEST_ASSERT_TRUE(poporon_rs_config_set_encode_mode(config_a, PPRN_RS_ENCODE_SLICE_4));
+    poporon_destroy(a2);
+    a2 = poporon_create(config_a);
+    TEST_ASSERT_NOT_NULL(a2);
+    TEST_ASSERT_TRUE(a1->ctx.rs.rs != a2->ctx.rs.rs);
+    TEST_ASSERT_TRUE(a1->ctx.rs.rs->gf == a2->ctx.rs.rs->gf);
+
+    poporon_destroy(rs16);
+    poporon_destroy(bch);
+    poporon_destroy(b);
+    poporon_destroy(a2);
+    poporon_destroy(a1);
+    TEST_ASSERT_EQUAL(baseline, poporon_registry_size());
+
+    poporon_config_destroy(config_rs16);
+    poporon_config_destroy(config_bch);
+    poporon_config_destroy(config_b);
+    poporon_config_destroy(config_a);
+}
+
+static void test_registry_ldpc_share(void)
+{
+    poporon_config_t *config, *config_seed;
+    poporon_t *a1, *a2, *b;
+    uint8_t data[64], parity[64], expected[64];
+    size_t baseline;
+
+    baseline = poporon_registry_size();
+
+    config = poporon_ldpc_config_create(64, PPRN_LDPC_RATE_1_2, PPRN_LDPC_RANDOM, 3, false, false, false, 0, 0, 0,
+                                        NULL, 0, 1);
+    config_seed = poporon_ldpc_config_create(64, PPRN_LDPC_RATE_1_2, PPRN_LDPC_RANDOM, 3, false, false, false, 0, 0,
+                                             0, NULL, 0, 2);
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_NOT_NULL(config_seed);
+
+    a1 = poporon_create(config);
+    a2 = poporon_create(config);
+    b = poporon_create(config_seed);
+    TEST_ASSERT_NOT_NULL(a1);
+    TEST_ASSERT_NOT_NULL(a2);
+    TEST_ASSERT_NOT_NULL(b);
+
+    TEST_ASSERT_TRUE(a1->ctx.ldpc.ldpc == a2->ctx.ldpc.ldpc);
+    TEST_ASSERT_TRUE(a1->ctx.ldpc.ldpc != b->ctx.ldpc.ldpc);
+    TEST_ASSERT_TRUE(a1->workspace != a2->workspace);
+
+    /* the shared code outlives the instance that created it */
+    memset(data, 0xA5, sizeof(data));
+    TEST_ASSERT_TRUE(poporon_encode(a1, data, sizeof(data), expected));
+    poporon_destroy(a1);
+    TEST_ASSERT_TRUE(poporon_encode(a2, data, sizeof(data), parity));
+    TEST_ASSERT_EQUAL_MEMORY(expected, parity, poporon_get_parity_size(a2));
+
+    poporon_destroy(b);
+    poporon_destroy(a2);
+    TEST_ASSERT_EQUAL(baseline, poporon_registry_size());
+
+    poporon_config_destroy(config_seed);
+    poporon_config_destroy(config);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_registry_refcount);
+    RUN_TEST(test_registry_rs_bch_share);
+    RUN_TEST(test_registry_ldpc_share);
+
+    return UNITY_END();
+}
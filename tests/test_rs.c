@@ -82,12 +82,350 @@ void test_rs_configurations(void)
     poporon_rs_destroy(rs);
 }
 
+static void reference_encode(poporon_rs_t *rs, const uint8_t *data, size_t size, uint8_t *parity)
+{
+    poporon_gf_t *gf = rs->gf;
+    uint16_t i, j, fb;
+
+    memset(parity, 0, rs->num_roots);
+
+    for (i = 0; i < size; i++) {
+        fb = gf->exp2log[data[i] ^ parity[0]];
+
+        for (j = 1; j < rs->num_roots; j++) {
+            parity[j - 1] = parity[j];
+            if (fb != gf->field_size) {
+                parity[j - 1] ^= gf->log2exp[(fb + rs->generator_polynomial[rs->num_roots - j]) % gf->field_size];
+            }
+        }
+
+        parity[rs->num_roots - 1] =
+            (fb != gf->field_size) ? gf->log2exp[(fb + rs->generator_polynomial[0]) % gf->field_size] : 0;
+    }
+}
+
+void test_rs_encode_matches_reference(void)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint8_t data[255], parity[255], expected[255];
+    uint8_t roots[] = {2, 8, 15, 16, 17, 31, 32, 33, 48, 64, 100};
+    size_t i, size;
+
+    random_data(data, sizeof(data));
+
+    for (i = 0; i < sizeof(roots); i++) {
+        config = poporon_rs_config_create(SYMBOL_SIZE, GENERATER_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT, PRIMITIVE_ELEMENT,
+                                          roots[i], NULL, NULL);
+        TEST_ASSERT_NOT_NULL(config);
+        pprn = poporon_create(config);
+        TEST_ASSERT_NOT_NULL(pprn);
+
+        for (size = 1; size <= (size_t)(255 - roots[i]); size += 37) {
+            reference_encode(pprn->ctx.rs.rs, data, size, expected);
+            TEST_ASSERT_TRUE(poporon_encode(pprn, data, size, parity));
+            TEST_ASSERT_EQUAL_MEMORY(expected, parity, roots[i]);
+        }
+
+        poporon_destroy(pprn);
+        poporon_config_destroy(config);
+    }
+}
+
+void test_rs_encode_modes(void)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint8_t data[255], parity[255], expected[255], received[255];
+    uint8_t roots[] = {2, 4, 7, 8, 9, 16, 32, 33, 64, 100};
+    poporon_rs_encode_mode_t modes[] = {PPRN_RS_ENCODE_MATRIX, PPRN_RS_ENCODE_SLICE_4, PPRN_RS_ENCODE_SLICE_8};
+    size_t i, m, size, corrected;
+
+    random_data(data, sizeof(data));
+
+    for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        for (i = 0; i < sizeof(roots); i++) {
+            config = poporon_rs_config_create(SYMBOL_SIZE, GENERATER_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT,
+                                              PRIMITIVE_ELEMENT, roots[i], NULL, NULL);
+            TEST_ASSERT_NOT_NULL(config);
+            TEST_ASSERT_TRUE(poporon_rs_config_set_encode_mode(config, modes[m]));
+            pprn = poporon_create(config);
+            TEST_ASSERT_NOT_NULL(pprn);
+
+            for (size = 1; size <= (size_t)(255 - roots[i]); size += 13) {
+                reference_encode(pprn->ctx.rs.rs, data, size, expected);
+                TEST_ASSERT_TRUE(poporon_encode(pprn, data, size, parity));
+                TEST_ASSERT_EQUAL_MEMORY(expected, parity, roots[i]);
+
+                memcpy(received, data, size);
+                break_data(received, size, roots[i] / 2 < size ? roots[i] / 2 : (uint32_t)size);
+                TEST_ASSERT_TRUE(poporon_decode(pprn, received, size, parity, &corrected));
+                TEST_ASSERT_EQUAL_MEMORY(data, received, size);
+            }
+
+            poporon_destroy(pprn);
+            poporon_config_destroy(config);
+        }
+    }
+}
+
+void test_rs_encode_mode_invalid(void)
+{
+    poporon_config_t *config;
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_FALSE(poporon_rs_config_set_encode_mode(config, (poporon_rs_encode_mode_t)3));
+    TEST_ASSERT_FALSE(poporon_rs_config_set_encode_mode(NULL, PPRN_RS_ENCODE_SLICE_8));
+    TEST_ASSERT_TRUE(poporon_rs_config_set_encode_mode(config, PPRN_RS_ENCODE_LFSR));
+    poporon_config_destroy(config);
+
+    config = poporon_config_bch_default();
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_FALSE(poporon_rs_config_set_encode_mode(config, PPRN_RS_ENCODE_SLICE_4));
+    poporon_config_destroy(config);
+}
+
+/* riBM and Berlekamp-Massey find the same locator up to a scale, so both modes agree on every outcome */
+typedef struct {
+    poporon_rs_encode_mode_t encode_mode;
+    poporon_rs_decode_mode_t decode_mode;
+    poporon_rs_syndrome_mode_t syndrome_mode;
+} rs_modes_t;
+
+/* a default instance against one with the given modes */
+static void check_decode_modes(uint8_t symbol_size, uint16_t generator_polynomial, uint16_t first_consecutive_root,
+                               uint16_t primitive_element, uint8_t num_roots, size_t size, const rs_modes_t *modes)
+{
+    poporon_config_t *config;
+    poporon_t *reference, *candidate;
+    uint8_t data[255], parity[255], received[255], received_parity[255], expected[255], expected_parity[255];
+    size_t i, trial, corrected, expected_corrected;
+    bool result, expected_result;
+
+    config = poporon_rs_config_create(symbol_size, generator_polynomial, first_consecutive_root, primitive_element,
+                                      num_roots, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(config);
+    reference = poporon_create(config);
+    TEST_ASSERT_TRUE(poporon_rs_config_set_encode_mode(config, modes->encode_mode));
+    TEST_ASSERT_TRUE(poporon_rs_config_set_decode_mode(config, modes->decode_mode));
+    TEST_ASSERT_TRUE(poporon_rs_config_set_syndrome_mode(config, modes->syndrome_mode));
+    candidate = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(reference);
+    TEST_ASSERT_NOT_NULL(candidate);
+
+    for (trial = 0; trial < 40; trial++) {
+        for (i = 0; i < size; i++) {
+            data[i] = (uint8_t)(rand() & ((1 << symbol_size) - 1));
+        }
+        TEST_ASSERT_TRUE(poporon_encode(reference, data, size, parity));
+
+        /* up to two errors past the capability, some of them in the parity */
+        memcpy(expected, data, size);
+        memcpy(expected_parity, parity, num_roots);
+        for (i = (size_t)rand() % (num_roots / 2 + 3); i > 0; i--) {
+            if (rand() % 4 == 0) {
+                expected_parity[(size_t)rand() % num_roots] ^= (uint8_t)(1 + rand() % ((1 << symbol_size) - 1));
+            } else {
+                expected[(size_t)rand() % size] ^= (uint8_t)(1 + rand() % ((1 << symbol_size) - 1));
+            }
+        }
+        memcpy(received, expected, size);
+        memcpy(received_parity, expected_parity, num_roots);
+
+        expected_corrected = 0;
+        corrected = 0;
+        expected_result = poporon_decode(reference, expected, size, expected_parity, &expected_corrected);
+        result = poporon_decode(candidate, received, size, received_parity, &corrected);
+        TEST_ASSERT_EQUAL(expected_result, result);
+        TEST_ASSERT_EQUAL(expected_corrected, corrected);
+        TEST_ASSERT_EQUAL_MEMORY(expected, received, size);
+        TEST_ASSERT_EQUAL_MEMORY(expected_parity, received_parity, num_roots);
+    }
+
+    poporon_destroy(reference);
+    poporon_destroy(candidate);
+    poporon_config_destroy(config);
+}
+
+static void check_decode_modes_all(const rs_modes_t *modes)
+{
+    static const poporon_simd_level_t levels[] = {PPRN_SIMD_SCALAR, PPRN_SIMD_AUTO};
+    uint8_t roots[] = {2, 3, 8, 15, 16, 32, 33, 64, 100};
+    size_t l, i;
+
+    for (l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        TEST_ASSERT_TRUE(poporon_simd_set_level(levels[l]));
+
+        for (i = 0; i < sizeof(roots); i++) {
+            check_decode_modes(SYMBOL_SIZE, GENERATER_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT, PRIMITIVE_ELEMENT, roots[i],
+                               (size_t)(255 - roots[i]), modes);
+            check_decode_modes(SYMBOL_SIZE, 0x187, 112, 11, roots[i], 50, modes);
+        }
+
+        check_decode_modes(4, 0x13, 1, 2, 6, 9, modes);
+    }
+
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+}
+
+void test_rs_decode_modes(void)
+{
+    rs_modes_t modes = {PPRN_RS_ENCODE_LFSR, PPRN_RS_DECODE_RIBM, PPRN_RS_SYNDROME_HORNER};
+
+    check_decode_modes_all(&modes);
+}
+
+/* the remainder comes from whichever encoder the code carries */
+void test_rs_syndrome_modes(void)
+{
+    rs_modes_t modes[] = {
+        {PPRN_RS_ENCODE_LFSR, PPRN_RS_DECODE_BM, PPRN_RS_SYNDROME_REMAINDER},
+        {PPRN_RS_ENCODE_MATRIX, PPRN_RS_DECODE_RIBM, PPRN_RS_SYNDROME_REMAINDER},
+        {PPRN_RS_ENCODE_SLICE_8, PPRN_RS_DECODE_BM, PPRN_RS_SYNDROME_REMAINDER},
+    };
+    size_t m;
+
+    for (m = 0; m < sizeof(modes) / sizeof(modes[0]); m++) {
+        check_decode_modes_all(&modes[m]);
+    }
+}
+
+/* the closed forms for one and two errors, every single error position of data || parity then random pairs */
+static void check_few_errors(uint8_t symbol_size, uint16_t generator_polynomial, uint16_t first_consecutive_root,
+                             uint16_t primitive_element, uint8_t num_roots, size_t size)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint8_t data[255], parity[255], received[255], received_parity[255], mask;
+    size_t i, trial, position[2], count, corrected, e;
+
+    config = poporon_rs_config_create(symbol_size, generator_polynomial, first_consecutive_root, primitive_element,
+                                      num_roots, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    mask = (uint8_t)((1 << symbol_size) - 1);
+    for (i = 0; i < size; i++) {
+        data[i] = (uint8_t)rand() & mask;
+    }
+    TEST_ASSERT_TRUE(poporon_encode(pprn, data, size, parity));
+
+    for (trial = 0; trial < size + num_roots + 200; trial++) {
+        count = (trial < size + num_roots || num_roots < 4) ? 1 : 2;
+        position[0] = trial < size + num_roots ? trial : (size_t)rand() % (size + num_roots);
+        do {
+            position[1] = (size_t)rand() % (size + num_roots);
+        } while (position[1] == position[0]);
+
+        memcpy(received, data, size);
+        memcpy(received_parity, parity, num_roots);
+        for (e = 0; e < count; e++) {
+            if (position[e] < size) {
+                received[position[e]] ^= (uint8_t)(1 + rand() % mask);
+            } else {
+                received_parity[position[e] - size] ^= (uint8_t)(1 + rand() % mask);
+            }
+        }
+
+        corrected = 0;
+        TEST_ASSERT_TRUE(poporon_decode(pprn, received, size, received_parity, &corrected));
+        TEST_ASSERT_EQUAL(count, corrected);
+        TEST_ASSERT_EQUAL_MEMORY(data, received, size);
+        TEST_ASSERT_EQUAL_MEMORY(parity, received_parity, num_roots);
+    }
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+void test_rs_decode_few_errors(void)
+{
+    uint8_t roots[] = {2, 3, 4, 5, 16, 32};
+    size_t i;
+
+    for (i = 0; i < sizeof(roots) / sizeof(roots[0]); i++) {
+        check_few_errors(SYMBOL_SIZE, GENERATER_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT, PRIMITIVE_ELEMENT, roots[i],
+                         (size_t)(255 - roots[i]));
+        check_few_errors(SYMBOL_SIZE, 0x187, 112, 11, roots[i], 50);
+    }
+
+    check_few_errors(4, 0x13, 1, 2, 4, 11);
+    check_few_errors(4, 0x13, 0, 2, 6, 5);
+}
+
+void test_rs_decode_ribm_erasures(void)
+{
+    poporon_erasure_t *erasure;
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint8_t data[200], received[200], parity[NUMBER_OF_ROOTS];
+    size_t count, corrected;
+
+    erasure = poporon_erasure_create(NUMBER_OF_ROOTS, NUMBER_OF_ROOTS);
+    TEST_ASSERT_NOT_NULL(erasure);
+    config = poporon_rs_config_create(SYMBOL_SIZE, GENERATER_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT, PRIMITIVE_ELEMENT,
+                                      NUMBER_OF_ROOTS, erasure, NULL);
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_TRUE(poporon_rs_config_set_decode_mode(config, PPRN_RS_DECODE_RIBM));
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    random_data(data, sizeof(data));
+    TEST_ASSERT_TRUE(poporon_encode(pprn, data, sizeof(data), parity));
+
+    for (count = 1; count <= NUMBER_OF_ROOTS; count++) {
+        poporon_erasure_reset(erasure);
+        memcpy(received, data, sizeof(data));
+        break_data_erasure(received, sizeof(data), (uint32_t)count, erasure);
+
+        corrected = 0;
+        TEST_ASSERT_TRUE(poporon_decode(pprn, received, sizeof(data), parity, &corrected));
+        TEST_ASSERT_EQUAL(count, corrected);
+        TEST_ASSERT_EQUAL_MEMORY(data, received, sizeof(data));
+    }
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+    poporon_erasure_destroy(erasure);
+}
+
+void test_rs_decode_mode_invalid(void)
+{
+    poporon_config_t *config;
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_FALSE(poporon_rs_config_set_decode_mode(config, (poporon_rs_decode_mode_t)2));
+    TEST_ASSERT_FALSE(poporon_rs_config_set_syndrome_mode(config, (poporon_rs_syndrome_mode_t)2));
+    TEST_ASSERT_FALSE(poporon_rs_config_set_decode_mode(NULL, PPRN_RS_DECODE_RIBM));
+    TEST_ASSERT_FALSE(poporon_rs_config_set_syndrome_mode(NULL, PPRN_RS_SYNDROME_REMAINDER));
+    TEST_ASSERT_TRUE(poporon_rs_config_set_decode_mode(config, PPRN_RS_DECODE_BM));
+    TEST_ASSERT_TRUE(poporon_rs_config_set_syndrome_mode(config, PPRN_RS_SYNDROME_HORNER));
+    poporon_config_destroy(config);
+
+    config = poporon_config_bch_default();
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_FALSE(poporon_rs_config_set_decode_mode(config, PPRN_RS_DECODE_RIBM));
+    TEST_ASSERT_FALSE(poporon_rs_config_set_syndrome_mode(config, PPRN_RS_SYNDROME_REMAINDER));
+    poporon_config_destroy(config);
+}
+
 int main(void)
 {
     UNITY_BEGIN();
 
     RUN_TEST(test_rs_create_destroy);
     RUN_TEST(test_rs_configurations);
+    RUN_TEST(test_rs_encode_matches_reference);
+    RUN_TEST(test_rs_encode_modes);
+    RUN_TEST(test_rs_encode_mode_invalid);
+    RUN_TEST(test_rs_decode_modes);
+    RUN_TEST(test_rs_syndrome_modes);
+    RUN_TEST(test_rs_decode_few_errors);
+    RUN_TEST(test_rs_decode_ribm_erasures);
+    RUN_TEST(test_rs_decode_mode_invalid);
 
     return UNITY_END();
 }
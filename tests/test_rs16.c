@@ -0,0 +1,463 @@
+/*
+ * libpoporon - test_rs16.c
+ *
+ * This file is part of libpoporon.
+ *
+ * Author: Go Kudo <zeriyoshi@gmail.com>
+ * SPDX-License-Identifier: MIT
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <poporon.h>
+#include <poporon/gf.h>
+
+#include "internal/common.h"
+
+#include "unity.h"
+#include "util.h"
+
+#define SYMBOL_SIZE            16
+#define GENERATOR_POLYNOMIAL   0x100B /* x^16 + x^12 + x^3 + x + 1, the x^16 term left out */
+#define FIRST_CONSECUTIVE_ROOT 1
+#define PRIMITIVE_ELEMENT      1
+#define NUMBER_OF_ROOTS        32
+#define DATA_SIZE              1000
+#define MAX_DATA_SIZE          (65535 - NUMBER_OF_ROOTS)
+
+static poporon_simd_level_t levels[] = {PPRN_SIMD_SCALAR, PPRN_SIMD_AUTO};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+    poporon_simd_set_level(PPRN_SIMD_AUTO);
+}
+
+static void random_symbols(uint16_t *out, size_t size)
+{
+    size_t i;
+
+    for (i = 0; i < size; i++) {
+        out[i] = (uint16_t)rand();
+    }
+}
+
+static poporon_t *create_rs16(poporon_erasure_t *erasure)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+
+    config = poporon_rs_config_create(SYMBOL_SIZE, GENERATOR_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT, PRIMITIVE_ELEMENT,
+                                      NUMBER_OF_ROOTS, erasure, NULL);
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    poporon_config_destroy(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    return pprn;
+}
+
+void test_rs16_field(void)
+{
+    poporon_gf_t *gf;
+
+    gf = poporon_gf_create(SYMBOL_SIZE, GENERATOR_POLYNOMIAL);
+    TEST_ASSERT_NOT_NULL(gf);
+    TEST_ASSERT_EQUAL_UINT16(65535, gf->field_size);
+    TEST_ASSERT_EQUAL_UINT16(0, poporon_gf_mod(gf, 65535));
+    TEST_ASSERT_EQUAL_UINT16(1, poporon_gf_mod(gf, 65536));
+    TEST_ASSERT_EQUAL_UINT16(65534, poporon_gf_mod(gf, 3 * 65535 - 1));
+    TEST_ASSERT_EQUAL_UINT16(1, gf->log2exp[0]);
+    TEST_ASSERT_EQUAL_UINT16(1, gf_mul(gf, gf->log2exp[65534], 2));
+    poporon_gf_destroy(gf);
+
+    /* x^16 + 1 is not primitive */
+    TEST_ASSERT_NULL(poporon_gf_create(SYMBOL_SIZE, 0x0001));
+}
+
+/* parity of a plain log/exp LFSR, independent of the split tables the kernels use */
+static void reference_encode(const poporon_rs_t *rs, const uint16_t *data, size_t size, uint16_t *parity)
+{
+    const poporon_gf_t *gf = rs->gf;
+    uint16_t fb;
+    size_t i, j;
+
+    memset(parity, 0, rs->num_roots * sizeof(uint16_t));
+
+    for (i = 0; i < size; i++) {
+        fb = gf->exp2log[(data[i] & gf->field_size) ^ parity[0]];
+        memmove(&parity[0], &parity[1], (rs->num_roots - 1) * sizeof(uint16_t));
+        parity[rs->num_roots - 1] = 0;
+
+        if (fb != gf->field_size) {
+            for (j = 0; j < rs->num_roots; j++) {
+                parity[j] ^= gf->log2exp[(fb + rs->generator_polynomial[rs->num_roots - 1 - j]) % gf->field_size];
+            }
+        }
+    }
+}
+
+void test_rs16_encode_matches_reference(void)
+{
+    poporon_t *pprn;
+    uint16_t data[DATA_SIZE], parity[NUMBER_OF_ROOTS], expected[NUMBER_OF_ROOTS];
+    size_t l, size;
+
+    pprn = create_rs16(NULL);
+
+    for (l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        TEST_ASSERT_TRUE(poporon_simd_set_level(levels[l]));
+
+        for (size = 1; size <= DATA_SIZE; size += 111) {
+            random_symbols(data, size);
+            reference_encode(pprn->ctx.rs.rs, data, size, expected);
+
+            TEST_ASSERT_TRUE(poporon_encode_u16(pprn, data, size, parity));
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(expected, parity, NUMBER_OF_ROOTS);
+        }
+    }
+
+    poporon_destroy(pprn);
+}
+
+void test_rs16_decode_errors(void)
+{
+    poporon_t *pprn;
+    uint16_t original[DATA_SIZE], data[DATA_SIZE], parity[NUMBER_OF_ROOTS], original_parity[NUMBER_OF_ROOTS];
+    size_t l, i, corrected;
+
+    pprn = create_rs16(NULL);
+
+    for (l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        TEST_ASSERT_TRUE(poporon_simd_set_level(levels[l]));
+
+        random_symbols(original, DATA_SIZE);
+        TEST_ASSERT_TRUE(poporon_encode_u16(pprn, original, DATA_SIZE, original_parity));
+
+        memcpy(data, original, sizeof(data));
+        memcpy(parity, original_parity, sizeof(parity));
+        TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+        TEST_ASSERT_EQUAL(0, corrected);
+
+        /* one error in the data or the parity takes the closed form, both the general decoder */
+        for (i = 1; i <= 3; i++) {
+            if (i & 1) {
+                data[DATA_SIZE - 1] ^= 0xBEEF;
+            }
+            if (i & 2) {
+                parity[NUMBER_OF_ROOTS / 2] ^= 0x0101;
+            }
+            TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+            TEST_ASSERT_EQUAL(i == 3 ? 2 : 1, corrected);
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, DATA_SIZE);
+            TEST_ASSERT_EQUAL_UINT16_ARRAY(original_parity, parity, NUMBER_OF_ROOTS);
+        }
+
+        /* NUMBER_OF_ROOTS / 2 errors, two of them in the parity */
+        for (i = 0; i < NUMBER_OF_ROOTS / 2 - 2; i++) {
+            data[(i * 61 + 5) % DATA_SIZE] ^= (uint16_t)(0x1234 + i * 0x0F0F);
+        }
+        parity[0] ^= 0x8000;
+        parity[NUMBER_OF_ROOTS - 1] ^= 0x0001;
+
+        TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+        TEST_ASSERT_EQUAL(NUMBER_OF_ROOTS / 2, corrected);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, DATA_SIZE);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original_parity, parity, NUMBER_OF_ROOTS);
+
+        /* one error past the capability */
+        for (i = 0; i <= NUMBER_OF_ROOTS / 2; i++) {
+            data[i * 37] ^= 0x00FF;
+        }
+        TEST_ASSERT_FALSE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, NULL));
+    }
+
+    poporon_destroy(pprn);
+}
+
+void test_rs16_code_parameters(void)
+{
+    static const uint16_t params[][2] = {{0, 7}, {112, 11}, {65534, 65534}};
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint16_t original[DATA_SIZE], data[DATA_SIZE], parity[NUMBER_OF_ROOTS];
+    size_t p, i, corrected;
+
+    for (p = 0; p < sizeof(params) / sizeof(params[0]); p++) {
+        config = poporon_rs_config_create(SYMBOL_SIZE, GENERATOR_POLYNOMIAL, params[p][0], params[p][1],
+                                          NUMBER_OF_ROOTS, NULL, NULL);
+        pprn = poporon_create(config);
+        TEST_ASSERT_NOT_NULL(pprn);
+
+        random_symbols(original, DATA_SIZE);
+        TEST_ASSERT_TRUE(poporon_encode_u16(pprn, original, DATA_SIZE, parity));
+        memcpy(data, original, sizeof(data));
+        for (i = 0; i < 5; i++) {
+            data[i * 199 + 3] ^= (uint16_t)(0xA5A5 >> i);
+        }
+
+        TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+        TEST_ASSERT_EQUAL(5, corrected);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, DATA_SIZE);
+
+        poporon_destroy(pprn);
+        poporon_config_destroy(config);
+    }
+}
+
+void test_rs16_decode_erasures(void)
+{
+    poporon_erasure_t *erasure;
+    poporon_t *pprn;
+    uint16_t original[DATA_SIZE], data[DATA_SIZE], parity[NUMBER_OF_ROOTS];
+    uint32_t i;
+    size_t corrected;
+
+    erasure = poporon_erasure_create(NUMBER_OF_ROOTS, NUMBER_OF_ROOTS);
+    TEST_ASSERT_NOT_NULL(erasure);
+    pprn = create_rs16(erasure);
+
+    for (i = 0; i < NUMBER_OF_ROOTS; i++) {
+        TEST_ASSERT_TRUE(poporon_erasure_add_position(erasure, 300 + i * 20));
+    }
+
+    random_symbols(original, DATA_SIZE);
+    TEST_ASSERT_TRUE(poporon_encode_u16(pprn, original, DATA_SIZE, parity));
+    memcpy(data, original, sizeof(data));
+
+    for (i = 0; i < NUMBER_OF_ROOTS; i++) {
+        data[300 + i * 20] = (uint16_t)~data[300 + i * 20];
+    }
+
+    TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+    TEST_ASSERT_EQUAL(NUMBER_OF_ROOTS, corrected);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, DATA_SIZE);
+
+    poporon_destroy(pprn);
+    poporon_erasure_destroy(erasure);
+}
+
+static poporon_t *create_rs16_ribm(poporon_erasure_t *erasure)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+
+    config = poporon_rs_config_create(SYMBOL_SIZE, GENERATOR_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT, PRIMITIVE_ELEMENT,
+                                      NUMBER_OF_ROOTS, erasure, NULL);
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_TRUE(poporon_rs_config_set_decode_mode(config, PPRN_RS_DECODE_RIBM));
+    pprn = poporon_create(config);
+    poporon_config_destroy(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    return pprn;
+}
+
+/* the riBM solver over uint16_t rows, errors then erasures */
+void test_rs16_decode_ribm(void)
+{
+    poporon_erasure_t *erasure;
+    poporon_t *pprn, *pprn_erasure;
+    uint16_t original[DATA_SIZE], data[DATA_SIZE], parity[NUMBER_OF_ROOTS], original_parity[NUMBER_OF_ROOTS];
+    size_t l, i, corrected;
+
+    erasure = poporon_erasure_create(NUMBER_OF_ROOTS, NUMBER_OF_ROOTS);
+    TEST_ASSERT_NOT_NULL(erasure);
+    pprn = create_rs16_ribm(NULL);
+    pprn_erasure = create_rs16_ribm(erasure);
+
+    for (l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        TEST_ASSERT_TRUE(poporon_simd_set_level(levels[l]));
+
+        random_symbols(original, DATA_SIZE);
+        TEST_ASSERT_TRUE(poporon_encode_u16(pprn, original, DATA_SIZE, original_parity));
+
+        memcpy(data, original, sizeof(data));
+        memcpy(parity, original_parity, sizeof(parity));
+        for (i = 0; i < NUMBER_OF_ROOTS / 2 - 1; i++) {
+            data[(i * 53 + 11) % DATA_SIZE] ^= (uint16_t)(0x4321 + i * 0x1111);
+        }
+        parity[3] ^= 0x0F0F;
+
+        TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+        TEST_ASSERT_EQUAL(NUMBER_OF_ROOTS / 2, corrected);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, DATA_SIZE);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original_parity, parity, NUMBER_OF_ROOTS);
+
+        poporon_erasure_reset(erasure);
+        for (i = 0; i < NUMBER_OF_ROOTS; i++) {
+            TEST_ASSERT_TRUE(poporon_erasure_add_position(erasure, (uint32_t)(i * 29 + 7)));
+            data[i * 29 + 7] = (uint16_t)~data[i * 29 + 7];
+        }
+
+        TEST_ASSERT_TRUE(poporon_decode_u16(pprn_erasure, data, DATA_SIZE, parity, &corrected));
+        TEST_ASSERT_EQUAL(NUMBER_OF_ROOTS, corrected);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, DATA_SIZE);
+    }
+
+    poporon_destroy(pprn);
+    poporon_destroy(pprn_erasure);
+    poporon_erasure_destroy(erasure);
+}
+
+/* syndromes from the encoder remainder, clean words never reach the evaluation */
+void test_rs16_decode_remainder(void)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint16_t original[DATA_SIZE], data[DATA_SIZE], parity[NUMBER_OF_ROOTS], original_parity[NUMBER_OF_ROOTS];
+    size_t l, i, corrected;
+
+    config = poporon_rs_config_create(SYMBOL_SIZE, GENERATOR_POLYNOMIAL, FIRST_CONSECUTIVE_ROOT, PRIMITIVE_ELEMENT,
+                                      NUMBER_OF_ROOTS, NULL, NULL);
+    TEST_ASSERT_NOT_NULL(config);
+    TEST_ASSERT_TRUE(poporon_rs_config_set_syndrome_mode(config, PPRN_RS_SYNDROME_REMAINDER));
+    pprn = poporon_create(config);
+    poporon_config_destroy(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    for (l = 0; l < sizeof(levels) / sizeof(levels[0]); l++) {
+        TEST_ASSERT_TRUE(poporon_simd_set_level(levels[l]));
+
+        random_symbols(original, DATA_SIZE);
+        TEST_ASSERT_TRUE(poporon_encode_u16(pprn, original, DATA_SIZE, original_parity));
+
+        memcpy(data, original, sizeof(data));
+        memcpy(parity, original_parity, sizeof(parity));
+        TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+        TEST_ASSERT_EQUAL(0, corrected);
+
+        for (i = 0; i < NUMBER_OF_ROOTS / 2 - 1; i++) {
+            data[(i * 67 + 3) % DATA_SIZE] ^= (uint16_t)(0x2468 + i * 0x0303);
+        }
+        parity[NUMBER_OF_ROOTS - 2] ^= 0x7001;
+
+        TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, &corrected));
+        TEST_ASSERT_EQUAL(NUMBER_OF_ROOTS / 2, corrected);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, DATA_SIZE);
+        TEST_ASSERT_EQUAL_UINT16_ARRAY(original_parity, parity, NUMBER_OF_ROOTS);
+
+        for (i = 0; i <= NUMBER_OF_ROOTS / 2; i++) {
+            data[i * 41] ^= 0x0F00;
+        }
+        TEST_ASSERT_FALSE(poporon_decode_u16(pprn, data, DATA_SIZE, parity, NULL));
+    }
+
+    poporon_destroy(pprn);
+}
+
+void test_rs16_full_length(void)
+{
+    poporon_t *pprn;
+    uint16_t *original, *data, parity[NUMBER_OF_ROOTS];
+    size_t corrected;
+
+    original = (uint16_t *)malloc(MAX_DATA_SIZE * sizeof(uint16_t));
+    data = (uint16_t *)malloc(MAX_DATA_SIZE * sizeof(uint16_t));
+    TEST_ASSERT_NOT_NULL(original);
+    TEST_ASSERT_NOT_NULL(data);
+    pprn = create_rs16(NULL);
+
+    random_symbols(original, MAX_DATA_SIZE);
+    TEST_ASSERT_TRUE(poporon_encode_u16(pprn, original, MAX_DATA_SIZE, parity));
+    TEST_ASSERT_FALSE(poporon_encode_u16(pprn, original, MAX_DATA_SIZE + 1, parity));
+
+    memcpy(data, original, MAX_DATA_SIZE * sizeof(uint16_t));
+    data[0] ^= 0xFFFF;
+    data[255] ^= 0x0100;
+    data[MAX_DATA_SIZE - 1] ^= 0x0001;
+
+    TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, MAX_DATA_SIZE, parity, &corrected));
+    TEST_ASSERT_EQUAL(3, corrected);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, MAX_DATA_SIZE);
+
+    poporon_destroy(pprn);
+    free(original);
+    free(data);
+}
+
+void test_rs16_narrow_field(void)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint16_t original[700], data[700], parity[16];
+    size_t i, corrected;
+
+    /* GF(2^10), symbols carry 10 bits */
+    config = poporon_rs_config_create(10, 0x409, 1, 1, 16, NULL, NULL);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    random_symbols(original, 700);
+    for (i = 0; i < 700; i++) {
+        original[i] &= 0x3FF;
+    }
+
+    TEST_ASSERT_TRUE(poporon_encode_u16(pprn, original, 700, parity));
+    memcpy(data, original, sizeof(data));
+    for (i = 0; i < 8; i++) {
+        data[i * 87] ^= (uint16_t)(0x201 + i);
+    }
+
+    TEST_ASSERT_TRUE(poporon_decode_u16(pprn, data, 700, parity, &corrected));
+    TEST_ASSERT_EQUAL(8, corrected);
+    TEST_ASSERT_EQUAL_UINT16_ARRAY(original, data, 700);
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+void test_rs16_api_mismatch(void)
+{
+    poporon_config_t *config;
+    poporon_t *pprn, *pprn8;
+    uint8_t bytes[64], byte_parity[NUMBER_OF_ROOTS];
+    uint16_t data[64], parity[NUMBER_OF_ROOTS];
+
+    pprn = create_rs16(NULL);
+    config = poporon_config_rs_default();
+    pprn8 = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn8);
+
+    random_data(bytes, sizeof(bytes));
+    random_symbols(data, 64);
+
+    /* the byte API cannot carry 16-bit symbols, the 16-bit API has no tables for byte codes */
+    TEST_ASSERT_FALSE(poporon_encode(pprn, bytes, sizeof(bytes), byte_parity));
+    TEST_ASSERT_FALSE(poporon_decode(pprn, bytes, sizeof(bytes), byte_parity, NULL));
+    TEST_ASSERT_FALSE(poporon_encode_u16(pprn8, data, 64, parity));
+    TEST_ASSERT_FALSE(poporon_decode_u16(pprn8, data, 64, parity, NULL));
+
+    TEST_ASSERT_FALSE(poporon_encode_u16(pprn, data, 0, parity));
+    TEST_ASSERT_FALSE(poporon_encode_u16(NULL, data, 64, parity));
+    TEST_ASSERT_FALSE(poporon_encode_u16(pprn, NULL, 64, parity));
+    TEST_ASSERT_FALSE(poporon_decode_u16(pprn, data, 0, parity, NULL));
+    TEST_ASSERT_FALSE(poporon_decode_u16(NULL, data, 64, parity, NULL));
+
+    poporon_destroy(pprn8);
+    poporon_config_destroy(config);
+    poporon_destroy(pprn);
+}
+
+int main(void)
+{
+    UNITY_BEGIN();
+
+    RUN_TEST(test_rs16_field);
+    RUN_TEST(test_rs16_encode_matches_reference);
+    RUN_TEST(test_rs16_decode_errors);
+    RUN_TEST(test_rs16_code_parameters);
+    RUN_TEST(test_rs16_decode_erasures);
+    RUN_TEST(test_rs16_decode_ribm);
+    RUN_TEST(test_rs16_decode_remainder);
+    RUN_TEST(test_rs16_full_length);
+    RUN_TEST(test_rs16_narrow_field);
+    RUN_TEST(test_rs16_api_mismatch);
+
+    return UNITY_END();
+}
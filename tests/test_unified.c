@@ -388,6 +388,419 @@ void test_bch_encode_decode_no_error(void)
     poporon_config_destroy(config);
 }
 
+#define BATCH_COUNT 8
+#define BATCH_DATA  223
+
+void test_rs_batch(void)
+{
+    poporon_t *pprn;
+    poporon_config_t *config;
+    uint8_t data[BATCH_COUNT][BATCH_DATA], original[BATCH_COUNT][BATCH_DATA], parity[BATCH_COUNT][32], expected[32];
+    uint8_t *data_list[BATCH_COUNT], *parity_list[BATCH_COUNT];
+    size_t corrected[BATCH_COUNT], i;
+    bool results[BATCH_COUNT];
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    for (i = 0; i < BATCH_COUNT; i++) {
+        random_data(data[i], BATCH_DATA);
+        data[i][0] = (uint8_t)i;
+        memcpy(original[i], data[i], BATCH_DATA);
+        data_list[i] = data[i];
+        parity_list[i] = parity[i];
+    }
+
+    TEST_ASSERT_TRUE(poporon_encode_batch(pprn, data_list, BATCH_DATA, parity_list, BATCH_COUNT, results));
+    for (i = 0; i < BATCH_COUNT; i++) {
+        TEST_ASSERT_TRUE(results[i]);
+        TEST_ASSERT_TRUE(poporon_encode(pprn, data[i], BATCH_DATA, expected));
+        TEST_ASSERT_EQUAL_MEMORY(expected, parity[i], 32);
+    }
+
+    for (i = 1; i < BATCH_COUNT; i++) {
+        break_data(data[i], BATCH_DATA, (uint32_t)(i * 2));
+    }
+    /* beyond the 16 symbol correction capability */
+    break_data(data[BATCH_COUNT - 1], BATCH_DATA, 30);
+
+    TEST_ASSERT_FALSE(poporon_decode_batch(pprn, data_list, BATCH_DATA, parity_list, BATCH_COUNT, results, corrected));
+    TEST_ASSERT_EQUAL(0, corrected[0]);
+    for (i = 0; i < BATCH_COUNT - 1; i++) {
+        TEST_ASSERT_TRUE(results[i]);
+        TEST_ASSERT_EQUAL_MEMORY(original[i], data[i], BATCH_DATA);
+    }
+    for (i = 1; i < BATCH_COUNT - 1; i++) {
+        TEST_ASSERT_EQUAL(i * 2, corrected[i]);
+    }
+    TEST_ASSERT_FALSE(results[BATCH_COUNT - 1]);
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+void test_rs_strided(void)
+{
+    poporon_t *pprn;
+    poporon_config_t *config;
+    uint8_t frames[BATCH_COUNT][BATCH_DATA + 32], original[BATCH_COUNT][BATCH_DATA];
+    size_t corrected[BATCH_COUNT], i;
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    /* data and parity interleaved in one buffer, as received frames */
+    for (i = 0; i < BATCH_COUNT; i++) {
+        random_data(frames[i], BATCH_DATA);
+        memcpy(original[i], frames[i], BATCH_DATA);
+    }
+
+    TEST_ASSERT_TRUE(poporon_encode_strided(pprn, frames[0], sizeof(frames[0]), BATCH_DATA, &frames[0][BATCH_DATA],
+                                            sizeof(frames[0]), BATCH_COUNT, NULL));
+
+    for (i = 0; i < BATCH_COUNT; i++) {
+        break_data(frames[i], BATCH_DATA + 32, (uint32_t)(i + 1));
+    }
+
+    TEST_ASSERT_TRUE(poporon_decode_strided(pprn, frames[0], sizeof(frames[0]), BATCH_DATA, &frames[0][BATCH_DATA],
+                                            sizeof(frames[0]), BATCH_COUNT, NULL, corrected));
+    for (i = 0; i < BATCH_COUNT; i++) {
+        TEST_ASSERT_EQUAL(i + 1, corrected[i]);
+        TEST_ASSERT_EQUAL_MEMORY(original[i], frames[i], BATCH_DATA);
+    }
+
+    TEST_ASSERT_FALSE(poporon_encode_strided(pprn, frames[0], BATCH_DATA - 1, BATCH_DATA, &frames[0][BATCH_DATA],
+                                             sizeof(frames[0]), BATCH_COUNT, NULL));
+
+    /* parity strides below the parity size would let codewords overwrite each other's parity */
+    TEST_ASSERT_FALSE(poporon_encode_strided(pprn, frames[0], sizeof(frames[0]), BATCH_DATA, &frames[0][BATCH_DATA], 0,
+                                             BATCH_COUNT, NULL));
+    TEST_ASSERT_FALSE(poporon_decode_strided(pprn, frames[0], sizeof(frames[0]), BATCH_DATA, &frames[0][BATCH_DATA],
+                                             31, BATCH_COUNT, NULL, NULL));
+    TEST_ASSERT_TRUE(poporon_encode_strided(pprn, frames[0], sizeof(frames[0]), BATCH_DATA, &frames[0][BATCH_DATA], 0,
+                                            1, NULL));
+    TEST_ASSERT_TRUE(poporon_decode_strided(pprn, frames[0], sizeof(frames[0]), BATCH_DATA, &frames[0][BATCH_DATA], 0,
+                                            1, NULL, NULL));
+
+    /* empty codewords are refused by both directions */
+    TEST_ASSERT_FALSE(poporon_encode_strided(pprn, frames[0], sizeof(frames[0]), 0, &frames[0][BATCH_DATA],
+                                             sizeof(frames[0]), BATCH_COUNT, NULL));
+    TEST_ASSERT_FALSE(poporon_decode_strided(pprn, frames[0], sizeof(frames[0]), 0, &frames[0][BATCH_DATA],
+                                             sizeof(frames[0]), BATCH_COUNT, NULL, NULL));
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+void test_rs_interleaved(void)
+{
+    poporon_t *pprn;
+    poporon_config_t *config;
+    uint8_t data[BATCH_COUNT][BATCH_DATA], original[BATCH_COUNT][BATCH_DATA], parity[BATCH_COUNT][32], expected[32];
+    uint8_t interleaved_data[BATCH_DATA * BATCH_COUNT], interleaved_parity[32 * BATCH_COUNT];
+    uint8_t *data_list[BATCH_COUNT], *parity_list[BATCH_COUNT];
+    size_t corrected[BATCH_COUNT], i;
+    bool results[BATCH_COUNT];
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    for (i = 0; i < BATCH_COUNT; i++) {
+        random_data(data[i], BATCH_DATA);
+        data[i][0] = (uint8_t)i;
+        memcpy(original[i], data[i], BATCH_DATA);
+        data_list[i] = data[i];
+        parity_list[i] = parity[i];
+    }
+
+    TEST_ASSERT_TRUE(poporon_interleave((const uint8_t *const *)data_list, BATCH_DATA, BATCH_COUNT, interleaved_data));
+    TEST_ASSERT_EQUAL(data[3][5], interleaved_data[5 * BATCH_COUNT + 3]);
+    TEST_ASSERT_TRUE(poporon_encode_interleaved(pprn, interleaved_data, BATCH_DATA, BATCH_COUNT, interleaved_parity));
+    TEST_ASSERT_TRUE(poporon_deinterleave(interleaved_parity, 32, BATCH_COUNT, parity_list));
+
+    for (i = 0; i < BATCH_COUNT; i++) {
+        TEST_ASSERT_TRUE(poporon_encode(pprn, data[i], BATCH_DATA, expected));
+        TEST_ASSERT_EQUAL_MEMORY(expected, parity[i], 32);
+    }
+
+    for (i = 1; i < BATCH_COUNT; i++) {
+        break_data(data[i], BATCH_DATA, (uint32_t)(i * 2));
+    }
+    /* beyond the 16 symbol correction capability */
+    break_data(data[BATCH_COUNT - 1], BATCH_DATA, 30);
+
+    TEST_ASSERT_TRUE(poporon_interleave((const uint8_t *const *)data_list, BATCH_DATA, BATCH_COUNT, interleaved_data));
+    TEST_ASSERT_FALSE(poporon_decode_interleaved(pprn, interleaved_data, BATCH_DATA, interleaved_parity, BATCH_COUNT,
+                                                 results, corrected));
+    TEST_ASSERT_TRUE(poporon_deinterleave(interleaved_data, BATCH_DATA, BATCH_COUNT, data_list));
+
+    for (i = 0; i < BATCH_COUNT - 1; i++) {
+        TEST_ASSERT_TRUE(results[i]);
+        TEST_ASSERT_EQUAL(i * 2, corrected[i]);
+        TEST_ASSERT_EQUAL_MEMORY(original[i], data[i], BATCH_DATA);
+    }
+    TEST_ASSERT_FALSE(results[BATCH_COUNT - 1]);
+    TEST_ASSERT_EQUAL(0, corrected[BATCH_COUNT - 1]);
+
+    /* fewer lanes on the syndrome scratch kept from the call above */
+    break_data(data[1], BATCH_DATA, 3);
+    TEST_ASSERT_TRUE(poporon_interleave((const uint8_t *const *)data_list, BATCH_DATA, 2, interleaved_data));
+    TEST_ASSERT_TRUE(poporon_interleave((const uint8_t *const *)parity_list, 32, 2, interleaved_parity));
+    TEST_ASSERT_TRUE(poporon_decode_interleaved(pprn, interleaved_data, BATCH_DATA, interleaved_parity, 2, results,
+                                                corrected));
+    TEST_ASSERT_TRUE(poporon_deinterleave(interleaved_data, BATCH_DATA, 2, data_list));
+    TEST_ASSERT_EQUAL(0, corrected[0]);
+    TEST_ASSERT_EQUAL(3, corrected[1]);
+    TEST_ASSERT_EQUAL_MEMORY(original[0], data[0], BATCH_DATA);
+    TEST_ASSERT_EQUAL_MEMORY(original[1], data[1], BATCH_DATA);
+
+    TEST_ASSERT_FALSE(poporon_encode_interleaved(pprn, interleaved_data, 224, BATCH_COUNT, interleaved_parity));
+    TEST_ASSERT_FALSE(poporon_interleave(NULL, BATCH_DATA, BATCH_COUNT, interleaved_data));
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+void test_workspace(void)
+{
+    poporon_t *rs, *rs_small, *ldpc;
+    poporon_config_t *rs_config, *rs_small_config, *ldpc_config;
+    poporon_workspace_t *first, *second, *small;
+    uint8_t data[2][BATCH_DATA], original[BATCH_DATA], parity[2][32], ldpc_data[2][64], ldpc_parity[2][64];
+    size_t corrected[2], ldpc_parity_size;
+
+    rs_config = poporon_config_rs_default();
+    rs_small_config = poporon_rs_config_create(8, 0x11D, 1, 1, 10, NULL, NULL);
+    ldpc_config = poporon_config_ldpc_default(64, PPRN_LDPC_RATE_1_2);
+    TEST_ASSERT_NOT_NULL(rs_config);
+    TEST_ASSERT_NOT_NULL(rs_small_config);
+    TEST_ASSERT_NOT_NULL(ldpc_config);
+    rs = poporon_create(rs_config);
+    rs_small = poporon_create(rs_small_config);
+    ldpc = poporon_create(ldpc_config);
+    TEST_ASSERT_NOT_NULL(rs);
+    TEST_ASSERT_NOT_NULL(rs_small);
+    TEST_ASSERT_NOT_NULL(ldpc);
+
+    /* two workspaces on one code decode independently and agree with the default one */
+    first = poporon_workspace_create(rs);
+    second = poporon_workspace_create(rs);
+    TEST_ASSERT_NOT_NULL(first);
+    TEST_ASSERT_NOT_NULL(second);
+
+    random_data(original, BATCH_DATA);
+    memcpy(data[0], original, BATCH_DATA);
+    TEST_ASSERT_TRUE(poporon_encode_with_workspace(rs, first, data[0], BATCH_DATA, parity[0]));
+    TEST_ASSERT_TRUE(poporon_encode(rs, data[0], BATCH_DATA, parity[1]));
+    TEST_ASSERT_EQUAL_MEMORY(parity[1], parity[0], 32);
+    memcpy(data[1], data[0], BATCH_DATA);
+    memcpy(parity[1], parity[0], 32);
+
+    break_data(data[0], BATCH_DATA, 5);
+    break_data(data[1], BATCH_DATA, 11);
+    TEST_ASSERT_TRUE(poporon_decode_with_workspace(rs, first, data[0], BATCH_DATA, parity[0], &corrected[0]));
+    TEST_ASSERT_TRUE(poporon_decode_with_workspace(rs, second, data[1], BATCH_DATA, parity[1], &corrected[1]));
+    TEST_ASSERT_EQUAL(5, corrected[0]);
+    TEST_ASSERT_EQUAL(11, corrected[1]);
+    TEST_ASSERT_EQUAL_MEMORY(original, data[0], BATCH_DATA);
+    TEST_ASSERT_EQUAL_MEMORY(original, data[1], BATCH_DATA);
+
+    /* a workspace only fits codes of the same type with no more roots than it was sized for */
+    small = poporon_workspace_create(rs_small);
+    TEST_ASSERT_NOT_NULL(small);
+    TEST_ASSERT_FALSE(poporon_decode_with_workspace(rs, small, data[0], BATCH_DATA, parity[0], NULL));
+    TEST_ASSERT_TRUE(poporon_encode_with_workspace(rs_small, first, data[0], BATCH_DATA, parity[0]));
+    TEST_ASSERT_TRUE(poporon_decode_with_workspace(rs_small, first, data[0], BATCH_DATA, parity[0], NULL));
+    TEST_ASSERT_FALSE(poporon_decode_with_workspace(ldpc, first, ldpc_data[0], 64, ldpc_parity[0], NULL));
+    TEST_ASSERT_FALSE(poporon_decode_with_workspace(rs, NULL, data[0], BATCH_DATA, parity[0], NULL));
+    poporon_workspace_destroy(small);
+    poporon_workspace_destroy(second);
+    poporon_workspace_destroy(first);
+
+    ldpc_parity_size = poporon_get_parity_size(ldpc);
+    TEST_ASSERT_TRUE(ldpc_parity_size <= sizeof(ldpc_parity[0]));
+    first = poporon_workspace_create(ldpc);
+    TEST_ASSERT_NOT_NULL(first);
+
+    random_data(ldpc_data[0], 64);
+    memcpy(ldpc_data[1], ldpc_data[0], 64);
+    TEST_ASSERT_TRUE(poporon_encode_with_workspace(ldpc, first, ldpc_data[0], 64, ldpc_parity[0]));
+    TEST_ASSERT_TRUE(poporon_encode(ldpc, ldpc_data[1], 64, ldpc_parity[1]));
+    TEST_ASSERT_EQUAL_MEMORY(ldpc_parity[1], ldpc_parity[0], ldpc_parity_size);
+
+    ldpc_data[0][3] ^= 0x01;
+    ldpc_data[1][3] ^= 0x01;
+    TEST_ASSERT_TRUE(poporon_decode_with_workspace(ldpc, first, ldpc_data[0], 64, ldpc_parity[0], NULL));
+    TEST_ASSERT_TRUE(poporon_decode(ldpc, ldpc_data[1], 64, ldpc_parity[1], NULL));
+    TEST_ASSERT_EQUAL_MEMORY(ldpc_data[1], ldpc_data[0], 64);
+    TEST_ASSERT_FALSE(poporon_decode_with_workspace(rs, first, data[0], BATCH_DATA, parity[0], NULL));
+    poporon_workspace_destroy(first);
+
+    TEST_ASSERT_NULL(poporon_workspace_create(NULL));
+
+    poporon_destroy(ldpc);
+    poporon_destroy(rs_small);
+    poporon_destroy(rs);
+    poporon_config_destroy(ldpc_config);
+    poporon_config_destroy(rs_small_config);
+    poporon_config_destroy(rs_config);
+}
+
+/* poporon_check() follows the state of the codeword and leaves both buffers untouched */
+static void check_verify(poporon_config_t *config, size_t size, uint8_t data_mask)
+{
+    poporon_t *pprn;
+    uint8_t data[256], parity[256], data_copy[256], parity_copy[256];
+    size_t parity_size;
+
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+    parity_size = poporon_get_parity_size(pprn);
+    TEST_ASSERT_TRUE(parity_size <= sizeof(parity));
+
+    random_data(data, size);
+    data[0] &= data_mask;
+    TEST_ASSERT_TRUE(poporon_encode(pprn, data, size, parity));
+    memcpy(data_copy, data, size);
+    memcpy(parity_copy, parity, parity_size);
+
+    TEST_ASSERT_TRUE(poporon_check(pprn, data, size, parity));
+
+    data[size - 1] ^= 0x01;
+    TEST_ASSERT_FALSE(poporon_check(pprn, data, size, parity));
+    data[size - 1] ^= 0x01;
+    parity[parity_size - 1] ^= 0x01;
+    TEST_ASSERT_FALSE(poporon_check(pprn, data, size, parity));
+    parity[parity_size - 1] ^= 0x01;
+
+    TEST_ASSERT_EQUAL_MEMORY(data_copy, data, size);
+    TEST_ASSERT_EQUAL_MEMORY(parity_copy, parity, parity_size);
+    TEST_ASSERT_TRUE(poporon_check(pprn, data, size, parity));
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
+void test_check(void)
+{
+    poporon_config_t *config;
+
+    check_verify(poporon_config_rs_default(), 223, 0xFF);
+    check_verify(poporon_rs_config_create(8, 0x11D, 1, 1, 10, NULL, NULL), 50, 0xFF);
+    check_verify(poporon_rs_config_create(4, 0x13, 1, 2, 6, NULL, NULL), 9, 0x0F);
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_TRUE(poporon_rs_config_set_syndrome_mode(config, PPRN_RS_SYNDROME_REMAINDER));
+    check_verify(config, 100, 0xFF);
+
+    check_verify(poporon_ldpc_config_create(64, PPRN_LDPC_RATE_1_2, PPRN_LDPC_RANDOM, 3, false, false, false, 0, 0, 0,
+                                            NULL, 0, 0),
+                 64, 0xFF);
+    check_verify(poporon_config_ldpc_default(64, PPRN_LDPC_RATE_1_2), 64, 0xFF);
+
+    /* BCH(15,5), five data bits */
+    check_verify(poporon_config_bch_default(), 1, 0x1F);
+}
+
+void test_check_u16(void)
+{
+    poporon_config_t *config;
+    poporon_t *pprn;
+    uint16_t data[300], parity[16];
+    size_t i, m;
+
+    for (m = 0; m < 2; m++) {
+        config = poporon_rs_config_create(16, 0x100B, 1, 1, 16, NULL, NULL);
+        TEST_ASSERT_NOT_NULL(config);
+        if (m == 1) {
+            TEST_ASSERT_TRUE(poporon_rs_config_set_syndrome_mode(config, PPRN_RS_SYNDROME_REMAINDER));
+        }
+        pprn = poporon_create(config);
+        TEST_ASSERT_NOT_NULL(pprn);
+
+        for (i = 0; i < 300; i++) {
+            data[i] = (uint16_t)(i * 0x9E37 + m);
+        }
+        TEST_ASSERT_TRUE(poporon_encode_u16(pprn, data, 300, parity));
+        TEST_ASSERT_TRUE(poporon_check_u16(pprn, data, 300, parity));
+
+        parity[15] ^= 0x8000;
+        TEST_ASSERT_FALSE(poporon_check_u16(pprn, data, 300, parity));
+        parity[15] ^= 0x8000;
+        data[150] ^= 0x0001;
+        TEST_ASSERT_FALSE(poporon_check_u16(pprn, data, 300, parity));
+
+        /* byte codes only */
+        TEST_ASSERT_FALSE(poporon_check(pprn, (const uint8_t *)data, 300, (const uint8_t *)parity));
+
+        poporon_destroy(pprn);
+        poporon_config_destroy(config);
+    }
+}
+
+void test_check_batch(void)
+{
+    poporon_t *pprn;
+    poporon_config_t *config;
+    uint8_t data[BATCH_COUNT][BATCH_DATA], parity[BATCH_COUNT][32], original[BATCH_COUNT][BATCH_DATA];
+    const uint8_t *data_list[BATCH_COUNT], *parity_list[BATCH_COUNT];
+    bool results[BATCH_COUNT];
+    size_t i;
+
+    config = poporon_config_rs_default();
+    TEST_ASSERT_NOT_NULL(config);
+    pprn = poporon_create(config);
+    TEST_ASSERT_NOT_NULL(pprn);
+
+    for (i = 0; i < BATCH_COUNT; i++) {
+        random_data(data[i], BATCH_DATA);
+        TEST_ASSERT_TRUE(poporon_encode(pprn, data[i], BATCH_DATA, parity[i]));
+        data_list[i] = data[i];
+        parity_list[i] = parity[i];
+    }
+
+    TEST_ASSERT_TRUE(poporon_check_batch(pprn, data_list, BATCH_DATA, parity_list, BATCH_COUNT, results));
+    for (i = 0; i < BATCH_COUNT; i++) {
+        TEST_ASSERT_TRUE(results[i]);
+    }
+
+    /* odd codewords damaged, beyond the correction capability for the last one */
+    for (i = 1; i < BATCH_COUNT; i += 2) {
+        break_data(data[i], BATCH_DATA, (uint32_t)i);
+    }
+    break_data(data[BATCH_COUNT - 1], BATCH_DATA, 30);
+    memcpy(original, data, sizeof(data));
+
+    TEST_ASSERT_FALSE(poporon_check_batch(pprn, data_list, BATCH_DATA, parity_list, BATCH_COUNT, results));
+    for (i = 0; i < BATCH_COUNT; i++) {
+        TEST_ASSERT_EQUAL(i % 2 == 0, results[i]);
+    }
+    TEST_ASSERT_EQUAL_MEMORY(original, data, sizeof(data));
+
+    data_list[0] = NULL;
+    TEST_ASSERT_FALSE(poporon_check_batch(pprn, data_list, BATCH_DATA, parity_list, 1, results));
+    TEST_ASSERT_FALSE(results[0]);
+    TEST_ASSERT_TRUE(poporon_check_batch(pprn, data_list, BATCH_DATA, parity_list, 0, NULL));
+
+    TEST_ASSERT_FALSE(poporon_check(NULL, data[0], BATCH_DATA, parity[0]));
+    TEST_ASSERT_FALSE(poporon_check(pprn, NULL, BATCH_DATA, parity[0]));
+    TEST_ASSERT_FALSE(poporon_check(pprn, data[0], BATCH_DATA, NULL));
+    TEST_ASSERT_FALSE(poporon_check(pprn, data[0], 0, parity[0]));
+    TEST_ASSERT_FALSE(poporon_check(pprn, data[0], 256, parity[0]));
+    TEST_ASSERT_FALSE(poporon_check_batch(NULL, data_list, BATCH_DATA, parity_list, 1, results));
+    TEST_ASSERT_FALSE(poporon_check_u16(pprn, NULL, BATCH_DATA, NULL));
+
+    poporon_destroy(pprn);
+    poporon_config_destroy(config);
+}
+
 void test_create_null_config(void)
 {
     TEST_ASSERT_NULL(poporon_create(NULL));
@@ -405,6 +818,8 @@ void test_encode_null(void)
 
     TEST_ASSERT_FALSE(poporon_encode(pprn, NULL, 10, NULL));
     TEST_ASSERT_FALSE(poporon_encode(NULL, NULL, 10, NULL));
+    TEST_ASSERT_FALSE(poporon_encode_batch(pprn, NULL, 10, NULL, 1, NULL));
+    TEST_ASSERT_FALSE(poporon_encode_strided(pprn, NULL, 10, 10, NULL, 10, 1, NULL));
 
     poporon_destroy(pprn);
     poporon_config_destroy(config);
@@ -422,6 +837,8 @@ void test_decode_null(void)
 
     TEST_ASSERT_FALSE(poporon_decode(pprn, NULL, 10, NULL, NULL));
     TEST_ASSERT_FALSE(poporon_decode(NULL, NULL, 10, NULL, NULL));
+    TEST_ASSERT_FALSE(poporon_decode_batch(pprn, NULL, 10, NULL, 1, NULL, NULL));
+    TEST_ASSERT_FALSE(poporon_decode_strided(pprn, NULL, 10, 10, NULL, 10, 1, NULL, NULL));
 
     poporon_destroy(pprn);
     poporon_config_destroy(config);
@@ -445,6 +862,14 @@ int main(void)
 
     RUN_TEST(test_bch_encode_decode_no_error);
 
+    RUN_TEST(test_rs_batch);
+    RUN_TEST(test_rs_strided);
+    RUN_TEST(test_rs_interleaved);
+    RUN_TEST(test_workspace);
+    RUN_TEST(test_check);
+    RUN_TEST(test_check_u16);
+    RUN_TEST(test_check_batch);
+
     RUN_TEST(test_create_null_config);
     RUN_TEST(test_encode_null);
     RUN_TEST(test_decode_null);
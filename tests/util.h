@@ -26,6 +26,17 @@ static inline void random_data(uint8_t *out, size_t size)
     }
 }
 
+/* xorshift64 stream for buffers that must differ, random_data() reseeds from the clock so back to back calls repeat */
+static inline void distinct_data(uint8_t *out, size_t size, uint64_t *state)
+{
+    for (size_t i = 0; i < size; i++) {
+        *state ^= *state << 13;
+        *state ^= *state >> 7;
+        *state ^= *state << 17;
+        out[i] = (uint8_t)*state;
+    }
+}
+
 static inline bool break_data(uint8_t *data, size_t data_size, uint32_t count)
 {
     uint32_t corrupted_count = 0;
@@ -93,6 +104,146 @@ static inline bool break_data_erasure(uint8_t *data, size_t data_size, uint32_t
     return true;
 }
 
+/* a shard codec (EC, FFT) behind its handle, encode and reconstruct forward to the codec calls */
+typedef struct {
+    const void *handle;
+    bool (*encode)(const void *handle, const uint8_t *const *data, uint8_t *const *parity, size_t size);
+    bool (*reconstruct)(const void *handle, uint8_t *const *shards, const bool *present, size_t size);
+} shard_codec_t;
+
+typedef struct {
+    shard_codec_t codec;
+    uint32_t data_shards;
+    uint32_t total;
+    size_t size;
+    uint8_t **original;
+    uint8_t **shards;
+    bool *present;
+} shard_set_t;
+
+static inline void shard_set_destroy(shard_set_t *set)
+{
+    uint32_t i;
+
+    if (set->original && set->shards) {
+        for (i = 0; i < set->total; i++) {
+            free(set->original[i]);
+            free(set->shards[i]);
+        }
+    }
+
+    free(set->original);
+    free(set->shards);
+    free(set->present);
+    memset(set, 0, sizeof(*set));
+}
+
+/* distinct data shards and the parity the codec computes for them in original[], false on failure */
+static inline bool shard_set_create(shard_set_t *set, const shard_codec_t *codec, uint32_t data_shards,
+                                    uint32_t parity_shards, size_t size)
+{
+    uint64_t state = 0x9E3779B97F4A7C15ULL ^ ((uint64_t)data_shards << 32) ^ ((uint64_t)parity_shards << 16) ^ size;
+    uint32_t i;
+
+    memset(set, 0, sizeof(*set));
+    set->codec = *codec;
+    set->data_shards = data_shards;
+    set->total = data_shards + parity_shards;
+    set->size = size;
+    set->original = (uint8_t **)calloc(set->total, sizeof(uint8_t *));
+    set->shards = (uint8_t **)calloc(set->total, sizeof(uint8_t *));
+    set->present = (bool *)calloc(set->total, sizeof(bool));
+    if (!set->original || !set->shards || !set->present) {
+        shard_set_destroy(set);
+        return false;
+    }
+
+    for (i = 0; i < set->total; i++) {
+        set->original[i] = (uint8_t *)malloc(size);
+        set->shards[i] = (uint8_t *)malloc(size);
+        if (!set->original[i] || !set->shards[i]) {
+            shard_set_destroy(set);
+            return false;
+        }
+
+        if (i < data_shards) {
+            distinct_data(set->original[i], size, &state);
+        }
+    }
+
+    if (!codec->encode(codec->handle, (const uint8_t *const *)set->original, &set->original[data_shards], size)) {
+        shard_set_destroy(set);
+        return false;
+    }
+
+    return true;
+}
+
+/* marks the shards whose bit is set in lost as missing */
+static inline void shard_set_lose_mask(shard_set_t *set, uint32_t lost)
+{
+    uint32_t i;
+
+    for (i = 0; i < set->total; i++) {
+        set->present[i] = !(lost & (1U << i));
+    }
+}
+
+/* marks count shards picked at random as missing */
+static inline void shard_set_lose_random(shard_set_t *set, uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0; i < set->total; i++) {
+        set->present[i] = true;
+    }
+
+    while (count > 0) {
+        i = (uint32_t)rand() % set->total;
+        if (set->present[i]) {
+            set->present[i] = false;
+            count--;
+        }
+    }
+}
+
+/* garbles the shards not flagged in present[], reconstructs them and compares every shard against the original */
+static inline bool shard_set_check(shard_set_t *set)
+{
+    uint32_t i;
+
+    for (i = 0; i < set->total; i++) {
+        if (set->present[i]) {
+            memcpy(set->shards[i], set->original[i], set->size);
+        } else {
+            memset(set->shards[i], 0xA5, set->size);
+        }
+    }
+
+    if (!set->codec.reconstruct(set->codec.handle, set->shards, set->present, set->size)) {
+        return false;
+    }
+
+    for (i = 0; i < set->total; i++) {
+        if (memcmp(set->original[i], set->shards[i], set->size) != 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static inline uint32_t popcount(uint32_t value)
+{
+    uint32_t count;
+
+    for (count = 0; value; value &= value - 1) {
+        count++;
+    }
+
+    return count;
+}
+
 static inline void print_hex(uint8_t *data, size_t len)
 {
     for (size_t i = 0; i < len; i++) {